@@ -22,6 +22,12 @@ cbuffer MatrixBuffer : register(b0)
     matrix Projection;
 }
 
+// bone palette for skinned meshes, the size matches Skeleton::sk_maxBones
+cbuffer BoneBuffer : register(b1)
+{
+    matrix Bones[64];
+}
+
 // Typedef input/output
 struct VS_INPUT
 {
@@ -29,6 +35,14 @@ struct VS_INPUT
     float3 normal : NORMAL;
 };
 
+struct VS_SKINNED_INPUT
+{
+    float4 position : POSITION;
+    float3 normal : NORMAL;
+    uint4 bones : BLENDINDICES;
+    float4 weights : BLENDWEIGHT;
+};
+
 struct PS_INPUT
 {
     float4 position : SV_POSITION;
@@ -53,3 +67,26 @@ PS_INPUT VS(VS_INPUT input)
 
     return output;
 }
+
+// Skinned Vertex Shader, blends up to four bones before applying the world transform
+PS_INPUT VS_Skinned(VS_SKINNED_INPUT input)
+{
+    PS_INPUT output = (PS_INPUT)0;
+
+    matrix skin = Bones[input.bones.x] * input.weights.x
+                + Bones[input.bones.y] * input.weights.y
+                + Bones[input.bones.z] * input.weights.z
+                + Bones[input.bones.w] * input.weights.w;
+    matrix model = mul(skin, World);
+
+    input.position.w = 1.0f;
+
+    output.position = mul(input.position, model);
+    output.world_position = output.position.xyz;
+    output.position = mul(output.position, View);
+    output.position = mul(output.position, Projection);
+
+    output.normal = normalize(mul(float4(input.normal, 0.f), model).xyz);
+
+    return output;
+}
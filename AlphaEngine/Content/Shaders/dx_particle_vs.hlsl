@@ -0,0 +1,58 @@
+// Copyright 2014-2015 Jason R. Wendlandt
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Constant Buffer
+
+// matrix buffer
+cbuffer MatrixBuffer : register(b0)
+{
+    matrix World;
+    matrix View;
+    matrix Projection;
+}
+
+// Typedef input/output
+struct VS_INPUT
+{
+    float2 corner : POSITION;
+    // particle position in xyz, size in w
+    float4 instance : TEXCOORD1;
+};
+
+struct PS_INPUT
+{
+    float4 position : SV_POSITION;
+    float3 normal : NORMAL;
+    float3 world_position : TEXCOORD0;
+};
+
+// Vertex Shader
+PS_INPUT VS(VS_INPUT input)
+{
+    PS_INPUT output = (PS_INPUT)0;
+
+    // expand each particle into a quad facing the camera
+    float3 right = float3(View[0][0], View[1][0], View[2][0]);
+    float3 up = float3(View[0][1], View[1][1], View[2][1]);
+    float3 world_position = input.instance.xyz + (right * input.corner.x + up * input.corner.y) * input.instance.w;
+
+    output.world_position = world_position;
+    output.position = mul(float4(world_position, 1.f), View);
+    output.position = mul(output.position, Projection);
+
+    // face back down the view direction, towards the camera
+    output.normal = -float3(View[0][2], View[1][2], View[2][2]);
+
+    return output;
+}
@@ -15,18 +15,34 @@
 #version 330 core
 layout(location = 0) in vec3 position;
 layout(location = 1) in vec3 normal;
+layout(location = 2) in uvec4 boneIds;
+layout(location = 3) in vec4 boneWeights;
 
 uniform mat4 world;
 uniform mat4 view;
 uniform mat4 projection;
 
+// skinned meshes blend up to four bones from the palette, the palette size matches Skeleton::sk_maxBones
+uniform bool skinned;
+uniform mat4 bones[64];
+
 out vec3 FragPos;
 out vec3 Normal;
 
 void main ()
 {
-    vec4 world_position = world * vec4(position, 1.0f);
+    mat4 model = world;
+    if (skinned)
+    {
+        mat4 skin = bones[boneIds.x] * boneWeights.x
+                  + bones[boneIds.y] * boneWeights.y
+                  + bones[boneIds.z] * boneWeights.z
+                  + bones[boneIds.w] * boneWeights.w;
+        model = world * skin;
+    }
+
+    vec4 world_position = model * vec4(position, 1.0f);
     gl_Position = projection * view * world_position;
     FragPos = world_position.xyz;
-    Normal = transpose(inverse(mat3(world))) * normal;
+    Normal = transpose(inverse(mat3(model))) * normal;
 }
@@ -0,0 +1,36 @@
+// Copyright 2014-2015 Jason R. Wendlandt
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#version 330 core
+layout(location = 0) in vec2 corner;
+layout(location = 1) in vec4 instance;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+out vec3 FragPos;
+out vec3 Normal;
+
+void main ()
+{
+    // expand each particle into a quad facing the camera, instance.xyz is the particle position and instance.w its size
+    vec3 right = vec3(view[0][0], view[1][0], view[2][0]);
+    vec3 up = vec3(view[0][1], view[1][1], view[2][1]);
+    vec3 world_position = instance.xyz + (right * corner.x + up * corner.y) * instance.w;
+
+    gl_Position = projection * view * vec4(world_position, 1.0f);
+    FragPos = world_position;
+    // face back down the view direction, towards the camera
+    Normal = -vec3(view[0][2], view[1][2], view[2][2]);
+}
@@ -59,6 +59,11 @@ namespace alpha
         virtual bool VInitialize() = 0;
         virtual bool VUpdate(double currentTime, double elapsedTime) = 0;
         virtual bool VShutdown() = 0;
+        /**
+         * Wait for any threaded work the system published during its last update, called before the events for
+         * the next update are handled.  Systems that do not publish work they depend on need not override it.
+         */
+        virtual void VFinishTasks() { }
 
         /** Handle any events recieved since the last update */
         void HandleEvents();
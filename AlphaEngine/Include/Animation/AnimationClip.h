@@ -0,0 +1,84 @@
+#ifndef ALPHA_ANIMATION_CLIP_H
+#define ALPHA_ANIMATION_CLIP_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+#include "Animation/Pose.h"
+
+namespace alpha
+{
+    class Asset;
+
+#define CLIPFILE_SIG "Alpha-Clip" // AC - Alpha Clip
+#define CLIPFILE_V1 0x01
+
+    /**
+     * A clip file is laid out as:
+     *   ClipFileHeader
+     *   frameCount poses, each Pose::GetData for boneCount bones
+     */
+    struct ClipFileHeader
+    {
+        char signature[12]; // = CLIPFILE_SIG;
+        unsigned short version;
+        uint32_t boneCount;
+        uint32_t frameCount;
+        float frameRate;
+    };
+
+    /**
+     * \brief A skeletal animation, resampled to a fixed frame rate.
+     *
+     * Every frame is a full pose for the skeleton the clip was made for, so sampling never searches for
+     * keys per bone, it blends the two frames either side of the sample time in a single pass.
+     */
+    class AnimationClip
+    {
+    public:
+        AnimationClip(float frameRate, std::vector<Pose> frames);
+
+        size_t GetBoneCount() const;
+        size_t GetFrameCount() const;
+        float GetFrameRate() const;
+        /** Length of the clip in seconds, from the first frame to the last */
+        float GetDuration() const;
+        const Pose & GetFrame(size_t index) const;
+
+        /**
+         * Sample the clip at a time in seconds.  Looping clips wrap the time around, others hold their
+         * first and last frames.  out is resized to the clips bone count if needed.
+         */
+        void Sample(float time, bool loop, Pose & out) const;
+
+    private:
+        float m_frameRate;
+        std::vector<Pose> m_frames;
+    };
+
+    /** Load an asset as a clip file, returns nullptr if it is not a valid clip */
+    AnimationClip * LoadClipFromAsset(std::shared_ptr<Asset> pAsset);
+    AnimationClip * DeserializeClip(const char * data, size_t size);
+    /** Write a clip out in the clip file format */
+    void SerializeClip(const AnimationClip * const pClip, std::ostream & stream);
+}
+
+#endif // ALPHA_ANIMATION_CLIP_H
@@ -0,0 +1,95 @@
+#ifndef ALPHA_ANIMATION_TRACK_H
+#define ALPHA_ANIMATION_TRACK_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <memory>
+#include <vector>
+
+namespace alpha
+{
+    struct Quaternion;
+    struct Vector3;
+
+    /** The part of a scene components transform a track drives */
+    typedef enum AnimationChannel
+    {
+        AC_POSITION,
+        AC_ROTATION,
+        AC_SCALE,
+    } AnimationChannel;
+
+    /** Easing applied between each pair of keys */
+    typedef enum AnimationEase
+    {
+        AE_LINEAR,
+        AE_EASE_IN,
+        AE_EASE_OUT,
+        AE_EASE_IN_OUT,
+    } AnimationEase;
+
+    /** What a playing track does when it reaches its last key */
+    typedef enum AnimationLoop
+    {
+        /** Hold the last key, and stop playing */
+        AL_ONCE,
+        /** Jump back to the first key */
+        AL_LOOP,
+        /** Play backwards to the first key, then forwards again */
+        AL_PING_PONG,
+    } AnimationLoop;
+
+    /**
+     * \brief A set of keyframes for one transform channel.
+     *
+     * Keys are stored as flat arrays, a time per key and four floats per value, so sampling is a search
+     * over one array and a four wide blend.  Rotation keys are blended with a normalized lerp along the
+     * shortest arc.  Tracks are immutable once playing, and are meant to be shared by every component
+     * that plays them.
+     */
+    class AnimationTrack
+    {
+    public:
+        explicit AnimationTrack(AnimationChannel channel, AnimationEase ease = AE_LINEAR);
+
+        /** Build a two key track that moves between from and to over duration seconds */
+        static std::shared_ptr<AnimationTrack> Tween(AnimationChannel channel, const Vector3 & from, const Vector3 & to, float duration, AnimationEase ease = AE_LINEAR);
+        static std::shared_ptr<AnimationTrack> Tween(const Quaternion & from, const Quaternion & to, float duration, AnimationEase ease = AE_LINEAR);
+
+        /** Add a key, keys must be added in time order.  Position and scale tracks take vectors, rotation tracks take quaternions. */
+        void AddKey(float time, const Vector3 & value);
+        void AddKey(float time, const Quaternion & value);
+
+        AnimationChannel GetChannel() const;
+        /** Time of the last key */
+        float GetDuration() const;
+        size_t GetKeyCount() const;
+
+        /** Sample the track at time, clamped to the first and last keys.  out receives four floats, x y z and w. */
+        void Sample(float time, float * out) const;
+
+    private:
+        AnimationChannel m_eChannel;
+        AnimationEase m_eEase;
+
+        std::vector<float> m_keyTimes;
+        /** Four floats per key */
+        std::vector<float> m_keyValues;
+    };
+}
+
+#endif // ALPHA_ANIMATION_TRACK_H
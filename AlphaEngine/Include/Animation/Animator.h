@@ -0,0 +1,101 @@
+#ifndef ALPHA_ANIMATOR_H
+#define ALPHA_ANIMATOR_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "Animation/AnimationTrack.h"
+#include "Entities/ComponentHandle.h"
+#include "Toolbox/SlotMap.h"
+
+namespace alpha
+{
+    class AEvent;
+    class Entity;
+    class SceneComponent;
+    class TaskGroup;
+
+    /** A reference to a playing animation track, stale once the track has stopped */
+    struct AnimationHandle
+    {
+        AnimationHandle() : index(0), generation(0) { }
+
+        bool IsValid() const { return generation != 0; }
+
+        uint32_t index;
+        uint32_t generation;
+    };
+
+    /**
+     * \brief Plays animation tracks on scene components.
+     *
+     * Playback state is advanced on the logic thread, then every playing track is sampled and written
+     * to its component by a group of update tasks.  Tracks are grouped by the component they drive, and
+     * every track on a component goes to the same task, so no two tasks ever write one transform.  Writing a transform
+     * wakes its entity, so animated entities are journaled with the rest of the next update batch, and
+     * no per-entity events are published.  A component channel driven by a track should not also be set
+     * by game code while the track is playing.
+     */
+    class Animator
+    {
+    public:
+        Animator();
+
+        /** Start playing the track on target, speed scales how fast time passes for the track */
+        AnimationHandle Play(const ComponentHandle<SceneComponent> & target, std::shared_ptr<const AnimationTrack> track,
+                             AnimationLoop loop = AL_ONCE, float speed = 1.f);
+        /** Stop the track where it is, returns false if it had already stopped */
+        bool Stop(const AnimationHandle & handle);
+        /** Stop every track playing on a component owned by the entity */
+        void StopEntity(const Entity * pEntity);
+        void SetSpeed(const AnimationHandle & handle, float speed);
+        bool IsPlaying(const AnimationHandle & handle) const;
+        /** Number of times a looping track has wrapped, or a ping pong track has turned around */
+        unsigned int GetLoops(const AnimationHandle & handle) const;
+
+        size_t Size() const;
+        void Clear();
+
+        /**
+         * Advance every playing track, and publish the tasks that evaluate and apply them.
+         * Returns the group of tasks, which must be finished before the components are read, or nullptr if nothing is playing.
+         */
+        std::shared_ptr<TaskGroup> Update(float fElapsedTime, std::function<void(AEvent *)> delPublishEvent);
+
+    private:
+        struct PlayingTrack
+        {
+            ComponentHandle<SceneComponent> target;
+            std::shared_ptr<const AnimationTrack> track;
+            AnimationLoop loop;
+            float speed;
+            /** Time into the current loop, or into the current pair of legs for ping pong tracks */
+            float time;
+            unsigned int loops;
+        };
+
+        /** Number of tracks evaluated by each task, a task only goes over to finish the tracks of its last component */
+        static const size_t sk_batchSize;
+
+        SlotMap<PlayingTrack, AnimationHandle> m_tracks;
+    };
+}
+
+#endif // ALPHA_ANIMATOR_H
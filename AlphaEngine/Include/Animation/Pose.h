@@ -0,0 +1,90 @@
+#ifndef ALPHA_POSE_H
+#define ALPHA_POSE_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <vector>
+
+#include "Math/Quaternion.h"
+#include "Math/Vector3.h"
+
+namespace alpha
+{
+    /** The separate streams a pose is stored as, one float per bone in each */
+    typedef enum PoseChannel
+    {
+        PC_POSITION_X,
+        PC_POSITION_Y,
+        PC_POSITION_Z,
+        PC_ROTATION_X,
+        PC_ROTATION_Y,
+        PC_ROTATION_Z,
+        PC_ROTATION_W,
+        PC_SCALE_X,
+        PC_SCALE_Y,
+        PC_SCALE_Z,
+        PC_COUNT,
+    } PoseChannel;
+
+    /**
+     * \brief The local transform of every bone in a skeleton.
+     *
+     * A pose is stored as one array per channel, each padded to a multiple of four bones, so blending and
+     * building matrices works on four bones at a time.  Padding bones hold the identity transform, so they
+     * stay well formed through every operation, and are never read back.
+     */
+    class Pose
+    {
+    public:
+        Pose();
+        explicit Pose(size_t boneCount);
+
+        /** Resize for a different skeleton, every bone is reset to the identity transform */
+        void Resize(size_t boneCount);
+
+        size_t GetBoneCount() const;
+        /** Number of floats in each channel, the bone count rounded up to a multiple of four */
+        size_t GetStride() const;
+
+        void SetBone(size_t bone, const Vector3 & position, const Quaternion & rotation, const Vector3 & scale);
+        Vector3 GetPosition(size_t bone) const;
+        Quaternion GetRotation(size_t bone) const;
+        Vector3 GetScale(size_t bone) const;
+
+        /** The start of a single channel, GetStride floats long */
+        float * GetChannel(PoseChannel channel);
+        const float * GetChannel(PoseChannel channel) const;
+
+        /** Every channel back to back, for reading and writing a pose in a single copy */
+        std::vector<float> & GetData();
+        const std::vector<float> & GetData() const;
+
+        /**
+         * Blend from one pose toward another, positions and scales are lerped and rotations are lerped along
+         * the shortest arc and renormalized.  All three poses must have the same bone count, and out may be
+         * the same pose as either input.
+         */
+        static void Blend(const Pose & from, const Pose & to, float weight, Pose & out);
+
+    private:
+        size_t m_boneCount;
+        size_t m_stride;
+        std::vector<float> m_data;
+    };
+}
+
+#endif // ALPHA_POSE_H
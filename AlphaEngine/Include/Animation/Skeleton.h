@@ -0,0 +1,71 @@
+#ifndef ALPHA_SKELETON_H
+#define ALPHA_SKELETON_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Animation/Pose.h"
+#include "Math/Matrix.h"
+
+namespace alpha
+{
+    /** A single joint of a skeleton */
+    struct Bone
+    {
+        std::string name;
+        /** Index of the parent bone, parents always come before their children, -1 for a root bone */
+        int parent;
+        /** Takes a vertex from model space into the bones space, as it was when the mesh was bound */
+        Matrix inverseBind;
+    };
+
+    /**
+     * \brief The bone hierarchy a skinned mesh is bound to.
+     *
+     * Skeletons are loaded as part of a model, clips and poses refer to bones by their index in it.
+     */
+    class Skeleton
+    {
+    public:
+        /** Most bones a skeleton can have, the size of the bone palette in the deferred vertex shaders */
+        static const unsigned int sk_maxBones = 64;
+
+        Skeleton(std::vector<Bone> bones, const Pose & bindPose);
+
+        size_t GetBoneCount() const;
+        const Bone & GetBone(size_t index) const;
+        /** Find a bone by name, returns -1 if there is no such bone */
+        int FindBone(const std::string & name) const;
+
+        /** The local transform of every bone, as it was when the mesh was bound */
+        const Pose & GetBindPose() const;
+
+        /** Write skeleton data out to stream */
+        void Serialize(std::ostream & stream) const;
+        /** Read data from stream, create and return a new Skeleton, returns nullptr if the data is invalid */
+        static Skeleton * Deserialize(std::istream & stream);
+
+    private:
+        std::vector<Bone> m_bones;
+        Pose m_bindPose;
+    };
+}
+
+#endif // ALPHA_SKELETON_H
@@ -0,0 +1,93 @@
+#ifndef ALPHA_SKELETON_ANIMATOR_H
+#define ALPHA_SKELETON_ANIMATOR_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Animation/Pose.h"
+#include "Math/Matrix.h"
+
+namespace alpha
+{
+    class AnimationClip;
+    class RenderSet;
+    class Skeleton;
+
+    /**
+     * \brief Plays clips on a single skinned model, and keeps its bone palette up to date.
+     *
+     * One animator exists per skinned scene node.  Evaluate only touches the animator and its own render
+     * set, so any number of animators can be evaluated in parallel.
+     */
+    class SkeletonAnimator
+    {
+    public:
+        /** The skeleton and render set belong to the model of the same scene node, and must outlive the animator */
+        SkeletonAnimator(const Skeleton * pSkeleton, RenderSet * pRenderSet);
+        virtual ~SkeletonAnimator();
+
+        /** Make a clip available to Play, the clip must have been made for this skeleton */
+        bool AddClip(const std::string & name, std::shared_ptr<const AnimationClip> pClip);
+
+        /**
+         * Fade from whatever is playing into a clip over blendTime seconds.
+         * Playing the clip that is already playing restarts it, fading from where it was.
+         */
+        bool Play(const std::string & name, float blendTime, bool loop);
+        /** Scale the rate every clip plays at */
+        void SetSpeed(float speed);
+
+        /** Advance playback, then rebuild the bone palette of the render set */
+        void Evaluate(float fElapsedTime);
+
+    private:
+        /** A clip being played, and how far through it is */
+        struct Layer
+        {
+            std::shared_ptr<const AnimationClip> clip;
+            float time;
+            bool loop;
+        };
+
+        /** Build model space bone matrices from a pose, then the palette the vertex shader skins with */
+        void BuildPalette(const Pose & pose);
+
+        const Skeleton * m_pSkeleton;
+        RenderSet * m_pRenderSet;
+
+        std::map<std::string, std::shared_ptr<const AnimationClip> > m_clips;
+
+        Layer m_current;
+        /** The clip being faded out of, if any */
+        Layer m_previous;
+        float m_fBlendTime;
+        float m_fBlendElapsed;
+        float m_fSpeed;
+
+        Pose m_pose;
+        Pose m_previousPose;
+        /** Per bone scratch matrices, kept between evaluations to avoid reallocating */
+        std::vector<Matrix> m_locals;
+        std::vector<Matrix> m_models;
+    };
+}
+
+#endif // ALPHA_SKELETON_ANIMATOR_H
@@ -0,0 +1,59 @@
+#ifndef ALPHA_TASK_ANIMATE_TRANSFORMS_H
+#define ALPHA_TASK_ANIMATE_TRANSFORMS_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <memory>
+#include <vector>
+
+#include "Threading/ATask.h"
+
+namespace alpha
+{
+    class AnimationTrack;
+    class SceneComponent;
+
+    /** Everything sampled in one animation update, one entry per playing track */
+    struct AnimationBatch
+    {
+        std::vector<std::shared_ptr<SceneComponent> > targets;
+        std::vector<std::shared_ptr<const AnimationTrack> > tracks;
+        /** The time to sample each track at, loops have already been resolved */
+        std::vector<float> times;
+    };
+
+    /**
+     * Task_AnimateTransforms
+     * Samples a contiguous range of tracks from a shared batch, and writes the results straight to
+     * their scene components.  The batch is sorted by component and the range never splits one, so no
+     * other task writes the same components.
+     */
+    class Task_AnimateTransforms : public ATask
+    {
+    public:
+        Task_AnimateTransforms(std::shared_ptr<const AnimationBatch> pBatch, size_t begin, size_t end);
+        bool VExecute();
+
+    private:
+        std::shared_ptr<const AnimationBatch> m_pBatch;
+        /** The range of tracks this task is responsible for, [begin, end) */
+        size_t m_begin;
+        size_t m_end;
+    };
+}
+
+#endif // ALPHA_TASK_ANIMATE_TRANSFORMS_H
@@ -0,0 +1,49 @@
+#ifndef ALPHA_TASK_EVALUATE_POSES_H
+#define ALPHA_TASK_EVALUATE_POSES_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cstddef>
+#include <vector>
+
+#include "Threading/ATask.h"
+
+namespace alpha
+{
+    class SkeletonAnimator;
+
+    /**
+     * Task_EvaluatePoses
+     * Advances a batch of skeleton animators, and rebuilds their bone palettes.  Animators are owned by
+     * their scene nodes, the graphics system waits for the task before it changes, draws, or releases any part of the scene.
+     */
+    class Task_EvaluatePoses : public ATask
+    {
+    public:
+        /** Number of animators evaluated by each task */
+        static const size_t sk_batchSize;
+
+        Task_EvaluatePoses(std::vector<SkeletonAnimator *> animators, float fElapsedTime);
+        bool VExecute();
+
+    private:
+        std::vector<SkeletonAnimator *> m_animators;
+        float m_fElapsedTime;
+    };
+}
+
+#endif // ALPHA_TASK_EVALUATE_POSES_H
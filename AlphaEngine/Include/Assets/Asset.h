@@ -18,6 +18,7 @@ limitations under the License.
 */
 
 #include <sys/stat.h>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -30,12 +31,17 @@ namespace alpha
         virtual ~Asset();
 
         std::string GetPath() const;
+        /** Get the files data, it is read the first time and kept.  Safe to call from any thread. */
         std::vector<unsigned char> GetData();
+        /** Read the file without keeping a copy in the asset, for data that is only needed once */
+        std::vector<unsigned char> ReadData() const;
 
     private:
         const char * m_pPath;
         struct stat m_fileStats;
         std::vector<unsigned char> m_data;
+        /** Guards m_data, scripts are loaded from worker threads while the logic thread may load the same asset */
+        std::mutex m_dataMutex;
     };
 }
 
@@ -0,0 +1,66 @@
+#ifndef ALPHA_BROADPHASE_H
+#define ALPHA_BROADPHASE_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <vector>
+
+#include "Entities/EntityHandle.h"
+
+namespace alpha
+{
+    struct AABB;
+
+    /** Two entities whose collision volumes overlap, a is always ordered before b */
+    struct ContactPair
+    {
+        ContactPair() { }
+        ContactPair(const EntityHandle & first, const EntityHandle & second);
+
+        bool operator==(const ContactPair & right) const { return a == right.a && b == right.b; }
+        bool operator<(const ContactPair & right) const { return a < right.a || (a == right.a && b < right.b); }
+
+        EntityHandle a;
+        EntityHandle b;
+    };
+
+    /**
+     * Collision volume bounds laid out as one array per axis, so the broadphase can test
+     * several volumes against one another with a single instruction.
+     */
+    struct BroadphaseBounds
+    {
+        void Add(const EntityHandle & entity, const AABB & bounds);
+        void Clear();
+        void Reserve(size_t count);
+        size_t Size() const;
+
+        std::vector<float> minX, minY, minZ;
+        std::vector<float> maxX, maxY, maxZ;
+        std::vector<EntityHandle> entities;
+    };
+
+    /**
+     * Find every overlapping pair of bounds.
+     * Bounds are sorted along the x axis and swept, and the candidates that overlap on x are tested on
+     * y and z four at a time where SIMD is available.  Pairs are returned sorted and without duplicates,
+     * volumes belonging to the same entity never form a pair.
+     */
+    void SweepAndPrune(const BroadphaseBounds & bounds, std::vector<ContactPair> & pairs);
+}
+
+#endif // ALPHA_BROADPHASE_H
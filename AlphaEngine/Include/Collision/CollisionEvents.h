@@ -0,0 +1,69 @@
+#ifndef ALPHA_COLLISION_EVENTS_H
+#define ALPHA_COLLISION_EVENTS_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <vector>
+
+#include "Events/AEvent.h"
+#include "Collision/Broadphase.h"
+
+namespace alpha
+{
+    /**
+     * Event_ContactsBegan
+     * Published once per broadphase pass, with every pair of entities that started overlapping.
+     */
+    class Event_ContactsBegan : public AEvent
+    {
+    public:
+        static const std::string sk_name;
+
+        explicit Event_ContactsBegan(std::vector<ContactPair> contacts);
+
+        virtual std::string VGetTypeName() const;
+        virtual AEvent * VCopy();
+
+        const std::vector<ContactPair> & GetContacts() const;
+
+    private:
+        std::vector<ContactPair> m_contacts;
+    };
+
+    /**
+     * Event_ContactsEnded
+     * Published once per broadphase pass, with every pair of entities that stopped overlapping.
+     * Pairs involving a destroyed entity end on the first pass after it is gone.
+     */
+    class Event_ContactsEnded : public AEvent
+    {
+    public:
+        static const std::string sk_name;
+
+        explicit Event_ContactsEnded(std::vector<ContactPair> contacts);
+
+        virtual std::string VGetTypeName() const;
+        virtual AEvent * VCopy();
+
+        const std::vector<ContactPair> & GetContacts() const;
+
+    private:
+        std::vector<ContactPair> m_contacts;
+    };
+}
+
+#endif // ALPHA_COLLISION_EVENTS_H
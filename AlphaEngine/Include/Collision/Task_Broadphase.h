@@ -0,0 +1,62 @@
+#ifndef ALPHA_TASK_BROADPHASE_H
+#define ALPHA_TASK_BROADPHASE_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "Threading/ATask.h"
+#include "Collision/Broadphase.h"
+
+namespace alpha
+{
+    class AEvent;
+
+    /** Broadphase results carried from one pass to the next */
+    struct BroadphaseState
+    {
+        BroadphaseState() : busy(false) { }
+
+        /** Set while a pass is running, only one pass may run at a time */
+        std::atomic<bool> busy;
+        /** Sorted contacts found by the last pass */
+        std::vector<ContactPair> contacts;
+    };
+
+    /**
+     * Task_Broadphase
+     * Finds every overlapping pair of collision volumes, compares them against the previous pass, and
+     * publishes the contacts that began and ended as one event each.
+     */
+    class Task_Broadphase : public ATask
+    {
+    public:
+        Task_Broadphase(std::shared_ptr<BroadphaseState> pState, BroadphaseBounds bounds,
+                        std::function<void(AEvent *)> delPublishEvent);
+        bool VExecute();
+
+    private:
+        std::shared_ptr<BroadphaseState> m_pState;
+        BroadphaseBounds m_bounds;
+        std::function<void(AEvent *)> m_delPublishEvent;
+    };
+}
+
+#endif // ALPHA_TASK_BROADPHASE_H
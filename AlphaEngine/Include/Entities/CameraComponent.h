@@ -35,7 +35,9 @@ namespace alpha
 
         virtual ~CameraComponent();
 
-        virtual void VInitialize(std::shared_ptr<LuaVar> var);
+        virtual void VInitialize(const LuaVar & var);
+        virtual void VSerialize(BinaryWriter & writer) const;
+        virtual bool VDeserialize(BinaryReader & reader);
         virtual bool VUpdate(float fCurrentTime, float fElapsedTime);
         virtual std::string VGetName() const;
 
@@ -44,9 +46,6 @@ namespace alpha
         float GetFar() const;
 
     private:
-        /** Init helper methods */
-        float ParseFloatVar(std::shared_ptr<LuaVar> var, float defaultValue);
-
         /** Camera field of view */
         float m_fov;
         /** Camera near plane position */
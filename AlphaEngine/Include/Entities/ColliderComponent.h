@@ -0,0 +1,69 @@
+#ifndef ALPHA_COLLIDER_COMPONENT_H
+#define ALPHA_COLLIDER_COMPONENT_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "Entities/EntityComponent.h"
+#include "Math/AABB.h"
+
+namespace alpha
+{
+    typedef enum ColliderShape
+    {
+        CS_BOX,
+        CS_SPHERE,
+    } ColliderShape;
+
+    /**
+     * The ColliderComponent gives an entity a collision volume, either a box or a sphere, positioned by
+     * the components transform relative to its parent.  Colliders are picked up by the logic systems
+     * broadphase, which reports overlapping entities as contacts.
+     *
+     * Script data:
+     *   shape = "box" or "sphere"
+     *   extents = { x, y, z }, half size of a box in model space
+     *   radius = sphere radius in world units
+     */
+    class ColliderComponent : public SceneComponent
+    {
+    public:
+        static const std::string sk_name;
+
+        ColliderComponent();
+        virtual ~ColliderComponent();
+
+        virtual void VInitialize(const LuaVar & var);
+        virtual void VSerialize(BinaryWriter & writer) const;
+        virtual bool VDeserialize(BinaryReader & reader);
+        virtual bool VUpdate(float fCurrentTime, float fElapsedTime);
+        virtual std::string VGetName() const;
+
+        ColliderShape GetShape() const;
+        const Vector3 & GetExtents() const;
+        float GetRadius() const;
+
+        /** World space bounds of the collision volume, built from this component and its parents transforms */
+        AABB GetWorldBounds() const;
+
+    private:
+        ColliderShape m_eShape;
+        Vector3 m_vExtents;
+        float m_fRadius;
+    };
+}
+
+#endif // ALPHA_COLLIDER_COMPONENT_H
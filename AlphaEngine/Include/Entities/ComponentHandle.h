@@ -0,0 +1,72 @@
+#ifndef ALPHA_COMPONENT_HANDLE_H
+#define ALPHA_COMPONENT_HANDLE_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <memory>
+
+namespace alpha
+{
+    class EntityComponent;
+
+    /**
+     * \brief A typed reference to a component, resolved once and then used without any lookups.
+     *
+     * Get returns nullptr once the component has been destroyed along with its entity.
+     * A handle to a derived component type converts to a handle to any of its base types.
+     */
+    template <class T>
+    class ComponentHandle
+    {
+        template <class U> friend class ComponentHandle;
+
+    public:
+        ComponentHandle()
+            : m_pComponent(nullptr)
+        { }
+        ComponentHandle(const std::shared_ptr<EntityComponent> & component, T * pComponent)
+            : m_component(component)
+            , m_pComponent(pComponent)
+        { }
+        template <class U>
+        ComponentHandle(const ComponentHandle<U> & other)
+            : m_component(other.m_component)
+            , m_pComponent(other.m_pComponent)
+        { }
+
+        T * Get() const
+        {
+            return m_component.expired() ? nullptr : m_pComponent;
+        }
+        T * operator->() const { return this->Get(); }
+        explicit operator bool() const { return this->Get() != nullptr; }
+
+        /** Get a reference that keeps the component alive, empty once the component has been destroyed */
+        std::shared_ptr<T> Lock() const
+        {
+            std::shared_ptr<EntityComponent> component = m_component.lock();
+            return component ? std::shared_ptr<T>(component, m_pComponent) : std::shared_ptr<T>();
+        }
+
+    private:
+        /** Only used to detect that the component has been destroyed */
+        std::weak_ptr<EntityComponent> m_component;
+        T * m_pComponent;
+    };
+}
+
+#endif // ALPHA_COMPONENT_HANDLE_H
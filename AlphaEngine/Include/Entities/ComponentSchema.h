@@ -0,0 +1,180 @@
+#ifndef ALPHA_COMPONENT_SCHEMA_H
+#define ALPHA_COMPONENT_SCHEMA_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Math/Vector3.h"
+
+namespace alpha
+{
+    class LuaVar;
+
+    /** The kinds of script value a schema field is read from, and how each is stored */
+    enum SchemaFieldType
+    {
+        /** A number, stored as a float */
+        SF_FLOAT,
+        /** A number, stored as an unsigned int, negative numbers are stored as 0 */
+        SF_UINT,
+        /** A boolean, stored as a bool */
+        SF_BOOL,
+        /** A string, stored as a std::string */
+        SF_STRING,
+        /** A string, stored as the int it is mapped to */
+        SF_ENUM,
+        /** A table of strings, stored as a std::map<std::string, std::string> */
+        SF_STRING_MAP,
+    };
+
+    /**
+     * \brief The type independent half of a ComponentSchema.
+     *
+     * Fields are kept in a tree of script tables, each tables keys sorted the same way as a LuaVar table, so
+     * parsing walks the script table and the schema side by side in a single pass.  Values are written
+     * straight to their offset in the descriptor, keys the schema does not know are skipped.
+     */
+    class SchemaLayout
+    {
+    public:
+        SchemaLayout();
+
+        /** Register a field at a dotted script path, such as "transform.position.x", stored offset bytes into the descriptor */
+        void AddField(const std::string & path, SchemaFieldType type, size_t offset);
+        /** Register a string field stored as an int, strings missing from values keep the descriptors default */
+        void AddEnum(const std::string & path, size_t offset, const std::map<std::string, int> & values);
+        /** Register a bool that is set when the script has a table at path */
+        void AddTableFlag(const std::string & path, size_t offset);
+
+        /** Parse a script table into the descriptor at pDescriptor, returns false if var is not a table */
+        bool Parse(const LuaVar & var, char * pDescriptor) const;
+
+    private:
+        struct Field
+        {
+            SchemaFieldType type;
+            size_t offset;
+            /** The full script path, for warnings */
+            std::string path;
+            /** Values for SF_ENUM fields */
+            std::map<std::string, int> values;
+        };
+
+        /** A key in a schema table, either a field or a nested table */
+        struct Entry
+        {
+            bool isField;
+            size_t index;
+        };
+
+        struct Table
+        {
+            Table();
+
+            std::map<std::string, Entry> entries;
+            /** Offset of a bool set when the table is present, sk_noFlag if none is registered */
+            size_t flagOffset;
+        };
+
+        /** Get the table holding the last key of path, adding any tables that are missing, and split off that key */
+        size_t GetTable(const std::string & path, std::string & key);
+        void ParseTable(size_t table, const LuaVar & script, char * pDescriptor) const;
+        void ParseField(const Field & field, const LuaVar & var, char * pDescriptor) const;
+
+        static const size_t sk_noFlag;
+
+        /** Every table in the schema, the root is the first */
+        std::vector<Table> m_tables;
+        std::vector<Field> m_fields;
+    };
+
+    /**
+     * \brief The script fields of a component type, and where each is stored in a flat descriptor struct.
+     *
+     * A component builds its schema once, registering each field as a member of the schemas own Layout
+     * descriptor, which records the members offset.  Parse then turns a script table into a descriptor in one
+     * pass, without looking keys up by name, and fields missing from the script keep the descriptors defaults.
+     */
+    template <class Descriptor>
+    class ComponentSchema
+    {
+    public:
+        /** The descriptor fields are registered from, pass its members to the Add functions */
+        const Descriptor & Layout() const
+        {
+            return m_layout;
+        }
+
+        void AddFloat(const std::string & path, const float & field)
+        {
+            m_fields.AddField(path, SF_FLOAT, this->OffsetOf(field));
+        }
+        void AddUInt(const std::string & path, const unsigned int & field)
+        {
+            m_fields.AddField(path, SF_UINT, this->OffsetOf(field));
+        }
+        void AddBool(const std::string & path, const bool & field)
+        {
+            m_fields.AddField(path, SF_BOOL, this->OffsetOf(field));
+        }
+        void AddString(const std::string & path, const std::string & field)
+        {
+            m_fields.AddField(path, SF_STRING, this->OffsetOf(field));
+        }
+        void AddStringMap(const std::string & path, const std::map<std::string, std::string> & field)
+        {
+            m_fields.AddField(path, SF_STRING_MAP, this->OffsetOf(field));
+        }
+        void AddEnum(const std::string & path, const int & field, const std::map<std::string, int> & values)
+        {
+            m_fields.AddEnum(path, this->OffsetOf(field), values);
+        }
+        /** Register the x, y, and z keys of a table at path */
+        void AddVector3(const std::string & path, const Vector3 & field)
+        {
+            this->AddFloat(path + ".x", field.x);
+            this->AddFloat(path + ".y", field.y);
+            this->AddFloat(path + ".z", field.z);
+        }
+        /** Register a bool that is set when the script has a table at path */
+        void AddTableFlag(const std::string & path, const bool & field)
+        {
+            m_fields.AddTableFlag(path, this->OffsetOf(field));
+        }
+
+        /** Parse a script table into descriptor, returns false if var is not a table */
+        bool Parse(const LuaVar & var, Descriptor & descriptor) const
+        {
+            return m_fields.Parse(var, reinterpret_cast<char *>(&descriptor));
+        }
+
+    private:
+        template <class T>
+        size_t OffsetOf(const T & field) const
+        {
+            return reinterpret_cast<const char *>(&field) - reinterpret_cast<const char *>(&m_layout);
+        }
+
+        Descriptor m_layout;
+        SchemaLayout m_fields;
+    };
+}
+
+#endif // ALPHA_COMPONENT_SCHEMA_H
@@ -17,36 +17,98 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <atomic>
+#include <functional>
 #include <map>
 #include <memory>
 #include <vector>
 
+#include "Entities/ComponentHandle.h"
+#include "Entities/EntityComponent.h"
+#include "Entities/EntityHandle.h"
+#include "Entities/EntityTags.h"
+
 namespace alpha
 {
     class EntityScript;
-    class EntityComponent;
 
     class Entity
     {
     public:
-        Entity(unsigned long entityId, std::shared_ptr<EntityScript> script);
+        explicit Entity(std::shared_ptr<EntityScript> script);
         virtual ~Entity();
 
         /** Tick the entity, and update all components. */
         bool Update(float fCurrentTime, float fElapsedTime);
+        /** Tick the entity, and append the fields each component changed since the last tick to deltas. */
+        bool Update(float fCurrentTime, float fElapsedTime, std::vector<ComponentDelta> & deltas);
+
+        /**
+         * Wake the entity so it is updated on the next logic tick.
+         * Safe to call from any thread, an entity already awake is not woken twice.
+         */
+        void Wake();
+        /** Is the entity waiting to be updated */
+        bool IsAwake() const;
+        /** Does any component on this entity need to be ticked every frame */
+        bool RequiresUpdate() const;
+        /** Set the function that is called when a sleeping entity is woken */
+        void SetWakeListener(std::function<void(Entity *)> listener);
 
-        unsigned long GetId() const;
+        /** Get the handle the logic system knows this entity by, invalid until the entity is added to the logic system */
+        EntityHandle GetHandle() const;
+        void SetHandle(const EntityHandle & handle);
         std::shared_ptr<EntityScript> GetScript() const;
 
+        /**
+         * Layer and tag bits, starting with the tags listed in the entities script.
+         * Change tags through the logic system, so other systems hear about it.
+         */
+        EntityTagMask GetTags() const;
+        void SetTags(EntityTagMask tags);
+        /** Does the entity have any of the given tags */
+        bool HasAnyTag(EntityTagMask tags) const;
+
         void Add(unsigned int component_id, std::shared_ptr<EntityComponent> component);
         std::shared_ptr<EntityComponent> Get(const std::string & component_name);
+        /** Get a component by the hashed variable name it is stored under, nullptr if the entity has none */
+        std::shared_ptr<EntityComponent> GetByID(unsigned int component_id) const;
         //void Remove(unsigned int component_id);
+        /** Get the first component of the given type, nullptr if the entity has none */
+        std::shared_ptr<EntityComponent> GetOfType(unsigned int type_id) const;
+
+        /**
+         * Resolve a named component to a typed handle, the handle is empty if the component
+         * does not exist or is not of type T.  Resolve once, then keep the handle around.
+         */
+        template <class T>
+        ComponentHandle<T> GetComponent(const std::string & component_name)
+        {
+            auto component = this->Get(component_name);
+            if (component != nullptr && component->GetID() == GetComponentTypeID<T>())
+            {
+                return ComponentHandle<T>(component, static_cast<T *>(component.get()));
+            }
+            return ComponentHandle<T>();
+        }
+        /** Resolve the first component of type T to a typed handle, empty if the entity has none */
+        template <class T>
+        ComponentHandle<T> GetComponent() const
+        {
+            auto component = this->GetOfType(GetComponentTypeID<T>());
+            if (component != nullptr)
+            {
+                return ComponentHandle<T>(component, static_cast<T *>(component.get()));
+            }
+            return ComponentHandle<T>();
+        }
 
         /** Retrieve the map container of all components belonging to this entity instance. */
         const std::map<unsigned int, std::shared_ptr<EntityComponent> > GetComponents() const;
 
     private:
-        unsigned long m_entityId;
+        EntityHandle m_handle;
+        EntityTagMask m_tags;
 
         /** The script instance that this entity is based on. */
         std::shared_ptr<EntityScript> m_script;
@@ -55,6 +117,15 @@ namespace alpha
         std::map<unsigned int, std::shared_ptr<EntityComponent> > m_allComponents;
         /** Root map container only contains root level components, so it can be treated more like a tree */
         std::map<unsigned int, std::shared_ptr<EntityComponent> > m_rootComponents;
+        /** The first component of each type, keyed by type id, so typed lookups need no casts */
+        std::map<unsigned int, std::shared_ptr<EntityComponent> > m_typeComponents;
+
+        /** Set while the entity is waiting to be updated */
+        std::atomic<bool> m_awake;
+        /** Set if any component needs to be ticked every frame */
+        bool m_requiresUpdate;
+        /** Called when the entity goes from sleeping to awake */
+        std::function<void(Entity *)> m_wakeListener;
     };
 }
 
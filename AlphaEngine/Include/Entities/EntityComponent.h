@@ -17,10 +17,15 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <atomic>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 
+#include "Entities/ComponentSchema.h"
+#include "Entities/EntityHandle.h"
+#include "Graphics/LightType.h"
 #include "Math/Matrix.h"
 #include "Math/Vector3.h"
 #include "Math/Vector4.h"
@@ -28,10 +33,67 @@ limitations under the License.
 
 namespace alpha
 {
+    class BinaryReader;
+    class BinaryWriter;
+    class Entity;
     class LuaVar;
-    class LuaTable;
     class Material;
 
+    /** Flags describing which fields of a component have changed */
+    enum ComponentChange
+    {
+        CC_NONE = 0,
+        /** Position, rotation, or scale */
+        CC_TRANSFORM = 1 << 0,
+        /** The material path */
+        CC_MATERIAL = 1 << 1,
+        /** Light color, intensity, distance, or direction */
+        CC_LIGHT = 1 << 2,
+        /** A skinned mesh started playing a clip */
+        CC_CLIP = 1 << 3,
+        /** A skinned mesh changed its playback speed */
+        CC_CLIP_SPEED = 1 << 4,
+        /** Every field, raised when a recycled component is reset */
+        CC_ALL = CC_TRANSFORM | CC_MATERIAL | CC_LIGHT | CC_CLIP | CC_CLIP_SPEED,
+    };
+
+    /**
+     * The new values of a components changed fields, captured on the logic side when the changes are journaled,
+     * so listeners on other threads never read the live component.  Only the fields of changed groups are set.
+     */
+    struct ComponentValues
+    {
+        ComponentValues();
+
+        /** CC_MATERIAL */
+        std::string materialPath;
+        /** CC_LIGHT */
+        LightType lightType;
+        Vector4 lightColor;
+        float lightDistance;
+        float lightIntensity;
+        float lightAmbientIntensity;
+        Vector3 lightDirection;
+        /** CC_CLIP */
+        std::string clip;
+        float clipBlendTime;
+        bool clipLoop;
+        /** CC_CLIP_SPEED */
+        float clipSpeed;
+    };
+
+    /** A single entry in the change journal, the fields of one component that changed during an update */
+    struct ComponentDelta
+    {
+        EntityHandle entity;
+        /** The hashed variable name the component is stored under on its entity */
+        unsigned int componentId;
+        /** ComponentChange flags */
+        unsigned int changes;
+        /** Values of every change but the transform, which is read under its own lock, null for transform only changes */
+        std::shared_ptr<const ComponentValues> pValues;
+    };
+
     /**
      * \brief Abstract base class for all entity components. 
      *
@@ -42,6 +104,12 @@ namespace alpha
     {
     public:
         EntityComponent();
+        /**
+         * Copying a component copies its data, but not its place in a hierarchy.
+         * The copy starts without an owner, a parent, or any child components.
+         */
+        EntityComponent(const EntityComponent & component);
+        EntityComponent & operator=(const EntityComponent & component);
         virtual ~EntityComponent();
 
         /** set the parent component */
@@ -49,10 +117,31 @@ namespace alpha
         /** Get the parent component for this component */
         std::weak_ptr<EntityComponent> GetParent() const;
 
+        /** Set the entity that owns this component, called when the component is added to an entity */
+        void SetOwner(Entity * pOwner);
+        /** Get the entity that owns this component, null if it has not been added to one */
+        Entity * GetOwner() const;
+
         /** Initialize the component from a script variable. */
-        virtual void VInitialize(std::shared_ptr<LuaVar> var) = 0;
+        virtual void VInitialize(const LuaVar & var) = 0;
+        /** Write the components data out for a world snapshot. */
+        virtual void VSerialize(BinaryWriter & writer) const;
+        /** Initialize the component from snapshot data written by VSerialize, returns false if the data is invalid. */
+        virtual bool VDeserialize(BinaryReader & reader);
         /** Tick the component. */
         bool Update(float fCurrentTime, float fElapsedTime);
+        /** Get the ComponentChange flags raised since the last call, and clear them */
+        unsigned int TakeChanges();
+        /** Flag every field as changed, after a recycled component has been reset to its prototype */
+        void MarkReset();
+        /** Copy the current values of the changed fields, called from the logic side as the changes are taken */
+        virtual void VCaptureChanges(unsigned int changes, ComponentValues & values) const;
+        /**
+         * Does this component need to be ticked every frame?
+         * Components that only change when something is set on them should return false,
+         * and wake their owning entity instead, so idle entities can sleep.
+         */
+        virtual bool VRequiresUpdate() const;
 
         /** Add a child component to this component */
         void Attach(unsigned int component_id, std::shared_ptr<EntityComponent> component);
@@ -71,6 +160,14 @@ namespace alpha
         /** Tick the component. */
         virtual bool VUpdate(float fCurrentTime, float fElapsedTime) = 0;
 
+        /** Wake the owning entity, so it is updated on the next logic tick. */
+        void Wake();
+        /** Record that fields have changed, flags the component dirty and wakes the owning entity. */
+        void MarkChanged(unsigned int changes);
+
+        /** The entity this component belongs to, not owned */
+        Entity * m_pOwner;
+
         /** Reference to this components parent, null if is top-level component */
         std::weak_ptr<EntityComponent> m_parent;
 
@@ -79,8 +176,21 @@ namespace alpha
 
         /** Has updated flag */
         bool m_dirty;
+        /** ComponentChange flags raised since the last update, may be set from any thread */
+        std::atomic<unsigned int> m_changes;
     };
 
+    /**
+     * Get the type id for a component class, the same value GetID returns for instances of that class.
+     * The name is only hashed the first time, T must declare its type name as sk_name.
+     */
+    template <class T>
+    unsigned int GetComponentTypeID()
+    {
+        static const unsigned int type_id = EntityComponent::GetIDFromName(T::sk_name);
+        return type_id;
+    }
+
     /**
      * \brief A component base class used to represent a geometrical object in the scene.
      *
@@ -91,31 +201,74 @@ namespace alpha
     class SceneComponent : public EntityComponent
     {
     public:
+        /** Script fields shared by every scene component, derived components extend it with their own */
+        struct Descriptor
+        {
+            Descriptor();
+
+            /** Set when the script has a transform table */
+            bool hasTransform;
+            Vector3 position;
+            Vector3 scale;
+            std::string material;
+        };
+
+        /** Register the scene fields of a descriptor derived from SceneComponent::Descriptor, under an optional path prefix */
+        template <class DerivedDescriptor>
+        static void AddSchemaFields(ComponentSchema<DerivedDescriptor> & schema, const std::string & prefix = std::string())
+        {
+            const Descriptor & layout = schema.Layout();
+            // TODO - read rotation value and convert to quaternion
+            schema.AddTableFlag(prefix + "transform", layout.hasTransform);
+            schema.AddVector3(prefix + "transform.position", layout.position);
+            schema.AddVector3(prefix + "transform.scale", layout.scale);
+            schema.AddString(prefix + "material", layout.material);
+        }
+
+        SceneComponent();
+        SceneComponent(const SceneComponent & component);
+        /** Assigning counts as a change to the transform, so caches keyed on the transform version rebuild */
+        SceneComponent & operator=(const SceneComponent & component);
         virtual ~SceneComponent();
 
         /** Base SceneComponent handles initialization of transform data */
-        virtual void VInitialize(std::shared_ptr<LuaVar> var);
+        virtual void VInitialize(const LuaVar & var);
+        /** Base SceneComponent handles serialization of transform and material data */
+        virtual void VSerialize(BinaryWriter & writer) const;
+        virtual bool VDeserialize(BinaryReader & reader);
+        /** Base SceneComponent captures the material path */
+        virtual void VCaptureChanges(unsigned int changes, ComponentValues & values) const;
 
         bool IsDirty() const;
 
-        const Vector3 & GetPosition() const;
-        const Vector3 & GetScale() const;
-        const Quaternion & GetRotation() const;
-        Matrix GetTransform() const;
+        Vector3 GetPosition() const;
+        Vector3 GetScale() const;
+        Quaternion GetRotation() const;
+        /**
+         * Get the local transform, it is only rebuilt from position, rotation, and scale when one of them has changed.
+         * If pVersion is given it receives the transform version the matrix was built from.
+         */
+        Matrix GetTransform(unsigned int * pVersion = nullptr) const;
+        /** Incremented every time the local transform changes, lets caches tell if they are stale */
+        unsigned int GetTransformVersion() const;
         std::string GetMaterialPath() const;
 
         void SetPosition(const Vector3 & position);
         void SetScale(const Vector3 & scale);
         void SetRotation(const Quaternion & rotation);
+        void SetMaterialPath(const std::string & material);
 
     protected:
-        /** Helper function for retrieving x, y, or z vars from script tables */
-        void GetTableVarValue(std::shared_ptr<LuaTable> table, const std::string axis, float * const out);
+        /** Take the scene fields parsed from a script */
+        void ApplyDescriptor(const Descriptor & descriptor);
 
-        /** Update the transform matrix */
+        /** Flag the transform matrix as out of date, it is rebuilt the next time it is requested */
         void UpdateTransform();
 
     private:
+        /** Mark the cached matrix stale and bump the version, the caller must hold m_transformMutex */
+        void InvalidateTransform();
+
         /** This components relative position in relation to its parent. */
         Vector3 m_vPosition;
         /** This components relative scale in relation to its parent. */
@@ -123,8 +276,17 @@ namespace alpha
         /** This components relative rotation in relation to its parent. */
         Quaternion m_qRotation;
 
-        /** This components combined rotation, scale, and position. */
-        Matrix m_mTransform;
+        /** This components combined rotation, scale, and position, built lazily. */
+        mutable Matrix m_mTransform;
+        /** Set when position, rotation, or scale have changed since the transform was last built */
+        mutable bool m_transformDirty;
+        /** Number of times the transform has changed, readable without the lock to test for staleness */
+        std::atomic<unsigned int> m_transformVersion;
+        /**
+         * Guards position, scale, rotation, and the cached matrix.  Update tasks and animation batches
+         * write the transform from worker threads while the scene reads it, so every access goes through it.
+         */
+        mutable std::mutex m_transformMutex;
 
         /** The file name for an object material, every visible object has a material that describes its look and feel */
         std::string m_sMaterial;
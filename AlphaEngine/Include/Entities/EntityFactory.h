@@ -20,11 +20,15 @@ limitations under the License.
 #include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 namespace alpha
 {
     class Entity;
     class EntityComponent;
+    class EntityScript;
     class Asset;
     class LuaVar;
 
@@ -37,6 +41,30 @@ namespace alpha
 
         /** Creates an entity using the components outlined in the given script asset */
         std::shared_ptr<Entity> CreateEntity(std::shared_ptr<Asset> asset);
+        /**
+         * Creates count entities using the components outlined in the given script asset.
+         * Every entity is copied from the cached prototype for that script.
+         * Safe to call from a worker thread, as long as the asset has already been looked up.  Two threads
+         * may build the same prototype at once, the asset guards its data and only one prototype is kept.
+         */
+        std::vector<std::shared_ptr<Entity> > CreateEntities(std::shared_ptr<Asset> asset, unsigned int count);
+        /**
+         * Reset an entity created from the given script asset back to the scripts prototype, reusing its components.
+         * Every component is flagged as fully changed, and the entities tags are reset to the scripts tags.
+         * Returns false if the entity no longer matches the prototype, and has to be created from scratch instead.
+         */
+        bool ResetEntity(std::shared_ptr<Asset> asset, Entity & entity);
+
+        /** Create an uninitialized component of a registered type, nullptr if the type is not registered. */
+        std::shared_ptr<EntityComponent> CreateComponentOfType(unsigned int typeId);
+        /**
+         * Get the script for a cached prototype, nullptr if the script has not been used yet.
+         * Along with CreateComponentOfType, this is safe to call from a worker thread.
+         */
+        std::shared_ptr<EntityScript> GetCachedScript(const std::string & path) const;
+
+        /** Drop all cached prototypes, scripts will be run again the next time they are used. */
+        void ClearPrototypes();
 
         /** Register a component, and allow the factory to generate them when creating an entity. */
         template <class SubClass>
@@ -47,18 +75,71 @@ namespace alpha
             {
                 // hurray for lambdas!
                 m_componentCreationFunctions[componentId] = [] () { return new SubClass; };
+                m_componentCopyFunctions[componentId] = [] (const EntityComponent & component)
+                {
+                    return new SubClass(static_cast<const SubClass &>(component));
+                };
+                m_componentAssignFunctions[componentId] = [] (EntityComponent & target, const EntityComponent & component)
+                {
+                    static_cast<SubClass &>(target) = static_cast<const SubClass &>(component);
+                };
                 return true;
             }
             return false;
         }
 
     private:
+        typedef std::function<EntityComponent *(const EntityComponent &)> CopyFunction;
+        typedef std::function<void(EntityComponent &, const EntityComponent &)> AssignFunction;
+
+        /**
+         * A single component in a flattened prototype.  Records are stored parents first,
+         * so every record can be copied and attached in one linear pass.
+         */
+        struct PrototypeRecord
+        {
+            /** The hashed variable name the component is stored under */
+            unsigned int component_id;
+            /** Index of the parent record, or -1 for root level components */
+            int parent;
+            /** The fully initialized component to copy */
+            std::shared_ptr<EntityComponent> component;
+            /** Copy function registered for the components type */
+            CopyFunction copy;
+            /** Assign function registered for the components type, used to reset recycled components */
+            AssignFunction assign;
+        };
+
+        /**
+         * A parsed entity script.  Built once per script asset, then treated as immutable
+         * and copied for every entity created from that script.
+         */
+        struct Prototype
+        {
+            /** The script the prototype was built from, shared by every entity created from it */
+            std::shared_ptr<EntityScript> script;
+            /** Flattened, fully initialized components */
+            std::vector<PrototypeRecord> records;
+        };
+
+        /**
+         * Get the prototype for the given script asset, building and caching it on first use.
+         * Safe to call from worker threads, the same script may be run by two threads at once but only one prototype is kept.
+         */
+        std::shared_ptr<const Prototype> GetPrototype(std::shared_ptr<Asset> asset);
+
         /** Creates a component using a registered creation function, if it exists. */
-        void CreateComponent(std::shared_ptr<Entity> entity, std::shared_ptr<EntityComponent> parent_component, const std::string & var_name, std::shared_ptr<LuaVar> var_value);
+        void CreateComponent(std::shared_ptr<Entity> entity, std::shared_ptr<EntityComponent> parent_component, const std::string & var_name, const LuaVar & var_value);
+        /** Flatten a tree of initialized components into a list of prototype records. */
+        void FlattenPrototype(const std::map<unsigned int, std::shared_ptr<EntityComponent> > & components, int parent, std::vector<PrototypeRecord> & records);
 
         std::map<unsigned int, std::function<EntityComponent *()> > m_componentCreationFunctions;
-
-        unsigned int m_lastEntityId = 0;
+        std::map<unsigned int, CopyFunction> m_componentCopyFunctions;
+        std::map<unsigned int, AssignFunction> m_componentAssignFunctions;
+        /** Prototypes keyed by the path of the script asset they were built from */
+        std::map<std::string, std::shared_ptr<const Prototype> > m_prototypes;
+        /** Guards the prototype cache, world cells look up scripts while they load on worker threads */
+        mutable std::mutex m_prototypeMutex;
     };
 }
 
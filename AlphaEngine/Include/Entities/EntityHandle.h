@@ -0,0 +1,51 @@
+#ifndef ALPHA_ENTITY_HANDLE_H
+#define ALPHA_ENTITY_HANDLE_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cstdint>
+
+namespace alpha
+{
+    /**
+     * \brief A weak reference to an entity owned by the LogicSystem.
+     *
+     * The index refers to a slot in the logic system's entity storage, and the generation
+     * identifies which entity occupied that slot, so a handle to a destroyed entity is
+     * never mistaken for whatever entity reuses the slot.
+     */
+    struct EntityHandle
+    {
+        EntityHandle() : index(0), generation(0) { }
+        EntityHandle(uint32_t i, uint32_t g) : index(i), generation(g) { }
+
+        /** A generation of 0 is never handed out, so a default handle never refers to an entity */
+        bool IsValid() const { return generation != 0; }
+
+        bool operator==(const EntityHandle & right) const { return index == right.index && generation == right.generation; }
+        bool operator!=(const EntityHandle & right) const { return !(*this == right); }
+        bool operator<(const EntityHandle & right) const
+        {
+            return index < right.index || (index == right.index && generation < right.generation);
+        }
+
+        uint32_t index;
+        uint32_t generation;
+    };
+}
+
+#endif // ALPHA_ENTITY_HANDLE_H
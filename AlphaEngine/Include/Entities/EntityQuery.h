@@ -0,0 +1,87 @@
+#ifndef ALPHA_ENTITY_QUERY_H
+#define ALPHA_ENTITY_QUERY_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "Entities/EntityComponent.h"
+#include "Entities/EntityHandle.h"
+
+namespace alpha
+{
+    class Entity;
+
+    /**
+     * \brief A cached view of every entity that has all of a set of component types.
+     *
+     * Queries are created through the logic system, which keeps them up to date as entities are
+     * created and destroyed, so iterating one costs no more than walking an array.  The matching
+     * components are stored alongside each entity, and are fetched by type without hashing or casts.
+     * Only the first component of each type on an entity is part of the view.
+     */
+    class EntityQuery
+    {
+    public:
+        /** type_ids are the component type ids an entity must have to be in the view */
+        explicit EntityQuery(std::vector<unsigned int> type_ids);
+
+        /** The sorted type ids that make up this query */
+        const std::vector<unsigned int> & GetTypeIDs() const;
+
+        /** Add the entity to the view if it has every component type in the query */
+        bool TryAdd(const std::shared_ptr<Entity> & entity);
+        /** Remove the entity from the view, the order of the remaining entities may change */
+        void Remove(const EntityHandle & handle);
+        void Clear();
+
+        size_t Size() const;
+        bool Empty() const;
+        Entity * GetEntity(size_t index) const;
+        const std::vector<std::shared_ptr<Entity> > & GetEntities() const;
+        /** One row of components per entity, in the same column order as GetTypeIDs */
+        const std::vector<EntityComponent *> & GetComponentRows() const;
+
+        /** Get the component of type T for the entity at index, nullptr if T is not part of the query */
+        template <class T>
+        T * Get(size_t index) const
+        {
+            const unsigned int type_id = GetComponentTypeID<T>();
+            const size_t columns = m_typeIds.size();
+            for (size_t c = 0; c < columns; ++c)
+            {
+                if (m_typeIds[c] == type_id)
+                {
+                    return static_cast<T *>(m_components[index * columns + c]);
+                }
+            }
+            return nullptr;
+        }
+
+    private:
+        std::vector<unsigned int> m_typeIds;
+        std::vector<std::shared_ptr<Entity> > m_entities;
+        /** One row of components per entity, one column per type id */
+        std::vector<EntityComponent *> m_components;
+        /** Position of each entity in the view, for removal */
+        std::map<EntityHandle, size_t> m_indices;
+    };
+}
+
+#endif // ALPHA_ENTITY_QUERY_H
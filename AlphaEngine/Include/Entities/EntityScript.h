@@ -17,15 +17,17 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
-#include <map>
 #include <memory>
+#include <string>
 
+#include "Entities/EntityTags.h"
 #include "Scripting/LuaScript.h"
 
 namespace alpha
 {
     class EntityComponent;
-    class LuaTable;
+    class LuaArena;
+    class LuaVar;
 
     class EntityScript : public LuaScript
     {
@@ -34,10 +36,17 @@ namespace alpha
         virtual ~EntityScript();
 
         bool HasComponent(const std::string & name);
-        const std::map<std::string, std::shared_ptr<LuaVar> > & GetComponentVars();
+        /** Path of the script asset this script was loaded from */
+        const std::string & GetPath() const;
+        /** The scripts components table, nil if the script has none.  Valid for as long as the script. */
+        LuaVar GetComponentVars() const;
+        /** Tags listed in the scripts optional 'tags' table */
+        EntityTagMask GetTags() const;
 
     private:
-        std::shared_ptr<LuaTable> m_components;
+        std::shared_ptr<const LuaArena> m_components;
+        std::string m_sPath;
+        EntityTagMask m_tags;
     };
 }
 
@@ -0,0 +1,76 @@
+#ifndef ALPHA_ENTITY_TAGS_H
+#define ALPHA_ENTITY_TAGS_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace alpha
+{
+    class LuaVar;
+
+    /**
+     * A set of layers and tags, one bit each.  Filtering is a single bitwise test against an entities mask,
+     * so systems can skip whole categories of entities without looking at their components.
+     */
+    typedef uint64_t EntityTagMask;
+
+    /** Built in tags, custom tags are handed out from ET_FIRST_CUSTOM upwards */
+    const EntityTagMask ET_NONE = 0;
+    /** Neither updated nor rendered */
+    const EntityTagMask ET_DISABLED = 1ull << 0;
+    /** Updated, but not rendered */
+    const EntityTagMask ET_HIDDEN = 1ull << 1;
+    /** Only exists for tools, never rendered in game */
+    const EntityTagMask ET_EDITOR_ONLY = 1ull << 2;
+    /** Only meaningful to an authoritative server, never rendered */
+    const EntityTagMask ET_SERVER_ONLY = 1ull << 3;
+    /**
+     * Parked in an entity pool, waiting to be handed out again, never updated, rendered, or queried.
+     * Only the logic system sets it, it is masked out of tags from scripts, snapshots, and game code.
+     */
+    const EntityTagMask ET_POOLED = 1ull << 4;
+
+    /**
+     * \brief Maps tag names used in entity scripts to tag bits.
+     *
+     * Scripts list tags in a global 'tags' table, either as an array of names, tags = { "hidden", "pickup" },
+     * or as named flags, tags = { hidden = true }.  Unknown names are given the next free bit.
+     */
+    class EntityTags
+    {
+    public:
+        /** Get the bit for a tag name, registering it if needed.  Returns ET_NONE once all 64 bits are in use. */
+        static EntityTagMask GetTag(const std::string & name);
+        /** Build a mask from a script tags table */
+        static EntityTagMask ParseTags(const LuaVar & table);
+
+    private:
+        static std::map<std::string, EntityTagMask> & GetRegistry();
+
+        static std::mutex s_mutex;
+        static unsigned int s_nextBit;
+        /** Bits below this are reserved for built in tags */
+        static const unsigned int sk_firstCustomBit;
+    };
+}
+
+#endif // ALPHA_ENTITY_TAGS_H
@@ -30,7 +30,10 @@ namespace alpha
 
         virtual ~LightComponent();
 
-        virtual void VInitialize(std::shared_ptr<LuaVar> var);
+        virtual void VInitialize(const LuaVar & var);
+        virtual void VSerialize(BinaryWriter & writer) const;
+        virtual bool VDeserialize(BinaryReader & reader);
+        virtual void VCaptureChanges(unsigned int changes, ComponentValues & values) const;
         virtual bool VUpdate(float fCurrentTime, float fElapsedTime);
         virtual std::string VGetName() const;
 
@@ -41,6 +44,13 @@ namespace alpha
         float GetAmbientIntensity() const;
         Vector3 GetLightDirection() const;
 
+        /** Changing a light parameter journals a CC_LIGHT change, so the renderer can refresh the light */
+        void SetLightColor(const Vector4 & color);
+        void SetLightDistance(float distance);
+        void SetIntensity(float intensity);
+        void SetAmbientIntensity(float intensity);
+        void SetLightDirection(const Vector3 & direction);
+
     private:
         LightType m_eLightType;
         Vector4 m_vLightColor;
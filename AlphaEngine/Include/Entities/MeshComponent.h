@@ -26,14 +26,35 @@ namespace alpha
     public:
         static const std::string sk_name;
 
+        /** Script fields of a mesh, shared with the meshes derived from it */
+        struct Descriptor : SceneComponent::Descriptor
+        {
+            std::string model;
+        };
+
+        /** Register the mesh fields of a descriptor derived from MeshComponent::Descriptor */
+        template <class DerivedDescriptor>
+        static void AddSchemaFields(ComponentSchema<DerivedDescriptor> & schema)
+        {
+            const Descriptor & layout = schema.Layout();
+            SceneComponent::AddSchemaFields(schema);
+            schema.AddString("model", layout.model);
+        }
+
         virtual ~MeshComponent();
 
-        virtual void VInitialize(std::shared_ptr<LuaVar> var);
+        virtual void VInitialize(const LuaVar & var);
+        virtual void VSerialize(BinaryWriter & writer) const;
+        virtual bool VDeserialize(BinaryReader & reader);
         virtual bool VUpdate(float fCurrentTime, float fElapsedTime);
         virtual std::string VGetName() const;
 
         std::string GetMeshPath() const;
 
+    protected:
+        /** Take the mesh fields parsed from a script, and the scene fields they extend */
+        void ApplyDescriptor(const Descriptor & descriptor);
+
     private:
         std::string m_sModelPath;
     };
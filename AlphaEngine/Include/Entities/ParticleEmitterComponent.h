@@ -0,0 +1,82 @@
+#ifndef ALPHA_PARTICLE_EMITTER_COMPONENT_H
+#define ALPHA_PARTICLE_EMITTER_COMPONENT_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "Entities/EntityComponent.h"
+#include "Math/Vector3.h"
+
+namespace alpha
+{
+    /** Describes how an emitter spawns and moves its particles */
+    struct ParticleSettings
+    {
+        ParticleSettings();
+
+        /** Most particles alive at once */
+        unsigned int maxParticles;
+        /** Particles spawned per second */
+        float rate;
+        /** Seconds each particle lives, picked at random between min and max */
+        float minLifetime;
+        float maxLifetime;
+        /** Initial speed, picked at random between min and max */
+        float minSpeed;
+        float maxSpeed;
+        /** Half angle, in radians, of the cone particles are launched in */
+        float spread;
+        /** Launch direction, relative to the emitter */
+        Vector3 direction;
+        /** Constant acceleration, in world space */
+        Vector3 gravity;
+        /** Width of a particle when it spawns, particles shrink away as they age */
+        float size;
+    };
+
+    /**
+     * The ParticleEmitterComponent spawns a stream of particles from the components position.
+     * Particles are purely visual, they are simulated and drawn by the graphics system, never by the logic system.
+     *
+     * Script data:
+     *   max_particles, rate, spread, size
+     *   lifetime = { min, max }
+     *   speed = { min, max }
+     *   direction = { x, y, z }
+     *   gravity = { x, y, z }
+     */
+    class ParticleEmitterComponent : public SceneComponent
+    {
+    public:
+        static const std::string sk_name;
+
+        ParticleEmitterComponent();
+        virtual ~ParticleEmitterComponent();
+
+        virtual void VInitialize(const LuaVar & var);
+        virtual void VSerialize(BinaryWriter & writer) const;
+        virtual bool VDeserialize(BinaryReader & reader);
+        virtual bool VUpdate(float fCurrentTime, float fElapsedTime);
+        virtual std::string VGetName() const;
+
+        const ParticleSettings & GetSettings() const;
+
+    private:
+        ParticleSettings m_settings;
+    };
+}
+
+#endif // ALPHA_PARTICLE_EMITTER_COMPONENT_H
@@ -28,7 +28,7 @@ namespace alpha
 
         virtual ~PrimitiveComponent();
 
-        virtual void VInitialize(std::shared_ptr<LuaVar> var);
+        virtual void VInitialize(const LuaVar & var);
         virtual bool VUpdate(float fCurrentTime, float fElapsedTime);
         virtual std::string VGetName() const;
 
@@ -0,0 +1,69 @@
+#ifndef ALPHA_SKINNED_MESH_COMPONENT_H
+#define ALPHA_SKINNED_MESH_COMPONENT_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <map>
+#include <string>
+
+#include "Entities/MeshComponent.h"
+
+namespace alpha
+{
+    /**
+     * \brief A mesh that is skinned to a skeleton, and plays animation clips.
+     *
+     * Clips are named in the entity script, and only started from game logic.  Poses are evaluated by the
+     * graphics system, so the component only records which clip should be playing and how.
+     */
+    class SkinnedMeshComponent : public MeshComponent
+    {
+    public:
+        static const std::string sk_name;
+
+        SkinnedMeshComponent();
+        virtual ~SkinnedMeshComponent();
+
+        virtual void VInitialize(const LuaVar & var);
+        virtual void VSerialize(BinaryWriter & writer) const;
+        virtual bool VDeserialize(BinaryReader & reader);
+        virtual void VCaptureChanges(unsigned int changes, ComponentValues & values) const;
+        virtual std::string VGetName() const;
+
+        /** Fade into a named clip over blendTime seconds, restarting it if it is already playing */
+        void PlayClip(const std::string & name, float blendTime, bool loop);
+        /** Scale the rate clips play at */
+        void SetClipSpeed(float speed);
+
+        /** Clip asset paths, keyed by the name they are played with */
+        const std::map<std::string, std::string> & GetClipPaths() const;
+        /** The clip last asked to play, empty to hold the bind pose */
+        const std::string & GetClip() const;
+        float GetBlendTime() const;
+        bool GetLoop() const;
+        float GetClipSpeed() const;
+
+    private:
+        std::map<std::string, std::string> m_clipPaths;
+        std::string m_sClip;
+        float m_fBlendTime;
+        bool m_loop;
+        float m_fSpeed;
+    };
+}
+
+#endif // ALPHA_SKINNED_MESH_COMPONENT_H
@@ -18,18 +18,31 @@ limitations under the License.
 */
 
 #include <functional>
+#include <future>
 #include <string>
+#include <vector>
 
 #include "FSA/State.h"
+#include "Animation/Animator.h"
+#include "Entities/EntityHandle.h"
+#include "Entities/EntityTags.h"
 
 namespace alpha
 {
     class AlphaController;
     class LogicSystem;
     class Entity;
+    class EntityQuery;
+    class AGameSystem;
+    struct AABB;
     class CameraComponent;
+    struct ContactPair;
     class Sound;
     class HIDContext;
+    struct Ray;
+    struct RaycastHit;
+    struct Sphere;
+    struct Vector3;
 
     /**
      * class GameState
@@ -51,9 +64,60 @@ namespace alpha
         // directely exposed to any derived class.
 
         /** Provide pass through access to entity life-cycle methods. */
-        std::shared_ptr<Entity> GetEntity(const unsigned long entityId);
+        Entity * GetEntity(const EntityHandle & handle);
         std::shared_ptr<Entity> CreateEntity(const char * resource);
-        void DestroyEntity(const unsigned long entityId);
+        std::vector<std::shared_ptr<Entity> > CreateEntities(const char * resource, unsigned int count);
+        /** Build entities on a worker thread, they are added to the world at the start of a later logic update */
+        std::shared_future<std::shared_ptr<Entity> > CreateEntityAsync(const char * resource);
+        std::shared_future<std::vector<std::shared_ptr<Entity> > > CreateEntitiesAsync(const char * resource, unsigned int count);
+        void DestroyEntity(const EntityHandle & handle);
+        /** Recycle destroyed entities of a script, rather than tearing them down and building new ones */
+        void SetPoolCapacity(const char * resource, unsigned int capacity);
+        void PrewarmPool(const char * resource, unsigned int count);
+        void WakeEntity(const EntityHandle & handle);
+        void ScheduleWake(const EntityHandle & handle, double delay);
+        void SetUpdateBatchSize(unsigned int batchSize);
+        void SetEntityTags(const EntityHandle & handle, EntityTagMask tags);
+        void SetUpdateFilter(EntityTagMask exclude);
+        /** Choose which tags keep entities out of the rendered scene, and out of scene lighting */
+        void SetRenderFilter(EntityTagMask renderExclude, EntityTagMask lightExclude);
+        std::shared_ptr<const EntityQuery> Query(const std::vector<std::string> & typeNames);
+        /** Typed query, for example Query<MeshComponent, LightComponent>() */
+        template <class... Components>
+        std::shared_ptr<const EntityQuery> Query()
+        {
+            return this->Query(std::vector<std::string>{ Components::sk_name... });
+        }
+        bool SaveSnapshot(const char * path);
+        std::vector<std::shared_ptr<Entity> > LoadSnapshot(const char * resource);
+
+        /** World streaming pass through methods */
+        void AddWorldCell(int x, int z, const char * resource);
+        void SetWorldCellSize(float cellSize);
+        void SetWorldLoadRadius(unsigned int loadRadius);
+        void SetStreamingBudgets(unsigned int commitBudget, unsigned int unloadBudget);
+        void SetStreamingFocus(const Vector3 & focus);
+
+        /** Bind function delegates to batches of collision contacts that begin and end */
+        void BindContactsBegan(std::function<void(const std::vector<ContactPair> &)> delegate);
+        void BindContactsEnded(std::function<void(const std::vector<ContactPair> &)> delegate);
+
+        /** Animation pass through methods */
+        AnimationHandle PlayAnimation(const ComponentHandle<SceneComponent> & target, std::shared_ptr<const AnimationTrack> track,
+                                      AnimationLoop loop = AL_ONCE, float speed = 1.f);
+        void StopAnimation(const AnimationHandle & handle);
+        void SetAnimationSpeed(const AnimationHandle & handle, float speed);
+        bool IsAnimationPlaying(const AnimationHandle & handle) const;
+        unsigned int GetAnimationLoops(const AnimationHandle & handle) const;
+
+        /** Game system pass through methods */
+        void AddGameSystem(std::shared_ptr<AGameSystem> system);
+        bool RemoveGameSystem(const std::shared_ptr<AGameSystem> & system);
+
+        /** Spatial query pass through methods, RaycastHit is declared in Graphics/SceneManager.h */
+        void QueryBoxes(const std::vector<AABB> & boxes, std::vector<std::vector<EntityHandle> > & results, EntityTagMask exclude = ET_NONE);
+        void QuerySpheres(const std::vector<Sphere> & spheres, std::vector<std::vector<EntityHandle> > & results, EntityTagMask exclude = ET_NONE);
+        void Raycast(const std::vector<Ray> & rays, std::vector<std::vector<RaycastHit> > & results, EntityTagMask exclude = ET_NONE);
 
         /** Audio system pass through methods */
         std::weak_ptr<Sound> CreateSound(const char * resource);
@@ -18,8 +18,11 @@ limitations under the License.
 */
 
 #include <memory>
+#include <vector>
 
 #include "AlphaSystem.h"
+#include "Entities/EntityHandle.h"
+#include "Entities/EntityTags.h"
 
 namespace alpha
 {
@@ -30,6 +33,11 @@ namespace alpha
     class AssetSystem;
     class Asset;
     class AEvent;
+    struct AABB;
+    struct Ray;
+    struct RaycastHit;
+    struct Sphere;
+    class TaskGroup;
 
     class GraphicsSystem : public AlphaSystem
     {
@@ -44,13 +52,26 @@ namespace alpha
 
         void SetAssetSystem(AssetSystem * const pAssets);
 
+        /** Spatial queries over the scene, see SceneManager for details.  Only call from the main thread. */
+        void QueryBoxes(const std::vector<AABB> & boxes, std::vector<std::vector<EntityHandle> > & results, EntityTagMask exclude = ET_NONE);
+        void QuerySpheres(const std::vector<Sphere> & spheres, std::vector<std::vector<EntityHandle> > & results, EntityTagMask exclude = ET_NONE);
+        void Raycast(const std::vector<Ray> & rays, std::vector<std::vector<RaycastHit> > & results, EntityTagMask exclude = ET_NONE);
+
     private:
         virtual bool VUpdate(double currentTime, double elapsedTime);
+        /** Wait for the scene tasks published by the last render, before the scene is changed or drawn again */
+        virtual void VFinishTasks();
+
+        /** Publish the tasks that step the scene by the time passed since it was last stepped */
+        void SimulateScene();
 
         /** Handle entity created event. */
         void HandleEntityCreatedEvent(AEvent * pEvent);
-        /** Handle entity updated event. */
-        void HandleEntityUpdatedEvent(AEvent * pEvent);
+        void HandleEntitiesUpdatedEvent(AEvent * pEvent);
+        void HandleEntitiesDestroyedEvent(AEvent * pEvent);
+        void HandleEntityHandleChangedEvent(AEvent * pEvent);
+        void HandleEntityTagsChangedEvent(AEvent * pEvent);
+        void HandleSetRenderFilterEvent(AEvent * pEvent);
         /** Handle set active camera event */
         void HandleSetActiveCameraEvent(AEvent * pEvent);
 
@@ -62,6 +83,10 @@ namespace alpha
         SceneManager * m_pSceneManager;
         /** Track the current camera that is viewing the scene */
         std::shared_ptr<Camera> m_pCamera;
+        /** Scene tasks published by the last render, they run while the next frame is updated */
+        std::shared_ptr<TaskGroup> m_pSceneTasks;
+        /** Time passed in updates since the scene was last stepped */
+        float m_fSimulateTime;
 
         // screen width and height
         float m_fWindowWidth;
@@ -26,6 +26,7 @@ namespace alpha
     class Camera;
     class RenderSet;
     class Light;
+    class ParticleEmitter;
 
     class IRenderer
     {
@@ -38,7 +39,10 @@ namespace alpha
 
         // rendering
         virtual void PreRender(RenderSet * renderSet) = 0;
-        virtual void Render(std::shared_ptr<Camera> pCamera, std::vector<RenderSet *> renderables, std::vector<Light *> lights) = 0;
+        /** Release any renderer resources created for the render set by PreRender */
+        virtual void Release(RenderSet * renderSet) = 0;
+        virtual void Render(std::shared_ptr<Camera> pCamera, std::vector<RenderSet *> renderables, std::vector<Light *> lights,
+                            std::vector<ParticleEmitter *> particles) = 0;
     };
 }
 
@@ -19,17 +19,13 @@ limitations under the License.
 
 #include "Math/Matrix.h"
 #include "Math/Vector4.h"
+#include "Graphics/LightType.h"
 #include "Graphics/Material.h"
 
 namespace alpha
 {
     class LightComponent;
-
-    typedef enum LightType
-    {
-        DIRECTIONAL,
-        POINT,
-    } LightType;
+    struct ComponentValues;
 
     /**
      * Lights are Models that are rendered in the scene
@@ -41,6 +37,11 @@ namespace alpha
         explicit Light(std::shared_ptr<LightComponent> light_component);
         virtual ~Light();
 
+        /** Read the light parameters from its component */
+        void Refresh(const LightComponent & light_component);
+        /** Take the light parameters captured with a CC_LIGHT change */
+        void Refresh(const ComponentValues & values);
+
         Vector4 GetAmbientLight() const;
         Vector4 GetDiffuseLight() const;
         Vector4 GetSpecularLight() const;
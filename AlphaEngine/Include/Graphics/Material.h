@@ -65,10 +65,10 @@ namespace alpha
         explicit MaterialScript(std::shared_ptr<Asset> asset);
         virtual ~MaterialScript();
 
-        std::shared_ptr<LuaTable> GetMaterialTable();
+        std::shared_ptr<const LuaArena> GetMaterialTable();
 
     private:
-        std::shared_ptr<LuaTable> m_pMaterialTable;
+        std::shared_ptr<const LuaArena> m_pMaterialTable;
     };
 }
 
@@ -28,15 +28,17 @@ namespace alpha
     class Mesh : public Renderable
     {
     public:
-        Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices);
+        Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices,
+             std::vector<VertexWeights> weights = std::vector<VertexWeights>());
 
         std::vector<Vertex> GetVertices() const;
         std::vector<unsigned int> GetIndices() const;
+        std::vector<VertexWeights> GetWeights() const;
 
-        /** Write mesh data out to stream */
+        /** Write mesh data out to stream, in the latest model file version */
         void Serialize(std::ostream & stream) const;
-        /** Read data from stream, create and return a new Mesh object */
-        static Mesh * Deserialize(std::istream & stream);
+        /** Read data from stream written as the given model file version, create and return a new Mesh object */
+        static Mesh * Deserialize(std::istream & stream, unsigned short version);
     };
 }
 
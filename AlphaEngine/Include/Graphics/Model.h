@@ -24,22 +24,28 @@ limitations under the License.
 namespace alpha
 {
     class Mesh;
+    class Skeleton;
 
     class Model : public RenderSet
     {
     public:
-        explicit Model(std::vector<Renderable *> meshes);
+        /** The model takes ownership of its meshes, and skeleton if it has one */
+        explicit Model(std::vector<Renderable *> meshes, Skeleton * pSkeleton = nullptr);
         virtual ~Model();
 
         std::vector<Renderable *> GetRenderables();
 
-        /** Write model data out to stream */
+        /** The skeleton the models meshes are skinned to, nullptr if it is not skinned */
+        const Skeleton * GetSkeleton() const;
+
+        /** Write model data out to stream, in the latest model file version */
         void Serialize(std::ostream & stream) const;
-        /** Read model data from stream, create a return a new model */
-        static Model * Deserialize(std::istream & stream);
+        /** Read model data written as the given model file version from stream, create a return a new model */
+        static Model * Deserialize(std::istream & stream, unsigned short version);
 
     private:
         std::vector<Renderable *> m_meshes;
+        Skeleton * m_pSkeleton;
     };
 }
 
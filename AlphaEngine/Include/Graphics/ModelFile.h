@@ -30,6 +30,7 @@ namespace alpha
 
 #define MODELFILE_SIG "Alpha-Model" // AM - Alpha Model
 #define MODELFILE_V1 0x01
+#define MODELFILE_V2 0x02 // adds vertex bone weights, and a skeleton
 
     struct ModelFileHeader
     {
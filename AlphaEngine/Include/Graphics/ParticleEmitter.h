@@ -0,0 +1,87 @@
+#ifndef ALPHA_PARTICLE_EMITTER_H
+#define ALPHA_PARTICLE_EMITTER_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "Entities/ParticleEmitterComponent.h"
+#include "Math/Matrix.h"
+
+namespace alpha
+{
+    class Material;
+
+    /**
+     * \brief The simulated particles of a single emitter.
+     *
+     * Particle state is kept as one array per field, padded to a multiple of four, so the integration
+     * step runs four particles per instruction.  Dead particles are swapped out, so live particles are
+     * always packed at the front of each array.  After each step the live particles are written out as
+     * per instance data, a position and size per particle, ready to be drawn in one instanced call.
+     */
+    class ParticleEmitter
+    {
+    public:
+        explicit ParticleEmitter(const ParticleSettings & settings);
+        virtual ~ParticleEmitter();
+
+        /** Set where the emitter is, particles spawn at its position and launch relative to its rotation */
+        void SetWorldTransform(const Matrix & world);
+
+        /** Age, move, retire, and spawn particles, then rebuild the instance data */
+        void Simulate(float fElapsedTime);
+
+        /** Retire every particle at once, so a recycled emitter starts out empty */
+        void Clear();
+
+        /** Number of live particles */
+        size_t GetCount() const;
+        /** Four floats per live particle: x, y, z, and size */
+        const std::vector<float> & GetInstanceData() const;
+
+        /** The material particles are drawn with */
+        std::weak_ptr<Material> material;
+
+    private:
+        /** Move every live particle, four at a time */
+        void Integrate(float fElapsedTime);
+        /** Swap out particles that have outlived their lifetime */
+        void Retire();
+        /** Spawn the particles due this step */
+        void Emit(float fElapsedTime);
+
+        ParticleSettings m_settings;
+        Matrix m_world;
+
+        size_t m_count;
+        /** Fractional particles carried over to the next step */
+        float m_fEmitDebt;
+        std::minstd_rand m_random;
+
+        std::vector<float> m_posX, m_posY, m_posZ;
+        std::vector<float> m_velX, m_velY, m_velZ;
+        std::vector<float> m_age;
+        std::vector<float> m_life;
+
+        std::vector<float> m_instances;
+    };
+}
+
+#endif // ALPHA_PARTICLE_EMITTER_H
@@ -22,6 +22,7 @@ limitations under the License.
 #include <vector>
 
 #include "Graphics/Material.h"
+#include "Math/AABB.h"
 #include "Math/Matrix.h"
 #include "Math/Vector4.h"
 
@@ -46,6 +47,9 @@ namespace alpha
 
         Matrix worldTransform;
 
+        /** Bounds of every renderable in the set, in model space */
+        AABB bounds;
+
         /** This set of renderables emits light */
         bool emitsLight;
 
@@ -54,6 +58,9 @@ namespace alpha
 
         /** The material to apply to this set of renderables */
         std::weak_ptr<Material> material;
+
+        /** Skinning matrix for each bone, from the bind pose to the current pose, empty if the set is not skinned */
+        std::vector<Matrix> bonePalette;
     };
 }
 
@@ -19,8 +19,16 @@ limitations under the License.
 
 #include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
+#include "Entities/EntityHandle.h"
+#include "Entities/EntityTags.h"
+#include "Math/AABB.h"
+#include "Math/Matrix.h"
+#include "Math/Ray.h"
+#include "Toolbox/DynamicAABBTree.h"
+
 namespace alpha
 {
     class AssetSystem;
@@ -28,7 +36,21 @@ namespace alpha
     class EntityComponent;
     class SceneNode;
     class RenderSet;
+    class IRenderer;
     class Light;
+    class ParticleEmitter;
+    class SkeletonAnimator;
+    class AnimationClip;
+    struct ComponentDelta;
+    struct Frustum;
+
+    /** A single entity hit by a ray query */
+    struct RaycastHit
+    {
+        EntityHandle entity;
+        /** Distance along the ray to where it enters the entities bounds */
+        float distance;
+    };
 
     /**
      * \brief The SceneManager manages the logical scene layout.
@@ -42,8 +64,11 @@ namespace alpha
         /** Keeps the Render Data structurs up to date, and preped for rendering if needed */
         bool Update(double currentTime, double elapsedTime);
 
-        /** Before rendering, prepare render and light data. */
-        bool PreRender();
+        /**
+         * Before rendering, prepare render and light data.
+         * Render sets and skinned models outside the view frustum are left out, lights and emitters are always kept.
+         */
+        bool PreRender(const Frustum & view);
 
         /**
          * \brief Constructs and array of data to be rendered on the next render call.
@@ -55,6 +80,18 @@ namespace alpha
          */
         const std::vector<Light *> & GetLightData();
 
+        /**
+         * \brief Retrieve the emitters to be drawn on the next render call.
+         * Emitters stay valid until the scene is next changed, the list is rebuilt by every PreRender.
+         */
+        const std::vector<ParticleEmitter *> & GetParticleData();
+
+        /**
+         * \brief Retrieve the animators of every skinned model to be drawn on the next render call.
+         * Animators stay valid until the scene is next changed, the list is rebuilt by every PreRender.
+         */
+        const std::vector<SkeletonAnimator *> & GetSkinnedData();
+
         /**
          * \brief Add an entity to the scene.
          * \param entity Shared pointer to an entity instance.
@@ -65,32 +102,150 @@ namespace alpha
          * \param entity Shared pointer to an entity instance.
          */
         bool Update(const std::shared_ptr<Entity> & entity);
+        /**
+         * \brief Apply a journal of component changes, only the changed fields of the affected nodes are touched.
+         * Transform changes need no work here, world transforms are rebuilt from component versions in PreRender,
+         * and before every spatial query.
+         */
+        void ApplyChanges(const std::vector<ComponentDelta> & deltas);
+        /** Move every node of an entity over to the entities new handle, a handle reissued for the same slot costs no allocation */
+        void ChangeHandle(const EntityHandle & oldHandle, const EntityHandle & newHandle);
+        /** Update the tags on every node of an entity */
+        void SetTags(const EntityHandle & handle, EntityTagMask tags);
+        /**
+         * Entities with any of the renderExclude tags are left out of the render data,
+         * and entities with any of the lightExclude tags are left out of the light data.
+         * Pooled entities are always left out.
+         */
+        void SetRenderFilter(EntityTagMask renderExclude, EntityTagMask lightExclude);
         /**
          * \brief Remove an entity from the scene.
-         * \param entity Shared pointer to an entity instance.
+         * The entities nodes stop being rendered straight away, but are only destroyed by ReleaseRemoved.
+         * \param handle Handle the entity was added to the scene with.
          */
-        bool Remove(const std::shared_ptr<Entity> & entity);
+        bool Remove(const EntityHandle & handle);
+        /**
+         * \brief Destroy the nodes of every removed entity, releasing their renderer resources.
+         * Must be called from a point where the renderer is no longer using them, e.g. after rendering.
+         */
+        void ReleaseRemoved(IRenderer * pRenderer);
+
+        /**
+         * Spatial queries, backed by a bounding volume tree over every scene node.
+         * Each query takes a batch, and fills one result list per query, listing every entity with
+         * a node that touches the query shape.  Nodes whose scene component moved since the last
+         * query or render are refit first, so bounds are as of the call.
+         * Entities with any of the exclude tags are skipped, as are pooled entities.
+         */
+        void QueryBoxes(const std::vector<AABB> & boxes, std::vector<std::vector<EntityHandle> > & results, EntityTagMask exclude = ET_NONE);
+        void QuerySpheres(const std::vector<Sphere> & spheres, std::vector<std::vector<EntityHandle> > & results, EntityTagMask exclude = ET_NONE);
+        /** Ray results are sorted from nearest to furthest */
+        void Raycast(const std::vector<Ray> & rays, std::vector<std::vector<RaycastHit> > & results, EntityTagMask exclude = ET_NONE);
 
     private:
+        /** The scene nodes built for one entity, under the handle the entity currently has */
+        struct EntityNodes
+        {
+            EntityHandle handle;
+            /** Root nodes, keyed by the id of the component they were built from */
+            std::map<unsigned int, SceneNode *> roots;
+            /** Every node, children included, keyed by the id of the component it was built from, to apply deltas */
+            std::map<unsigned int, SceneNode *> components;
+        };
+
         /**
-         * \brief Given an entity component, recuresively add SceneNodes.
+         * A single node in the flattened transform hierarchy.
+         * Parents always come before their children, and every entity's nodes are contiguous.
+         */
+        struct TransformEntry
+        {
+            /** The node this entry updates, nullptr once the node has been removed */
+            SceneNode * node;
+            /** Index of the parent entry, -1 for root nodes */
+            int parent;
+            /** Transform version of the scene component when the world transform was last built */
+            unsigned int version;
+            /** Force the world transform to be rebuilt, set for new entries */
+            bool dirty;
+            /** Pass the world transform was last rebuilt on, children rebuild when their parent did */
+            unsigned int updatedPass;
+            /** Cached world transform */
+            Matrix world;
+            /** Model space bounds of the node */
+            AABB localBounds;
+            /** Id of the node's proxy in the spatial tree */
+            int proxy;
+        };
+
+        /**
+         * Bring every world transform, and the spatial tree, up to date with the scene components.
+         * Only entries whose component version changed, or whose parent was rebuilt, do any work.
+         */
+        void RefreshTransforms();
+        /** Find the nodes of an entity, nullptr if the entity is not in the scene or the handle is stale */
+        EntityNodes * FindNodes(const EntityHandle & handle);
+        /**
+         * Rebuild world transforms for entries [begin, end), in one linear pass.
+         * Entity ranges never reference each other, so disjoint ranges split on entity roots can be updated in
+         * parallel, as long as the spatial tree updates are then applied serially.
          */
-        std::map<unsigned int, SceneNode *> CreateNodes(const std::map<unsigned int, std::shared_ptr<EntityComponent> > components, SceneNode * pParent);
+        void UpdateTransforms(size_t begin, size_t end);
+        /** Drop removed entries from the transform list, and fix up the indices of the remaining entries */
+        void CompactTransforms();
+        /** Flag the transform entries of a set of nodes as removed */
+        void RemoveTransforms(std::map<unsigned int, SceneNode *> nodes);
 
-        /** Recursively build render data for an entities scene node map */
-        void BuildRenderData(unsigned int entity_id, std::map<unsigned int, SceneNode *> nodes, std::vector<RenderSet *> & renderables, std::vector<Light *> & lights) const;
+        /**
+         * \brief Given an entity component, recuresively add SceneNodes.
+         */
+        std::map<unsigned int, SceneNode *> CreateNodes(const EntityHandle & handle, const std::map<unsigned int, std::shared_ptr<EntityComponent> > components, SceneNode * pParent,
+                                                        std::map<unsigned int, SceneNode *> & lookup);
+        /** Load the material at path and set it on the node, unless the node already has it */
+        void LoadMaterial(SceneNode * pNode, const std::string & path);
+        /** Create an animator for a skinned mesh node, with every clip its component names */
+        void CreateSkeletonAnimator(SceneNode * pNode);
+        /** Load a clip, clips are shared by every node that plays them */
+        std::shared_ptr<const AnimationClip> LoadClip(const std::string & path);
+
+        /** Recursively build render data for an entities scene node map, any list may be null to skip it */
+        void BuildRenderData(const EntityHandle & handle, const std::map<unsigned int, SceneNode *> & nodes, std::vector<RenderSet *> * pRenderables, std::vector<Light *> * pLights,
+                             std::vector<ParticleEmitter *> * pParticles, std::vector<SkeletonAnimator *> * pSkinned) const;
         /** recursively update render data for an entity. */
         void UpdateRenderData(std::map<unsigned int, SceneNode *> nodes) const;
+        /** recursively release renderer resources held by a set of nodes */
+        void ReleaseRenderData(std::map<unsigned int, SceneNode *> nodes, IRenderer * pRenderer) const;
 
         /** Handle to the asset system, so that the scene manager can pull in any necessary assets */
         AssetSystem * m_pAssets;
 
-        /** Map of entity ID to SceneNode maps */
-        std::map<unsigned int, std::map<unsigned int, SceneNode *> > m_nodes;
+        /**
+         * Nodes of every entity in the scene, keyed by the slot index of its handle.  A slot holds one entity at a time,
+         * and parking an entity only bumps the generation of its handle, so the entry never has to be re-keyed.
+         */
+        std::map<uint32_t, EntityNodes> m_nodes;
+        /** Flattened transform hierarchy, for every node in the scene */
+        std::vector<TransformEntry> m_transforms;
+        /** Set when entries have been removed, and the list needs compacting */
+        bool m_compactTransforms;
+        /** Counts transform passes */
+        unsigned int m_transformPass;
+        /** Bounding volume tree over every node in the scene, for spatial queries */
+        DynamicAABBTree<SceneNode *> m_spatialTree;
+        /** Root nodes of removed entities, waiting to be released */
+        std::vector<std::map<unsigned int, SceneNode *> > m_removedNodes;
+        /** Tags that keep an entity out of the render data, and out of the light data */
+        EntityTagMask m_renderExclude;
+        EntityTagMask m_lightExclude;
         /** Store Render Data array for easy retrieval when rendering. */
         std::vector<RenderSet *> m_vRenderData;
         /** Store a list of lights for use on the next render call. */
         std::vector<Light *> m_vLightData;
+        /** Store a list of particle emitters for use on the next render call. */
+        std::vector<ParticleEmitter *> m_vParticleData;
+        /** Store a list of skeleton animators for use on the next render call. */
+        std::vector<SkeletonAnimator *> m_vSkinnedData;
+        /** Every clip loaded so far, keyed by asset path */
+        std::map<std::string, std::shared_ptr<const AnimationClip> > m_clips;
     };
 }
 
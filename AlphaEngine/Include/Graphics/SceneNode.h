@@ -18,15 +18,21 @@ limitations under the License.
 */
 
 #include <memory>
+#include <string>
 #include <vector>
 #include "Entities/EntityComponent.h"
 #include "Math/Matrix.h"
+#include "Math/AABB.h"
+#include "Entities/EntityHandle.h"
+#include "Entities/EntityTags.h"
 
 namespace alpha
 {
     class Asset;
     class RenderSet;
     class Light;
+    class ParticleEmitter;
+    class SkeletonAnimator;
 
     class SceneNode
     {
@@ -47,8 +53,33 @@ namespace alpha
         /** Retrieve this nodes child nodes */
         std::map<unsigned int, SceneNode *> GetChildren() const;
 
-        /** Build and return this nodes world transform */
-        Matrix GetWorldTransform() const;
+        /** Retrieve the scene component this node represents */
+        std::shared_ptr<SceneComponent> GetSceneComponent() const;
+
+        /** Return this nodes cached world transform, kept up to date by the SceneManager */
+        const Matrix & GetWorldTransform() const;
+        void SetWorldTransform(const Matrix & world);
+
+        /** World space bounds of this node, kept up to date by the SceneManager */
+        const AABB & GetWorldBounds() const;
+        void SetWorldBounds(const AABB & bounds);
+        /** Model space bounds, from the render set if this node has one, otherwise a point at the origin */
+        AABB GetLocalBounds();
+
+        /** The entity this node was created for */
+        EntityHandle GetEntityHandle() const;
+        void SetEntityHandle(const EntityHandle & handle);
+        /** Tags of the entity this node was created for */
+        EntityTagMask GetTags() const;
+        void SetTags(EntityTagMask tags);
+
+        /** Position of this node in the SceneManager's flattened transform list */
+        int GetTransformIndex() const;
+        void SetTransformIndex(int index);
+
+        /** Last SceneManager pass that found this node inside the view frustum */
+        unsigned int GetVisiblePass() const;
+        void SetVisiblePass(unsigned int pass);
 
         /** Set the model mesh that should for which render data will be build for this node */
         void SetMesh(std::shared_ptr<Asset> pAsset);
@@ -57,10 +88,19 @@ namespace alpha
         void SetLight(Light * pLight);
         Light * GetLight() const;
 
-        /** Set the material for this node */
-        void SetMaterial(std::shared_ptr<Material> pMaterial);
+        /** Set the particle emitter for this node, the node takes ownership */
+        void SetParticleEmitter(ParticleEmitter * pEmitter);
+        ParticleEmitter * GetParticleEmitter() const;
+
+        /** Set the animator that poses this nodes skinned model, the node takes ownership */
+        void SetSkeletonAnimator(SkeletonAnimator * pAnimator);
+        SkeletonAnimator * GetSkeletonAnimator() const;
+
+        /** Set the material for this node, along with the path of the material script it was loaded from */
+        void SetMaterial(std::shared_ptr<Material> pMaterial, const std::string & path);
         /** Retrieve material */
         std::weak_ptr<Material> GetMaterial() const;
+        const std::string & GetMaterialPath() const;
 
         /**
          * Does this node emit light.
@@ -77,6 +117,16 @@ namespace alpha
 
         /** The transform that represents this scene nodes position, scale, and rotation in the world. */
         Matrix m_world;
+        /** World space bounds */
+        AABB m_worldBounds;
+        /** The entity this node belongs to */
+        EntityHandle m_entity;
+        /** The tags of the entity this node belongs to */
+        EntityTagMask m_tags;
+        /** Index into the SceneManager's flattened transform list, -1 if not in the list */
+        int m_transformIndex;
+        /** Pass on which the node was last found to be in view */
+        unsigned int m_visiblePass;
 
         /** A handle to the SceneComponent which this SceneNode represents */
         std::shared_ptr<SceneComponent> m_pSceneComponent;
@@ -90,8 +140,15 @@ namespace alpha
         /** Light information for this node */
         Light * m_pLight;
 
+        /** Particles spawned by this node, if it represents an emitter */
+        ParticleEmitter * m_pParticleEmitter;
+
+        /** Poses the render set, if it is a skinned model */
+        SkeletonAnimator * m_pSkeletonAnimator;
+
         /** Material script describing the look and feel of this node */
         std::shared_ptr<Material> m_pMaterial;
+        std::string m_sMaterialPath;
     };
 }
 
@@ -0,0 +1,43 @@
+#ifndef ALPHA_TASK_SIMULATE_PARTICLES_H
+#define ALPHA_TASK_SIMULATE_PARTICLES_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "Threading/ATask.h"
+
+namespace alpha
+{
+    class ParticleEmitter;
+
+    /**
+     * Task_SimulateParticles
+     * Steps a single emitter.  The emitter is owned by its scene node, the graphics system waits for the
+     * task before it changes, draws, or releases any part of the scene.
+     */
+    class Task_SimulateParticles : public ATask
+    {
+    public:
+        Task_SimulateParticles(ParticleEmitter * pEmitter, float fElapsedTime);
+        bool VExecute();
+
+    private:
+        ParticleEmitter * m_pEmitter;
+        float m_fElapsedTime;
+    };
+}
+
+#endif // ALPHA_TASK_SIMULATE_PARTICLES_H
@@ -0,0 +1,105 @@
+#ifndef ALPHA_GAME_SYSTEM_H
+#define ALPHA_GAME_SYSTEM_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Entities/EntityComponent.h"
+#include "Entities/EntityTags.h"
+
+namespace alpha
+{
+    class Entity;
+    class EntityQuery;
+
+    /**
+     * \brief One frames snapshot of the entities a game system runs over.
+     *
+     * Taken from the systems query when the frame is scheduled, so entities created or destroyed while
+     * the systems run do not change it.  Components are fetched by type without hashing or casts.
+     */
+    class SystemView
+    {
+    public:
+        /** Copy every entity in the query that has none of the exclude tags */
+        SystemView(const EntityQuery & query, EntityTagMask exclude);
+
+        size_t Size() const;
+        bool Empty() const;
+        Entity * GetEntity(size_t index) const;
+
+        /** Get the component of type T for the entity at index, nullptr if T is not part of the view */
+        template <class T>
+        T * Get(size_t index) const
+        {
+            const unsigned int type_id = GetComponentTypeID<T>();
+            const size_t columns = m_typeIds.size();
+            for (size_t c = 0; c < columns; ++c)
+            {
+                if (m_typeIds[c] == type_id)
+                {
+                    return static_cast<T *>(m_components[index * columns + c]);
+                }
+            }
+            return nullptr;
+        }
+
+    private:
+        std::vector<unsigned int> m_typeIds;
+        /** Keeps the entities, and so their components, alive until the frame is done with them */
+        std::vector<std::shared_ptr<Entity> > m_entities;
+        /** One row of components per entity, one column per type id */
+        std::vector<EntityComponent *> m_components;
+    };
+
+    /**
+     * \brief Game logic that runs over every entity with a set of component types.
+     *
+     * A system declares the component types it reads and the types it writes, a written type may also be read.
+     * The logic system orders systems from those declarations, so a system never runs alongside another system
+     * that writes anything it touches, and VUpdate needs no locking.  Work is split into batches of entities, and
+     * batches of the same system may run at the same time, so a batch must only touch its own entities components.
+     */
+    class AGameSystem
+    {
+    public:
+        /** batchSize is the number of entities in each batch, 0 runs the whole view as a single batch */
+        AGameSystem(const std::vector<std::string> & reads, const std::vector<std::string> & writes, size_t batchSize = 0);
+        virtual ~AGameSystem();
+
+        /** Every component type the system touches, the system runs over entities that have all of them */
+        const std::vector<std::string> & GetTypeNames() const;
+        size_t GetBatchSize() const;
+        /** Must one of the two systems wait for the other, because either writes a type the other touches */
+        bool ConflictsWith(const AGameSystem & other) const;
+
+        /** Update entities [begin, end) of the view */
+        virtual void VUpdate(const SystemView & view, size_t begin, size_t end, float fCurrentTime, float fElapsedTime) = 0;
+
+    private:
+        std::vector<std::string> m_typeNames;
+        /** Sorted type ids of the components only read, and of the components written */
+        std::vector<unsigned int> m_readIds;
+        std::vector<unsigned int> m_writeIds;
+        size_t m_batchSize;
+    };
+}
+
+#endif // ALPHA_GAME_SYSTEM_H
@@ -17,19 +17,44 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <atomic>
+#include <functional>
+#include <future>
 #include <map>
 #include <memory>
+#include <set>
+#include <string>
+#include <vector>
 #include "AlphaSystem.h"
+#include "Animation/Animator.h"
+#include "Entities/EntityHandle.h"
+#include "Entities/EntityTags.h"
+#include "Logic/SystemScheduler.h"
+#include "Logic/WorldPartition.h"
+#include "Math/Vector3.h"
+#include "Toolbox/ConcurrentQueue.h"
+#include "Toolbox/SlotMap.h"
 
 namespace alpha
 {
+    struct AABB;
+    class Asset;
     class AssetSystem;
     class AudioSystem;
+    struct BroadphaseState;
+    class CameraComponent;
+    struct ContactPair;
     class EntityFactory;
+    class EntityQuery;
     class Entity;
+    class GraphicsSystem;
     class HIDContextManager;
+    struct Ray;
+    struct RaycastHit;
+    struct Sphere;
     class StateMachine;
     class Sound;
+    class TaskGroup;
 
     class LogicSystem : public AlphaSystem
     {
@@ -53,28 +78,286 @@ namespace alpha
         void SetAssetSystem(AssetSystem * const pAssets);
         /** Allow controller to attach audio system to logic layer. */
         void SetAudioSystem(AudioSystem * const pAudio);
+        /** Allow controller to attach graphics system to logic layer, it answers spatial queries. */
+        void SetGraphicsSystem(GraphicsSystem * const pGraphics);
 
-        /** Entity life-cycle methods */
-        std::shared_ptr<Entity> GetEntity(const unsigned long entityId);
+        /**
+         * Entity life-cycle methods
+         * GetEntity returns nullptr if the handle is stale, the pointer is owned by the logic system.
+         */
+        Entity * GetEntity(const EntityHandle & handle);
         std::shared_ptr<Entity> CreateEntity(const char * resource);
-        void DestroyEntity(const unsigned long entityId);
+        std::vector<std::shared_ptr<Entity> > CreateEntities(const char * resource, unsigned int count);
+        /**
+         * Build entities on a worker thread, so running the script and building components does not hold up the caller.
+         * Finished entities are added to the world, and announced with Event_EntityCreated, at the start of a later
+         * logic update, at most the spawn commit budget per update.  The future is ready once every entity of the
+         * request has been added, so their handles are valid.  It holds nullptr, or no entities, if the resource
+         * could not be found.  Pooled scripts are served from the pool straight away.
+         */
+        std::shared_future<std::shared_ptr<Entity> > CreateEntityAsync(const char * resource);
+        std::shared_future<std::vector<std::shared_ptr<Entity> > > CreateEntitiesAsync(const char * resource, unsigned int count);
+        /** Maximum number of asynchronously built entities added to the world per update */
+        void SetSpawnCommitBudget(unsigned int budget);
+        /**
+         * Request that an entity be destroyed.  Destruction is deferred until the start of the next logic
+         * update, when every request is processed as one batch and announced with Event_EntitiesDestroyed.
+         */
+        void DestroyEntity(const EntityHandle & handle);
+
+        /**
+         * Entity pool methods
+         * Entities created from a pooled script are parked when destroyed, as long as their pool has room, rather
+         * than torn down.  A parked entity keeps its components, scene nodes, and renderer resources, is tagged
+         * ET_POOLED, and is hidden from updates, rendering, and queries.  Creating an entity from the script hands
+         * out a parked entity first, reset to the scripts prototype, and only builds a new one when the pool is empty.
+         * A parked entity is given a new handle, so a handle held past destruction stays stale once the entity is reused.
+         * PrewarmPool creates parked entities up front, so spawning never has to build one.
+         */
+        void SetPoolCapacity(const char * resource, unsigned int capacity);
+        void PrewarmPool(const char * resource, unsigned int count);
+
+        /**
+         * World snapshot methods
+         * SaveSnapshot writes every live entity to the file at path, LoadSnapshot recreates the entities in a
+         * snapshot resource without running any entity scripts.
+         */
+        bool SaveSnapshot(const char * path);
+        std::vector<std::shared_ptr<Entity> > LoadSnapshot(const char * resource);
+
+        /**
+         * Get a view of every entity that has all of the given component types.  Views are shared by
+         * everyone asking for the same set of types, and are kept up to date as entities come and go.
+         */
+        std::shared_ptr<const EntityQuery> Query(const std::vector<std::string> & typeNames);
+
+        /**
+         * Entity scheduling methods
+         * Entities sleep until they are woken, only awake entities and entities with components
+         * that need to be ticked every frame are updated.
+         */
+        void WakeEntity(const EntityHandle & handle);
+        /** Wake the entity after delay seconds have passed */
+        void ScheduleWake(const EntityHandle & handle, double delay);
+        /**
+         * Set the number of entities updated by each update task.
+         * A batch size of 0 lets the logic system size batches from the measured cost of an entity update.
+         */
+        void SetUpdateBatchSize(unsigned int batchSize);
+
+        /**
+         * Entity tag methods
+         * SetEntityTags replaces an entities tags and lets other systems know, ET_POOLED is ignored.  Entities with
+         * any of the update filters tags are not updated, by default only disabled entities are skipped.
+         */
+        void SetEntityTags(const EntityHandle & handle, EntityTagMask tags);
+        void SetUpdateFilter(EntityTagMask exclude);
+
+        /**
+         * World streaming methods
+         * The world is divided into square cells on the x/z plane, each stored as a world snapshot resource.
+         * Cells within the load radius of the streaming camera, or the streaming focus if no camera is set,
+         * are loaded on worker threads and added to the world a budgeted number of entities per update.
+         * Cells that move out of range are unloaded, again a budgeted number of entities per update.
+         */
+        void AddWorldCell(int x, int z, const char * resource);
+        void SetWorldCellSize(float cellSize);
+        void SetWorldLoadRadius(unsigned int loadRadius);
+        void SetStreamingBudgets(unsigned int commitBudget, unsigned int unloadBudget);
+        void SetStreamingFocus(const Vector3 & focus);
+        void SetStreamingCamera(std::weak_ptr<CameraComponent> pCameraComponent);
+
+        /**
+         * Collision methods
+         * Entities with a collider component are tested against each other once per update, on a worker
+         * thread, and every pair that starts or stops overlapping is reported to the bound delegates.
+         * Contacts are found from the previous updates transforms, so they arrive one update late.
+         */
+        void BindContactsBegan(std::function<void(const std::vector<ContactPair> &)> delegate);
+        void BindContactsEnded(std::function<void(const std::vector<ContactPair> &)> delegate);
+
+        /**
+         * Animation methods
+         * Tracks drive the position, rotation, or scale of a scene component, every playing track is
+         * evaluated in parallel once per logic update.
+         */
+        AnimationHandle PlayAnimation(const ComponentHandle<SceneComponent> & target, std::shared_ptr<const AnimationTrack> track,
+                                      AnimationLoop loop = AL_ONCE, float speed = 1.f);
+        void StopAnimation(const AnimationHandle & handle);
+        void SetAnimationSpeed(const AnimationHandle & handle, float speed);
+        bool IsAnimationPlaying(const AnimationHandle & handle) const;
+        unsigned int GetAnimationLoops(const AnimationHandle & handle) const;
+
+        /**
+         * Game system methods
+         * Systems run over every entity with their component types, on worker threads once per logic update.
+         * Systems that write to the same component types run one after another, in the order they were added.
+         */
+        void AddGameSystem(std::shared_ptr<AGameSystem> system);
+        bool RemoveGameSystem(const std::shared_ptr<AGameSystem> & system);
+
+        /**
+         * Spatial query methods
+         * Find every entity with a scene node touching each box or sphere, or hit by each ray, nearest first.
+         * Bounds are refit from the latest scene component transforms before answering, but entities created
+         * this update only take part once the scene has picked them up.  Call from the logic thread only.
+         */
+        void QueryBoxes(const std::vector<AABB> & boxes, std::vector<std::vector<EntityHandle> > & results, EntityTagMask exclude = ET_NONE);
+        void QuerySpheres(const std::vector<Sphere> & spheres, std::vector<std::vector<EntityHandle> > & results, EntityTagMask exclude = ET_NONE);
+        void Raycast(const std::vector<Ray> & rays, std::vector<std::vector<RaycastHit> > & results, EntityTagMask exclude = ET_NONE);
 
         /** Audio life-cycle methods */
         std::weak_ptr<Sound> CreateSound(const char * resource);
 
     private:
         virtual bool VUpdate(double currentTime, double elapsedTime);
+        /**
+         * Wait for the last ticks animation, entity updates, and game systems, they may still be moving scene components.
+         * The thread system runs at the same rate, so its tasks are always finished here before anything else reads
+         * a transform.
+         */
+        virtual void VFinishTasks();
 
         /** Handle HID Key Action events from subscription */
         void HandleHIDKeyActionEvent(AEvent * pEvent);
+
+        /** Hook a newly created entity into the update schedule */
+        void AddEntity(std::shared_ptr<Entity> entity);
+        /** Make an entity that is in the entity list visible to updates and queries, and wake it */
+        void ActivateEntity(const std::shared_ptr<Entity> & entity);
+        /** Park a destroyed entity in its scripts pool, returns false if the script is not pooled or its pool is full */
+        bool ParkEntity(Entity * pEntity);
+        /** Take a parked entity from the scripts pool and reset it, nullptr if there are none */
+        std::shared_ptr<Entity> TakeFromPool(std::shared_ptr<Asset> asset);
+        /** Remove an entity from the entity list for good, the caller announces it with Event_EntitiesDestroyed */
+        void ReleaseEntity(const EntityHandle & handle);
+        /**
+         * Take parked entities for an asynchronous request, then queue up a task to build the rest.
+         * delComplete is called on the logic thread once every entity has been added to the world.
+         */
+        void SpawnAsync(const char * resource, unsigned int count, std::function<void(const std::vector<std::shared_ptr<Entity> > &)> delComplete);
+        /** Add entities built by spawn tasks to the world, within the spawn commit budget */
+        void CommitSpawnedEntities();
+        /** Split the entities into batches, and publish a group with an update task for each batch */
+        void ScheduleUpdates(std::shared_ptr<const std::vector<Entity *> > entities, float fCurrentTime, float fElapsedTime);
+        /** Destroy every entity requested since the last update, and notify other systems */
+        void DestroyPendingEntities();
+        /** Work out how many entities each update task should handle */
+        size_t GetUpdateBatchSize(size_t entityCount);
+        /** Start, commit, and unload world cells around the streaming focus */
+        void UpdateStreaming();
+        /** Gather collider bounds and queue up a broadphase pass */
+        void UpdateCollision();
         
         EntityFactory *m_pEntityFactory;
-        std::map<unsigned long, std::shared_ptr<Entity> > m_entities;
+        /** Every live entity, packed for iteration and addressed by generational handles */
+        SlotMap<std::shared_ptr<Entity>, EntityHandle> m_entities;
+
+        /** Every query view handed out, updated as entities are added and destroyed */
+        std::vector<std::shared_ptr<EntityQuery> > m_queries;
+
+        /** Entities waiting to be destroyed at the start of the next update */
+        std::vector<EntityHandle> m_pendingDestroy;
+
+        /** Entities built by a spawn task, waiting to be added to the world by the logic thread */
+        struct SpawnedEntities
+        {
+            std::vector<std::shared_ptr<Entity> > entities;
+            /** Number of entities at the front of the list that are already in the world */
+            size_t committed;
+            std::function<void(const std::vector<std::shared_ptr<Entity> > &)> delComplete;
+        };
+        /** Requests finished by spawn tasks, pushed from any thread */
+        ConcurrentQueue<SpawnedEntities> m_spawned;
+        /** Requests being added to the world, in the order they finished building */
+        std::vector<SpawnedEntities> m_committingSpawns;
+        /** Maximum number of spawned entities added per update */
+        unsigned int m_spawnCommitBudget;
+
+        /** Parked entities created from a single script */
+        struct EntityPool
+        {
+            /** Most entities the pool keeps parked, entities destroyed while it is full are torn down */
+            unsigned int capacity;
+            std::vector<EntityHandle> parked;
+        };
+        /** Entity pools, keyed by the path of the script their entities are created from */
+        std::map<std::string, EntityPool> m_pools;
+
+        /** Entities that contain a component that needs to be ticked every frame */
+        std::set<EntityHandle> m_activeEntities;
+        /** Entities that have been woken since the last tick, pushed from any thread */
+        ConcurrentQueue<EntityHandle> m_wokenEntities;
+        /** Pending wake timers, keyed by the time they should fire */
+        std::multimap<double, EntityHandle> m_wakeTimers;
+        /** Time of the last logic update, used to schedule wake timers */
+        double m_lastUpdateTime;
+
+        /** Amount of work, in seconds, an automatically sized update task aims for */
+        static const double sk_targetBatchSeconds;
+        /** Smallest automatically sized batch, keeps per task overhead down when entities are expensive */
+        static const size_t sk_minBatchSize;
+
+        /** Entities with any of these tags are not updated */
+        EntityTagMask m_updateExclude;
+
+        /** Fixed update batch size, 0 if batches are sized automatically */
+        unsigned int m_updateBatchSize;
+        /** Running average of the seconds it takes to update a single entity */
+        double m_entityUpdateCost;
+        /** Update cost reported by tasks since the last tick, in nanoseconds */
+        std::atomic<unsigned long long> m_reportedUpdateNanoseconds;
+        /** Number of entities updated by tasks since the last tick */
+        std::atomic<unsigned long long> m_reportedUpdateCount;
+        /** Entity update tasks published by the last tick, finished before the next tick starts */
+        std::shared_ptr<TaskGroup> m_pUpdateGroup;
+        /** Animation tasks published by the last tick, entity updates and game systems wait for them */
+        std::shared_ptr<TaskGroup> m_pAnimationGroup;
+
+        /** Entities built by a cell load task, waiting to be picked up by the logic thread */
+        struct LoadedWorldCell
+        {
+            WorldCellCoord coord;
+            std::vector<std::shared_ptr<Entity> > entities;
+        };
+
+        /** Most cell loads in flight at once, bounds the memory held by cells waiting to be committed */
+        static const unsigned int sk_maxCellLoads;
+
+        WorldPartition m_worldPartition;
+        /** The camera that cells are streamed around, falls back to the streaming focus when not set */
+        std::weak_ptr<CameraComponent> m_pStreamingCamera;
+        Vector3 m_vStreamingFocus;
+        /** Number of cell load tasks in flight */
+        unsigned int m_cellLoads;
+        /** Cells finished loading on a worker thread */
+        ConcurrentQueue<LoadedWorldCell> m_loadedCells;
+        /** Cells being committed to the world, in the order they finished loading */
+        std::vector<WorldCellCoord> m_committingCells;
+        /** Entities from unloaded cells that are still waiting to be destroyed */
+        std::vector<EntityHandle> m_streamUnloads;
+        /** Maximum number of streamed entities added, and destroyed, per update */
+        unsigned int m_streamCommitBudget;
+        unsigned int m_streamUnloadBudget;
+
+        /** Plays animation tracks on scene components */
+        Animator m_animator;
+        /** Runs game systems in parallel, in the order their component access allows */
+        SystemScheduler m_gameSystems;
+
+        /** Every entity with a collider */
+        std::shared_ptr<const EntityQuery> m_colliders;
+        /** Contacts found by the last broadphase pass, shared with the pass in flight */
+        std::shared_ptr<BroadphaseState> m_pBroadphase;
+        std::function<void(const std::vector<ContactPair> &)> m_delContactsBegan;
+        std::function<void(const std::vector<ContactPair> &)> m_delContactsEnded;
 
         /** Asset management system handle. */
         AssetSystem * m_pAssets;
         /** Handle to the audio system, allows logic to create and manage sounds in a game */
         AudioSystem * m_pAudio;
+        /** Handle to the graphics system, which owns the spatial index of the scene */
+        GraphicsSystem * m_pGraphics;
 
         /** HID Context Manager, handles translation of engine input code events, to contextual actions */
         HIDContextManager * m_pHIDContextManager;
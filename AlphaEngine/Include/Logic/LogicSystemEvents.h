@@ -18,8 +18,12 @@ limitations under the License.
 */
 
 #include <memory>
+#include <vector>
 
 #include "Events/AEvent.h"
+#include "Entities/EntityComponent.h"
+#include "Entities/EntityHandle.h"
+#include "Entities/EntityTags.h"
 
 namespace alpha
 {
@@ -47,21 +51,121 @@ namespace alpha
         std::shared_ptr<Entity> m_pEntity;
     };
 
-    class Event_EntityUpdated : public AEvent
+    /**
+     * Event_EntitiesUpdated
+     * Published once per update batch, containing every entity in the batch that changed,
+     * along with a journal of exactly which component fields changed.
+     */
+    class Event_EntitiesUpdated : public AEvent
     {
     public:
         static const std::string sk_name;
 
-        explicit Event_EntityUpdated(std::shared_ptr<Entity> pEntity);
+        Event_EntitiesUpdated(std::vector<EntityHandle> handles, std::vector<ComponentDelta> deltas);
 
         virtual std::string VGetTypeName() const;
         virtual AEvent * VCopy();
 
-        /** Retrieve the entity that was created. */
-        std::shared_ptr<Entity> GetEntity() const;
+        /** Retrieve the handles of the entities that were updated. */
+        const std::vector<EntityHandle> & GetHandles() const;
+        /** Retrieve the changed fields of every component in the batch. */
+        const std::vector<ComponentDelta> & GetDeltas() const;
 
     private:
-        std::shared_ptr<Entity> m_pEntity;
+        std::vector<EntityHandle> m_handles;
+        std::vector<ComponentDelta> m_deltas;
+    };
+
+    /**
+     * Event_EntitiesDestroyed
+     * Published once per logic update, containing the handles of every entity destroyed during that update.
+     * The handles are already stale, they can only be used to find and tear down data keyed by them.
+     */
+    class Event_EntitiesDestroyed : public AEvent
+    {
+    public:
+        static const std::string sk_name;
+
+        explicit Event_EntitiesDestroyed(std::vector<EntityHandle> handles);
+
+        virtual std::string VGetTypeName() const;
+        virtual AEvent * VCopy();
+
+        /** Retrieve the handles of the entities that were destroyed. */
+        const std::vector<EntityHandle> & GetHandles() const;
+
+    private:
+        std::vector<EntityHandle> m_handles;
+    };
+
+    /**
+     * Event_EntityTagsChanged
+     * Published whenever the tags of an entity are changed through the logic system.
+     */
+    class Event_EntityTagsChanged : public AEvent
+    {
+    public:
+        static const std::string sk_name;
+
+        Event_EntityTagsChanged(const EntityHandle & handle, EntityTagMask tags);
+
+        virtual std::string VGetTypeName() const;
+        virtual AEvent * VCopy();
+
+        EntityHandle GetHandle() const;
+        EntityTagMask GetTags() const;
+
+    private:
+        EntityHandle m_handle;
+        EntityTagMask m_tags;
+    };
+
+    /**
+     * Event_EntityHandleChanged
+     * Published when an entity is given a new handle, such as when it is parked in its pool.  The old handle
+     * is already stale, it can only be used to find data keyed by it, which should be moved to the new handle.
+     * The entities tags under the new handle come with it, so parking takes a single event.
+     */
+    class Event_EntityHandleChanged : public AEvent
+    {
+    public:
+        static const std::string sk_name;
+
+        Event_EntityHandleChanged(const EntityHandle & oldHandle, const EntityHandle & newHandle, EntityTagMask tags);
+
+        virtual std::string VGetTypeName() const;
+        virtual AEvent * VCopy();
+
+        EntityHandle GetOldHandle() const;
+        EntityHandle GetNewHandle() const;
+        EntityTagMask GetTags() const;
+
+    private:
+        EntityHandle m_oldHandle;
+        EntityHandle m_newHandle;
+        EntityTagMask m_tags;
+    };
+
+    /**
+     * Event_SetRenderFilter
+     * Published when the game state changes which tags keep entities out of the rendered scene.
+     */
+    class Event_SetRenderFilter : public AEvent
+    {
+    public:
+        static const std::string sk_name;
+
+        Event_SetRenderFilter(EntityTagMask renderExclude, EntityTagMask lightExclude);
+
+        virtual std::string VGetTypeName() const;
+        virtual AEvent * VCopy();
+
+        EntityTagMask GetRenderExclude() const;
+        EntityTagMask GetLightExclude() const;
+
+    private:
+        EntityTagMask m_renderExclude;
+        EntityTagMask m_lightExclude;
     };
 
     /**
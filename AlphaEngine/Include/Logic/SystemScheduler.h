@@ -0,0 +1,85 @@
+#ifndef ALPHA_SYSTEM_SCHEDULER_H
+#define ALPHA_SYSTEM_SCHEDULER_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "Entities/EntityTags.h"
+
+namespace alpha
+{
+    class AEvent;
+    class AGameSystem;
+    class EntityQuery;
+    struct SystemFrame;
+    class TaskGroup;
+
+    /**
+     * \brief Runs game systems on the thread pool, in an order built from what each system reads and writes.
+     *
+     * A system waits for every system added before it that conflicts with it, so later systems always see
+     * the writes of earlier ones, while systems that only share read access run side by side.  Each frame the
+     * graph is instantiated, every systems view is snapshot, and a handful of tasks work through the batches
+     * as their dependencies finish.  Only one frame runs at a time, Finish helps the last frame to the end
+     * on the calling thread, and every update finishes the last frame before it starts the next one.
+     */
+    class SystemScheduler
+    {
+    public:
+        SystemScheduler();
+
+        /** Add a system, query is the view of every entity with all of the systems component types */
+        void Add(std::shared_ptr<AGameSystem> system, std::shared_ptr<const EntityQuery> query);
+        /** Remove a system, a frame already running keeps the system alive until it is done */
+        bool Remove(const std::shared_ptr<AGameSystem> & system);
+        size_t Size() const;
+        void Clear();
+
+        /**
+         * Finish the last frame, snapshot every systems view, and publish the tasks that run this frames graph.
+         * No system runs until every task in pAfter is done.
+         */
+        void Update(float fCurrentTime, float fElapsedTime, EntityTagMask exclude, std::function<void(AEvent *)> delPublishEvent,
+                    std::shared_ptr<TaskGroup> pAfter = nullptr);
+        /** Run the last frame to completion, taking batches on the calling thread alongside the pool */
+        void Finish();
+
+    private:
+        /** Work out which later systems wait on each system, only needed after systems are added or removed */
+        void BuildGraph();
+
+        struct ScheduledSystem
+        {
+            std::shared_ptr<AGameSystem> system;
+            std::shared_ptr<const EntityQuery> query;
+            /** Indices of later systems that wait for this one */
+            std::vector<size_t> dependents;
+            /** Number of earlier systems this one waits for */
+            unsigned int dependencies;
+        };
+
+        std::vector<ScheduledSystem> m_systems;
+        bool m_graphDirty;
+        /** The last frame published, still running until its remaining node count reaches 0 */
+        std::shared_ptr<SystemFrame> m_pFrame;
+    };
+}
+
+#endif // ALPHA_SYSTEM_SCHEDULER_H
@@ -0,0 +1,52 @@
+#ifndef ALPHA_TASK_CREATE_ENTITIES_H
+#define ALPHA_TASK_CREATE_ENTITIES_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "Threading/ATask.h"
+
+namespace alpha
+{
+    class Asset;
+    class Entity;
+    class EntityFactory;
+
+    /**
+     * Task_CreateEntities
+     * Runs an entity script and builds entities from it off of the logic thread.  The entities are
+     * handed back through the completion delegate, they are not added to the world by the task.
+     */
+    class Task_CreateEntities : public ATask
+    {
+    public:
+        Task_CreateEntities(std::shared_ptr<Asset> asset, unsigned int count, EntityFactory * pFactory,
+                            std::function<void(std::vector<std::shared_ptr<Entity> >)> delComplete);
+        bool VExecute();
+
+    private:
+        std::shared_ptr<Asset> m_asset;
+        unsigned int m_count;
+        EntityFactory * m_pFactory;
+        std::function<void(std::vector<std::shared_ptr<Entity> >)> m_delComplete;
+    };
+}
+
+#endif // ALPHA_TASK_CREATE_ENTITIES_H
@@ -0,0 +1,53 @@
+#ifndef ALPHA_TASK_LOAD_WORLD_CELL_H
+#define ALPHA_TASK_LOAD_WORLD_CELL_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "Threading/ATask.h"
+#include "Logic/WorldPartition.h"
+
+namespace alpha
+{
+    class Asset;
+    class Entity;
+    class EntityFactory;
+
+    /**
+     * Task_LoadWorldCell
+     * Reads a world cells snapshot and builds its entities off of the logic thread.  The entities are
+     * handed back through the completion delegate, they are not added to the world by the task.
+     */
+    class Task_LoadWorldCell : public ATask
+    {
+    public:
+        Task_LoadWorldCell(WorldCellCoord coord, std::shared_ptr<Asset> asset, EntityFactory * pFactory,
+                           std::function<void(WorldCellCoord, std::vector<std::shared_ptr<Entity> >)> delComplete);
+        bool VExecute();
+
+    private:
+        WorldCellCoord m_coord;
+        std::shared_ptr<Asset> m_asset;
+        EntityFactory * m_pFactory;
+        std::function<void(WorldCellCoord, std::vector<std::shared_ptr<Entity> >)> m_delComplete;
+    };
+}
+
+#endif // ALPHA_TASK_LOAD_WORLD_CELL_H
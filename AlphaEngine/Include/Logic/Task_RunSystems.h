@@ -0,0 +1,92 @@
+#ifndef ALPHA_TASK_RUN_SYSTEMS_H
+#define ALPHA_TASK_RUN_SYSTEMS_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "Threading/ATask.h"
+
+namespace alpha
+{
+    class AGameSystem;
+    class SystemView;
+    class TaskGroup;
+
+    /** One frame of game systems, shared by every task running it */
+    struct SystemFrame
+    {
+        /** A single system in the frames dependency graph */
+        struct Node
+        {
+            Node() : batchSize(0), batchCount(0), remainingBatches(0), remainingDependencies(0) { }
+
+            std::shared_ptr<AGameSystem> system;
+            std::shared_ptr<const SystemView> view;
+            size_t batchSize;
+            size_t batchCount;
+            std::atomic<size_t> remainingBatches;
+            /** Systems this one waits for that have not finished yet */
+            std::atomic<unsigned int> remainingDependencies;
+            /** Nodes that wait for this one */
+            std::vector<size_t> dependents;
+        };
+
+        explicit SystemFrame(size_t nodeCount)
+            : currentTime(0.f)
+            , elapsedTime(0.f)
+            , nodes(nodeCount)
+            , remainingNodes(nodeCount)
+        { }
+
+        float currentTime;
+        float elapsedTime;
+        std::vector<Node> nodes;
+        /** Tasks that must be done before any system in the frame runs, nullptr if there are none */
+        std::shared_ptr<TaskGroup> pAfter;
+
+        std::mutex readyMutex;
+        /** Batches of systems with no unfinished dependencies, as node index and batch index */
+        std::vector<std::pair<size_t, size_t> > ready;
+        /** Systems that have not finished yet, the frame is done when this reaches 0 */
+        std::atomic<size_t> remainingNodes;
+    };
+
+    /**
+     * Task_RunSystems
+     * Runs ready batches from a shared frame until every system in it has finished.  Finishing the last
+     * batch of a system releases the systems waiting for it, so the graph runs in a single round of tasks.
+     */
+    class Task_RunSystems : public ATask
+    {
+    public:
+        explicit Task_RunSystems(std::shared_ptr<SystemFrame> pFrame);
+        bool VExecute();
+
+    private:
+        /** Finish a batch, releasing the nodes that wait for its system once every batch of the system is done */
+        void FinishBatch(size_t node);
+
+        std::shared_ptr<SystemFrame> m_pFrame;
+    };
+}
+
+#endif // ALPHA_TASK_RUN_SYSTEMS_H
@@ -0,0 +1,59 @@
+#ifndef ALPHA_TASK_UPDATE_ENTITIES_H
+#define ALPHA_TASK_UPDATE_ENTITIES_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "Threading/ATask.h"
+
+namespace alpha
+{
+    class AEvent;
+    class Entity;
+
+    /**
+     * Task_UpdateEntities
+     * Updates a contiguous range of entities from a shared list, then publishes every entity that changed
+     * as a single Event_EntitiesUpdated.  The time spent is reported back, so the caller can size batches.
+     */
+    class Task_UpdateEntities : public ATask
+    {
+    public:
+        Task_UpdateEntities(float fCurrentTime, float fElapsedTime,
+                            std::shared_ptr<const std::vector<Entity *> > pEntities, size_t begin, size_t end,
+                            std::function<void(AEvent *)> delPublishEvent,
+                            std::function<void(size_t, double)> delReportCost);
+        bool VExecute();
+
+    private:
+        float m_fCurrentTime;
+        float m_fElapsedTime;
+        /** The full list of entities being updated this tick, shared by every batch, and owned by the logic system */
+        std::shared_ptr<const std::vector<Entity *> > m_pEntities;
+        /** The range of entities this task is responsible for, [begin, end) */
+        size_t m_begin;
+        size_t m_end;
+        std::function<void(AEvent *)> m_delPublishEvent;
+        /** Reports the number of entities updated, and the seconds it took */
+        std::function<void(size_t, double)> m_delReportCost;
+    };
+}
+
+#endif // ALPHA_TASK_UPDATE_ENTITIES_H
@@ -0,0 +1,87 @@
+#ifndef ALPHA_WORLD_FILE_H
+#define ALPHA_WORLD_FILE_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+namespace alpha
+{
+    class Entity;
+    class EntityFactory;
+
+#define WORLDFILE_SIG "Alpha-World" // AW - Alpha World
+#define WORLDFILE_V2 0x02 // entity records carry tags, the only version that is read or written
+
+    /**
+     * A world snapshot is laid out as:
+     *   WorldFileHeader
+     *   string table, stringCount length prefixed strings
+     *   WorldEntityRecord[entityCount]
+     *   WorldComponentRecord[componentCount]
+     *   component data, dataSize bytes
+     * Records are fixed size so both tables can be read in a single copy each.
+     */
+    struct WorldFileHeader
+    {
+        char signature[12]; // = WORLDFILE_SIG;
+        unsigned short version;
+        uint32_t entityCount;
+        uint32_t componentCount;
+        uint32_t stringCount;
+        uint32_t dataSize;
+    };
+
+    struct WorldEntityRecord
+    {
+        /** The entities layer and tag bits */
+        uint64_t tags;
+        /** String table index of the script the entity was created from, or WORLDFILE_NO_STRING */
+        uint32_t script;
+        /** Index of the entities first component record, components of an entity are contiguous */
+        uint32_t firstComponent;
+        uint32_t componentCount;
+    };
+
+    struct WorldComponentRecord
+    {
+        /** String table index of the component type name */
+        uint32_t type;
+        /** The hashed variable name the component is stored under */
+        uint32_t componentId;
+        /** Index of the parent component, relative to the entities first component, -1 for root components */
+        int32_t parent;
+        /** Location of the components serialized data in the data block */
+        uint32_t dataOffset;
+        uint32_t dataSize;
+    };
+
+#define WORLDFILE_NO_STRING 0xFFFFFFFF
+
+    /** Write every entity, and its full component state, out as a world snapshot. */
+    void SerializeWorld(const std::vector<std::shared_ptr<Entity> > & entities, std::ostream & stream);
+    /**
+     * Rebuild entities from a world snapshot held in memory, without running any scripts.
+     * Returns an empty list if the data is not a valid snapshot.
+     */
+    std::vector<std::shared_ptr<Entity> > DeserializeWorld(const char * data, size_t size, EntityFactory * pFactory);
+}
+
+#endif // ALPHA_WORLD_FILE_H
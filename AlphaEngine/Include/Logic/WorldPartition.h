@@ -0,0 +1,116 @@
+#ifndef ALPHA_WORLD_PARTITION_H
+#define ALPHA_WORLD_PARTITION_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Entities/EntityHandle.h"
+
+namespace alpha
+{
+    class Entity;
+    struct Vector3;
+
+    /** Integer coordinate of a cell on the world partition grid, the grid lies on the x/z plane */
+    struct WorldCellCoord
+    {
+        int x;
+        int z;
+
+        bool operator<(const WorldCellCoord & other) const
+        {
+            return (x != other.x) ? (x < other.x) : (z < other.z);
+        }
+        bool operator==(const WorldCellCoord & other) const
+        {
+            return x == other.x && z == other.z;
+        }
+    };
+
+    enum WorldCellState
+    {
+        /** Nothing from the cell is in the world */
+        WCS_UNLOADED = 0,
+        /** The cell snapshot is being read and instantiated on a worker thread */
+        WCS_LOADING,
+        /** The cells entities are built, and are being added to the world a few at a time */
+        WCS_COMMITTING,
+        /** Every entity in the cell is in the world */
+        WCS_LOADED,
+    };
+
+    /** A single streamable cell, its entities are stored in a world snapshot resource */
+    struct WorldCell
+    {
+        WorldCellCoord coord;
+        /** The world snapshot resource holding the cells entities */
+        std::string resource;
+        WorldCellState state;
+        /** Is the cell inside the load radius of the streaming focus */
+        bool wanted;
+        /** Entities built by the load task, waiting to be committed to the world */
+        std::vector<std::shared_ptr<Entity> > pending;
+        /** Number of pending entities already committed */
+        size_t committed;
+        /** Handles of every committed entity, used to unload the cell */
+        std::vector<EntityHandle> entities;
+    };
+
+    /**
+     * \brief Divides the world into a grid of square cells, which stream in and out around a focus point.
+     *
+     * The partition only tracks cell state and grid math, the logic system drives the actual
+     * loading, committing, and unloading of cells so it can keep each within a per frame budget.
+     * Cells are unloaded one cell further out than they are loaded, so a focus sitting on a cell
+     * border does not cause the same cell to load and unload every frame.
+     */
+    class WorldPartition
+    {
+    public:
+        WorldPartition(float cellSize, unsigned int loadRadius);
+
+        /** Register a cell, and the world snapshot resource that holds its entities */
+        void AddCell(int x, int z, const std::string & resource);
+        WorldCell * GetCell(const WorldCellCoord & coord);
+        bool Empty() const;
+
+        void SetCellSize(float cellSize);
+        /** Set the number of cells around the focus cell that are kept loaded */
+        void SetLoadRadius(unsigned int loadRadius);
+
+        /** Get the coordinate of the cell that contains the given position */
+        WorldCellCoord GetCellCoord(const Vector3 & position) const;
+
+        /**
+         * Move the streaming focus, and flag which cells are wanted.
+         * Fills toLoad with unloaded cells inside the load radius, nearest first,
+         * and toUnload with cells that have moved outside of the unload radius.
+         */
+        void UpdateFocus(const Vector3 & focus, std::vector<WorldCell *> & toLoad, std::vector<WorldCell *> & toUnload);
+
+    private:
+        float m_cellSize;
+        unsigned int m_loadRadius;
+        std::map<WorldCellCoord, WorldCell> m_cells;
+    };
+}
+
+#endif // ALPHA_WORLD_PARTITION_H
@@ -0,0 +1,66 @@
+#ifndef ALPHA_AABB_H
+#define ALPHA_AABB_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "Math/Vector3.h"
+
+namespace alpha
+{
+    struct Matrix;
+
+    /**
+     * \brief Axis aligned bounding box.
+     */
+    struct AABB
+    {
+        Vector3 min;
+        Vector3 max;
+
+        /** An empty box, at the origin */
+        AABB();
+        AABB(const Vector3 & vMin, const Vector3 & vMax);
+
+        Vector3 Center() const;
+        Vector3 Extents() const;
+        /** Surface area, used as the cost heuristic when building bounding volume trees */
+        float SurfaceArea() const;
+
+        /** Does this box fully contain the other box */
+        bool Contains(const AABB & other) const;
+        /** Do the two boxes touch or overlap */
+        bool Overlaps(const AABB & other) const;
+        /** Does the sphere touch or overlap this box */
+        bool Overlaps(const Vector3 & center, float radius) const;
+        /**
+         * Does the ray hit the box within maxDistance.
+         * invDirection is 1 / direction per axis, so it can be computed once per ray rather than once per box.
+         * On a hit, distance is set to the distance along the ray where it enters the box, or 0 if it starts inside.
+         */
+        bool Raycast(const Vector3 & origin, const Vector3 & invDirection, float maxDistance, float * distance) const;
+
+        /** Grow the box by margin on every side */
+        AABB Expand(float margin) const;
+        /** Return the box that bounds this box once it has been transformed */
+        AABB Transform(const Matrix & transform) const;
+
+        /** Return the smallest box that contains both boxes */
+        static AABB Merge(const AABB & left, const AABB & right);
+    };
+}
+
+#endif // ALPHA_AABB_H
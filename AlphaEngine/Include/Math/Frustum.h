@@ -0,0 +1,48 @@
+#ifndef ALPHA_FRUSTUM_H
+#define ALPHA_FRUSTUM_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "Math/Vector4.h"
+
+namespace alpha
+{
+    struct AABB;
+    struct Matrix;
+
+    /**
+     * \brief The six planes bounding a camera's view volume, used for culling.
+     */
+    struct Frustum
+    {
+        /** A frustum that contains everything */
+        Frustum();
+        /**
+         * Extract the planes from a combined view * projection matrix, in the engines row vector convention.
+         * The near plane is taken at clip z = -w, so the test stays conservative for either depth range.
+         */
+        explicit Frustum(const Matrix & viewProjection);
+
+        /** Does the box touch or lie inside the frustum, boxes near a corner may report a false positive */
+        bool Overlaps(const AABB & aabb) const;
+
+        /** Plane normals in xyz and distances in w, a point p is inside a plane when dot(p, xyz) + w >= 0 */
+        Vector4 planes[6];
+    };
+}
+
+#endif // ALPHA_FRUSTUM_H
@@ -45,6 +45,11 @@ namespace alpha
         static Matrix Rotate(const Quaternion & rotation);
         static Matrix Translate(const Vector3 & position);
         static Matrix Scale(const Vector3 & scale);
+        /**
+         * Build a full transform from its parts, equivalent to Rotate(rotation) * Scale(scale) * Translate(position),
+         * but without the matrix multiplies.
+         */
+        static Matrix Compose(const Vector3 & position, const Quaternion & rotation, const Vector3 & scale);
 
         static Matrix Projection(float fov, float aspect, float near, float far);
         static Matrix OrthoProjection(float width, float height, float near, float far);
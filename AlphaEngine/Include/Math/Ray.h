@@ -0,0 +1,47 @@
+#ifndef ALPHA_RAY_H
+#define ALPHA_RAY_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "Math/Vector3.h"
+
+namespace alpha
+{
+    /** A ray, or segment when maxDistance is finite, used for spatial queries. */
+    struct Ray
+    {
+        Ray() : maxDistance(0.f) { }
+        Ray(const Vector3 & o, const Vector3 & d, float max) : origin(o), direction(d), maxDistance(max) { }
+
+        Vector3 origin;
+        /** Normalized direction, distances reported for the ray are in the same units */
+        Vector3 direction;
+        float maxDistance;
+    };
+
+    /** A sphere, used for spatial queries. */
+    struct Sphere
+    {
+        Sphere() : radius(0.f) { }
+        Sphere(const Vector3 & c, float r) : center(c), radius(r) { }
+
+        Vector3 center;
+        float radius;
+    };
+}
+
+#endif // ALPHA_RAY_H
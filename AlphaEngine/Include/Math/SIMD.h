@@ -0,0 +1,31 @@
+#ifndef ALPHA_SIMD_H
+#define ALPHA_SIMD_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/**
+ * SIMD support detection.
+ * ALPHA_SIMD_SSE2 is defined when the target is guaranteed to support SSE2, which is every x86-64
+ * target, and 32 bit x86 targets built with SSE2 enabled.  Code using intrinsics must keep a scalar
+ * path for other targets.
+ */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define ALPHA_SIMD_SSE2
+#   include <emmintrin.h>
+#endif
+
+#endif // ALPHA_SIMD_H
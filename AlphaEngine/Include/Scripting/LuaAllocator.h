@@ -0,0 +1,109 @@
+#ifndef ALPHA_LUA_ALLOCATOR_H
+#define ALPHA_LUA_ALLOCATOR_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+struct lua_State;
+
+namespace alpha
+{
+    /**
+     * \brief The allocator behind a single lua state, with size class pools and memory accounting.
+     *
+     * Small blocks, which are nearly everything lua allocates, are carved out of chunks owned by the
+     * allocator and recycled through one free list per size class.  Larger blocks go to the system.
+     * A state is only ever used by one thread at a time, so none of this needs a lock, and scripts
+     * running side by side no longer contend on malloc.
+     *
+     * Every block is counted, so the memory a state is using can be read and capped.  When an
+     * allocation would go over the limit it fails, and lua raises a memory error in the script.
+     */
+    class LuaAllocator
+    {
+    public:
+        LuaAllocator();
+        /** Frees the chunks, the state using the allocator must already be closed */
+        ~LuaAllocator();
+
+        /** The lua_Alloc function, pUserData is the LuaAllocator */
+        static void * Allocate(void * pUserData, void * pBlock, size_t oldSize, size_t newSize);
+        /** Get the allocator a state was created with, null if it was not created with a LuaAllocator */
+        static LuaAllocator * Get(lua_State * pState);
+        /** Total bytes every allocator is holding from the system, chunks and large blocks */
+        static size_t GetReservedTotal();
+
+        /** Cap the bytes in use, 0 for no cap.  Only allocations that grow the usage can fail. */
+        void SetLimit(size_t limit);
+        size_t GetLimit() const;
+        /** Bytes lua currently has allocated */
+        size_t GetUsage() const;
+        /** Most bytes allocated at once since the last ResetPeak */
+        size_t GetPeak() const;
+        void ResetPeak();
+
+    private:
+        LuaAllocator(const LuaAllocator &);
+        LuaAllocator & operator=(const LuaAllocator &);
+
+        /** A recycled block, the link is kept in the block itself */
+        struct FreeBlock
+        {
+            FreeBlock * pNext;
+        };
+
+        /** Get the size class for a block, sk_classCount for blocks too large to pool */
+        static size_t GetClass(size_t size);
+
+        /** Allocate a block of the given size, null if the system is out of memory */
+        void * Alloc(size_t size);
+        void Free(void * pBlock, size_t size);
+        /** Take a block of the given class from its free list, or the current chunk */
+        void * AllocSmall(size_t sizeClass);
+        /**
+         * Keep a large block that had to shrink into a pooled size while the system was out of memory.
+         * It is cut down to the classes block size and joins the pool, and is freed with the chunks.
+         */
+        void * Adopt(void * pBlock, size_t oldSize, size_t sizeClass);
+
+        /** Size classes step up in multiples of this, which also keeps blocks aligned */
+        static const size_t sk_classSize;
+        static const size_t sk_classCount;
+        /** Bytes taken from the system at a time for small blocks */
+        static const size_t sk_chunkSize;
+
+        static std::atomic<size_t> s_reserved;
+
+        std::vector<FreeBlock *> m_freeLists;
+        std::vector<char *> m_chunks;
+        /** The unused end of the newest chunk */
+        char * m_pNext;
+        char * m_pEnd;
+        /** Large blocks taken into the pool by Adopt, and the bytes they hold */
+        std::vector<void *> m_adopted;
+        size_t m_adoptedBytes;
+
+        size_t m_usage;
+        size_t m_peak;
+        size_t m_limit;
+    };
+}
+
+#endif // ALPHA_LUA_ALLOCATOR_H
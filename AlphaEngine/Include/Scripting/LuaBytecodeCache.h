@@ -0,0 +1,71 @@
+#ifndef ALPHA_LUA_BYTECODE_CACHE_H
+#define ALPHA_LUA_BYTECODE_CACHE_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace alpha
+{
+    /**
+     * \brief Compiled lua chunks, keyed by a hash of their source text.
+     *
+     * Scripts check the cache before compiling, so each source is only parsed once per run.  When a
+     * directory is set, chunks are also written to disk, and later runs load them without parsing at all.
+     * Each file carries its key, length and a checksum of the bytecode, and is written to a temporary file
+     * that is then moved into place, so a torn or damaged file is ignored rather than handed to lua.
+     * Bytecode from a different lua build fails to load, the script then compiles its source and replaces it.
+     * Lua does not verify bytecode, so the directory must only ever be written by the engine.
+     */
+    class LuaBytecodeCache
+    {
+    public:
+        typedef std::vector<char> Bytecode;
+
+        /** Set the directory chunks are saved to and loaded from, creating it if needed.  Empty keeps chunks in memory only. */
+        static void SetDirectory(const std::string & directory);
+        /** Hash source text into a cache key */
+        static uint64_t Hash(const char * pSource, size_t size);
+        /** Find the chunk for a key, in memory first and then on disk, null if it has not been compiled yet */
+        static std::shared_ptr<const Bytecode> Find(uint64_t key);
+        /** Keep a compiled chunk in memory, and write it to the cache directory */
+        static void Store(uint64_t key, Bytecode bytecode);
+        /** Drop a chunk that failed to load */
+        static void Remove(uint64_t key);
+        /** Drop every chunk held in memory, chunks on disk are kept */
+        static void Clear();
+
+    private:
+        /** Path of the file holding the chunk for a key, empty if there is no cache directory */
+        static std::string GetFilePath(uint64_t key);
+        /** Read and verify the chunk file at path, false if it is missing or does not match its header */
+        static bool ReadChunk(const std::string & path, uint64_t key, Bytecode & bytecode);
+        /** Write a chunk file through a temporary file, called without holding the lock */
+        static void WriteChunk(const std::string & path, uint64_t key, const Bytecode & bytecode);
+
+        static std::mutex s_mutex;
+        static std::string s_directory;
+        static std::map<uint64_t, std::shared_ptr<const Bytecode> > s_chunks;
+    };
+}
+
+#endif // ALPHA_LUA_BYTECODE_CACHE_H
@@ -17,7 +17,10 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
 struct lua_State;
@@ -25,9 +28,19 @@ struct lua_State;
 namespace alpha
 {
     class Asset;
-    class LuaTable;
-    class LuaVar;
+    class LuaArena;
 
+    /**
+     * \brief Loads and runs data scripts, and converts their global tables to LuaVars.
+     *
+     * The lua state is borrowed from the LuaStatePool when the script is loaded.  Every script runs with
+     * its own global table as its _ENV, which falls back on the shared standard libraries, so globals
+     * set by one script are never seen by another script run on the same state.  Global tables are
+     * extracted into a LuaArena, which outlives the script and its lua state.
+     *
+     * The memory a script allocates in its state is counted by the states LuaAllocator, and can be capped
+     * while the script runs.
+     */
     class LuaScript
     {
     public:
@@ -37,24 +50,52 @@ namespace alpha
         void Add(std::shared_ptr<Asset> asset);
         void Load();
         void Run();
+        /**
+         * Return the lua state to the pool once all needed data has been pulled out of the script.
+         * Any LuaVar tables already built remain valid, the script can no longer be loaded or run.
+         */
+        void Close();
+        /** Check whether the script can still be loaded or run */
+        bool IsOpen() const;
 
-        /** Helper function for retrieving float var from script tables */
-        void GetTableFloatValue(std::shared_ptr<LuaTable> table, const std::string key, float * const out);
-        /** Helper function for retrieving std::string var from script tables */
-        void GetTableStringValue(std::shared_ptr<LuaTable> table, const std::string key, std::string * const out);
-        /** Helper function for retrieving boolean var from script tables */
-        void GetTableBoolValue(std::shared_ptr<LuaTable> table, const std::string key, bool * const out);
+        /** Cap the bytes the script can have allocated while it runs, 0 for no cap.  Going over fails the run. */
+        void SetMemoryLimit(size_t limit);
+        size_t GetMemoryLimit() const;
+        /** Bytes the script has allocated in its lua state since it was loaded, 0 if it is not open */
+        size_t GetMemoryUsage() const;
+        /** Most bytes the script had allocated at once, 0 if it is not open */
+        size_t GetPeakMemoryUsage() const;
 
     protected:
-        std::shared_ptr<LuaTable> GetGlobalTable(const std::string & key);
+        /** Extract a global table, and every table nested in it, into a flat arena.  Null if the global is not a table. */
+        std::shared_ptr<const LuaArena> GetGlobalTable(const std::string & key);
+        /** Check if a global variable is set, for optional script variables */
+        bool HasGlobal(const std::string & key);
 
     private:
-        std::shared_ptr<LuaVar> BuildTable(std::string table_name, int index);
-        std::shared_ptr<LuaVar> BuildString(std::string name, std::string value);
-        std::shared_ptr<LuaVar> BuildNumber(std::string name, double value);
-        std::shared_ptr<LuaVar> BuildBoolean(std::string name, bool value);
+        /** Borrow a lua state and create the scripts global table, the first time the script is loaded */
+        bool Open();
+        /**
+         * Push the chunk for a script source onto the stack, loading compiled bytecode from the
+         * LuaBytecodeCache when it has it, and compiling and caching the source when it does not.
+         */
+        bool LoadChunk(const char * pSource, size_t size);
+        /** Push the scripts own global variable key onto the stack, ignoring the shared libraries */
+        int PushGlobal(const std::string & key);
 
+        /** Copy the pairs of the table at stack index into the arena, as the pairs of the table value at slot */
+        void BuildTable(LuaArena & arena, uint32_t slot, int index, std::map<std::string, uint32_t> & interned);
+        /** Get the offset of a string in the arenas string block, adding it the first time it is seen */
+        static uint32_t Intern(LuaArena & arena, const char * pString, size_t length, std::map<std::string, uint32_t> & interned);
+
+        /** Borrowed from the LuaStatePool, null until the script is loaded and after it is closed */
         lua_State *m_pLuaState;
+        /** Registry reference to the scripts global table */
+        int m_envRef;
+        bool m_closed;
+        size_t m_memoryLimit;
+        /** States allocator usage when the script borrowed it, what earlier scripts and the libraries left behind */
+        size_t m_baseUsage;
         std::vector<std::shared_ptr<Asset> > m_scriptAssets;
     };
 }
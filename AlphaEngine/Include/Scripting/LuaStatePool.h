@@ -0,0 +1,56 @@
+#ifndef ALPHA_LUA_STATE_POOL_H
+#define ALPHA_LUA_STATE_POOL_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <mutex>
+#include <vector>
+
+struct lua_State;
+
+namespace alpha
+{
+    /**
+     * \brief Lua states with the standard libraries already open, shared by every script.
+     *
+     * Creating a state and registering the libraries costs far more than loading a small data script,
+     * so scripts borrow an idle state instead, and give it back when they close.  Each state is only
+     * ever used by the one script holding it, so scripts can be loaded on any thread.  Every state
+     * allocates through its own LuaAllocator.
+     */
+    class LuaStatePool
+    {
+    public:
+        /** Take an idle state, or create a new one if every state is in use.  Null if a state could not be created. */
+        static lua_State * Acquire();
+        /** Give a state back, its stack must be empty.  States beyond the idle limit are closed. */
+        static void Release(lua_State * pState);
+        /** Close every idle state */
+        static void Clear();
+
+    private:
+        /** Close a state and delete its allocator */
+        static void Close(lua_State * pState);
+
+        static std::mutex s_mutex;
+        static std::vector<lua_State *> s_idle;
+        /** Most idle states kept open, enough for one script per worker thread */
+        static const size_t sk_maxIdle;
+    };
+}
+
+#endif // ALPHA_LUA_STATE_POOL_H
@@ -17,78 +17,101 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
-#include <map>
-#include <memory>
+#include <cstdint>
+#include <string>
+#include <vector>
 
 namespace alpha
 {
     typedef enum LUA_VARTYPE
     {
-        VT_STATIC = 1,
-        VT_TABLE = 2,
+        VT_NIL = 0,
+        VT_NUMBER,
+        VT_BOOLEAN,
+        VT_STRING,
+        VT_TABLE,
     } LUA_VARTYPE;
 
-    /**
-     * Base LUA variable class, stores the variable name
-     */
-    class LuaVar
-    {
-    public:
-        explicit LuaVar(const std::string & name)
-            : m_name(name)
-        { }
-        virtual ~LuaVar() { }
-
-        virtual LUA_VARTYPE GetVarType() const = 0;
-
-    private:
-        std::string m_name;
-    };
+    class LuaArena;
 
     /**
-     * LuaVar used to represent the contents of a LUA table.
-     * Maintains a key/value mapping of variables in the LUA table.
+     * A read only view of a single value pulled out of a LUA script, a number, boolean, string, or table.
+     * Views are two words and can be copied freely, they stay valid for as long as their arena does.
+     * Missing values are nil, so lookups chain safely, var.Get("transform").Get("position").
      */
-    class LuaTable : public LuaVar
+    class LuaVar
     {
     public:
-        explicit LuaTable(const std::string & name);
-        virtual ~LuaTable();
-
-        virtual LUA_VARTYPE GetVarType() const;
-
-        void Push(std::string key, std::shared_ptr<LuaVar> value);
-        std::shared_ptr<LuaVar> Get(const std::string & key) const;
-        const std::map<std::string, std::shared_ptr<LuaVar> > & GetAll() const;
+        /** A nil value */
+        LuaVar();
+        LuaVar(const LuaArena * pArena, uint32_t index);
+
+        LUA_VARTYPE GetVarType() const;
+        bool IsNil() const;
+        bool IsTable() const;
+
+        /** Get the value as a number, boolean, or string, or the fallback if it holds another type */
+        double GetNumber(double fallback = 0.0) const;
+        bool GetBool(bool fallback = false) const;
+        const char * GetString(const char * fallback = "") const;
+
+        /** Number of key/value pairs in a table, 0 for any other type */
+        size_t Size() const;
+        /** Get the key, or value, of a tables pair at index, pairs are sorted by key */
+        const char * GetKey(size_t index) const;
+        LuaVar GetValue(size_t index) const;
+        /** Find a tables value by key, nil if the key is missing or this is not a table (shallow search) */
+        LuaVar Get(const char * key) const;
+        LuaVar Get(const std::string & key) const;
 
     private:
-        std::map<std::string, std::shared_ptr<LuaVar> > m_vars;
+        const LuaArena * m_pArena;
+        uint32_t m_index;
     };
 
     /**
-     * LuaVar used to encapsulate a static variable type.
-     * and presents it as its C/C++ counterpart.
-     * LUA_TSTRING = std::string
-     * LUA_TNUMBER = double,
-     * LUA_TBOOLEAN = bool,
-     * TODO: could possibly represent functions and nil values as well ... needs testing
+     * \brief A LUA table extracted from a script, stored flat.
+     *
+     * Every value in the table, and in every table nested inside it, is a tagged value in one contiguous
+     * array.  The pairs of each table are a run of that array sorted by key, and every key and string is
+     * interned once into a single block of characters.  However deep the table, it costs two allocations.
      */
-    template <typename T>
-    class LuaStatic : public LuaVar
+    class LuaArena
     {
     public:
-        explicit LuaStatic(const std::string & name, T value)
-            : LuaVar(name)
-            , m_value(value)
-        { }
-        virtual ~LuaStatic() { }
-
-        virtual LUA_VARTYPE GetVarType() const { return VT_STATIC; }
-
-        T GetValue() const { return m_value; };
+        /** The extracted table itself */
+        LuaVar GetRoot() const;
 
     private:
-        T m_value;
+        friend class LuaVar;
+        friend class LuaScript;
+
+        /** A tables pairs, a run of the value array */
+        struct Range
+        {
+            uint32_t first;
+            uint32_t count;
+        };
+
+        struct Value
+        {
+            LUA_VARTYPE type;
+            /** Offset of the key in the string block */
+            uint32_t key;
+            union
+            {
+                double number;
+                bool boolean;
+                /** Offset of the string in the string block */
+                uint32_t string;
+                Range pairs;
+            };
+        };
+
+        /** The root table is the first value */
+        std::vector<Value> m_values;
+        /** Null terminated keys and strings */
+        std::vector<char> m_strings;
     };
 }
 
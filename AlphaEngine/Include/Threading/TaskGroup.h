@@ -0,0 +1,78 @@
+#ifndef ALPHA_TASK_GROUP_H
+#define ALPHA_TASK_GROUP_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace alpha
+{
+    class AEvent;
+    class ATask;
+
+    /**
+     * \brief A set of tasks that can be waited on.
+     *
+     * Tasks published to the thread pool only reach a worker once the event that carries them has been
+     * delivered, which may be well after the publisher wants their results.  A group hands its tasks out one
+     * at a time to whoever asks first, a worker running a Task_RunGroup or a thread calling Wait, so waiting
+     * never depends on the pool having picked the work up.  Wait runs anything left unclaimed on the calling
+     * thread, then blocks until the tasks claimed by other threads are done.
+     *
+     * A group can follow another group, none of its tasks start until every task of the earlier group is done.
+     */
+    class TaskGroup
+    {
+    public:
+        /** The group takes ownership of the tasks */
+        explicit TaskGroup(std::vector<ATask *> tasks, std::shared_ptr<TaskGroup> pAfter = nullptr);
+        ~TaskGroup();
+
+        /**
+         * Make a group, and publish a Task_RunGroup for each of its tasks so the thread pool can help run them.
+         * Returns nullptr, publishing nothing, if there are no tasks.
+         */
+        static std::shared_ptr<TaskGroup> Publish(std::vector<ATask *> tasks, std::function<void(AEvent *)> delPublishEvent,
+                                                  std::shared_ptr<TaskGroup> pAfter = nullptr);
+
+        /** Claim and run tasks until none are left unclaimed.  Safe to call from any number of threads. */
+        void Run();
+        /** Run any unclaimed tasks on this thread, then block until every task in the group is done */
+        void Wait();
+        /** Has every task in the group finished */
+        bool IsDone() const;
+        size_t Size() const;
+
+    private:
+        // non-copyable
+        TaskGroup(const TaskGroup&);
+        TaskGroup & operator=(const TaskGroup&);
+
+        std::vector<ATask *> m_tasks;
+        /** Group that must be done before any task of this group runs */
+        std::shared_ptr<TaskGroup> m_pAfter;
+        /** Index of the next unclaimed task */
+        std::atomic<size_t> m_next;
+        /** Number of tasks that have finished */
+        std::atomic<size_t> m_finished;
+    };
+}
+
+#endif // ALPHA_TASK_GROUP_H
@@ -1,5 +1,5 @@
-#ifndef ALPHA_TASK_UPDATE_ENTITY_H
-#define ALPHA_TASK_UPDATE_ENTITY_H
+#ifndef ALPHA_TASK_RUN_GROUP_H
+#define ALPHA_TASK_RUN_GROUP_H
 
 /**
 Copyright 2014-2015 Jason R. Wendlandt
@@ -17,28 +17,27 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
-#include <functional>
 #include <memory>
 
 #include "Threading/ATask.h"
 
 namespace alpha
 {
-    class AEvent;
-    class Entity;
+    class TaskGroup;
 
-    class Task_UpdateEntity : public ATask
+    /**
+     * Task_RunGroup
+     * Lends a worker thread to a task group, running the groups tasks until none are left unclaimed.
+     */
+    class Task_RunGroup : public ATask
     {
     public:
-        Task_UpdateEntity(float fCurrentTime, float fElapsedTime, std::shared_ptr<Entity> pEntity, std::function<void(AEvent *)> delPublishEvent);
+        explicit Task_RunGroup(std::shared_ptr<TaskGroup> pGroup);
         bool VExecute();
 
     private:
-        float m_fCurrentTime;
-        float m_fElapsedTime;
-        std::shared_ptr<Entity> m_pEntity;
-        std::function<void(AEvent *)> m_delPublishEvent;
+        std::shared_ptr<TaskGroup> m_pGroup;
     };
 }
 
-#endif // ALPHA_TASK_UPDATE_ENTITY_H
\ No newline at end of file
+#endif // ALPHA_TASK_RUN_GROUP_H
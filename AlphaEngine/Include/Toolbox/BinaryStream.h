@@ -0,0 +1,126 @@
+#ifndef BINARY_STREAM_H
+#define BINARY_STREAM_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace alpha
+{
+    /**
+     * \brief Appends plain data to a growing byte buffer.
+     *
+     * Only use Write<T> with plain data types (numbers, and structs made of them),
+     * values are written as raw bytes in native byte order.
+     */
+    class BinaryWriter
+    {
+    public:
+        BinaryWriter() { }
+
+        void Write(const void * data, size_t size)
+        {
+            const char * bytes = static_cast<const char *>(data);
+            m_buffer.insert(m_buffer.end(), bytes, bytes + size);
+        }
+
+        template<typename T>
+        void Write(const T & value)
+        {
+            this->Write(&value, sizeof(T));
+        }
+
+        /** Write a length prefixed string */
+        void WriteString(const std::string & value)
+        {
+            this->Write(static_cast<uint32_t>(value.size()));
+            this->Write(value.data(), value.size());
+        }
+
+        const std::vector<char> & GetBuffer() const { return m_buffer; }
+        size_t Size() const { return m_buffer.size(); }
+
+    private:
+        std::vector<char> m_buffer;
+    };
+
+    /**
+     * \brief Reads plain data back out of a byte buffer it does not own.
+     *
+     * Every read is bounds checked, once a read fails the reader stays failed
+     * and every following read also fails, so callers can check once at the end.
+     */
+    class BinaryReader
+    {
+    public:
+        BinaryReader(const char * data, size_t size)
+            : m_data(data)
+            , m_size(size)
+            , m_position(0)
+            , m_failed(false)
+        { }
+
+        bool Read(void * out, size_t size)
+        {
+            if (m_failed || size > m_size - m_position)
+            {
+                m_failed = true;
+                return false;
+            }
+            memcpy(out, m_data + m_position, size);
+            m_position += size;
+            return true;
+        }
+
+        template<typename T>
+        bool Read(T & value)
+        {
+            return this->Read(&value, sizeof(T));
+        }
+
+        /** Read a length prefixed string */
+        bool ReadString(std::string & value)
+        {
+            uint32_t length = 0;
+            if (!this->Read(length) || length > m_size - m_position)
+            {
+                m_failed = true;
+                return false;
+            }
+            value.assign(m_data + m_position, length);
+            m_position += length;
+            return true;
+        }
+
+        /** Has every read so far succeeded */
+        bool IsValid() const { return !m_failed; }
+        size_t GetPosition() const { return m_position; }
+        /** Number of bytes left to read */
+        size_t GetRemaining() const { return m_size - m_position; }
+
+    private:
+        const char * m_data;
+        size_t m_size;
+        size_t m_position;
+        bool m_failed;
+    };
+}
+
+#endif // BINARY_STREAM_H
@@ -0,0 +1,449 @@
+#ifndef DYNAMIC_AABB_TREE_H
+#define DYNAMIC_AABB_TREE_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "Math/AABB.h"
+#include "Math/Frustum.h"
+
+namespace alpha
+{
+    /**
+     * \brief A bounding volume hierarchy of axis aligned boxes that can be updated incrementally.
+     *
+     * Every proxy is stored with a fat box, grown by a margin, so small movements do not touch the tree at all.
+     * When a proxy leaves its fat box it is removed and re-inserted, and the tree is kept balanced with rotations.
+     * Each proxy carries a value of type T, which is what queries report back.
+     */
+    template<typename T>
+    class DynamicAABBTree
+    {
+    public:
+        static const int sk_nullNode = -1;
+
+        explicit DynamicAABBTree(float margin = 0.1f)
+            : m_root(sk_nullNode)
+            , m_freeList(sk_nullNode)
+            , m_margin(margin)
+        { }
+
+        /** Add a proxy with the given tight bounds, returns the proxy id */
+        int CreateProxy(const AABB & aabb, const T & value)
+        {
+            int proxy = this->AllocateNode();
+            m_nodes[proxy].aabb = aabb.Expand(m_margin);
+            m_nodes[proxy].value = value;
+            m_nodes[proxy].height = 0;
+            this->InsertLeaf(proxy);
+            return proxy;
+        }
+
+        /** Remove a proxy from the tree */
+        void DestroyProxy(int proxy)
+        {
+            this->RemoveLeaf(proxy);
+            this->FreeNode(proxy);
+        }
+
+        /**
+         * Update the bounds of a proxy.
+         * Returns true if the proxy had to be re-inserted, false if it still fits in its fat box.
+         */
+        bool MoveProxy(int proxy, const AABB & aabb)
+        {
+            if (m_nodes[proxy].aabb.Contains(aabb))
+            {
+                return false;
+            }
+
+            this->RemoveLeaf(proxy);
+            m_nodes[proxy].aabb = aabb.Expand(m_margin);
+            this->InsertLeaf(proxy);
+            return true;
+        }
+
+        const T & GetValue(int proxy) const { return m_nodes[proxy].value; }
+        const AABB & GetFatAABB(int proxy) const { return m_nodes[proxy].aabb; }
+
+        /** Call visit(value) for every proxy whose fat box overlaps the box */
+        template<typename Visitor>
+        void Query(const AABB & aabb, Visitor visit) const
+        {
+            this->Traverse([&aabb](const AABB & node) { return node.Overlaps(aabb); }, visit);
+        }
+
+        /** Call visit(value) for every proxy whose fat box touches the sphere */
+        template<typename Visitor>
+        void Query(const Vector3 & center, float radius, Visitor visit) const
+        {
+            this->Traverse([&center, radius](const AABB & node) { return node.Overlaps(center, radius); }, visit);
+        }
+
+        /** Call visit(value) for every proxy whose fat box touches the frustum */
+        template<typename Visitor>
+        void Query(const Frustum & frustum, Visitor visit) const
+        {
+            this->Traverse([&frustum](const AABB & node) { return frustum.Overlaps(node); }, visit);
+        }
+
+        /** Call visit(value, distance) for every proxy whose fat box is hit by the ray within maxDistance */
+        template<typename Visitor>
+        void Raycast(const Vector3 & origin, const Vector3 & direction, float maxDistance, Visitor visit) const
+        {
+            const float inf = std::numeric_limits<float>::infinity();
+            Vector3 inv(direction.x != 0.f ? 1.f / direction.x : inf,
+                        direction.y != 0.f ? 1.f / direction.y : inf,
+                        direction.z != 0.f ? 1.f / direction.z : inf);
+
+            if (m_root == sk_nullNode)
+            {
+                return;
+            }
+
+            // each query keeps its own stack, so queries can run concurrently or from inside a visitor
+            std::vector<int> stack;
+            stack.reserve(this->GetHeight());
+            stack.push_back(m_root);
+            while (!stack.empty())
+            {
+                int index = stack.back();
+                stack.pop_back();
+
+                const Node & node = m_nodes[index];
+                float distance = 0.f;
+                if (!node.aabb.Raycast(origin, inv, maxDistance, &distance))
+                {
+                    continue;
+                }
+
+                if (node.IsLeaf())
+                {
+                    visit(node.value, distance);
+                }
+                else
+                {
+                    stack.push_back(node.child1);
+                    stack.push_back(node.child2);
+                }
+            }
+        }
+
+        /** Number of levels in the tree, 0 if empty */
+        int GetHeight() const { return m_root == sk_nullNode ? 0 : m_nodes[m_root].height + 1; }
+
+    private:
+        struct Node
+        {
+            bool IsLeaf() const { return child1 == sk_nullNode; }
+
+            AABB aabb;
+            T value;
+            /** Parent for nodes in the tree, next free node for nodes in the free list */
+            int parent;
+            int child1;
+            int child2;
+            /** Leaves are 0, free nodes are -1 */
+            int height;
+        };
+
+        template<typename Test, typename Visitor>
+        void Traverse(Test test, Visitor visit) const
+        {
+            if (m_root == sk_nullNode)
+            {
+                return;
+            }
+
+            // each query keeps its own stack, so queries can run concurrently or from inside a visitor.
+            // visiting both children of every node keeps the stack within the height of the tree.
+            std::vector<int> stack;
+            stack.reserve(this->GetHeight());
+            stack.push_back(m_root);
+            while (!stack.empty())
+            {
+                int index = stack.back();
+                stack.pop_back();
+
+                const Node & node = m_nodes[index];
+                if (!test(node.aabb))
+                {
+                    continue;
+                }
+
+                if (node.IsLeaf())
+                {
+                    visit(node.value);
+                }
+                else
+                {
+                    stack.push_back(node.child1);
+                    stack.push_back(node.child2);
+                }
+            }
+        }
+
+        int AllocateNode()
+        {
+            if (m_freeList == sk_nullNode)
+            {
+                m_nodes.push_back(Node());
+                m_nodes.back().parent = sk_nullNode;
+                m_freeList = static_cast<int>(m_nodes.size() - 1);
+            }
+
+            int index = m_freeList;
+            Node & node = m_nodes[index];
+            m_freeList = node.parent;
+            node.parent = sk_nullNode;
+            node.child1 = sk_nullNode;
+            node.child2 = sk_nullNode;
+            node.height = 0;
+            return index;
+        }
+
+        void FreeNode(int index)
+        {
+            m_nodes[index].parent = m_freeList;
+            m_nodes[index].height = -1;
+            m_freeList = index;
+        }
+
+        void InsertLeaf(int leaf)
+        {
+            if (m_root == sk_nullNode)
+            {
+                m_root = leaf;
+                m_nodes[leaf].parent = sk_nullNode;
+                return;
+            }
+
+            // find the best sibling, using the surface area of the merged boxes as the cost
+            AABB leaf_aabb = m_nodes[leaf].aabb;
+            int index = m_root;
+            while (!m_nodes[index].IsLeaf())
+            {
+                const Node & node = m_nodes[index];
+                float area = node.aabb.SurfaceArea();
+                float combined_area = AABB::Merge(node.aabb, leaf_aabb).SurfaceArea();
+
+                // cost of making a new parent for this node and the new leaf
+                float cost = 2.f * combined_area;
+                // minimum cost of pushing the leaf further down the tree
+                float inheritance_cost = 2.f * (combined_area - area);
+
+                float cost1 = this->DescendCost(node.child1, leaf_aabb) + inheritance_cost;
+                float cost2 = this->DescendCost(node.child2, leaf_aabb) + inheritance_cost;
+
+                if (cost < cost1 && cost < cost2)
+                {
+                    break;
+                }
+                index = (cost1 < cost2) ? node.child1 : node.child2;
+            }
+            int sibling = index;
+
+            // create a new parent for the sibling and the leaf
+            int old_parent = m_nodes[sibling].parent;
+            int new_parent = this->AllocateNode();
+            m_nodes[new_parent].parent = old_parent;
+            m_nodes[new_parent].aabb = AABB::Merge(leaf_aabb, m_nodes[sibling].aabb);
+            m_nodes[new_parent].height = m_nodes[sibling].height + 1;
+            m_nodes[new_parent].child1 = sibling;
+            m_nodes[new_parent].child2 = leaf;
+            m_nodes[sibling].parent = new_parent;
+            m_nodes[leaf].parent = new_parent;
+
+            if (old_parent != sk_nullNode)
+            {
+                if (m_nodes[old_parent].child1 == sibling)
+                {
+                    m_nodes[old_parent].child1 = new_parent;
+                }
+                else
+                {
+                    m_nodes[old_parent].child2 = new_parent;
+                }
+            }
+            else
+            {
+                m_root = new_parent;
+            }
+
+            this->Refit(m_nodes[leaf].parent);
+        }
+
+        void RemoveLeaf(int leaf)
+        {
+            if (leaf == m_root)
+            {
+                m_root = sk_nullNode;
+                return;
+            }
+
+            int parent = m_nodes[leaf].parent;
+            int grand_parent = m_nodes[parent].parent;
+            int sibling = (m_nodes[parent].child1 == leaf) ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+            if (grand_parent != sk_nullNode)
+            {
+                // the sibling takes the parents place
+                if (m_nodes[grand_parent].child1 == parent)
+                {
+                    m_nodes[grand_parent].child1 = sibling;
+                }
+                else
+                {
+                    m_nodes[grand_parent].child2 = sibling;
+                }
+                m_nodes[sibling].parent = grand_parent;
+                this->FreeNode(parent);
+
+                this->Refit(grand_parent);
+            }
+            else
+            {
+                m_root = sibling;
+                m_nodes[sibling].parent = sk_nullNode;
+                this->FreeNode(parent);
+            }
+        }
+
+        float DescendCost(int index, const AABB & leaf_aabb) const
+        {
+            const Node & node = m_nodes[index];
+            AABB merged = AABB::Merge(leaf_aabb, node.aabb);
+            if (node.IsLeaf())
+            {
+                return merged.SurfaceArea();
+            }
+            return merged.SurfaceArea() - node.aabb.SurfaceArea();
+        }
+
+        /** Walk from index to the root, balancing and refitting boxes and heights */
+        void Refit(int index)
+        {
+            while (index != sk_nullNode)
+            {
+                index = this->Balance(index);
+
+                Node & node = m_nodes[index];
+                node.height = 1 + std::max(m_nodes[node.child1].height, m_nodes[node.child2].height);
+                node.aabb = AABB::Merge(m_nodes[node.child1].aabb, m_nodes[node.child2].aabb);
+
+                index = node.parent;
+            }
+        }
+
+        /** Rotate the subtree at a if it is imbalanced, returns the new root of the subtree */
+        int Balance(int a)
+        {
+            Node & A = m_nodes[a];
+            if (A.IsLeaf() || A.height < 2)
+            {
+                return a;
+            }
+
+            int b = A.child1;
+            int c = A.child2;
+            int balance = m_nodes[c].height - m_nodes[b].height;
+
+            if (balance > 1)
+            {
+                return this->Rotate(a, c, b);
+            }
+            if (balance < -1)
+            {
+                return this->Rotate(a, b, c);
+            }
+            return a;
+        }
+
+        /** Promote the taller child up in place of a, other is the shorter child of a */
+        int Rotate(int a, int up, int other)
+        {
+            Node & A = m_nodes[a];
+            Node & U = m_nodes[up];
+            int f = U.child1;
+            int g = U.child2;
+
+            // swap a and up
+            U.child1 = a;
+            U.parent = A.parent;
+            A.parent = up;
+
+            if (U.parent != sk_nullNode)
+            {
+                if (m_nodes[U.parent].child1 == a)
+                {
+                    m_nodes[U.parent].child1 = up;
+                }
+                else
+                {
+                    m_nodes[U.parent].child2 = up;
+                }
+            }
+            else
+            {
+                m_root = up;
+            }
+
+            // keep the taller grandchild under up, and hand the shorter one to a
+            int keep = f;
+            int give = g;
+            if (m_nodes[f].height < m_nodes[g].height)
+            {
+                keep = g;
+                give = f;
+            }
+
+            U.child2 = keep;
+            if (A.child1 == up)
+            {
+                A.child1 = give;
+            }
+            else
+            {
+                A.child2 = give;
+            }
+            m_nodes[give].parent = a;
+
+            A.aabb = AABB::Merge(m_nodes[other].aabb, m_nodes[give].aabb);
+            A.height = 1 + std::max(m_nodes[other].height, m_nodes[give].height);
+            U.aabb = AABB::Merge(A.aabb, m_nodes[keep].aabb);
+            U.height = 1 + std::max(A.height, m_nodes[keep].height);
+
+            return up;
+        }
+
+        // non-copyable
+        DynamicAABBTree(const DynamicAABBTree&);
+        DynamicAABBTree & operator=(const DynamicAABBTree&);
+
+        std::vector<Node> m_nodes;
+        int m_root;
+        int m_freeList;
+        /** Margin added to each side of a proxy box */
+        float m_margin;
+    };
+}
+
+#endif // DYNAMIC_AABB_TREE_H
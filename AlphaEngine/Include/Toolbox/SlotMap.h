@@ -0,0 +1,196 @@
+#ifndef SLOT_MAP_H
+#define SLOT_MAP_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace alpha
+{
+    /**
+     * \brief Dense storage with stable, generation checked handles.
+     *
+     * Values are kept packed in a single array, so iterating them is a linear walk.  Handles index
+     * into an indirection table of slots, each slot records where its value lives in the dense array
+     * and a generation that is bumped when the value is removed, so stale handles are detected rather
+     * than silently pointing at whatever reused the slot.
+     *
+     * Handle must be a type with uint32_t index and generation members.  A generation of 0 is never
+     * handed out, so a default constructed handle is always invalid.
+     */
+    template<typename T, typename Handle>
+    class SlotMap
+    {
+    public:
+        typedef typename std::vector<T>::iterator iterator;
+        typedef typename std::vector<T>::const_iterator const_iterator;
+
+        SlotMap() { }
+
+        /** Add a value, returning the handle that refers to it */
+        Handle Insert(T value)
+        {
+            uint32_t slot_index;
+            if (!m_freeSlots.empty())
+            {
+                slot_index = m_freeSlots.back();
+                m_freeSlots.pop_back();
+            }
+            else
+            {
+                slot_index = static_cast<uint32_t>(m_slots.size());
+                m_slots.push_back(Slot());
+            }
+
+            Slot & slot = m_slots[slot_index];
+            slot.dense_index = static_cast<uint32_t>(m_values.size());
+
+            m_values.push_back(std::move(value));
+            m_valueSlots.push_back(slot_index);
+
+            Handle handle;
+            handle.index = slot_index;
+            handle.generation = slot.generation;
+            return handle;
+        }
+
+        /** Remove the value the handle refers to, returns false if the handle is stale */
+        bool Remove(const Handle & handle)
+        {
+            if (!this->Contains(handle))
+            {
+                return false;
+            }
+
+            Slot & slot = m_slots[handle.index];
+            uint32_t dense_index = slot.dense_index;
+            uint32_t last_index = static_cast<uint32_t>(m_values.size() - 1);
+
+            // swap the last value into the hole, so the values stay packed
+            if (dense_index != last_index)
+            {
+                m_values[dense_index] = std::move(m_values[last_index]);
+                m_valueSlots[dense_index] = m_valueSlots[last_index];
+                m_slots[m_valueSlots[dense_index]].dense_index = dense_index;
+            }
+            m_values.pop_back();
+            m_valueSlots.pop_back();
+
+            // invalidate every outstanding handle to this slot, skipping the reserved 0 generation
+            if (++slot.generation == 0)
+            {
+                slot.generation = 1;
+            }
+            m_freeSlots.push_back(handle.index);
+            return true;
+        }
+
+        /**
+         * Give the value a new handle, leaving it where it is.  Every outstanding handle to it becomes stale,
+         * returns a default handle if the given handle already was.
+         */
+        Handle Reissue(const Handle & handle)
+        {
+            if (!this->Contains(handle))
+            {
+                return Handle();
+            }
+
+            Slot & slot = m_slots[handle.index];
+            if (++slot.generation == 0)
+            {
+                slot.generation = 1;
+            }
+
+            Handle reissued;
+            reissued.index = handle.index;
+            reissued.generation = slot.generation;
+            return reissued;
+        }
+
+        /** Check that the handle still refers to a value */
+        bool Contains(const Handle & handle) const
+        {
+            return handle.index < m_slots.size() && m_slots[handle.index].generation == handle.generation;
+        }
+
+        /** Get the value the handle refers to, or nullptr if the handle is stale */
+        T * Get(const Handle & handle)
+        {
+            return this->Contains(handle) ? &m_values[m_slots[handle.index].dense_index] : nullptr;
+        }
+        const T * Get(const Handle & handle) const
+        {
+            return this->Contains(handle) ? &m_values[m_slots[handle.index].dense_index] : nullptr;
+        }
+
+        /** Get the handle for the value stored at the given position in the dense array */
+        Handle GetHandleAt(size_t dense_index) const
+        {
+            Handle handle;
+            handle.index = m_valueSlots[dense_index];
+            handle.generation = m_slots[handle.index].generation;
+            return handle;
+        }
+
+        size_t Size() const { return m_values.size(); }
+        bool Empty() const { return m_values.empty(); }
+
+        /** Remove every value, all outstanding handles become stale */
+        void Clear()
+        {
+            while (!m_values.empty())
+            {
+                this->Remove(this->GetHandleAt(m_values.size() - 1));
+            }
+        }
+
+        /** Iterate over the packed values, order is not stable across removals */
+        iterator begin() { return m_values.begin(); }
+        iterator end() { return m_values.end(); }
+        const_iterator begin() const { return m_values.begin(); }
+        const_iterator end() const { return m_values.end(); }
+
+    private:
+        struct Slot
+        {
+            Slot() : dense_index(0), generation(1) { }
+
+            /** Position of the value in the dense array, only meaningful while the slot is in use */
+            uint32_t dense_index;
+            /** Bumped every time the slot's value is removed, or given a new handle */
+            uint32_t generation;
+        };
+
+        // non-copyable
+        SlotMap(const SlotMap&);
+        SlotMap & operator=(const SlotMap&);
+
+        /** Indirection table, indexed by handle index */
+        std::vector<Slot> m_slots;
+        /** Slots that are free to be reused */
+        std::vector<uint32_t> m_freeSlots;
+        /** Packed values */
+        std::vector<T> m_values;
+        /** The slot that owns each packed value, used to fix up slots when values are moved */
+        std::vector<uint32_t> m_valueSlots;
+    };
+}
+
+#endif // SLOT_MAP_H
@@ -21,6 +21,8 @@ limitations under the License.
 
 namespace alpha
 {
+    class ParticleEmitter;
+
     class GeometryPass : public ARenderPass
     {
     public:
@@ -32,6 +34,9 @@ namespace alpha
 
         virtual void VRender(std::shared_ptr<Camera> pCamera, std::vector<RenderSet *> render_sets, std::vector<Light *> lights);
 
+        /** Draw every emitters particles into the gbuffer, one instanced draw per emitter */
+        void RenderParticles(std::shared_ptr<Camera> pCamera, std::vector<ParticleEmitter *> emitters);
+
         GLuint GetGBufferTexture(GBUFFER_TYPE texture_type);
 
     private:
@@ -49,6 +54,17 @@ namespace alpha
         GLuint m_gBufferTextures[GBUFFER_TEXTURE_COUNT];
         /** GL depth render buffer object */
         GLuint m_rboDepth;
+
+        /** Particle billboard vertex shader asset, particles share the deferred pixel shader */
+        std::shared_ptr<Asset> m_vsParticleShader;
+        /** GL particle shader program */
+        GLuint m_particleProgram;
+        /** Vertex array binding the quad corners, and the per particle instance data */
+        GLuint m_particleVertexAttribute;
+        /** The four corners of a particle quad */
+        GLuint m_particleQuadBuffer;
+        /** Per particle position and size, refilled for every emitter */
+        GLuint m_particleInstanceBuffer;
     };
 }
 
@@ -37,6 +37,7 @@ namespace alpha
     class Camera;
     class AssetSystem;
     class Light;
+    class ParticleEmitter;
 
     class GraphicsRenderer : public IRenderer
     {
@@ -50,7 +51,10 @@ namespace alpha
 
         /** PreRender takes a list of data that will be rendered, and preps it rendering. */
         void PreRender(RenderSet * renderSet);
-        void Render(std::shared_ptr<Camera> pCamera, std::vector<RenderSet *> renderables, std::vector<Light *> lights);
+        /** Release the buffers PreRender created for the render set. */
+        void Release(RenderSet * renderSet);
+        void Render(std::shared_ptr<Camera> pCamera, std::vector<RenderSet *> renderables, std::vector<Light *> lights,
+                    std::vector<ParticleEmitter *> particles);
 
     private:
         /** Initializes the OpenGL device with SDL/GLEW */
@@ -32,6 +32,13 @@ namespace alpha
         Vector3 normal;
     };
 
+    /** Up to four bones a skinned vertex follows, weights sum to one */
+    struct VertexWeights
+    {
+        unsigned char bones[4];
+        float weights[4];
+    };
+
     typedef struct PointLight
     {
         Vector4 position;
@@ -66,16 +73,20 @@ namespace alpha
     class Renderable
     {
     public:
-        Renderable(std::vector<Vertex> vertices, std::vector<unsigned int> indices);
+        Renderable(std::vector<Vertex> vertices, std::vector<unsigned int> indices,
+                   std::vector<VertexWeights> weights = std::vector<VertexWeights>());
         virtual ~Renderable();
 
         /** platform agnostic list of vertices */
         std::vector<Vertex> vertices;
         /** platform agnostic list of indices */
         std::vector<unsigned int> indices;
+        /** bone weights for each vertex, empty unless the renderable is skinned */
+        std::vector<VertexWeights> weights;
 
         /** OpenGL specific variables */
         GLuint m_vertexBuffer;
+        GLuint m_weightBuffer;
         GLuint m_vertexAttribute;
         GLuint m_elementBuffer;
     };
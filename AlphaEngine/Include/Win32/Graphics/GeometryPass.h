@@ -21,10 +21,13 @@ limitations under the License.
 #include <d3d11_1.h>
 
 #include "Graphics/ARenderPass.h"
+#include "Animation/Skeleton.h"
 #include "Math/Vector4.h"
 
 namespace alpha
 {
+    class ParticleEmitter;
+
     class GeometryPass : public ARenderPass
     {
         typedef struct MatrixBuffer
@@ -43,6 +46,11 @@ namespace alpha
             float _spacer3; // buffer size has to be a multiple of 16 bytes to be properly byte aligned
         } DeferredBuffer;
 
+        typedef struct BoneBuffer
+        {
+            DirectX::XMMATRIX mBones[Skeleton::sk_maxBones];
+        } BoneBuffer;
+
     public:
         GeometryPass();
         virtual ~GeometryPass();
@@ -55,6 +63,9 @@ namespace alpha
 
         virtual void VRender(ID3D11DeviceContext * pDeviceContext, std::shared_ptr<Camera> pCamera, std::vector<RenderSet *> renderables, std::vector<Light *> lights);
 
+        /** Draw every emitters particles into the gbuffer, one instanced draw per emitter */
+        void RenderParticles(ID3D11DeviceContext * pDeviceContext, std::shared_ptr<Camera> pCamera, std::vector<ParticleEmitter *> emitters);
+
         ID3D11ShaderResourceView ** GetShaderResourceViews();
 
     private:
@@ -64,6 +75,9 @@ namespace alpha
         ID3D11InputLayout * m_pInputLayout;
         /** Compiled pixel shader */
         ID3D11PixelShader * m_pPixelShader;
+        /** Skinning vertex shader, and its layout reading bone weights from a second vertex buffer */
+        ID3D11VertexShader * m_pSkinnedVertexShader;
+        ID3D11InputLayout * m_pSkinnedInputLayout;
 
         ID3D11Texture2D * m_pRenderTargetTextures[GBUFFER_TEXTURE_COUNT];
         ID3D11RenderTargetView * m_pRenderTargetViews[GBUFFER_TEXTURE_COUNT];
@@ -75,6 +89,18 @@ namespace alpha
         /** Shader buffer bind objects */
         ID3D11Buffer * m_pMatrixBuffer;
         ID3D11Buffer * m_pDeferredBuffer;
+        ID3D11Buffer * m_pBoneBuffer;
+
+        /** Most particles uploaded at once, larger emitters are drawn in several instanced calls */
+        static const unsigned int sk_maxParticleInstances;
+
+        /** Particle billboard vertex shader and layout, particles share the deferred pixel shader */
+        ID3D11VertexShader * m_pParticleVertexShader;
+        ID3D11InputLayout * m_pParticleInputLayout;
+        /** The four corners of a particle quad */
+        ID3D11Buffer * m_pParticleQuadBuffer;
+        /** Per particle position and size, rewritten for every emitter */
+        ID3D11Buffer * m_pParticleInstanceBuffer;
     };
 }
 
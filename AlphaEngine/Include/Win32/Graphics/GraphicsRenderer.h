@@ -30,6 +30,7 @@ namespace alpha
     class RenderWindow;
     class RenderSet;
     class Light;
+    class ParticleEmitter;
     class Asset;
     class AssetSystem;
     class Camera;
@@ -48,7 +49,10 @@ namespace alpha
 
         /** PreRender takes a list of data that will be rendered, and preps it rendering. */
         void PreRender(RenderSet * renderSet);
-        void Render(std::shared_ptr<Camera> pCamera, std::vector<RenderSet *> renderables, std::vector<Light *> lights);
+        /** Release the buffers PreRender created for the render set. */
+        void Release(RenderSet * renderSet);
+        void Render(std::shared_ptr<Camera> pCamera, std::vector<RenderSet *> renderables, std::vector<Light *> lights,
+                    std::vector<ParticleEmitter *> particles);
 
     private:
         HRESULT InitializeDevice();
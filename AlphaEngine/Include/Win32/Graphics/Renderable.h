@@ -33,6 +33,13 @@ namespace alpha
         Vector3 normal;
     };
 
+    /** Up to four bones a skinned vertex follows, weights sum to one */
+    struct VertexWeights
+    {
+        unsigned char bones[4];
+        float weights[4];
+    };
+
     /**
      * The Renderable object represents the smallest subset of data
      * to be rendered by the rendering engine, and is platform specific.
@@ -45,15 +52,19 @@ namespace alpha
     class Renderable
     {
     public:
-        Renderable(std::vector<Vertex> vertices, std::vector<unsigned int> indices);
+        Renderable(std::vector<Vertex> vertices, std::vector<unsigned int> indices,
+                   std::vector<VertexWeights> weights = std::vector<VertexWeights>());
         virtual ~Renderable();
 
         /** vertex vertices array */
         std::vector<Vertex> vertices;
         std::vector<unsigned int> indices;
+        /** bone weights for each vertex, empty unless the renderable is skinned */
+        std::vector<VertexWeights> weights;
 
         /** D3D11 data structures */
         ID3D11Buffer * m_pVertexBuffer;
+        ID3D11Buffer * m_pWeightBuffer;
         ID3D11Buffer * m_pIndexBuffer;
     };
 }
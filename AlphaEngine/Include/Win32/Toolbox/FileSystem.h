@@ -23,6 +23,10 @@ namespace alpha
 {
     char * OSGetBaseDirectory();
     char * OSJoinPath(const char * left, const char * right);
+    /** Create a directory, returns true if it was created or already exists */
+    bool OSCreateDirectory(const char * path);
+    /** Move a file over another, replacing it if it exists, returns true on success */
+    bool OSReplaceFile(const char * from, const char * to);
 }
 
 #endif // FILE_SYSTEM_H
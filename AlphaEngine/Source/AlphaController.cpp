@@ -29,6 +29,9 @@ limitations under the License.
 #include "Threading/ThreadSystem.h"
 #include "HID/HIDSystem.h"
 #include "Events/EventManager.h"
+#include "Scripting/LuaBytecodeCache.h"
+#include "Scripting/LuaStatePool.h"
+#include "Toolbox/FileSystem.h"
 
 namespace alpha
 {
@@ -103,6 +106,13 @@ namespace alpha
         m_pAssets = new AssetSystem();
         if (!InitializeSystem(m_pAssets)) { LOG_ERR("<AssetSystem> Initialization failed!"); return false; }
 
+        // compiled scripts are saved next to the executable, so later runs skip the lua parser
+        char * base = OSGetBaseDirectory();
+        char * script_cache = OSJoinPath(base, "ScriptCache");
+        LuaBytecodeCache::SetDirectory(script_cache);
+        free(script_cache);
+        free(base);
+
         // create graphics system, for platform specific rendering
         m_pGraphics = new GraphicsSystem();
         m_pGraphics->SetAssetSystem(m_pAssets); // attach asset system to graphics system
@@ -120,6 +130,7 @@ namespace alpha
         m_pLogic = new LogicSystem();
         m_pLogic->SetAudioSystem(m_pAudio);     // attach audio system to logic layer
         m_pLogic->SetAssetSystem(m_pAssets);    // initialize the game logic
+        m_pLogic->SetGraphicsSystem(m_pGraphics); // answers spatial queries from the scene
         this->SetGameState(state);              // set starting state
         if (!InitializeSystem(m_pLogic)) { LOG_ERR("<LogicSystem> Initialization failed!"); return false; }
 
@@ -226,6 +237,10 @@ namespace alpha
         if (ShutdownSystem(m_pGraphics)) { LOG("<GraphicsSystem> Disposed."); }
         if (ShutdownSystem(m_pAssets)) { LOG("<AssetSystem> Disposed."); }
 
+        // every script has been closed by now, release the idle lua states and compiled chunks
+        LuaStatePool::Clear();
+        LuaBytecodeCache::Clear();
+
         // finally close all sdl and all sub-systems
         SDL_Quit();
 
@@ -42,6 +42,9 @@ namespace alpha
         m_elapsedTime += elapsedTime;
         if (m_elapsedTime > m_updateFrequency)
         {
+            // make sure the last update's tasks are done before anything can touch what they wrote
+            this->VFinishTasks();
+
             // Allow any event handler to be called
             HandleEvents();
 
@@ -0,0 +1,157 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <stdio.h>
+#include <string.h>
+
+#include "Animation/AnimationClip.h"
+#include "Assets/Asset.h"
+#include "Toolbox/BinaryStream.h"
+#include "Toolbox/Logger.h"
+
+namespace alpha
+{
+    AnimationClip::AnimationClip(float frameRate, std::vector<Pose> frames)
+        : m_frameRate(frameRate > 0.f ? frameRate : 30.f)
+        , m_frames(frames)
+    { }
+
+    size_t AnimationClip::GetBoneCount() const
+    {
+        return m_frames.empty() ? 0 : m_frames[0].GetBoneCount();
+    }
+
+    size_t AnimationClip::GetFrameCount() const
+    {
+        return m_frames.size();
+    }
+
+    float AnimationClip::GetFrameRate() const
+    {
+        return m_frameRate;
+    }
+
+    float AnimationClip::GetDuration() const
+    {
+        return m_frames.empty() ? 0.f : static_cast<float>(m_frames.size() - 1) / m_frameRate;
+    }
+
+    const Pose & AnimationClip::GetFrame(size_t index) const
+    {
+        return m_frames[index];
+    }
+
+    void AnimationClip::Sample(float time, bool loop, Pose & out) const
+    {
+        if (m_frames.empty())
+        {
+            return;
+        }
+        if (out.GetBoneCount() != this->GetBoneCount())
+        {
+            out.Resize(this->GetBoneCount());
+        }
+
+        const float duration = this->GetDuration();
+        if (duration <= 0.f)
+        {
+            out.GetData() = m_frames[0].GetData();
+            return;
+        }
+
+        if (loop)
+        {
+            time = std::fmod(time, duration);
+            if (time < 0.f)
+            {
+                time += duration;
+            }
+        }
+        else
+        {
+            time = std::min(std::max(time, 0.f), duration);
+        }
+
+        const float frame = time * m_frameRate;
+        const size_t first = std::min(static_cast<size_t>(frame), m_frames.size() - 1);
+        const size_t second = std::min(first + 1, m_frames.size() - 1);
+        Pose::Blend(m_frames[first], m_frames[second], frame - static_cast<float>(first), out);
+    }
+
+    AnimationClip * LoadClipFromAsset(std::shared_ptr<Asset> pAsset)
+    {
+        if (pAsset == nullptr)
+        {
+            return nullptr;
+        }
+        std::vector<unsigned char> data = pAsset->GetData();
+        if (data.empty())
+        {
+            return nullptr;
+        }
+        return DeserializeClip(reinterpret_cast<const char *>(&data[0]), data.size());
+    }
+
+    AnimationClip * DeserializeClip(const char * data, size_t size)
+    {
+        BinaryReader reader(data, size);
+
+        ClipFileHeader header;
+        if (!reader.Read(header) || strncmp(header.signature, CLIPFILE_SIG, sizeof(header.signature)) != 0 || header.version != CLIPFILE_V1)
+        {
+            LOG_ERR("AnimationClip > Not a valid clip file.");
+            return nullptr;
+        }
+        if (header.frameCount == 0)
+        {
+            LOG_ERR("AnimationClip > Clip has no frames.");
+            return nullptr;
+        }
+
+        std::vector<Pose> frames(header.frameCount, Pose(header.boneCount));
+        for (Pose & frame : frames)
+        {
+            std::vector<float> & values = frame.GetData();
+            if (!reader.Read(values.data(), values.size() * sizeof(float)))
+            {
+                LOG_ERR("AnimationClip > Clip data is truncated.");
+                return nullptr;
+            }
+        }
+
+        return new AnimationClip(header.frameRate, frames);
+    }
+
+    void SerializeClip(const AnimationClip * const pClip, std::ostream & stream)
+    {
+        ClipFileHeader header;
+        memset(&header, 0, sizeof(ClipFileHeader));
+        sprintf(header.signature, "%s", CLIPFILE_SIG);
+        header.version = CLIPFILE_V1;
+        header.boneCount = static_cast<uint32_t>(pClip->GetBoneCount());
+        header.frameCount = static_cast<uint32_t>(pClip->GetFrameCount());
+        header.frameRate = pClip->GetFrameRate();
+
+        stream.write(reinterpret_cast<const char *>(&header), sizeof(ClipFileHeader));
+        for (size_t i = 0; i < pClip->GetFrameCount(); ++i)
+        {
+            const std::vector<float> & values = pClip->GetFrame(i).GetData();
+            stream.write(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(float));
+        }
+    }
+}
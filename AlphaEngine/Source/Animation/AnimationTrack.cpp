@@ -0,0 +1,159 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+#include <cmath>
+
+#include "Animation/AnimationTrack.h"
+#include "Math/Quaternion.h"
+#include "Math/SIMD.h"
+#include "Math/Vector3.h"
+#include "Toolbox/Logger.h"
+
+namespace alpha
+{
+    AnimationTrack::AnimationTrack(AnimationChannel channel, AnimationEase ease)
+        : m_eChannel(channel)
+        , m_eEase(ease)
+    { }
+
+    std::shared_ptr<AnimationTrack> AnimationTrack::Tween(AnimationChannel channel, const Vector3 & from, const Vector3 & to, float duration, AnimationEase ease)
+    {
+        auto track = std::make_shared<AnimationTrack>(channel, ease);
+        track->AddKey(0.f, from);
+        track->AddKey(duration, to);
+        return track;
+    }
+
+    std::shared_ptr<AnimationTrack> AnimationTrack::Tween(const Quaternion & from, const Quaternion & to, float duration, AnimationEase ease)
+    {
+        auto track = std::make_shared<AnimationTrack>(AC_ROTATION, ease);
+        track->AddKey(0.f, from);
+        track->AddKey(duration, to);
+        return track;
+    }
+
+    void AnimationTrack::AddKey(float time, const Vector3 & value)
+    {
+        if (m_eChannel == AC_ROTATION)
+        {
+            LOG_WARN("AnimationTrack > Vector key added to a rotation track, key ignored.");
+            return;
+        }
+        if (!m_keyTimes.empty() && time < m_keyTimes.back())
+        {
+            LOG_WARN("AnimationTrack > Keys must be added in time order, key ignored.");
+            return;
+        }
+        m_keyTimes.push_back(time);
+        m_keyValues.insert(m_keyValues.end(), { value.x, value.y, value.z, 0.f });
+    }
+
+    void AnimationTrack::AddKey(float time, const Quaternion & value)
+    {
+        if (m_eChannel != AC_ROTATION)
+        {
+            LOG_WARN("AnimationTrack > Quaternion key added to a position or scale track, key ignored.");
+            return;
+        }
+        if (!m_keyTimes.empty() && time < m_keyTimes.back())
+        {
+            LOG_WARN("AnimationTrack > Keys must be added in time order, key ignored.");
+            return;
+        }
+        m_keyTimes.push_back(time);
+        m_keyValues.insert(m_keyValues.end(), { value.x, value.y, value.z, value.w });
+    }
+
+    AnimationChannel AnimationTrack::GetChannel() const
+    {
+        return m_eChannel;
+    }
+
+    float AnimationTrack::GetDuration() const
+    {
+        return m_keyTimes.empty() ? 0.f : m_keyTimes.back();
+    }
+
+    size_t AnimationTrack::GetKeyCount() const
+    {
+        return m_keyTimes.size();
+    }
+
+    void AnimationTrack::Sample(float time, float * out) const
+    {
+        const size_t count = m_keyTimes.size();
+        if (count == 0)
+        {
+            std::fill(out, out + 4, 0.f);
+            return;
+        }
+
+        // find the pair of keys either side of time, clamping to the ends of the track
+        const size_t next = std::upper_bound(m_keyTimes.begin(), m_keyTimes.end(), time) - m_keyTimes.begin();
+        if (next == 0 || next == count)
+        {
+            const float * key = &m_keyValues[(next == 0 ? 0 : count - 1) * 4];
+            std::copy(key, key + 4, out);
+            return;
+        }
+        const size_t prev = next - 1;
+
+        const float span = m_keyTimes[next] - m_keyTimes[prev];
+        float t = span > 0.f ? (time - m_keyTimes[prev]) / span : 1.f;
+        switch (m_eEase)
+        {
+        case AE_EASE_IN: t = t * t; break;
+        case AE_EASE_OUT: t = t * (2.f - t); break;
+        case AE_EASE_IN_OUT: t = t * t * (3.f - 2.f * t); break;
+        case AE_LINEAR: break;
+        }
+
+        const float * a = &m_keyValues[prev * 4];
+        const float * b = &m_keyValues[next * 4];
+
+        // blend along the shortest arc, q and -q are the same rotation
+        float sign = 1.f;
+        if (m_eChannel == AC_ROTATION && (a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3]) < 0.f)
+        {
+            sign = -1.f;
+        }
+
+#if defined(ALPHA_SIMD_SSE2)
+        const __m128 va = _mm_loadu_ps(a);
+        const __m128 vb = _mm_mul_ps(_mm_loadu_ps(b), _mm_set1_ps(sign));
+        _mm_storeu_ps(out, _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(vb, va), _mm_set1_ps(t))));
+#else
+        for (int i = 0; i < 4; ++i)
+        {
+            out[i] = a[i] + (b[i] * sign - a[i]) * t;
+        }
+#endif
+
+        if (m_eChannel == AC_ROTATION)
+        {
+            const float length = std::sqrt(out[0] * out[0] + out[1] * out[1] + out[2] * out[2] + out[3] * out[3]);
+            if (length > 0.f)
+            {
+                const float inv_length = 1.f / length;
+                for (int i = 0; i < 4; ++i)
+                {
+                    out[i] *= inv_length;
+                }
+            }
+        }
+    }
+}
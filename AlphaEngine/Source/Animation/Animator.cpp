@@ -0,0 +1,204 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "Animation/Animator.h"
+#include "Animation/Task_AnimateTransforms.h"
+#include "Entities/EntityComponent.h"
+#include "Threading/TaskGroup.h"
+
+namespace alpha
+{
+    const size_t Animator::sk_batchSize = 256;
+
+    Animator::Animator() { }
+
+    AnimationHandle Animator::Play(const ComponentHandle<SceneComponent> & target, std::shared_ptr<const AnimationTrack> track,
+                                   AnimationLoop loop, float speed)
+    {
+        PlayingTrack playing;
+        playing.target = target;
+        playing.track = track;
+        playing.loop = loop;
+        playing.speed = std::max(speed, 0.f);
+        playing.time = 0.f;
+        playing.loops = 0;
+        return m_tracks.Insert(std::move(playing));
+    }
+
+    bool Animator::Stop(const AnimationHandle & handle)
+    {
+        return m_tracks.Remove(handle);
+    }
+
+    void Animator::StopEntity(const Entity * pEntity)
+    {
+        // walk backwards, removing swaps a track that has already been checked into the hole
+        for (size_t i = m_tracks.Size(); i-- > 0;)
+        {
+            SceneComponent * pTarget = (m_tracks.begin() + i)->target.Get();
+            if (pTarget != nullptr && pTarget->GetOwner() == pEntity)
+            {
+                m_tracks.Remove(m_tracks.GetHandleAt(i));
+            }
+        }
+    }
+
+    void Animator::SetSpeed(const AnimationHandle & handle, float speed)
+    {
+        if (PlayingTrack * playing = m_tracks.Get(handle))
+        {
+            playing->speed = std::max(speed, 0.f);
+        }
+    }
+
+    bool Animator::IsPlaying(const AnimationHandle & handle) const
+    {
+        return m_tracks.Contains(handle);
+    }
+
+    unsigned int Animator::GetLoops(const AnimationHandle & handle) const
+    {
+        const PlayingTrack * playing = m_tracks.Get(handle);
+        return playing != nullptr ? playing->loops : 0;
+    }
+
+    size_t Animator::Size() const
+    {
+        return m_tracks.Size();
+    }
+
+    void Animator::Clear()
+    {
+        m_tracks.Clear();
+    }
+
+    std::shared_ptr<TaskGroup> Animator::Update(float fElapsedTime, std::function<void(AEvent *)> delPublishEvent)
+    {
+        if (m_tracks.Empty())
+        {
+            return nullptr;
+        }
+
+        // gather every track first, the batch is built once they are sorted by target
+        AnimationBatch sampled;
+        sampled.targets.reserve(m_tracks.Size());
+        sampled.tracks.reserve(m_tracks.Size());
+        sampled.times.reserve(m_tracks.Size());
+
+        std::vector<AnimationHandle> finished;
+
+        for (size_t i = 0; i < m_tracks.Size(); ++i)
+        {
+            PlayingTrack & playing = *(m_tracks.begin() + i);
+
+            auto target = playing.target.Lock();
+            if (target == nullptr || playing.track == nullptr)
+            {
+                finished.push_back(m_tracks.GetHandleAt(i));
+                continue;
+            }
+
+            const float duration = playing.track->GetDuration();
+            const float previous_time = playing.time;
+            playing.time += fElapsedTime * playing.speed;
+
+            float sample_time = playing.time;
+            if (duration <= 0.f)
+            {
+                sample_time = 0.f;
+                if (playing.loop == AL_ONCE)
+                {
+                    finished.push_back(m_tracks.GetHandleAt(i));
+                }
+            }
+            else if (playing.loop == AL_ONCE)
+            {
+                if (playing.time >= duration)
+                {
+                    // land exactly on the last key before stopping
+                    sample_time = duration;
+                    finished.push_back(m_tracks.GetHandleAt(i));
+                }
+            }
+            else
+            {
+                // count every time the track reaches an end, for ping pong tracks that is every turn around
+                const float ends_before = std::floor(previous_time / duration);
+                const float ends_after = std::floor(playing.time / duration);
+                playing.loops += static_cast<unsigned int>(ends_after - ends_before);
+
+                // ping pong tracks run over two legs, forward then back
+                const float period = playing.loop == AL_LOOP ? duration : duration * 2.f;
+                playing.time = std::fmod(playing.time, period);
+                sample_time = playing.time <= duration ? playing.time : period - playing.time;
+            }
+
+            sampled.targets.push_back(std::move(target));
+            sampled.tracks.push_back(playing.track);
+            sampled.times.push_back(sample_time);
+        }
+
+        for (auto & handle : finished)
+        {
+            m_tracks.Remove(handle);
+        }
+
+        // bring the tracks of each component together, a stable sort keeps the order they were played in,
+        // so the last track played on a channel still wins.
+        const size_t count = sampled.times.size();
+        std::vector<size_t> order(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [&sampled](size_t left, size_t right)
+        {
+            return std::less<SceneComponent *>()(sampled.targets[left].get(), sampled.targets[right].get());
+        });
+
+        // the batch is a snapshot, tracks can be played and stopped while the tasks are still running
+        auto batch = std::make_shared<AnimationBatch>();
+        batch->targets.reserve(count);
+        batch->tracks.reserve(count);
+        batch->times.reserve(count);
+        for (size_t i : order)
+        {
+            batch->targets.push_back(std::move(sampled.targets[i]));
+            batch->tracks.push_back(std::move(sampled.tracks[i]));
+            batch->times.push_back(sampled.times[i]);
+        }
+
+        // evaluate in roughly fixed size batches, sampling is cheap and uniform so there is no need to measure it.
+        // a batch is only cut between components, so each transform is written by exactly one task.
+        std::vector<ATask *> tasks;
+        size_t begin = 0;
+        while (begin < count)
+        {
+            size_t end = std::min(begin + sk_batchSize, count);
+            while (end < count && batch->targets[end] == batch->targets[end - 1])
+            {
+                ++end;
+            }
+            tasks.push_back(new Task_AnimateTransforms(batch, begin, end));
+            begin = end;
+        }
+        return TaskGroup::Publish(std::move(tasks), delPublishEvent);
+    }
+}
@@ -0,0 +1,196 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+#include <cmath>
+
+#include "Animation/Pose.h"
+#include "Math/SIMD.h"
+
+namespace alpha
+{
+    Pose::Pose()
+        : m_boneCount(0)
+        , m_stride(0)
+    { }
+    Pose::Pose(size_t boneCount)
+        : m_boneCount(0)
+        , m_stride(0)
+    {
+        this->Resize(boneCount);
+    }
+
+    void Pose::Resize(size_t boneCount)
+    {
+        m_boneCount = boneCount;
+        m_stride = (boneCount + 3) & ~static_cast<size_t>(3);
+
+        m_data.assign(m_stride * PC_COUNT, 0.f);
+        std::fill(m_data.begin() + PC_ROTATION_W * m_stride, m_data.begin() + (PC_ROTATION_W + 1) * m_stride, 1.f);
+        std::fill(m_data.begin() + PC_SCALE_X * m_stride, m_data.end(), 1.f);
+    }
+
+    size_t Pose::GetBoneCount() const
+    {
+        return m_boneCount;
+    }
+
+    size_t Pose::GetStride() const
+    {
+        return m_stride;
+    }
+
+    void Pose::SetBone(size_t bone, const Vector3 & position, const Quaternion & rotation, const Vector3 & scale)
+    {
+        float * data = &m_data[bone];
+        data[PC_POSITION_X * m_stride] = position.x;
+        data[PC_POSITION_Y * m_stride] = position.y;
+        data[PC_POSITION_Z * m_stride] = position.z;
+        data[PC_ROTATION_X * m_stride] = rotation.x;
+        data[PC_ROTATION_Y * m_stride] = rotation.y;
+        data[PC_ROTATION_Z * m_stride] = rotation.z;
+        data[PC_ROTATION_W * m_stride] = rotation.w;
+        data[PC_SCALE_X * m_stride] = scale.x;
+        data[PC_SCALE_Y * m_stride] = scale.y;
+        data[PC_SCALE_Z * m_stride] = scale.z;
+    }
+
+    Vector3 Pose::GetPosition(size_t bone) const
+    {
+        const float * data = &m_data[bone];
+        return Vector3(data[PC_POSITION_X * m_stride], data[PC_POSITION_Y * m_stride], data[PC_POSITION_Z * m_stride]);
+    }
+
+    Quaternion Pose::GetRotation(size_t bone) const
+    {
+        const float * data = &m_data[bone];
+        return Quaternion(data[PC_ROTATION_X * m_stride], data[PC_ROTATION_Y * m_stride], data[PC_ROTATION_Z * m_stride], data[PC_ROTATION_W * m_stride]);
+    }
+
+    Vector3 Pose::GetScale(size_t bone) const
+    {
+        const float * data = &m_data[bone];
+        return Vector3(data[PC_SCALE_X * m_stride], data[PC_SCALE_Y * m_stride], data[PC_SCALE_Z * m_stride]);
+    }
+
+    float * Pose::GetChannel(PoseChannel channel)
+    {
+        return &m_data[channel * m_stride];
+    }
+
+    const float * Pose::GetChannel(PoseChannel channel) const
+    {
+        return &m_data[channel * m_stride];
+    }
+
+    std::vector<float> & Pose::GetData()
+    {
+        return m_data;
+    }
+
+    const std::vector<float> & Pose::GetData() const
+    {
+        return m_data;
+    }
+
+    void Pose::Blend(const Pose & from, const Pose & to, float weight, Pose & out)
+    {
+        const size_t stride = out.m_stride;
+        const float * a = from.m_data.data();
+        const float * b = to.m_data.data();
+        float * o = out.m_data.data();
+
+        const float * ax = a + PC_ROTATION_X * stride;
+        const float * ay = a + PC_ROTATION_Y * stride;
+        const float * az = a + PC_ROTATION_Z * stride;
+        const float * aw = a + PC_ROTATION_W * stride;
+        const float * bx = b + PC_ROTATION_X * stride;
+        const float * by = b + PC_ROTATION_Y * stride;
+        const float * bz = b + PC_ROTATION_Z * stride;
+        const float * bw = b + PC_ROTATION_W * stride;
+        float * ox = o + PC_ROTATION_X * stride;
+        float * oy = o + PC_ROTATION_Y * stride;
+        float * oz = o + PC_ROTATION_Z * stride;
+        float * ow = o + PC_ROTATION_W * stride;
+
+#if defined(ALPHA_SIMD_SSE2)
+        const __m128 w = _mm_set1_ps(weight);
+
+        // positions and scales are a plain lerp, the rotation channels sit between them
+        for (size_t i = 0; i < PC_ROTATION_X * stride; i += 4)
+        {
+            __m128 va = _mm_loadu_ps(a + i);
+            _mm_storeu_ps(o + i, _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(b + i), va), w)));
+        }
+        for (size_t i = PC_SCALE_X * stride; i < PC_COUNT * stride; i += 4)
+        {
+            __m128 va = _mm_loadu_ps(a + i);
+            _mm_storeu_ps(o + i, _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(b + i), va), w)));
+        }
+
+        const __m128 sign = _mm_set1_ps(-0.f);
+        for (size_t i = 0; i < stride; i += 4)
+        {
+            __m128 qax = _mm_loadu_ps(ax + i), qay = _mm_loadu_ps(ay + i), qaz = _mm_loadu_ps(az + i), qaw = _mm_loadu_ps(aw + i);
+            __m128 qbx = _mm_loadu_ps(bx + i), qby = _mm_loadu_ps(by + i), qbz = _mm_loadu_ps(bz + i), qbw = _mm_loadu_ps(bw + i);
+
+            // flip the target of any lane pointing the long way round
+            __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(qax, qbx), _mm_mul_ps(qay, qby)),
+                                    _mm_add_ps(_mm_mul_ps(qaz, qbz), _mm_mul_ps(qaw, qbw)));
+            __m128 flip = _mm_and_ps(_mm_cmplt_ps(dot, _mm_setzero_ps()), sign);
+            qbx = _mm_xor_ps(qbx, flip); qby = _mm_xor_ps(qby, flip); qbz = _mm_xor_ps(qbz, flip); qbw = _mm_xor_ps(qbw, flip);
+
+            __m128 rx = _mm_add_ps(qax, _mm_mul_ps(_mm_sub_ps(qbx, qax), w));
+            __m128 ry = _mm_add_ps(qay, _mm_mul_ps(_mm_sub_ps(qby, qay), w));
+            __m128 rz = _mm_add_ps(qaz, _mm_mul_ps(_mm_sub_ps(qbz, qaz), w));
+            __m128 rw = _mm_add_ps(qaw, _mm_mul_ps(_mm_sub_ps(qbw, qaw), w));
+
+            __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(ry, ry)),
+                                                   _mm_add_ps(_mm_mul_ps(rz, rz), _mm_mul_ps(rw, rw))));
+            _mm_storeu_ps(ox + i, _mm_div_ps(rx, length));
+            _mm_storeu_ps(oy + i, _mm_div_ps(ry, length));
+            _mm_storeu_ps(oz + i, _mm_div_ps(rz, length));
+            _mm_storeu_ps(ow + i, _mm_div_ps(rw, length));
+        }
+#else
+        for (size_t i = 0; i < PC_ROTATION_X * stride; ++i)
+        {
+            o[i] = a[i] + (b[i] - a[i]) * weight;
+        }
+        for (size_t i = PC_SCALE_X * stride; i < PC_COUNT * stride; ++i)
+        {
+            o[i] = a[i] + (b[i] - a[i]) * weight;
+        }
+
+        for (size_t i = 0; i < stride; ++i)
+        {
+            const float dot = ax[i] * bx[i] + ay[i] * by[i] + az[i] * bz[i] + aw[i] * bw[i];
+            const float s = dot < 0.f ? -1.f : 1.f;
+
+            const float rx = ax[i] + (bx[i] * s - ax[i]) * weight;
+            const float ry = ay[i] + (by[i] * s - ay[i]) * weight;
+            const float rz = az[i] + (bz[i] * s - az[i]) * weight;
+            const float rw = aw[i] + (bw[i] * s - aw[i]) * weight;
+
+            const float length = std::sqrt(rx * rx + ry * ry + rz * rz + rw * rw);
+            ox[i] = rx / length;
+            oy[i] = ry / length;
+            oz[i] = rz / length;
+            ow[i] = rw / length;
+        }
+#endif
+    }
+}
@@ -0,0 +1,148 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cstdint>
+#include <sstream>
+#include <stdio.h>
+
+#include "Animation/Skeleton.h"
+#include "Math/Constants.h"
+#include "Toolbox/Logger.h"
+
+namespace alpha
+{
+    namespace
+    {
+        /** Counts are written as fixed width text, the same as the rest of the model file */
+        void WriteCount(std::ostream & stream, unsigned int count)
+        {
+            char buf[UINT_LENGTH] = { 0 };
+            sprintf(buf, "%u", count);
+            stream.write(buf, UINT_LENGTH);
+        }
+
+        unsigned int ReadCount(std::istream & stream)
+        {
+            unsigned int count = 0;
+            char buf[UINT_LENGTH + 1] = { 0 };
+            stream.read(buf, UINT_LENGTH);
+            std::stringstream str(buf);
+            str >> count;
+            return count;
+        }
+    }
+
+    const unsigned int Skeleton::sk_maxBones;
+
+    Skeleton::Skeleton(std::vector<Bone> bones, const Pose & bindPose)
+        : m_bones(bones)
+        , m_bindPose(bindPose)
+    { }
+
+    size_t Skeleton::GetBoneCount() const
+    {
+        return m_bones.size();
+    }
+
+    const Bone & Skeleton::GetBone(size_t index) const
+    {
+        return m_bones[index];
+    }
+
+    int Skeleton::FindBone(const std::string & name) const
+    {
+        for (size_t i = 0; i < m_bones.size(); ++i)
+        {
+            if (m_bones[i].name == name)
+            {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    const Pose & Skeleton::GetBindPose() const
+    {
+        return m_bindPose;
+    }
+
+    void Skeleton::Serialize(std::ostream & stream) const
+    {
+        WriteCount(stream, static_cast<unsigned int>(m_bones.size()));
+
+        for (size_t i = 0; i < m_bones.size(); ++i)
+        {
+            const Bone & bone = m_bones[i];
+            WriteCount(stream, static_cast<unsigned int>(bone.name.size()));
+            stream.write(bone.name.data(), bone.name.size());
+
+            int32_t parent = bone.parent;
+            stream.write(reinterpret_cast<const char *>(&parent), sizeof(int32_t));
+            stream.write(reinterpret_cast<const char *>(&bone.inverseBind), sizeof(Matrix));
+
+            Vector3 position = m_bindPose.GetPosition(i);
+            Quaternion rotation = m_bindPose.GetRotation(i);
+            Vector3 scale = m_bindPose.GetScale(i);
+            stream.write(reinterpret_cast<const char *>(&position), sizeof(Vector3));
+            stream.write(reinterpret_cast<const char *>(&rotation), sizeof(Quaternion));
+            stream.write(reinterpret_cast<const char *>(&scale), sizeof(Vector3));
+        }
+    }
+
+    Skeleton * Skeleton::Deserialize(std::istream & stream)
+    {
+        unsigned int numBones = ReadCount(stream);
+        if (numBones > sk_maxBones)
+        {
+            LOG_ERR("Skeleton > Too many bones: ", numBones, ", at most ", sk_maxBones, " are supported.");
+            return nullptr;
+        }
+
+        std::vector<Bone> bones(numBones);
+        Pose bindPose(numBones);
+        for (unsigned int i = 0; i < numBones; ++i)
+        {
+            Bone & bone = bones[i];
+            unsigned int length = ReadCount(stream);
+            bone.name.resize(length);
+            if (length > 0)
+            {
+                stream.read(&bone.name[0], length);
+            }
+
+            int32_t parent = -1;
+            stream.read(reinterpret_cast<char *>(&parent), sizeof(int32_t));
+            stream.read(reinterpret_cast<char *>(&bone.inverseBind), sizeof(Matrix));
+            bone.parent = parent;
+
+            Vector3 position, scale;
+            Quaternion rotation;
+            stream.read(reinterpret_cast<char *>(&position), sizeof(Vector3));
+            stream.read(reinterpret_cast<char *>(&rotation), sizeof(Quaternion));
+            stream.read(reinterpret_cast<char *>(&scale), sizeof(Vector3));
+            bindPose.SetBone(i, position, rotation, scale);
+
+            // poses are evaluated in a single pass over the bones, so every parent has to come first
+            if (!stream || bone.parent >= static_cast<int>(i))
+            {
+                LOG_ERR("Skeleton > Invalid bone data for bone ", i, ".");
+                return nullptr;
+            }
+        }
+
+        return new Skeleton(bones, bindPose);
+    }
+}
@@ -0,0 +1,231 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "Animation/SkeletonAnimator.h"
+#include "Animation/AnimationClip.h"
+#include "Animation/Skeleton.h"
+#include "Graphics/RenderSet.h"
+#include "Math/SIMD.h"
+#include "Toolbox/Logger.h"
+
+namespace alpha
+{
+    namespace
+    {
+        /** out = left * right, out may be either input */
+        inline void MultiplyMatrix(const Matrix & left, const Matrix & right, Matrix & out)
+        {
+#if defined(ALPHA_SIMD_SSE2)
+            const float * l = &left.m_11;
+            const float * r = &right.m_11;
+            const __m128 r0 = _mm_loadu_ps(r);
+            const __m128 r1 = _mm_loadu_ps(r + 4);
+            const __m128 r2 = _mm_loadu_ps(r + 8);
+            const __m128 r3 = _mm_loadu_ps(r + 12);
+
+            // each row of the result is a blend of the rows of right, weighted by a row of left
+            __m128 rows[4];
+            for (int i = 0; i < 4; ++i)
+            {
+                const float * row = l + i * 4;
+                rows[i] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(row[0]), r0), _mm_mul_ps(_mm_set1_ps(row[1]), r1)),
+                                     _mm_add_ps(_mm_mul_ps(_mm_set1_ps(row[2]), r2), _mm_mul_ps(_mm_set1_ps(row[3]), r3)));
+            }
+
+            float * o = &out.m_11;
+            for (int i = 0; i < 4; ++i)
+            {
+                _mm_storeu_ps(o + i * 4, rows[i]);
+            }
+#else
+            out = left * right;
+#endif
+        }
+    }
+
+    SkeletonAnimator::SkeletonAnimator(const Skeleton * pSkeleton, RenderSet * pRenderSet)
+        : m_pSkeleton(pSkeleton)
+        , m_pRenderSet(pRenderSet)
+        , m_fBlendTime(0.f)
+        , m_fBlendElapsed(0.f)
+        , m_fSpeed(1.f)
+        , m_pose(pSkeleton->GetBindPose())
+        , m_previousPose(pSkeleton->GetBoneCount())
+        , m_locals(m_pose.GetStride())
+        , m_models(pSkeleton->GetBoneCount())
+    {
+        m_current.time = 0.f;
+        m_current.loop = true;
+        m_previous.time = 0.f;
+        m_previous.loop = true;
+
+        // start out in the bind pose, so the mesh is drawn as modelled until a clip plays
+        this->BuildPalette(m_pose);
+    }
+    SkeletonAnimator::~SkeletonAnimator() { }
+
+    bool SkeletonAnimator::AddClip(const std::string & name, std::shared_ptr<const AnimationClip> pClip)
+    {
+        if (pClip == nullptr || pClip->GetBoneCount() != m_pSkeleton->GetBoneCount())
+        {
+            LOG_WARN("SkeletonAnimator > Clip '", name, "' does not match the skeleton, it will not be played.");
+            return false;
+        }
+        m_clips[name] = pClip;
+        return true;
+    }
+
+    bool SkeletonAnimator::Play(const std::string & name, float blendTime, bool loop)
+    {
+        auto search = m_clips.find(name);
+        if (search == m_clips.end())
+        {
+            LOG_WARN("SkeletonAnimator > No clip named '", name, "'.");
+            return false;
+        }
+
+        // cross fade from the current clip, cutting off any fade that was still going
+        if (m_current.clip != nullptr && blendTime > 0.f)
+        {
+            m_previous = m_current;
+            m_fBlendTime = blendTime;
+            m_fBlendElapsed = 0.f;
+        }
+        else
+        {
+            m_previous.clip = nullptr;
+        }
+
+        m_current.clip = search->second;
+        m_current.time = 0.f;
+        m_current.loop = loop;
+        return true;
+    }
+
+    void SkeletonAnimator::SetSpeed(float speed)
+    {
+        m_fSpeed = speed;
+    }
+
+    void SkeletonAnimator::Evaluate(float fElapsedTime)
+    {
+        if (m_current.clip == nullptr)
+        {
+            return;
+        }
+
+        const float step = fElapsedTime * m_fSpeed;
+        m_current.time += step;
+        m_current.clip->Sample(m_current.time, m_current.loop, m_pose);
+
+        if (m_previous.clip != nullptr)
+        {
+            m_fBlendElapsed += fElapsedTime;
+            if (m_fBlendElapsed >= m_fBlendTime)
+            {
+                m_previous.clip = nullptr;
+            }
+            else
+            {
+                m_previous.time += step;
+                m_previous.clip->Sample(m_previous.time, m_previous.loop, m_previousPose);
+                Pose::Blend(m_previousPose, m_pose, m_fBlendElapsed / m_fBlendTime, m_pose);
+            }
+        }
+
+        this->BuildPalette(m_pose);
+    }
+
+    void SkeletonAnimator::BuildPalette(const Pose & pose)
+    {
+        const size_t count = m_pSkeleton->GetBoneCount();
+        const size_t stride = pose.GetStride();
+
+        const float * px = pose.GetChannel(PC_POSITION_X);
+        const float * py = pose.GetChannel(PC_POSITION_Y);
+        const float * pz = pose.GetChannel(PC_POSITION_Z);
+        const float * qx = pose.GetChannel(PC_ROTATION_X);
+        const float * qy = pose.GetChannel(PC_ROTATION_Y);
+        const float * qz = pose.GetChannel(PC_ROTATION_Z);
+        const float * qw = pose.GetChannel(PC_ROTATION_W);
+        const float * sx = pose.GetChannel(PC_SCALE_X);
+        const float * sy = pose.GetChannel(PC_SCALE_Y);
+        const float * sz = pose.GetChannel(PC_SCALE_Z);
+
+        // local transforms, scale then rotate then translate, four bones at a time
+#if defined(ALPHA_SIMD_SSE2)
+        const __m128 one = _mm_set1_ps(1.f);
+        const __m128 two = _mm_set1_ps(2.f);
+        for (size_t i = 0; i < stride; i += 4)
+        {
+            __m128 x = _mm_loadu_ps(qx + i), y = _mm_loadu_ps(qy + i), z = _mm_loadu_ps(qz + i), w = _mm_loadu_ps(qw + i);
+            __m128 x2 = _mm_mul_ps(x, x), y2 = _mm_mul_ps(y, y), z2 = _mm_mul_ps(z, z);
+            __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+            __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+            __m128 scaleX = _mm_loadu_ps(sx + i), scaleY = _mm_loadu_ps(sy + i), scaleZ = _mm_loadu_ps(sz + i);
+
+            float m[12][4];
+            _mm_storeu_ps(m[0], _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(y2, z2))), scaleX));
+            _mm_storeu_ps(m[1], _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), scaleX));
+            _mm_storeu_ps(m[2], _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), scaleX));
+            _mm_storeu_ps(m[3], _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), scaleY));
+            _mm_storeu_ps(m[4], _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(x2, z2))), scaleY));
+            _mm_storeu_ps(m[5], _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), scaleY));
+            _mm_storeu_ps(m[6], _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), scaleZ));
+            _mm_storeu_ps(m[7], _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), scaleZ));
+            _mm_storeu_ps(m[8], _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(x2, y2))), scaleZ));
+            _mm_storeu_ps(m[9], _mm_loadu_ps(px + i));
+            _mm_storeu_ps(m[10], _mm_loadu_ps(py + i));
+            _mm_storeu_ps(m[11], _mm_loadu_ps(pz + i));
+
+            for (size_t k = 0; k < 4; ++k)
+            {
+                m_locals[i + k] = Matrix(m[0][k], m[1][k], m[2][k], 0.f,
+                                         m[3][k], m[4][k], m[5][k], 0.f,
+                                         m[6][k], m[7][k], m[8][k], 0.f,
+                                         m[9][k], m[10][k], m[11][k], 1.f);
+            }
+        }
+#else
+        for (size_t i = 0; i < count; ++i)
+        {
+            Matrix local = Matrix::Rotate(Quaternion(qx[i], qy[i], qz[i], qw[i]));
+            local.m_11 *= sx[i]; local.m_12 *= sx[i]; local.m_13 *= sx[i];
+            local.m_21 *= sy[i]; local.m_22 *= sy[i]; local.m_23 *= sy[i];
+            local.m_31 *= sz[i]; local.m_32 *= sz[i]; local.m_33 *= sz[i];
+            local.m_41 = px[i]; local.m_42 = py[i]; local.m_43 = pz[i];
+            m_locals[i] = local;
+        }
+#endif
+
+        // parents always come first, so one pass takes every bone into model space
+        std::vector<Matrix> & palette = m_pRenderSet->bonePalette;
+        palette.resize(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Bone & bone = m_pSkeleton->GetBone(i);
+            if (bone.parent < 0)
+            {
+                m_models[i] = m_locals[i];
+            }
+            else
+            {
+                MultiplyMatrix(m_locals[i], m_models[bone.parent], m_models[i]);
+            }
+            MultiplyMatrix(bone.inverseBind, m_models[i], palette[i]);
+        }
+    }
+}
@@ -0,0 +1,53 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "Animation/Task_AnimateTransforms.h"
+#include "Animation/AnimationTrack.h"
+#include "Entities/EntityComponent.h"
+
+namespace alpha
+{
+    Task_AnimateTransforms::Task_AnimateTransforms(std::shared_ptr<const AnimationBatch> pBatch, size_t begin, size_t end)
+        : m_pBatch(pBatch)
+        , m_begin(begin)
+        , m_end(end)
+    { }
+
+    bool Task_AnimateTransforms::VExecute()
+    {
+        float value[4];
+        for (size_t i = m_begin; i < m_end; ++i)
+        {
+            const AnimationTrack & track = *m_pBatch->tracks[i];
+            SceneComponent & target = *m_pBatch->targets[i];
+
+            track.Sample(m_pBatch->times[i], value);
+            switch (track.GetChannel())
+            {
+            case AC_POSITION:
+                target.SetPosition(Vector3(value[0], value[1], value[2]));
+                break;
+            case AC_ROTATION:
+                target.SetRotation(Quaternion(value[0], value[1], value[2], value[3]));
+                break;
+            case AC_SCALE:
+                target.SetScale(Vector3(value[0], value[1], value[2]));
+                break;
+            }
+        }
+        return true;
+    }
+}
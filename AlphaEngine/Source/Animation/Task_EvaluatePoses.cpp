@@ -14,25 +14,24 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
-#include "Logic/Task_UpdateEntity.h"
-#include "Entities/Entity.h"
-#include "Logic/LogicSystemEvents.h"
+#include "Animation/Task_EvaluatePoses.h"
+#include "Animation/SkeletonAnimator.h"
 
 namespace alpha
 {
-    Task_UpdateEntity::Task_UpdateEntity(float fCurrentTime, float fElapsedTime, std::shared_ptr<Entity> pEntity, std::function<void(AEvent *)> delPublishEvent)
-        : m_fCurrentTime(fCurrentTime)
+    const size_t Task_EvaluatePoses::sk_batchSize = 16;
+
+    Task_EvaluatePoses::Task_EvaluatePoses(std::vector<SkeletonAnimator *> animators, float fElapsedTime)
+        : m_animators(animators)
         , m_fElapsedTime(fElapsedTime)
-        , m_pEntity(pEntity)
-        , m_delPublishEvent(delPublishEvent)
     { }
 
-    bool Task_UpdateEntity::VExecute()
+    bool Task_EvaluatePoses::VExecute()
     {
-        if (m_pEntity->Update(m_fCurrentTime, m_fElapsedTime))
+        for (SkeletonAnimator * pAnimator : m_animators)
         {
-            this->m_delPublishEvent(new Event_EntityUpdated(m_pEntity));
+            pAnimator->Evaluate(m_fElapsedTime);
         }
         return true;
     }
-}
\ No newline at end of file
+}
@@ -35,29 +35,38 @@ namespace alpha
 
     std::vector<unsigned char> Asset::GetData()
     {
+        std::lock_guard<std::mutex> lock(m_dataMutex);
         if (m_data.size() == 0)
         {
-            LOG("Loading file into memory: ", m_pPath);
+            m_data = this->ReadData();
+        }
+        return m_data;
+    }
 
-            FILE * fp = fopen(m_pPath, "rb");
-            if (fp)
-            {
-                LOG("File handler opened, attempting to load.");
-                size_t bufSize = (sizeof(char) * m_fileStats.st_size) + 1;
-                m_data.resize(bufSize);
-
-                if (m_data.size() == bufSize)
-                {
-                    LOG("File opened, loading into memory.");
-                    fread(&m_data[0], 1, bufSize, fp);
-                }
-                fclose(fp);
-            }
-            else
+    std::vector<unsigned char> Asset::ReadData() const
+    {
+        std::vector<unsigned char> data;
+
+        LOG("Loading file into memory: ", m_pPath);
+
+        FILE * fp = fopen(m_pPath, "rb");
+        if (fp)
+        {
+            LOG("File handler opened, attempting to load.");
+            size_t bufSize = (sizeof(char) * m_fileStats.st_size) + 1;
+            data.resize(bufSize);
+
+            if (data.size() == bufSize)
             {
-                LOG_ERR("Failed to open file handler...");
+                LOG("File opened, loading into memory.");
+                fread(&data[0], 1, bufSize, fp);
             }
+            fclose(fp);
         }
-        return m_data;
+        else
+        {
+            LOG_ERR("Failed to open file handler...");
+        }
+        return data;
     }
 }
@@ -0,0 +1,143 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+#include "Collision/Broadphase.h"
+#include "Math/AABB.h"
+#include "Math/SIMD.h"
+
+namespace alpha
+{
+    ContactPair::ContactPair(const EntityHandle & first, const EntityHandle & second)
+        : a(first < second ? first : second)
+        , b(first < second ? second : first)
+    { }
+
+    void BroadphaseBounds::Add(const EntityHandle & entity, const AABB & bounds)
+    {
+        minX.push_back(bounds.min.x);
+        minY.push_back(bounds.min.y);
+        minZ.push_back(bounds.min.z);
+        maxX.push_back(bounds.max.x);
+        maxY.push_back(bounds.max.y);
+        maxZ.push_back(bounds.max.z);
+        entities.push_back(entity);
+    }
+
+    void BroadphaseBounds::Clear()
+    {
+        minX.clear(); minY.clear(); minZ.clear();
+        maxX.clear(); maxY.clear(); maxZ.clear();
+        entities.clear();
+    }
+
+    void BroadphaseBounds::Reserve(size_t count)
+    {
+        minX.reserve(count); minY.reserve(count); minZ.reserve(count);
+        maxX.reserve(count); maxY.reserve(count); maxZ.reserve(count);
+        entities.reserve(count);
+    }
+
+    size_t BroadphaseBounds::Size() const
+    {
+        return entities.size();
+    }
+
+    void SweepAndPrune(const BroadphaseBounds & bounds, std::vector<ContactPair> & pairs)
+    {
+        pairs.clear();
+
+        const size_t count = bounds.Size();
+        if (count < 2)
+        {
+            return;
+        }
+
+        // sort the volumes along x
+        std::vector<size_t> order(count);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&bounds](size_t left, size_t right) { return bounds.minX[left] < bounds.minX[right]; });
+
+        // copy into sorted arrays, padded so four wide loads never read past the end.  padding is an
+        // inverted volume, which fails every overlap test, so it never needs to be masked out.
+        const float inf = std::numeric_limits<float>::infinity();
+        const size_t padded = count + 3;
+        std::vector<float> minX(padded, inf), minY(padded, inf), minZ(padded, inf);
+        std::vector<float> maxX(padded, -inf), maxY(padded, -inf), maxZ(padded, -inf);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const size_t s = order[i];
+            minX[i] = bounds.minX[s]; minY[i] = bounds.minY[s]; minZ[i] = bounds.minZ[s];
+            maxX[i] = bounds.maxX[s]; maxY[i] = bounds.maxY[s]; maxZ[i] = bounds.maxZ[s];
+        }
+
+        auto add_pair = [&](size_t i, size_t j)
+        {
+            const EntityHandle & first = bounds.entities[order[i]];
+            const EntityHandle & second = bounds.entities[order[j]];
+            if (first != second)
+            {
+                pairs.push_back(ContactPair(first, second));
+            }
+        };
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            // every volume that starts before this one ends overlaps it on x
+            const size_t end = std::upper_bound(minX.begin() + i + 1, minX.begin() + count, maxX[i]) - minX.begin();
+
+#if defined(ALPHA_SIMD_SSE2)
+            const __m128 a_min_y = _mm_set1_ps(minY[i]);
+            const __m128 a_min_z = _mm_set1_ps(minZ[i]);
+            const __m128 a_max_y = _mm_set1_ps(maxY[i]);
+            const __m128 a_max_z = _mm_set1_ps(maxZ[i]);
+            for (size_t j = i + 1; j < end; j += 4)
+            {
+                __m128 overlap = _mm_and_ps(_mm_cmple_ps(a_min_y, _mm_loadu_ps(&maxY[j])),
+                                            _mm_cmple_ps(_mm_loadu_ps(&minY[j]), a_max_y));
+                overlap = _mm_and_ps(overlap, _mm_cmple_ps(a_min_z, _mm_loadu_ps(&maxZ[j])));
+                overlap = _mm_and_ps(overlap, _mm_cmple_ps(_mm_loadu_ps(&minZ[j]), a_max_z));
+
+                // lanes past the end of the x range are real volumes, so they do have to be masked
+                const size_t lanes = std::min<size_t>(4, end - j);
+                int mask = _mm_movemask_ps(overlap) & ((1 << lanes) - 1);
+                for (size_t lane = 0; mask != 0; ++lane, mask >>= 1)
+                {
+                    if (mask & 1)
+                    {
+                        add_pair(i, j + lane);
+                    }
+                }
+            }
+#else
+            for (size_t j = i + 1; j < end; ++j)
+            {
+                if (minY[i] <= maxY[j] && minY[j] <= maxY[i] &&
+                    minZ[i] <= maxZ[j] && minZ[j] <= maxZ[i])
+                {
+                    add_pair(i, j);
+                }
+            }
+#endif
+        }
+
+        std::sort(pairs.begin(), pairs.end());
+        pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+    }
+}
@@ -0,0 +1,62 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "Collision/CollisionEvents.h"
+
+namespace alpha
+{
+    const std::string Event_ContactsBegan::sk_name = "Event_ContactsBegan";
+
+    Event_ContactsBegan::Event_ContactsBegan(std::vector<ContactPair> contacts)
+        : m_contacts(std::move(contacts))
+    { }
+
+    std::string Event_ContactsBegan::VGetTypeName() const
+    {
+        return Event_ContactsBegan::sk_name;
+    }
+
+    AEvent * Event_ContactsBegan::VCopy()
+    {
+        return new Event_ContactsBegan(m_contacts);
+    }
+
+    const std::vector<ContactPair> & Event_ContactsBegan::GetContacts() const
+    {
+        return m_contacts;
+    }
+
+    const std::string Event_ContactsEnded::sk_name = "Event_ContactsEnded";
+
+    Event_ContactsEnded::Event_ContactsEnded(std::vector<ContactPair> contacts)
+        : m_contacts(std::move(contacts))
+    { }
+
+    std::string Event_ContactsEnded::VGetTypeName() const
+    {
+        return Event_ContactsEnded::sk_name;
+    }
+
+    AEvent * Event_ContactsEnded::VCopy()
+    {
+        return new Event_ContactsEnded(m_contacts);
+    }
+
+    const std::vector<ContactPair> & Event_ContactsEnded::GetContacts() const
+    {
+        return m_contacts;
+    }
+}
@@ -0,0 +1,57 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+#include <iterator>
+
+#include "Collision/Task_Broadphase.h"
+#include "Collision/CollisionEvents.h"
+
+namespace alpha
+{
+    Task_Broadphase::Task_Broadphase(std::shared_ptr<BroadphaseState> pState, BroadphaseBounds bounds,
+                                     std::function<void(AEvent *)> delPublishEvent)
+        : m_pState(pState)
+        , m_bounds(std::move(bounds))
+        , m_delPublishEvent(delPublishEvent)
+    { }
+
+    bool Task_Broadphase::VExecute()
+    {
+        std::vector<ContactPair> contacts;
+        SweepAndPrune(m_bounds, contacts);
+
+        // both lists are sorted, so the changes fall out of a pair of linear set differences
+        std::vector<ContactPair> began;
+        std::vector<ContactPair> ended;
+        std::set_difference(contacts.begin(), contacts.end(), m_pState->contacts.begin(), m_pState->contacts.end(), std::back_inserter(began));
+        std::set_difference(m_pState->contacts.begin(), m_pState->contacts.end(), contacts.begin(), contacts.end(), std::back_inserter(ended));
+
+        m_pState->contacts = std::move(contacts);
+
+        if (!began.empty())
+        {
+            m_delPublishEvent(new Event_ContactsBegan(std::move(began)));
+        }
+        if (!ended.empty())
+        {
+            m_delPublishEvent(new Event_ContactsEnded(std::move(ended)));
+        }
+
+        m_pState->busy = false;
+        return true;
+    }
+}
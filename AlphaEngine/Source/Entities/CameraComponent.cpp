@@ -19,23 +19,79 @@ limitations under the License.
 #include "Graphics/Camera.h"
 #include "Math/Vector3.h"
 #include "Math/Quaternion.h"
+#include "Toolbox/BinaryStream.h"
+#include "Toolbox/Logger.h"
 
 namespace alpha
 {
     const std::string CameraComponent::sk_name = "camera";
 
+    namespace
+    {
+        struct CameraDescriptor : SceneComponent::Descriptor
+        {
+            CameraDescriptor()
+                : fov(45.f)
+                , nearPlane(0.1f)
+                , farPlane(100.f)
+            { }
+
+            float fov;
+            float nearPlane;
+            float farPlane;
+        };
+
+        const ComponentSchema<CameraDescriptor> & GetCameraSchema()
+        {
+            static const ComponentSchema<CameraDescriptor> schema = [] ()
+            {
+                ComponentSchema<CameraDescriptor> fields;
+                SceneComponent::AddSchemaFields(fields);
+                fields.AddFloat("fov", fields.Layout().fov);
+                fields.AddFloat("near", fields.Layout().nearPlane);
+                fields.AddFloat("far", fields.Layout().farPlane);
+                return fields;
+            }();
+            return schema;
+        }
+    }
+
     CameraComponent::~CameraComponent() { }
 
     //! Provides logic for how to initialize a transform component from Lua script data
-    void CameraComponent::VInitialize(std::shared_ptr<LuaVar> var)
+    void CameraComponent::VInitialize(const LuaVar & var)
     {
-        std::shared_ptr<LuaTable> table = std::dynamic_pointer_cast<LuaTable>(var);
+        CameraDescriptor descriptor;
+        if (!GetCameraSchema().Parse(var, descriptor))
+        {
+            LOG_ERR("CameraComponent > Script variable data does not represent a valid data table.");
+            return;
+        }
 
-        m_fov = this->ParseFloatVar(table->Get("fov"), 45.f);
-        m_near = this->ParseFloatVar(table->Get("near"), 0.1f);
-        m_far = this->ParseFloatVar(table->Get("far"), 100.f);
+        m_fov = descriptor.fov;
+        m_near = descriptor.nearPlane;
+        m_far = descriptor.farPlane;
+        this->ApplyDescriptor(descriptor);
+    }
 
-        SceneComponent::VInitialize(var);
+    void CameraComponent::VSerialize(BinaryWriter & writer) const
+    {
+        SceneComponent::VSerialize(writer);
+        writer.Write(m_fov);
+        writer.Write(m_near);
+        writer.Write(m_far);
+    }
+
+    bool CameraComponent::VDeserialize(BinaryReader & reader)
+    {
+        if (!SceneComponent::VDeserialize(reader))
+        {
+            return false;
+        }
+        reader.Read(m_fov);
+        reader.Read(m_near);
+        reader.Read(m_far);
+        return reader.IsValid();
     }
 
     bool CameraComponent::VUpdate(float /*fCurrentTime*/, float /*fElapsedTime*/)
@@ -62,20 +118,4 @@ namespace alpha
     {
         return m_far;
     }
-
-    float CameraComponent::ParseFloatVar(std::shared_ptr<LuaVar> var, float defaultValue)
-    {
-        if (var != nullptr)
-        {
-            std::shared_ptr<LuaStatic<double>> fVar = std::dynamic_pointer_cast<LuaStatic<double>>(var);
-            // make sure cast succeeded
-            if (fVar)
-            {
-                return static_cast<float>(fVar->GetValue());
-            }
-        }
-
-        // return default value
-        return defaultValue;
-    }
 }
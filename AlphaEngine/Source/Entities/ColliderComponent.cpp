@@ -0,0 +1,149 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "Entities/ColliderComponent.h"
+#include "Scripting/LuaVar.h"
+#include "Toolbox/BinaryStream.h"
+#include "Toolbox/Logger.h"
+
+namespace alpha
+{
+    const std::string ColliderComponent::sk_name = "collider";
+
+    namespace
+    {
+        struct ColliderDescriptor : SceneComponent::Descriptor
+        {
+            ColliderDescriptor()
+                : shape(CS_BOX)
+                , extents(0.5f, 0.5f, 0.5f)
+                , radius(0.5f)
+            { }
+
+            int shape;
+            Vector3 extents;
+            float radius;
+        };
+
+        const ComponentSchema<ColliderDescriptor> & GetColliderSchema()
+        {
+            static const ComponentSchema<ColliderDescriptor> schema = [] ()
+            {
+                ComponentSchema<ColliderDescriptor> fields;
+                const ColliderDescriptor & layout = fields.Layout();
+                SceneComponent::AddSchemaFields(fields);
+                fields.AddEnum("shape", layout.shape, { { "box", CS_BOX }, { "sphere", CS_SPHERE } });
+                fields.AddVector3("extents", layout.extents);
+                fields.AddFloat("radius", layout.radius);
+                return fields;
+            }();
+            return schema;
+        }
+    }
+
+    ColliderComponent::ColliderComponent()
+        : m_eShape(CS_BOX)
+        , m_vExtents(0.5f, 0.5f, 0.5f)
+        , m_fRadius(0.5f)
+    { }
+    ColliderComponent::~ColliderComponent() { }
+
+    void ColliderComponent::VInitialize(const LuaVar & var)
+    {
+        ColliderDescriptor descriptor;
+        if (!GetColliderSchema().Parse(var, descriptor))
+        {
+            LOG_ERR("ColliderComponent > Script variable data does not represent a valid data table.");
+            return;
+        }
+
+        m_eShape = static_cast<ColliderShape>(descriptor.shape);
+        m_vExtents = descriptor.extents;
+        m_fRadius = descriptor.radius;
+        this->ApplyDescriptor(descriptor);
+    }
+
+    void ColliderComponent::VSerialize(BinaryWriter & writer) const
+    {
+        SceneComponent::VSerialize(writer);
+        writer.Write(static_cast<uint32_t>(m_eShape));
+        writer.Write(m_vExtents);
+        writer.Write(m_fRadius);
+    }
+
+    bool ColliderComponent::VDeserialize(BinaryReader & reader)
+    {
+        if (!SceneComponent::VDeserialize(reader))
+        {
+            return false;
+        }
+        uint32_t shape = CS_BOX;
+        reader.Read(shape);
+        m_eShape = (shape == CS_SPHERE) ? CS_SPHERE : CS_BOX;
+        reader.Read(m_vExtents);
+        reader.Read(m_fRadius);
+        return reader.IsValid();
+    }
+
+    bool ColliderComponent::VUpdate(float /*fCurrentTime*/, float /*fElapsedTime*/)
+    {
+        return true;
+    }
+
+    std::string ColliderComponent::VGetName() const
+    {
+        return ColliderComponent::sk_name;
+    }
+
+    ColliderShape ColliderComponent::GetShape() const
+    {
+        return m_eShape;
+    }
+
+    const Vector3 & ColliderComponent::GetExtents() const
+    {
+        return m_vExtents;
+    }
+
+    float ColliderComponent::GetRadius() const
+    {
+        return m_fRadius;
+    }
+
+    AABB ColliderComponent::GetWorldBounds() const
+    {
+        // row vectors, so parent transforms are applied on the right
+        Matrix world = this->GetTransform();
+        auto parent = this->GetParent().lock();
+        while (parent != nullptr)
+        {
+            if (auto scene_parent = std::dynamic_pointer_cast<SceneComponent>(parent))
+            {
+                world = world * scene_parent->GetTransform();
+            }
+            parent = parent->GetParent().lock();
+        }
+
+        if (m_eShape == CS_SPHERE)
+        {
+            Vector3 center = world.Position();
+            Vector3 radius(m_fRadius, m_fRadius, m_fRadius);
+            return AABB(center - radius, center + radius);
+        }
+
+        return AABB(Vector3(-m_vExtents.x, -m_vExtents.y, -m_vExtents.z), m_vExtents).Transform(world);
+    }
+}
@@ -0,0 +1,209 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cstring>
+#include <limits>
+
+#include "Entities/ComponentSchema.h"
+#include "Scripting/LuaVar.h"
+#include "Toolbox/Logger.h"
+
+namespace alpha
+{
+    const size_t SchemaLayout::sk_noFlag = std::numeric_limits<size_t>::max();
+
+    SchemaLayout::Table::Table()
+        : flagOffset(sk_noFlag)
+    { }
+
+    SchemaLayout::SchemaLayout()
+        : m_tables(1)
+    { }
+
+    void SchemaLayout::AddField(const std::string & path, SchemaFieldType type, size_t offset)
+    {
+        std::string key;
+        size_t table = this->GetTable(path, key);
+
+        Field field;
+        field.type = type;
+        field.offset = offset;
+        field.path = path;
+        m_fields.push_back(field);
+
+        Entry entry;
+        entry.isField = true;
+        entry.index = m_fields.size() - 1;
+        if (!m_tables[table].entries.insert(std::make_pair(key, entry)).second)
+        {
+            LOG_WARN("ComponentSchema > Script path '", path, "' is registered more than once.");
+        }
+    }
+
+    void SchemaLayout::AddEnum(const std::string & path, size_t offset, const std::map<std::string, int> & values)
+    {
+        this->AddField(path, SF_ENUM, offset);
+        m_fields.back().values = values;
+    }
+
+    void SchemaLayout::AddTableFlag(const std::string & path, size_t offset)
+    {
+        // the path names a table itself, so look up a child that does not exist to land on it
+        std::string key;
+        size_t table = this->GetTable(path + ".", key);
+        m_tables[table].flagOffset = offset;
+    }
+
+    bool SchemaLayout::Parse(const LuaVar & var, char * pDescriptor) const
+    {
+        if (!var.IsTable())
+        {
+            return false;
+        }
+
+        this->ParseTable(0, var, pDescriptor);
+        return true;
+    }
+
+    size_t SchemaLayout::GetTable(const std::string & path, std::string & key)
+    {
+        size_t table = 0;
+        size_t start = 0;
+        size_t dot = path.find('.');
+        while (dot != std::string::npos)
+        {
+            const std::string name = path.substr(start, dot - start);
+
+            auto it = m_tables[table].entries.find(name);
+            if (it == m_tables[table].entries.end())
+            {
+                Entry entry;
+                entry.isField = false;
+                entry.index = m_tables.size();
+                m_tables.push_back(Table());
+                it = m_tables[table].entries.insert(std::make_pair(name, entry)).first;
+            }
+            else if (it->second.isField)
+            {
+                LOG_WARN("ComponentSchema > Script path '", path, "' runs through a field.");
+            }
+            table = it->second.index;
+
+            start = dot + 1;
+            dot = path.find('.', start);
+        }
+
+        key = path.substr(start);
+        return table;
+    }
+
+    void SchemaLayout::ParseTable(size_t table, const LuaVar & script, char * pDescriptor) const
+    {
+        const Table & schema = m_tables[table];
+        if (schema.flagOffset != sk_noFlag)
+        {
+            *reinterpret_cast<bool *>(pDescriptor + schema.flagOffset) = true;
+        }
+
+        // both sides are sorted by key, so one walk over each finds every match
+        const size_t count = script.Size();
+        size_t pair = 0;
+        auto entry = schema.entries.begin();
+        while (pair < count && entry != schema.entries.end())
+        {
+            const int order = strcmp(script.GetKey(pair), entry->first.c_str());
+            if (order < 0)
+            {
+                ++pair;
+            }
+            else if (order > 0)
+            {
+                ++entry;
+            }
+            else
+            {
+                const LuaVar value = script.GetValue(pair);
+                if (entry->second.isField)
+                {
+                    this->ParseField(m_fields[entry->second.index], value, pDescriptor);
+                }
+                else if (value.IsTable())
+                {
+                    this->ParseTable(entry->second.index, value, pDescriptor);
+                }
+                ++pair;
+                ++entry;
+            }
+        }
+    }
+
+    void SchemaLayout::ParseField(const Field & field, const LuaVar & var, char * pDescriptor) const
+    {
+        // values of the wrong type are skipped, leaving the descriptors default in place
+        char * pValue = pDescriptor + field.offset;
+        switch (field.type)
+        {
+        case SF_FLOAT:
+            if (var.GetVarType() == VT_NUMBER)
+            {
+                *reinterpret_cast<float *>(pValue) = static_cast<float>(var.GetNumber());
+            }
+            break;
+        case SF_UINT:
+            if (var.GetVarType() == VT_NUMBER)
+            {
+                *reinterpret_cast<unsigned int *>(pValue) = var.GetNumber() > 0.0 ? static_cast<unsigned int>(var.GetNumber()) : 0;
+            }
+            break;
+        case SF_BOOL:
+            if (var.GetVarType() == VT_BOOLEAN)
+            {
+                *reinterpret_cast<bool *>(pValue) = var.GetBool();
+            }
+            break;
+        case SF_STRING:
+            if (var.GetVarType() == VT_STRING)
+            {
+                *reinterpret_cast<std::string *>(pValue) = var.GetString();
+            }
+            break;
+        case SF_ENUM:
+            if (var.GetVarType() == VT_STRING)
+            {
+                auto value = field.values.find(var.GetString());
+                if (value != field.values.end())
+                {
+                    *reinterpret_cast<int *>(pValue) = value->second;
+                }
+                else
+                {
+                    LOG_WARN("ComponentSchema > Unknown value '", var.GetString(), "' for '", field.path, "', using the default.");
+                }
+            }
+            break;
+        case SF_STRING_MAP:
+            for (size_t i = 0; i < var.Size(); ++i)
+            {
+                const LuaVar value = var.GetValue(i);
+                if (value.GetVarType() == VT_STRING)
+                {
+                    (*reinterpret_cast<std::map<std::string, std::string> *>(pValue))[var.GetKey(i)] = value.GetString();
+                }
+            }
+            break;
+        }
+    }
+}
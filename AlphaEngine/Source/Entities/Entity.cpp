@@ -16,21 +16,38 @@ limitations under the License.
 
 #include "Entities/Entity.h"
 #include "Entities/EntityComponent.h"
+#include "Entities/EntityScript.h"
 
 #include "Toolbox/Logger.h"
 
 namespace alpha
 {
-    Entity::Entity(unsigned long entityId, std::shared_ptr<EntityScript> script)
-        : m_entityId(entityId)
+    Entity::Entity(std::shared_ptr<EntityScript> script)
+        : m_tags(script != nullptr ? script->GetTags() : ET_NONE)
         , m_script(script)
+        , m_awake(false)
+        , m_requiresUpdate(false)
     { }
-    Entity::~Entity() { }
+    Entity::~Entity()
+    {
+        // components can outlive the entity, make sure they do not keep a dangling owner.
+        for (auto key_value : m_allComponents)
+        {
+            if (key_value.second->GetOwner() == this)
+            {
+                key_value.second->SetOwner(nullptr);
+            }
+        }
+    }
 
     bool Entity::Update(float fCurrentTime, float fElapsedTime)
     {
         bool entity_updated = false;
 
+        // go back to sleep before ticking, so anything that changes during or
+        // after this update wakes the entity again for the next tick.
+        m_awake = false;
+
         // update all entity components
         for (auto key_value : m_allComponents)
         {
@@ -41,9 +58,42 @@ namespace alpha
         return entity_updated;
     }
 
-    unsigned long Entity::GetId() const
+    bool Entity::Update(float fCurrentTime, float fElapsedTime, std::vector<ComponentDelta> & deltas)
     {
-        return m_entityId;
+        bool entity_updated = this->Update(fCurrentTime, fElapsedTime);
+
+        // journal what changed, so listeners only have to apply those fields
+        for (auto & key_value : m_allComponents)
+        {
+            unsigned int changes = key_value.second->TakeChanges();
+            if (changes != CC_NONE)
+            {
+                ComponentDelta delta = { m_handle, key_value.first, changes, nullptr };
+
+                // every other field is captured now, while this task is the only one touching the entity
+                if (changes & ~CC_TRANSFORM)
+                {
+                    auto values = std::make_shared<ComponentValues>();
+                    key_value.second->VCaptureChanges(changes, *values);
+                    delta.pValues = values;
+                }
+
+                deltas.push_back(std::move(delta));
+                entity_updated = true;
+            }
+        }
+
+        return entity_updated;
+    }
+
+    EntityHandle Entity::GetHandle() const
+    {
+        return m_handle;
+    }
+
+    void Entity::SetHandle(const EntityHandle & handle)
+    {
+        m_handle = handle;
     }
 
     std::shared_ptr<EntityScript> Entity::GetScript() const
@@ -51,6 +101,51 @@ namespace alpha
         return m_script;
     }
 
+    EntityTagMask Entity::GetTags() const
+    {
+        return m_tags;
+    }
+
+    void Entity::SetTags(EntityTagMask tags)
+    {
+        m_tags = tags;
+    }
+
+    bool Entity::HasAnyTag(EntityTagMask tags) const
+    {
+        return (m_tags & tags) != 0;
+    }
+
+    void Entity::Wake()
+    {
+        // only notify the listener on the sleeping -> awake transition
+        if (!m_awake.exchange(true) && m_wakeListener)
+        {
+            m_wakeListener(this);
+        }
+    }
+
+    bool Entity::IsAwake() const
+    {
+        return m_awake;
+    }
+
+    bool Entity::RequiresUpdate() const
+    {
+        return m_requiresUpdate;
+    }
+
+    void Entity::SetWakeListener(std::function<void(Entity *)> listener)
+    {
+        m_wakeListener = listener;
+
+        // the entity may have been woken before anyone was listening
+        if (m_awake && m_wakeListener)
+        {
+            m_wakeListener(this);
+        }
+    }
+
     void Entity::Add(unsigned int component_id, std::shared_ptr<EntityComponent> component)
     {
         auto it = m_allComponents.find(component_id);
@@ -61,6 +156,12 @@ namespace alpha
         else 
         {
             m_allComponents[component_id] = component;
+            component->SetOwner(this);
+            m_requiresUpdate = m_requiresUpdate || component->VRequiresUpdate();
+
+            // keeps the first component added for each type
+            m_typeComponents.insert(std::make_pair(component->GetID(), component));
+
             auto spParent = component->GetParent().lock();
             if (spParent == nullptr)
             {
@@ -85,6 +186,26 @@ namespace alpha
         return nullptr;
     }
 
+    std::shared_ptr<EntityComponent> Entity::GetByID(unsigned int component_id) const
+    {
+        auto it = m_allComponents.find(component_id);
+        if (it != m_allComponents.end())
+        {
+            return it->second;
+        }
+        return nullptr;
+    }
+
+    std::shared_ptr<EntityComponent> Entity::GetOfType(unsigned int type_id) const
+    {
+        auto it = m_typeComponents.find(type_id);
+        if (it != m_typeComponents.end())
+        {
+            return it->second;
+        }
+        return nullptr;
+    }
+
     /*
     void Entity::Remove(unsigned int component_id)
     {
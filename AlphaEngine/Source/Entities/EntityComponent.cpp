@@ -18,16 +18,43 @@ limitations under the License.
 #include <string>
 
 #include "Entities/EntityComponent.h"
+#include "Entities/Entity.h"
 
 #include "Scripting/LuaVar.h"
 #include "Math/Vector3.h"
+#include "Toolbox/BinaryStream.h"
 #include "Toolbox/Logger.h"
 
 namespace alpha
 {
+    ComponentValues::ComponentValues()
+        : lightType(POINT)
+        , lightDistance(0.f)
+        , lightIntensity(0.f)
+        , lightAmbientIntensity(0.f)
+        , clipBlendTime(0.f)
+        , clipLoop(false)
+        , clipSpeed(1.f)
+    { }
+
     EntityComponent::EntityComponent()
-        : m_dirty(false)
+        : m_pOwner(nullptr)
+        , m_dirty(false)
+        , m_changes(CC_NONE)
+    { }
+    EntityComponent::EntityComponent(const EntityComponent & component)
+        : m_pOwner(nullptr)
+        , m_dirty(component.m_dirty)
+        , m_changes(component.m_changes.load())
     { }
+    EntityComponent & EntityComponent::operator=(const EntityComponent & component)
+    {
+        // owner, parent and children are left untouched, they describe where this
+        // component lives, not what it contains.
+        m_dirty = component.m_dirty;
+        m_changes = component.m_changes.load();
+        return *this;
+    }
     EntityComponent::~EntityComponent() { }
 
     void EntityComponent::SetParent(const std::shared_ptr<EntityComponent> & parent)
@@ -40,6 +67,16 @@ namespace alpha
         return m_parent;
     }
 
+    void EntityComponent::SetOwner(Entity * pOwner)
+    {
+        m_pOwner = pOwner;
+    }
+
+    Entity * EntityComponent::GetOwner() const
+    {
+        return m_pOwner;
+    }
+
     bool EntityComponent::Update(float fCurrentTime, float fElapsedTime)
     {
         // update the component implementation
@@ -51,6 +88,45 @@ namespace alpha
         return dirty;
     }
 
+    unsigned int EntityComponent::TakeChanges()
+    {
+        return m_changes.exchange(CC_NONE);
+    }
+
+    void EntityComponent::MarkReset()
+    {
+        this->MarkChanged(CC_ALL);
+    }
+
+    void EntityComponent::VCaptureChanges(unsigned int /*changes*/, ComponentValues & /*values*/) const { }
+
+    void EntityComponent::VSerialize(BinaryWriter & /*writer*/) const { }
+
+    bool EntityComponent::VDeserialize(BinaryReader & reader)
+    {
+        return reader.IsValid();
+    }
+
+    bool EntityComponent::VRequiresUpdate() const
+    {
+        return false;
+    }
+
+    void EntityComponent::Wake()
+    {
+        if (m_pOwner != nullptr)
+        {
+            m_pOwner->Wake();
+        }
+    }
+
+    void EntityComponent::MarkChanged(unsigned int changes)
+    {
+        m_changes |= changes;
+        m_dirty = true;
+        this->Wake();
+    }
+
     void EntityComponent::Attach(unsigned int component_id, std::shared_ptr<EntityComponent> component)
     {
         auto it = m_components.find(component_id);
@@ -78,50 +154,104 @@ namespace alpha
         return string_hash(name);
     }
 
+    namespace
+    {
+        const ComponentSchema<SceneComponent::Descriptor> & GetSceneSchema()
+        {
+            static const ComponentSchema<SceneComponent::Descriptor> schema = [] ()
+            {
+                ComponentSchema<SceneComponent::Descriptor> fields;
+                SceneComponent::AddSchemaFields(fields);
+                return fields;
+            }();
+            return schema;
+        }
+    }
+
+    SceneComponent::Descriptor::Descriptor()
+        : hasTransform(false)
+    { }
+
+    SceneComponent::SceneComponent()
+        : m_transformDirty(false)
+        , m_transformVersion(0)
+    { }
+    SceneComponent::SceneComponent(const SceneComponent & component)
+        : EntityComponent(component)
+        , m_transformDirty(true)
+        , m_transformVersion(0)
+        , m_sMaterial(component.m_sMaterial)
+    {
+        std::lock_guard<std::mutex> lock(component.m_transformMutex);
+        m_vPosition = component.m_vPosition;
+        m_vScale = component.m_vScale;
+        m_qRotation = component.m_qRotation;
+        m_transformVersion = component.m_transformVersion.load();
+    }
+    SceneComponent & SceneComponent::operator=(const SceneComponent & component)
+    {
+        if (this == &component)
+        {
+            return *this;
+        }
+
+        EntityComponent::operator=(component);
+        Vector3 position = component.GetPosition();
+        Vector3 scale = component.GetScale();
+        Quaternion rotation = component.GetRotation();
+        m_sMaterial = component.m_sMaterial;
+
+        {
+            std::lock_guard<std::mutex> lock(m_transformMutex);
+            m_vPosition = position;
+            m_vScale = scale;
+            m_qRotation = rotation;
+            // keep counting from this components own version, copying it could land on a version a cache has already seen
+            this->InvalidateTransform();
+        }
+        this->MarkChanged(CC_TRANSFORM);
+        return *this;
+    }
     SceneComponent::~SceneComponent() { }
 
-    void SceneComponent::VInitialize(std::shared_ptr<LuaVar> var)
+    void SceneComponent::VInitialize(const LuaVar & var)
     {
         // var should represent a LUA table containing some of the following variables:
         // 1. transform
-        // 2. light_emitter
-        // 3. light_color
-
-        if (var->GetVarType() != VT_TABLE)
+        // 2. material
+        Descriptor descriptor;
+        if (!GetSceneSchema().Parse(var, descriptor))
         {
             LOG_ERR("Script variable data does not represent a valid data table.");
             return;
         }
+        this->ApplyDescriptor(descriptor);
+    }
 
-        std::shared_ptr<LuaTable> data_table = std::dynamic_pointer_cast<LuaTable>(var);
-
-        // get and handle transform
-        std::shared_ptr<LuaTable> transform_table = std::dynamic_pointer_cast<LuaTable>(data_table->Get("transform"));
-        if (transform_table != nullptr)
+    void SceneComponent::VSerialize(BinaryWriter & writer) const
+    {
         {
-            // get the position, scale, and rotation tables.
-            std::shared_ptr<LuaTable> position = std::dynamic_pointer_cast<LuaTable>(transform_table->Get("position"));
-            std::shared_ptr<LuaTable> rotation = std::dynamic_pointer_cast<LuaTable>(transform_table->Get("rotation"));
-            std::shared_ptr<LuaTable> scale = std::dynamic_pointer_cast<LuaTable>(transform_table->Get("scale"));
-
-            // get x, y, z values for each position, scale, and rotation.
-            this->GetTableVarValue(position, "x", &m_vPosition.x);
-            this->GetTableVarValue(position, "y", &m_vPosition.y);
-            this->GetTableVarValue(position, "z", &m_vPosition.z);
-
-            this->GetTableVarValue(scale, "x", &m_vScale.x);
-            this->GetTableVarValue(scale, "y", &m_vScale.y);
-            this->GetTableVarValue(scale, "z", &m_vScale.z);
-
-            // TODO - read rotation value and convert to quaternion
-
-            this->UpdateTransform();
+            std::lock_guard<std::mutex> lock(m_transformMutex);
+            writer.Write(m_vPosition);
+            writer.Write(m_qRotation);
+            writer.Write(m_vScale);
         }
+        writer.WriteString(m_sMaterial);
+    }
 
-        if (auto material_var = std::dynamic_pointer_cast<LuaStatic<std::string>>(data_table->Get("material")))
+    bool SceneComponent::VDeserialize(BinaryReader & reader)
+    {
         {
-            m_sMaterial = material_var->GetValue();
+            std::lock_guard<std::mutex> lock(m_transformMutex);
+            reader.Read(m_vPosition);
+            reader.Read(m_qRotation);
+            reader.Read(m_vScale);
+            this->InvalidateTransform();
         }
+        reader.ReadString(m_sMaterial);
+
+        this->MarkChanged(CC_TRANSFORM);
+        return reader.IsValid();
     }
 
     bool SceneComponent::IsDirty() const
@@ -129,26 +259,46 @@ namespace alpha
         return m_dirty;
     }
 
-    const Vector3 & SceneComponent::GetPosition() const
+    Vector3 SceneComponent::GetPosition() const
     {
+        std::lock_guard<std::mutex> lock(m_transformMutex);
         return m_vPosition;
     }
 
-    const Vector3 & SceneComponent::GetScale() const
+    Vector3 SceneComponent::GetScale() const
     {
+        std::lock_guard<std::mutex> lock(m_transformMutex);
         return m_vScale;
     }
 
-    const Quaternion & SceneComponent::GetRotation() const
+    Quaternion SceneComponent::GetRotation() const
     {
+        std::lock_guard<std::mutex> lock(m_transformMutex);
         return m_qRotation;
     }
 
-    Matrix SceneComponent::GetTransform() const
+    Matrix SceneComponent::GetTransform(unsigned int * pVersion) const
     {
+        // the matrix and the version are read under the same lock, so the version handed back
+        // is exactly the one the matrix was composed from.
+        std::lock_guard<std::mutex> lock(m_transformMutex);
+        if (m_transformDirty)
+        {
+            m_mTransform = Matrix::Compose(m_vPosition, m_qRotation, m_vScale);
+            m_transformDirty = false;
+        }
+        if (pVersion != nullptr)
+        {
+            *pVersion = m_transformVersion;
+        }
         return m_mTransform;
     }
 
+    unsigned int SceneComponent::GetTransformVersion() const
+    {
+        return m_transformVersion;
+    }
+
     std::string SceneComponent::GetMaterialPath() const
     {
         return m_sMaterial;
@@ -156,53 +306,87 @@ namespace alpha
 
     void SceneComponent::SetPosition(const Vector3 & position)
     {
-        m_vPosition.x = position.x;
-        m_vPosition.y = position.y;
-        m_vPosition.z = position.z;
-
-        this->UpdateTransform();
+        {
+            std::lock_guard<std::mutex> lock(m_transformMutex);
+            m_vPosition.x = position.x;
+            m_vPosition.y = position.y;
+            m_vPosition.z = position.z;
+            this->InvalidateTransform();
+        }
+        this->MarkChanged(CC_TRANSFORM);
     }
     void SceneComponent::SetScale(const Vector3 & scale)
     {
-        m_vScale.x = scale.x;
-        m_vScale.y = scale.y;
-        m_vScale.z = scale.z;
-
-        this->UpdateTransform();
+        {
+            std::lock_guard<std::mutex> lock(m_transformMutex);
+            m_vScale.x = scale.x;
+            m_vScale.y = scale.y;
+            m_vScale.z = scale.z;
+            this->InvalidateTransform();
+        }
+        this->MarkChanged(CC_TRANSFORM);
     }
 
     void SceneComponent::SetRotation(const Quaternion & rotation)
     {
-        m_qRotation.x = rotation.x;
-        m_qRotation.y = rotation.y;
-        m_qRotation.z = rotation.z;
-        m_qRotation.w = rotation.w;
+        {
+            std::lock_guard<std::mutex> lock(m_transformMutex);
+            m_qRotation.x = rotation.x;
+            m_qRotation.y = rotation.y;
+            m_qRotation.z = rotation.z;
+            m_qRotation.w = rotation.w;
+            this->InvalidateTransform();
+        }
+        this->MarkChanged(CC_TRANSFORM);
+    }
+
+    void SceneComponent::VCaptureChanges(unsigned int changes, ComponentValues & values) const
+    {
+        if (changes & CC_MATERIAL)
+        {
+            values.materialPath = m_sMaterial;
+        }
+    }
 
-        this->UpdateTransform();
+    void SceneComponent::SetMaterialPath(const std::string & material)
+    {
+        m_sMaterial = material;
+        this->MarkChanged(CC_MATERIAL);
     }
 
-    void SceneComponent::GetTableVarValue(std::shared_ptr<LuaTable> table, const std::string key, float * const out)
+    void SceneComponent::ApplyDescriptor(const Descriptor & descriptor)
     {
-        std::shared_ptr<LuaStatic<double> > var = std::dynamic_pointer_cast<LuaStatic<double>>(table->Get(key));
-        if (var != nullptr && out != nullptr)
+        // the descriptor starts from the same defaults as the component, so only a script
+        // transform counts as a change.
+        if (descriptor.hasTransform)
         {
-            *out = static_cast<float>(var->GetValue());
+            {
+                std::lock_guard<std::mutex> lock(m_transformMutex);
+                m_vPosition = descriptor.position;
+                m_vScale = descriptor.scale;
+                this->InvalidateTransform();
+            }
+            this->MarkChanged(CC_TRANSFORM);
         }
+        m_sMaterial = descriptor.material;
     }
 
     void SceneComponent::UpdateTransform()
     {
-        // star with identity matrix
-        this->m_mTransform = Matrix();
+        {
+            std::lock_guard<std::mutex> lock(m_transformMutex);
+            this->InvalidateTransform();
+        }
 
-        // then apply vector transforms
-        // always apply R -> S -> T
-        this->m_mTransform = this->m_mTransform * Matrix::Rotate(this->m_qRotation);
-        this->m_mTransform = this->m_mTransform * Matrix::Scale(this->m_vScale);
-        this->m_mTransform = this->m_mTransform * Matrix::Translate(this->m_vPosition);
+        // journal the change, and make sure the entity is awake to pass it along.
+        this->MarkChanged(CC_TRANSFORM);
+    }
 
-        // mark this component as dirty, so it can notify the parent entity
-        // that an update has occured.
-        m_dirty = true;
+    void SceneComponent::InvalidateTransform()
+    {
+        // defer building the matrix until someone asks for it, so several setter calls
+        // in a row only cost a single compose.
+        m_transformDirty = true;
+        ++m_transformVersion;
     }
 }
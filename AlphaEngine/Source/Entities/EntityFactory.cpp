@@ -23,6 +23,9 @@ limitations under the License.
 #include "Entities/MeshComponent.h"
 #include "Entities/LightComponent.h"
 #include "Entities/CameraComponent.h"
+#include "Entities/ColliderComponent.h"
+#include "Entities/ParticleEmitterComponent.h"
+#include "Entities/SkinnedMeshComponent.h"
 #include "Entities/EntityScript.h"
 
 #include "Assets/AssetSystem.h"
@@ -37,56 +40,173 @@ namespace alpha
         RegisterComponent<MeshComponent>(EntityComponent::GetIDFromName(MeshComponent::sk_name));
         RegisterComponent<LightComponent>(EntityComponent::GetIDFromName(LightComponent::sk_name));
         RegisterComponent<CameraComponent>(EntityComponent::GetIDFromName(CameraComponent::sk_name));
+        RegisterComponent<ColliderComponent>(EntityComponent::GetIDFromName(ColliderComponent::sk_name));
+        RegisterComponent<ParticleEmitterComponent>(EntityComponent::GetIDFromName(ParticleEmitterComponent::sk_name));
+        RegisterComponent<SkinnedMeshComponent>(EntityComponent::GetIDFromName(SkinnedMeshComponent::sk_name));
     }
 
     std::shared_ptr<Entity> EntityFactory::CreateEntity(std::shared_ptr<Asset> asset)
     {
-        // TODO:
-        // Creating a single entity is most likely never the common case.
-        // More than likely we will need to batch create 2 or more entities
-        // based on the same script asset.  This method should be enhanced so
-        // that it can create multiple entities in a data oriented manner.
-
-        // 1. get a list of components that the script wants to make
-        
-        // 2. use the data from the script, build each component once, so it can be copied
-        
-        // 3. for 0 to N: 
-        //        create an entity
-        //        for each component
-        //            copy component
-        //            add copy to entity.
+        auto entities = this->CreateEntities(asset, 1);
+        if (entities.empty())
+        {
+            return nullptr;
+        }
+        return entities[0];
+    }
 
-        auto script = std::make_shared<EntityScript>(asset);
-        auto entity = std::make_shared<Entity>(m_lastEntityId++, script);
-        
-        // iterate over the list of component variables list in the script
-        // and create a component for that variable, if it is properly registered.
-        auto vars = script->GetComponentVars();
-        for (auto var_pair : vars)
+    std::vector<std::shared_ptr<Entity> > EntityFactory::CreateEntities(std::shared_ptr<Asset> asset, unsigned int count)
+    {
+        std::vector<std::shared_ptr<Entity> > entities;
+        if (count == 0 || asset == nullptr)
+        {
+            return entities;
+        }
+
+        // held for the whole build, the cache may be cleared from another thread in the meantime
+        std::shared_ptr<const Prototype> prototype = this->GetPrototype(asset);
+        const std::vector<PrototypeRecord> & records = prototype->records;
+
+        // for 0 to N, copy every prototype component and rebuild the hierarchy.
+        entities.reserve(count);
+        std::vector<std::shared_ptr<EntityComponent> > copies(records.size());
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            auto entity = std::make_shared<Entity>(prototype->script);
+
+            for (size_t r = 0; r < records.size(); ++r)
+            {
+                const PrototypeRecord & record = records[r];
+                std::shared_ptr<EntityComponent> component(record.copy(*record.component));
+
+                // parents are always copied before their children
+                if (record.parent >= 0)
+                {
+                    auto & parent = copies[record.parent];
+                    parent->Attach(record.component_id, component);
+                    component->SetParent(parent);
+                }
+
+                entity->Add(record.component_id, component);
+                copies[r] = component;
+            }
+
+            entities.push_back(entity);
+        }
+
+        return entities;
+    }
+
+    bool EntityFactory::ResetEntity(std::shared_ptr<Asset> asset, Entity & entity)
+    {
+        if (asset == nullptr)
+        {
+            return false;
+        }
+
+        // an entity built from a prototype that has since been cleared may not line up with the new one
+        std::shared_ptr<const Prototype> prototype = this->GetPrototype(asset);
+        if (entity.GetScript() != prototype->script)
         {
-            if (var_pair.second->GetVarType() == VT_TABLE)
+            return false;
+        }
+
+        for (auto & record : prototype->records)
+        {
+            auto component = entity.GetByID(record.component_id);
+            if (component == nullptr || component->GetID() != record.component->GetID())
             {
-                this->CreateComponent(entity, nullptr, var_pair.first, var_pair.second);
+                return false;
             }
+
+            // components keep their place in the hierarchy, only their data is copied over
+            record.assign(*component, *record.component);
+            component->MarkReset();
+        }
+
+        entity.SetTags(prototype->script->GetTags());
+        return true;
+    }
+
+    std::shared_ptr<EntityComponent> EntityFactory::CreateComponentOfType(unsigned int typeId)
+    {
+        auto it = m_componentCreationFunctions.find(typeId);
+        if (it == m_componentCreationFunctions.end())
+        {
+            return nullptr;
         }
+        return std::shared_ptr<EntityComponent>(it->second());
+    }
 
-        return entity;
+    std::shared_ptr<EntityScript> EntityFactory::GetCachedScript(const std::string & path) const
+    {
+        std::lock_guard<std::mutex> lock(m_prototypeMutex);
+        auto it = m_prototypes.find(path);
+        if (it != m_prototypes.end())
+        {
+            return it->second->script;
+        }
+        return nullptr;
+    }
+
+    void EntityFactory::ClearPrototypes()
+    {
+        std::lock_guard<std::mutex> lock(m_prototypeMutex);
+        m_prototypes.clear();
     }
 
-    void EntityFactory::CreateComponent(std::shared_ptr<Entity> entity, std::shared_ptr<EntityComponent> parent_component, const std::string & var_name, std::shared_ptr<LuaVar> var_value)
+    std::shared_ptr<const EntityFactory::Prototype> EntityFactory::GetPrototype(std::shared_ptr<Asset> asset)
     {
-        // convert var data to a table so we can access its elements
-        auto table = std::dynamic_pointer_cast<LuaTable>(var_value);
+        const std::string path = asset->GetPath();
+        {
+            std::lock_guard<std::mutex> lock(m_prototypeMutex);
+            auto it = m_prototypes.find(path);
+            if (it != m_prototypes.end())
+            {
+                return it->second;
+            }
+        }
+
+        LOG("EntityFactory -> Building prototype for script: ", path);
+
+        // 1. run the script once, the script releases its lua state as soon as
+        // the components table has been read, so only the parsed data is kept.
+        auto script = std::make_shared<EntityScript>(asset);
+
+        // 2. build a fully initialized prototype entity from the script.
+        auto entity = std::make_shared<Entity>(script);
+        const LuaVar components = script->GetComponentVars();
+        for (size_t i = 0; i < components.Size(); ++i)
+        {
+            if (components.GetValue(i).IsTable())
+            {
+                this->CreateComponent(entity, nullptr, components.GetKey(i), components.GetValue(i));
+            }
+        }
+
+        // 3. flatten the prototype component tree, parents first, so that each
+        // entity can be built with a single linear pass over the records.
+        auto prototype = std::make_shared<Prototype>();
+        prototype->script = script;
+        this->FlattenPrototype(entity->GetComponents(), -1, prototype->records);
 
+        // only publish the prototype once it is complete.  if another thread built the same
+        // prototype in the meantime, use theirs so every entity shares one script.
+        std::lock_guard<std::mutex> lock(m_prototypeMutex);
+        return m_prototypes.insert(std::make_pair(path, prototype)).first->second;
+    }
+
+    void EntityFactory::CreateComponent(std::shared_ptr<Entity> entity, std::shared_ptr<EntityComponent> parent_component, const std::string & var_name, const LuaVar & var_value)
+    {
         // get the type name for this component
-        auto type_name = std::dynamic_pointer_cast<LuaStatic<std::string>>(table->Get("type"));
-        if (type_name != nullptr)
+        const LuaVar type_var = var_value.Get("type");
+        if (type_var.GetVarType() == VT_STRING)
         {
-            LOG("EntityFactory -> Attempting to create component type: ", type_name->GetValue());
+            const std::string type_name = type_var.GetString();
+            LOG("EntityFactory -> Attempting to create component type: ", type_name);
 
             // convert the variable name into a component id, and type name into type_id
-            unsigned int type_id = EntityComponent::GetIDFromName(type_name->GetValue());
+            unsigned int type_id = EntityComponent::GetIDFromName(type_name);
             unsigned int component_id = EntityComponent::GetIDFromName(var_name);
 
             // get the creation function for this component type, if it exists
@@ -96,22 +216,17 @@ namespace alpha
                 // make the component, and initialize it will the var data
                 std::function<EntityComponent *()> func = it->second;
                 std::shared_ptr<EntityComponent> component(func());
-                component->VInitialize(table);
+                component->VInitialize(var_value);
 
                 // if var data contains a 'components' variable
                 // then create each component in that table and
                 // add it to this component
-                std::shared_ptr<LuaVar> child_components = table->Get("components");
-                if (child_components != nullptr && child_components->GetVarType() == VT_TABLE)
+                const LuaVar child_components = var_value.Get("components");
+                for (size_t i = 0; i < child_components.Size(); ++i)
                 {
-                    auto child_table = std::dynamic_pointer_cast<LuaTable>(child_components);
-                    for (auto var_pair : child_table->GetAll())
+                    if (child_components.GetValue(i).IsTable())
                     {
-                        if (var_pair.second->GetVarType() == VT_TABLE)
-                        {
-                            //unsigned int child_component_id = EntityComponent::GetIDFromName(var_pair.first);
-                            this->CreateComponent(entity, component, var_pair.first, var_pair.second);
-                        }
+                        this->CreateComponent(entity, component, child_components.GetKey(i), child_components.GetValue(i));
                     }
                 }
 
@@ -128,7 +243,7 @@ namespace alpha
             }
             else
             {
-                LOG_WARN("EntityFactory > Attempted to add an invalid component type: ", type_name->GetValue());
+                LOG_WARN("EntityFactory > Attempted to add an invalid component type: ", type_name);
             }
         }
         else
@@ -136,4 +251,23 @@ namespace alpha
             LOG_WARN("EntityFactory > Attempted to add a component without a valid 'type'.");
         }
     }
+
+    void EntityFactory::FlattenPrototype(const std::map<unsigned int, std::shared_ptr<EntityComponent> > & components, int parent, std::vector<PrototypeRecord> & records)
+    {
+        for (auto & pair : components)
+        {
+            auto it = m_componentCopyFunctions.find(pair.second->GetID());
+            if (it == m_componentCopyFunctions.end())
+            {
+                LOG_WARN("EntityFactory > No copy function registered for component type: ", pair.second->VGetName());
+                continue;
+            }
+
+            PrototypeRecord record = { pair.first, parent, pair.second, it->second, m_componentAssignFunctions[pair.second->GetID()] };
+            records.push_back(record);
+
+            // children reference their parent by its index in the record list
+            this->FlattenPrototype(pair.second->GetComponents(), static_cast<int>(records.size() - 1), records);
+        }
+    }
 }
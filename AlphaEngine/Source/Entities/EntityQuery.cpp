@@ -0,0 +1,115 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+
+#include "Entities/EntityQuery.h"
+#include "Entities/Entity.h"
+
+namespace alpha
+{
+    EntityQuery::EntityQuery(std::vector<unsigned int> type_ids)
+        : m_typeIds(std::move(type_ids))
+    {
+        std::sort(m_typeIds.begin(), m_typeIds.end());
+        m_typeIds.erase(std::unique(m_typeIds.begin(), m_typeIds.end()), m_typeIds.end());
+    }
+
+    const std::vector<unsigned int> & EntityQuery::GetTypeIDs() const
+    {
+        return m_typeIds;
+    }
+
+    bool EntityQuery::TryAdd(const std::shared_ptr<Entity> & entity)
+    {
+        if (entity == nullptr || m_indices.find(entity->GetHandle()) != m_indices.end())
+        {
+            return false;
+        }
+
+        // resolve every column first, so a partial match leaves the view untouched
+        const size_t row = m_components.size();
+        for (auto type_id : m_typeIds)
+        {
+            auto component = entity->GetOfType(type_id);
+            if (component == nullptr)
+            {
+                m_components.resize(row);
+                return false;
+            }
+            m_components.push_back(component.get());
+        }
+
+        m_indices[entity->GetHandle()] = m_entities.size();
+        m_entities.push_back(entity);
+        return true;
+    }
+
+    void EntityQuery::Remove(const EntityHandle & handle)
+    {
+        auto it = m_indices.find(handle);
+        if (it == m_indices.end())
+        {
+            return;
+        }
+
+        // swap the last entity into the removed slot, and drop the tail
+        const size_t index = it->second;
+        const size_t last = m_entities.size() - 1;
+        const size_t columns = m_typeIds.size();
+        if (index != last)
+        {
+            m_entities[index] = m_entities[last];
+            std::copy(m_components.begin() + last * columns, m_components.begin() + (last + 1) * columns, m_components.begin() + index * columns);
+            m_indices[m_entities[index]->GetHandle()] = index;
+        }
+        m_entities.pop_back();
+        m_components.resize(last * columns);
+        m_indices.erase(it);
+    }
+
+    void EntityQuery::Clear()
+    {
+        m_entities.clear();
+        m_components.clear();
+        m_indices.clear();
+    }
+
+    size_t EntityQuery::Size() const
+    {
+        return m_entities.size();
+    }
+
+    bool EntityQuery::Empty() const
+    {
+        return m_entities.empty();
+    }
+
+    Entity * EntityQuery::GetEntity(size_t index) const
+    {
+        return m_entities[index].get();
+    }
+
+    const std::vector<std::shared_ptr<Entity> > & EntityQuery::GetEntities() const
+    {
+        return m_entities;
+    }
+
+    const std::vector<EntityComponent *> & EntityQuery::GetComponentRows() const
+    {
+        return m_components;
+    }
+}
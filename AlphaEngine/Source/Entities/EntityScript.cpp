@@ -20,10 +20,13 @@ limitations under the License.
 #include "Scripting/LuaScript.h"
 #include "Scripting/LuaVar.h"
 #include "Entities/EntityScript.h"
+#include "Assets/Asset.h"
 
 namespace alpha
 {
     EntityScript::EntityScript(std::shared_ptr<Asset> asset)
+        : m_sPath(asset->GetPath())
+        , m_tags(ET_NONE)
     {
         this->Add(asset);
         this->Load();
@@ -31,25 +34,41 @@ namespace alpha
 
         // once the script environment is prepared, load and store the components table.
         m_components = this->GetGlobalTable("components");
+        if (this->HasGlobal("tags"))
+        {
+            if (auto tags = this->GetGlobalTable("tags"))
+            {
+                m_tags = EntityTags::ParseTags(tags->GetRoot());
+            }
+        }
+
+        // everything an entity needs now lives in the components table, so the
+        // lua state can be released rather than kept alive for the script's lifetime.
+        this->Close();
     }
     EntityScript::~EntityScript() { }
 
     /**
-     * Checks to see if the given component name is present in the components LuaTable loaded from the entity script.
+     * Checks to see if the given component name is present in the components table loaded from the entity script.
      */
     bool EntityScript::HasComponent(const std::string & name)
     {
-        auto search = m_components->Get(name);
-        if (search != nullptr)
-        {
-            return true;
-        }
-        return false;
+        return !this->GetComponentVars().Get(name).IsNil();
+    }
+
+    const std::string & EntityScript::GetPath() const
+    {
+        return m_sPath;
+    }
+
+    EntityTagMask EntityScript::GetTags() const
+    {
+        return m_tags;
     }
 
     //! Get a list of the components specified by the script.
-    const std::map<std::string, std::shared_ptr<LuaVar> > & EntityScript::GetComponentVars()
+    LuaVar EntityScript::GetComponentVars() const
     {
-        return m_components->GetAll();
+        return m_components != nullptr ? m_components->GetRoot() : LuaVar();
     }
 }
@@ -0,0 +1,82 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "Entities/EntityTags.h"
+#include "Scripting/LuaVar.h"
+#include "Toolbox/Logger.h"
+
+namespace alpha
+{
+    const unsigned int EntityTags::sk_firstCustomBit = 16;
+    std::mutex EntityTags::s_mutex;
+    unsigned int EntityTags::s_nextBit = EntityTags::sk_firstCustomBit;
+
+    std::map<std::string, EntityTagMask> & EntityTags::GetRegistry()
+    {
+        static std::map<std::string, EntityTagMask> registry = {
+            { "disabled", ET_DISABLED },
+            { "hidden", ET_HIDDEN },
+            { "editor_only", ET_EDITOR_ONLY },
+            { "server_only", ET_SERVER_ONLY },
+        };
+        return registry;
+    }
+
+    EntityTagMask EntityTags::GetTag(const std::string & name)
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+
+        auto & registry = GetRegistry();
+        auto it = registry.find(name);
+        if (it != registry.end())
+        {
+            return it->second;
+        }
+
+        if (s_nextBit >= 64)
+        {
+            LOG_WARN("EntityTags > No free tag bits left for tag: ", name);
+            return ET_NONE;
+        }
+
+        EntityTagMask tag = 1ull << s_nextBit++;
+        registry[name] = tag;
+        return tag;
+    }
+
+    EntityTagMask EntityTags::ParseTags(const LuaVar & table)
+    {
+        EntityTagMask tags = ET_NONE;
+        for (size_t i = 0; i < table.Size(); ++i)
+        {
+            const LuaVar value = table.GetValue(i);
+            if (value.GetVarType() == VT_STRING)
+            {
+                // array style, tags = { "hidden" }
+                tags |= GetTag(value.GetString());
+            }
+            else if (value.GetVarType() == VT_BOOLEAN)
+            {
+                // flag style, tags = { hidden = true }
+                if (value.GetBool())
+                {
+                    tags |= GetTag(table.GetKey(i));
+                }
+            }
+        }
+        return tags & ~ET_POOLED;
+    }
+}
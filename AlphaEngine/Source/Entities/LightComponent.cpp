@@ -18,82 +18,103 @@ limitations under the License.
 #include "Scripting/LuaVar.h"
 #include "Graphics/Material.h"
 #include "Toolbox/Logger.h"
+#include "Toolbox/BinaryStream.h"
 
 namespace alpha
 {
     const std::string LightComponent::sk_name = "light";
 
-    LightComponent::~LightComponent() { }
-
-    //! Provides logic for how to initialize a transform component from Lua script data
-    void LightComponent::VInitialize(std::shared_ptr<LuaVar> var)
+    namespace
     {
-        std::shared_ptr<LuaTable> component_table = std::dynamic_pointer_cast<LuaTable>(var);
-        std::shared_ptr<LuaTable> table = std::dynamic_pointer_cast<LuaTable>(component_table->Get("light"));
-
-        // get the type of light this component represents
-        if (auto light_type_var = std::dynamic_pointer_cast<LuaStatic<std::string>>(table->Get("type")))
+        struct LightDescriptor : SceneComponent::Descriptor
         {
-            std::string light_type = light_type_var->GetValue();
-            
-            if (light_type == "directional")
-            {
-                m_eLightType = LightType::DIRECTIONAL;
-            }
-            else if (light_type == "point")
-            {
-                m_eLightType = LightType::POINT;
-            }
-            else
+            LightDescriptor()
+                : type(DIRECTIONAL)
+                , distance(100.f)
+                , intensity(1.f)
+                , ambientIntensity(0.f)
+            { }
+
+            int type;
+            /** Defaults to black, no light */
+            Vector4 color;
+            /** Read whether the light is directional or not, it is ignored if unused */
+            Vector3 direction;
+            /** Max illumination distance, only used by point lights */
+            float distance;
+            float intensity;
+            float ambientIntensity;
+        };
+
+        const ComponentSchema<LightDescriptor> & GetLightSchema()
+        {
+            static const ComponentSchema<LightDescriptor> schema = [] ()
             {
-                m_eLightType = LightType::DIRECTIONAL;
-            }
+                ComponentSchema<LightDescriptor> fields;
+                const LightDescriptor & layout = fields.Layout();
+                SceneComponent::AddSchemaFields(fields);
+                fields.AddEnum("light.type", layout.type, { { "directional", DIRECTIONAL }, { "point", POINT } });
+                fields.AddFloat("light.color.r", layout.color.x);
+                fields.AddFloat("light.color.g", layout.color.y);
+                fields.AddFloat("light.color.b", layout.color.z);
+                fields.AddFloat("light.color.a", layout.color.w);
+                fields.AddVector3("light.direction", layout.direction);
+                fields.AddFloat("light.distance", layout.distance);
+                fields.AddFloat("light.intensity", layout.intensity);
+                fields.AddFloat("light.ambient_intensity", layout.ambientIntensity);
+                return fields;
+            }();
+            return schema;
         }
+    }
 
-        // get the light color, or default to black(none)
-        if (auto light_color = std::dynamic_pointer_cast<LuaTable>(table->Get("color")))
-        {
-            this->GetTableVarValue(light_color, "r", &m_vLightColor.x);
-            this->GetTableVarValue(light_color, "g", &m_vLightColor.y);
-            this->GetTableVarValue(light_color, "b", &m_vLightColor.z);
-            this->GetTableVarValue(light_color, "a", &m_vLightColor.w);
-        }
+    LightComponent::~LightComponent() { }
 
-        // get direct light intensity
-        std::shared_ptr<LuaVar> intensity_var = table->Get("intensity");
-        if (intensity_var->GetVarType() == VT_STATIC)
+    //! Provides logic for how to initialize a transform component from Lua script data
+    void LightComponent::VInitialize(const LuaVar & var)
+    {
+        LightDescriptor descriptor;
+        if (!GetLightSchema().Parse(var, descriptor))
         {
-            auto intensity = std::dynamic_pointer_cast<LuaStatic<double>>(intensity_var);
-            m_fIntensity = static_cast<float>(intensity->GetValue());
+            LOG_ERR("LightComponent > Script variable data does not represent a valid data table.");
+            return;
         }
 
-        // get indirect ambient intensity
-        std::shared_ptr<LuaVar> ambient_var = table->Get("ambient_intensity");
-        if (ambient_var->GetVarType() == VT_STATIC)
-        {
-            auto ambient = std::dynamic_pointer_cast<LuaStatic<double>>(ambient_var);
-            m_fAmbientIntensity = static_cast<float>(ambient->GetValue());
-        }
+        m_eLightType = static_cast<LightType>(descriptor.type);
+        m_vLightColor = descriptor.color;
+        m_vDirection = descriptor.direction;
+        m_fLightDistance = descriptor.distance;
+        m_fIntensity = descriptor.intensity;
+        m_fAmbientIntensity = descriptor.ambientIntensity;
 
-        // get the direction regardless of whether the light directional or not
-        // the prameter will be ignored if it does not exist, or is not used.
-        if (auto light_direction = std::dynamic_pointer_cast<LuaTable>(table->Get("direction")))
-        {
-            this->GetTableVarValue(light_direction, "x", &m_vDirection.x);
-            this->GetTableVarValue(light_direction, "y", &m_vDirection.y);
-            this->GetTableVarValue(light_direction, "z", &m_vDirection.z);
-        }
+        // init base scene component
+        this->ApplyDescriptor(descriptor);
+    }
 
-        // get the max illumination distance of the light
-        // only valid for point lights
-        m_fLightDistance = 100.f;
-        if (auto light_distance = std::dynamic_pointer_cast<LuaStatic<double>>(table->Get("distance")))
+    void LightComponent::VSerialize(BinaryWriter & writer) const
+    {
+        SceneComponent::VSerialize(writer);
+        writer.Write(m_eLightType);
+        writer.Write(m_vLightColor);
+        writer.Write(m_fLightDistance);
+        writer.Write(m_fIntensity);
+        writer.Write(m_fAmbientIntensity);
+        writer.Write(m_vDirection);
+    }
+
+    bool LightComponent::VDeserialize(BinaryReader & reader)
+    {
+        if (!SceneComponent::VDeserialize(reader))
         {
-            m_fLightDistance = static_cast<float>(light_distance->GetValue());
+            return false;
         }
-
-        // init base scene component
-        SceneComponent::VInitialize(var);
+        reader.Read(m_eLightType);
+        reader.Read(m_vLightColor);
+        reader.Read(m_fLightDistance);
+        reader.Read(m_fIntensity);
+        reader.Read(m_fAmbientIntensity);
+        reader.Read(m_vDirection);
+        return reader.IsValid();
     }
 
     bool LightComponent::VUpdate(float /*fCurrentTime*/, float /*fElapsedTime*/)
@@ -135,4 +156,48 @@ namespace alpha
     {
         return m_vDirection;
     }
+
+    void LightComponent::VCaptureChanges(unsigned int changes, ComponentValues & values) const
+    {
+        SceneComponent::VCaptureChanges(changes, values);
+        if (changes & CC_LIGHT)
+        {
+            values.lightType = m_eLightType;
+            values.lightColor = m_vLightColor;
+            values.lightDistance = m_fLightDistance;
+            values.lightIntensity = m_fIntensity;
+            values.lightAmbientIntensity = m_fAmbientIntensity;
+            values.lightDirection = m_vDirection;
+        }
+    }
+
+    void LightComponent::SetLightColor(const Vector4 & color)
+    {
+        m_vLightColor = color;
+        this->MarkChanged(CC_LIGHT);
+    }
+
+    void LightComponent::SetLightDistance(float distance)
+    {
+        m_fLightDistance = distance;
+        this->MarkChanged(CC_LIGHT);
+    }
+
+    void LightComponent::SetIntensity(float intensity)
+    {
+        m_fIntensity = intensity;
+        this->MarkChanged(CC_LIGHT);
+    }
+
+    void LightComponent::SetAmbientIntensity(float intensity)
+    {
+        m_fAmbientIntensity = intensity;
+        this->MarkChanged(CC_LIGHT);
+    }
+
+    void LightComponent::SetLightDirection(const Vector3 & direction)
+    {
+        m_vDirection = direction;
+        this->MarkChanged(CC_LIGHT);
+    }
 }
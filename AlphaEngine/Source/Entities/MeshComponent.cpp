@@ -16,29 +16,65 @@ limitations under the License.
 
 #include "Entities/MeshComponent.h"
 #include "Scripting/LuaVar.h"
+#include "Toolbox/BinaryStream.h"
+#include "Toolbox/Logger.h"
 
 namespace alpha
 {
     const std::string MeshComponent::sk_name = "mesh";
 
+    namespace
+    {
+        const ComponentSchema<MeshComponent::Descriptor> & GetMeshSchema()
+        {
+            static const ComponentSchema<MeshComponent::Descriptor> schema = [] ()
+            {
+                ComponentSchema<MeshComponent::Descriptor> fields;
+                MeshComponent::AddSchemaFields(fields);
+                return fields;
+            }();
+            return schema;
+        }
+    }
+
     MeshComponent::~MeshComponent() { }
 
     //! Provides logic for how to initialize a transform component from Lua script data
-    void MeshComponent::VInitialize(std::shared_ptr<LuaVar> var)
+    void MeshComponent::VInitialize(const LuaVar & var)
     {
-        std::shared_ptr<LuaTable> table = std::dynamic_pointer_cast<LuaTable>(var);
-
-        // load model asset path
         // model asset will be loaded in the graphics system
-        std::shared_ptr<LuaVar> modelVar = table->Get("model");
-        if (modelVar->GetVarType() == VT_STATIC)
+        Descriptor descriptor;
+        if (!GetMeshSchema().Parse(var, descriptor))
         {
-            auto model = std::dynamic_pointer_cast<LuaStatic<std::string>>(modelVar);
-            m_sModelPath = model->GetValue();
+            LOG_ERR("MeshComponent > Script variable data does not represent a valid data table.");
+            return;
         }
+        this->ApplyDescriptor(descriptor);
+    }
+
+    void MeshComponent::ApplyDescriptor(const Descriptor & descriptor)
+    {
+        m_sModelPath = descriptor.model;
 
         // init base scene component
-        SceneComponent::VInitialize(var);
+        SceneComponent::ApplyDescriptor(descriptor);
+    }
+
+    void MeshComponent::VSerialize(BinaryWriter & writer) const
+    {
+        SceneComponent::VSerialize(writer);
+        writer.WriteString(m_sModelPath);
+    }
+
+    bool MeshComponent::VDeserialize(BinaryReader & reader)
+    {
+        // read back in the order VSerialize wrote, scene data first
+        if (!SceneComponent::VDeserialize(reader))
+        {
+            return false;
+        }
+        reader.ReadString(m_sModelPath);
+        return reader.IsValid();
     }
 
     bool MeshComponent::VUpdate(float /*fCurrentTime*/, float /*fElapsedTime*/)
@@ -0,0 +1,135 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "Entities/ParticleEmitterComponent.h"
+#include "Scripting/LuaVar.h"
+#include "Toolbox/BinaryStream.h"
+#include "Toolbox/Logger.h"
+
+namespace alpha
+{
+    const std::string ParticleEmitterComponent::sk_name = "particle_emitter";
+
+    namespace
+    {
+        struct ParticleEmitterDescriptor : SceneComponent::Descriptor
+        {
+            ParticleSettings settings;
+        };
+
+        const ComponentSchema<ParticleEmitterDescriptor> & GetParticleEmitterSchema()
+        {
+            static const ComponentSchema<ParticleEmitterDescriptor> schema = [] ()
+            {
+                ComponentSchema<ParticleEmitterDescriptor> fields;
+                const ParticleSettings & layout = fields.Layout().settings;
+                SceneComponent::AddSchemaFields(fields);
+                fields.AddUInt("max_particles", layout.maxParticles);
+                fields.AddFloat("rate", layout.rate);
+                fields.AddFloat("spread", layout.spread);
+                fields.AddFloat("size", layout.size);
+                fields.AddFloat("lifetime.min", layout.minLifetime);
+                fields.AddFloat("lifetime.max", layout.maxLifetime);
+                fields.AddFloat("speed.min", layout.minSpeed);
+                fields.AddFloat("speed.max", layout.maxSpeed);
+                fields.AddVector3("direction", layout.direction);
+                fields.AddVector3("gravity", layout.gravity);
+                return fields;
+            }();
+            return schema;
+        }
+    }
+
+    ParticleSettings::ParticleSettings()
+        : maxParticles(1000)
+        , rate(100.f)
+        , minLifetime(1.f)
+        , maxLifetime(2.f)
+        , minSpeed(1.f)
+        , maxSpeed(2.f)
+        , spread(0.5f)
+        , direction(0.f, 1.f, 0.f)
+        , gravity(0.f, -9.8f, 0.f)
+        , size(0.1f)
+    { }
+
+    ParticleEmitterComponent::ParticleEmitterComponent() { }
+    ParticleEmitterComponent::~ParticleEmitterComponent() { }
+
+    void ParticleEmitterComponent::VInitialize(const LuaVar & var)
+    {
+        ParticleEmitterDescriptor descriptor;
+        if (!GetParticleEmitterSchema().Parse(var, descriptor))
+        {
+            LOG_ERR("ParticleEmitterComponent > Script variable data does not represent a valid data table.");
+            return;
+        }
+
+        m_settings = descriptor.settings;
+        this->ApplyDescriptor(descriptor);
+    }
+
+    void ParticleEmitterComponent::VSerialize(BinaryWriter & writer) const
+    {
+        SceneComponent::VSerialize(writer);
+        writer.Write(static_cast<uint32_t>(m_settings.maxParticles));
+        writer.Write(m_settings.rate);
+        writer.Write(m_settings.minLifetime);
+        writer.Write(m_settings.maxLifetime);
+        writer.Write(m_settings.minSpeed);
+        writer.Write(m_settings.maxSpeed);
+        writer.Write(m_settings.spread);
+        writer.Write(m_settings.direction);
+        writer.Write(m_settings.gravity);
+        writer.Write(m_settings.size);
+    }
+
+    bool ParticleEmitterComponent::VDeserialize(BinaryReader & reader)
+    {
+        if (!SceneComponent::VDeserialize(reader))
+        {
+            return false;
+        }
+        uint32_t max_particles = 0;
+        reader.Read(max_particles);
+        m_settings.maxParticles = max_particles;
+        reader.Read(m_settings.rate);
+        reader.Read(m_settings.minLifetime);
+        reader.Read(m_settings.maxLifetime);
+        reader.Read(m_settings.minSpeed);
+        reader.Read(m_settings.maxSpeed);
+        reader.Read(m_settings.spread);
+        reader.Read(m_settings.direction);
+        reader.Read(m_settings.gravity);
+        reader.Read(m_settings.size);
+        return reader.IsValid();
+    }
+
+    bool ParticleEmitterComponent::VUpdate(float /*fCurrentTime*/, float /*fElapsedTime*/)
+    {
+        return true;
+    }
+
+    std::string ParticleEmitterComponent::VGetName() const
+    {
+        return ParticleEmitterComponent::sk_name;
+    }
+
+    const ParticleSettings & ParticleEmitterComponent::GetSettings() const
+    {
+        return m_settings;
+    }
+}
@@ -17,22 +17,39 @@ limitations under the License.
 #include "Entities/PrimitiveComponent.h"
 
 #include "Scripting/LuaVar.h"
+#include "Toolbox/Logger.h"
 
 namespace alpha
 {
     const std::string PrimitiveComponent::sk_name = "primitive";
 
+    namespace
+    {
+        const ComponentSchema<SceneComponent::Descriptor> & GetPrimitiveSchema()
+        {
+            static const ComponentSchema<SceneComponent::Descriptor> schema = [] ()
+            {
+                ComponentSchema<SceneComponent::Descriptor> fields;
+                // primitives keep all of their scene fields inside their transform table
+                SceneComponent::AddSchemaFields(fields, "transform.");
+                return fields;
+            }();
+            return schema;
+        }
+    }
+
     PrimitiveComponent::~PrimitiveComponent() { }
 
     //! Provides logic for how to initialize a transform component from Lua script data
-    void PrimitiveComponent::VInitialize(std::shared_ptr<LuaVar> var)
+    void PrimitiveComponent::VInitialize(const LuaVar & var)
     {
-        std::shared_ptr<LuaTable> table = std::dynamic_pointer_cast<LuaTable>(var);
-        std::shared_ptr<LuaVar> transform = table->Get("transform");
-        if (transform != nullptr)
+        Descriptor descriptor;
+        if (!GetPrimitiveSchema().Parse(var, descriptor))
         {
-            SceneComponent::VInitialize(transform);
+            LOG_ERR("PrimitiveComponent > Script variable data does not represent a valid data table.");
+            return;
         }
+        this->ApplyDescriptor(descriptor);
     }
 
     bool PrimitiveComponent::VUpdate(float /*fCurrentTime*/, float /*fElapsedTime*/)
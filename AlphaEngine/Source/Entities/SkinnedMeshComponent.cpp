@@ -0,0 +1,178 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "Entities/SkinnedMeshComponent.h"
+#include "Scripting/LuaVar.h"
+#include "Toolbox/BinaryStream.h"
+#include "Toolbox/Logger.h"
+
+namespace alpha
+{
+    const std::string SkinnedMeshComponent::sk_name = "skinned_mesh";
+
+    namespace
+    {
+        struct SkinnedMeshDescriptor : MeshComponent::Descriptor
+        {
+            SkinnedMeshDescriptor()
+                : loop(true)
+                , speed(1.f)
+            { }
+
+            /** clips = { name = "path", ... } */
+            std::map<std::string, std::string> clips;
+            /** The clip to start with, if any */
+            std::string clip;
+            bool loop;
+            float speed;
+        };
+
+        const ComponentSchema<SkinnedMeshDescriptor> & GetSkinnedMeshSchema()
+        {
+            static const ComponentSchema<SkinnedMeshDescriptor> schema = [] ()
+            {
+                ComponentSchema<SkinnedMeshDescriptor> fields;
+                const SkinnedMeshDescriptor & layout = fields.Layout();
+                MeshComponent::AddSchemaFields(fields);
+                fields.AddStringMap("clips", layout.clips);
+                fields.AddString("clip", layout.clip);
+                fields.AddBool("loop", layout.loop);
+                fields.AddFloat("speed", layout.speed);
+                return fields;
+            }();
+            return schema;
+        }
+    }
+
+    SkinnedMeshComponent::SkinnedMeshComponent()
+        : m_fBlendTime(0.f)
+        , m_loop(true)
+        , m_fSpeed(1.f)
+    { }
+    SkinnedMeshComponent::~SkinnedMeshComponent() { }
+
+    void SkinnedMeshComponent::VInitialize(const LuaVar & var)
+    {
+        SkinnedMeshDescriptor descriptor;
+        if (!GetSkinnedMeshSchema().Parse(var, descriptor))
+        {
+            LOG_ERR("SkinnedMeshComponent > Script variable data does not represent a valid data table.");
+            return;
+        }
+
+        m_clipPaths = descriptor.clips;
+        m_sClip = descriptor.clip;
+        m_loop = descriptor.loop;
+        m_fSpeed = descriptor.speed;
+        this->ApplyDescriptor(descriptor);
+    }
+
+    void SkinnedMeshComponent::VSerialize(BinaryWriter & writer) const
+    {
+        MeshComponent::VSerialize(writer);
+        writer.Write(static_cast<uint32_t>(m_clipPaths.size()));
+        for (auto & pair : m_clipPaths)
+        {
+            writer.WriteString(pair.first);
+            writer.WriteString(pair.second);
+        }
+        writer.WriteString(m_sClip);
+        writer.Write(m_loop);
+        writer.Write(m_fSpeed);
+    }
+
+    bool SkinnedMeshComponent::VDeserialize(BinaryReader & reader)
+    {
+        if (!MeshComponent::VDeserialize(reader))
+        {
+            return false;
+        }
+
+        uint32_t count = 0;
+        reader.Read(count);
+        m_clipPaths.clear();
+        for (uint32_t i = 0; i < count && reader.IsValid(); ++i)
+        {
+            std::string name, path;
+            reader.ReadString(name);
+            reader.ReadString(path);
+            m_clipPaths[name] = path;
+        }
+        reader.ReadString(m_sClip);
+        reader.Read(m_loop);
+        reader.Read(m_fSpeed);
+        return reader.IsValid();
+    }
+
+    std::string SkinnedMeshComponent::VGetName() const
+    {
+        return SkinnedMeshComponent::sk_name;
+    }
+
+    void SkinnedMeshComponent::VCaptureChanges(unsigned int changes, ComponentValues & values) const
+    {
+        MeshComponent::VCaptureChanges(changes, values);
+        if (changes & CC_CLIP)
+        {
+            values.clip = m_sClip;
+            values.clipBlendTime = m_fBlendTime;
+            values.clipLoop = m_loop;
+        }
+        if (changes & CC_CLIP_SPEED)
+        {
+            values.clipSpeed = m_fSpeed;
+        }
+    }
+
+    void SkinnedMeshComponent::PlayClip(const std::string & name, float blendTime, bool loop)
+    {
+        m_sClip = name;
+        m_fBlendTime = blendTime;
+        m_loop = loop;
+        this->MarkChanged(CC_CLIP);
+    }
+
+    void SkinnedMeshComponent::SetClipSpeed(float speed)
+    {
+        m_fSpeed = speed;
+        this->MarkChanged(CC_CLIP_SPEED);
+    }
+
+    const std::map<std::string, std::string> & SkinnedMeshComponent::GetClipPaths() const
+    {
+        return m_clipPaths;
+    }
+
+    const std::string & SkinnedMeshComponent::GetClip() const
+    {
+        return m_sClip;
+    }
+
+    float SkinnedMeshComponent::GetBlendTime() const
+    {
+        return m_fBlendTime;
+    }
+
+    bool SkinnedMeshComponent::GetLoop() const
+    {
+        return m_loop;
+    }
+
+    float SkinnedMeshComponent::GetClipSpeed() const
+    {
+        return m_fSpeed;
+    }
+}
@@ -23,6 +23,7 @@ limitations under the License.
 #include "HID/HIDContextManager.h"
 #include "HID/HIDContext.h"
 #include "Logic/LogicSystemEvents.h"
+#include "Graphics/SceneManager.h"
 
 namespace alpha
 {
@@ -34,17 +35,148 @@ namespace alpha
         state->SetLogic(m_pLogic);
     }
 
-    std::shared_ptr<Entity> AGameState::GetEntity(const unsigned long entityId)
+    Entity * AGameState::GetEntity(const EntityHandle & handle)
     {
-        return m_pLogic->GetEntity(entityId);
+        return m_pLogic->GetEntity(handle);
     }
     std::shared_ptr<Entity> AGameState::CreateEntity(const char * resource)
     {
         return m_pLogic->CreateEntity(resource);
     }
-    void AGameState::DestroyEntity(const unsigned long entityId)
+    std::vector<std::shared_ptr<Entity> > AGameState::CreateEntities(const char * resource, unsigned int count)
     {
-        m_pLogic->DestroyEntity(entityId);
+        return m_pLogic->CreateEntities(resource, count);
+    }
+    std::shared_future<std::shared_ptr<Entity> > AGameState::CreateEntityAsync(const char * resource)
+    {
+        return m_pLogic->CreateEntityAsync(resource);
+    }
+    std::shared_future<std::vector<std::shared_ptr<Entity> > > AGameState::CreateEntitiesAsync(const char * resource, unsigned int count)
+    {
+        return m_pLogic->CreateEntitiesAsync(resource, count);
+    }
+    void AGameState::DestroyEntity(const EntityHandle & handle)
+    {
+        m_pLogic->DestroyEntity(handle);
+    }
+    void AGameState::SetPoolCapacity(const char * resource, unsigned int capacity)
+    {
+        m_pLogic->SetPoolCapacity(resource, capacity);
+    }
+    void AGameState::PrewarmPool(const char * resource, unsigned int count)
+    {
+        m_pLogic->PrewarmPool(resource, count);
+    }
+    void AGameState::WakeEntity(const EntityHandle & handle)
+    {
+        m_pLogic->WakeEntity(handle);
+    }
+    void AGameState::ScheduleWake(const EntityHandle & handle, double delay)
+    {
+        m_pLogic->ScheduleWake(handle, delay);
+    }
+    void AGameState::SetUpdateBatchSize(unsigned int batchSize)
+    {
+        m_pLogic->SetUpdateBatchSize(batchSize);
+    }
+    void AGameState::SetEntityTags(const EntityHandle & handle, EntityTagMask tags)
+    {
+        m_pLogic->SetEntityTags(handle, tags);
+    }
+    void AGameState::SetUpdateFilter(EntityTagMask exclude)
+    {
+        m_pLogic->SetUpdateFilter(exclude);
+    }
+    void AGameState::SetRenderFilter(EntityTagMask renderExclude, EntityTagMask lightExclude)
+    {
+        m_pLogic->PublishEvent(new Event_SetRenderFilter(renderExclude, lightExclude));
+    }
+    std::shared_ptr<const EntityQuery> AGameState::Query(const std::vector<std::string> & typeNames)
+    {
+        return m_pLogic->Query(typeNames);
+    }
+    bool AGameState::SaveSnapshot(const char * path)
+    {
+        return m_pLogic->SaveSnapshot(path);
+    }
+    std::vector<std::shared_ptr<Entity> > AGameState::LoadSnapshot(const char * resource)
+    {
+        return m_pLogic->LoadSnapshot(resource);
+    }
+
+    void AGameState::AddWorldCell(int x, int z, const char * resource)
+    {
+        m_pLogic->AddWorldCell(x, z, resource);
+    }
+    void AGameState::SetWorldCellSize(float cellSize)
+    {
+        m_pLogic->SetWorldCellSize(cellSize);
+    }
+    void AGameState::SetWorldLoadRadius(unsigned int loadRadius)
+    {
+        m_pLogic->SetWorldLoadRadius(loadRadius);
+    }
+    void AGameState::SetStreamingBudgets(unsigned int commitBudget, unsigned int unloadBudget)
+    {
+        m_pLogic->SetStreamingBudgets(commitBudget, unloadBudget);
+    }
+    void AGameState::SetStreamingFocus(const Vector3 & focus)
+    {
+        m_pLogic->SetStreamingFocus(focus);
+    }
+
+    void AGameState::BindContactsBegan(std::function<void(const std::vector<ContactPair> &)> delegate)
+    {
+        m_pLogic->BindContactsBegan(delegate);
+    }
+
+    void AGameState::BindContactsEnded(std::function<void(const std::vector<ContactPair> &)> delegate)
+    {
+        m_pLogic->BindContactsEnded(delegate);
+    }
+
+    AnimationHandle AGameState::PlayAnimation(const ComponentHandle<SceneComponent> & target, std::shared_ptr<const AnimationTrack> track,
+                                              AnimationLoop loop, float speed)
+    {
+        return m_pLogic->PlayAnimation(target, track, loop, speed);
+    }
+    void AGameState::StopAnimation(const AnimationHandle & handle)
+    {
+        m_pLogic->StopAnimation(handle);
+    }
+    void AGameState::SetAnimationSpeed(const AnimationHandle & handle, float speed)
+    {
+        m_pLogic->SetAnimationSpeed(handle, speed);
+    }
+    bool AGameState::IsAnimationPlaying(const AnimationHandle & handle) const
+    {
+        return m_pLogic->IsAnimationPlaying(handle);
+    }
+    unsigned int AGameState::GetAnimationLoops(const AnimationHandle & handle) const
+    {
+        return m_pLogic->GetAnimationLoops(handle);
+    }
+
+    void AGameState::AddGameSystem(std::shared_ptr<AGameSystem> system)
+    {
+        m_pLogic->AddGameSystem(system);
+    }
+    bool AGameState::RemoveGameSystem(const std::shared_ptr<AGameSystem> & system)
+    {
+        return m_pLogic->RemoveGameSystem(system);
+    }
+
+    void AGameState::QueryBoxes(const std::vector<AABB> & boxes, std::vector<std::vector<EntityHandle> > & results, EntityTagMask exclude)
+    {
+        m_pLogic->QueryBoxes(boxes, results, exclude);
+    }
+    void AGameState::QuerySpheres(const std::vector<Sphere> & spheres, std::vector<std::vector<EntityHandle> > & results, EntityTagMask exclude)
+    {
+        m_pLogic->QuerySpheres(spheres, results, exclude);
+    }
+    void AGameState::Raycast(const std::vector<Ray> & rays, std::vector<std::vector<RaycastHit> > & results, EntityTagMask exclude)
+    {
+        m_pLogic->Raycast(rays, results, exclude);
     }
 
     std::weak_ptr<Sound> AGameState::CreateSound(const char * resource)
@@ -80,5 +212,7 @@ namespace alpha
     void AGameState::SetActiveCamera(std::shared_ptr<CameraComponent> pCameraComponent)
     {
         m_pLogic->PublishEvent(new Event_SetActiveCamera(pCameraComponent));
+        // world cells stream in around whatever the player is looking through
+        m_pLogic->SetStreamingCamera(pCameraComponent);
     }
 }
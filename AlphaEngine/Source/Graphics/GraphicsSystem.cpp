@@ -14,16 +14,24 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <algorithm>
+
 #include "Graphics/GraphicsSystem.h"
 #include "Graphics/IRenderer.h"
 #include "Graphics/GraphicsRenderer.h"
 #include "Graphics/SceneManager.h"
 #include "Graphics/Light.h"
 #include "Graphics/Camera.h"
+#include "Graphics/ParticleEmitter.h"
+#include "Graphics/Task_SimulateParticles.h"
+#include "Animation/Task_EvaluatePoses.h"
 #include "Assets/AssetSystem.h"
 #include "Assets/Asset.h"
+#include "Math/Frustum.h"
+#include "Math/Ray.h"
 #include "Toolbox/Logger.h"
 #include "Logic/LogicSystemEvents.h"
+#include "Threading/TaskGroup.h"
 
 namespace alpha
 {
@@ -33,6 +41,7 @@ namespace alpha
         , m_pRenderer(nullptr)
         , m_pSceneManager(nullptr)
         , m_pCamera(nullptr)
+        , m_fSimulateTime(0.f)
         , m_fWindowWidth(1024.f)
         , m_fWindowHeight(768.f)
     { }
@@ -52,7 +61,11 @@ namespace alpha
 
         // register event handlers
         this->AddEventHandler(AEvent::GetIDFromName(Event_EntityCreated::sk_name), [this](AEvent * pEvent) { this->HandleEntityCreatedEvent(pEvent); });
-        this->AddEventHandler(AEvent::GetIDFromName(Event_EntityUpdated::sk_name), [this](AEvent * pEvent) { this->HandleEntityUpdatedEvent(pEvent); });
+        this->AddEventHandler(AEvent::GetIDFromName(Event_EntitiesUpdated::sk_name), [this](AEvent * pEvent) { this->HandleEntitiesUpdatedEvent(pEvent); });
+        this->AddEventHandler(AEvent::GetIDFromName(Event_EntitiesDestroyed::sk_name), [this](AEvent * pEvent) { this->HandleEntitiesDestroyedEvent(pEvent); });
+        this->AddEventHandler(AEvent::GetIDFromName(Event_EntityHandleChanged::sk_name), [this](AEvent * pEvent) { this->HandleEntityHandleChangedEvent(pEvent); });
+        this->AddEventHandler(AEvent::GetIDFromName(Event_EntityTagsChanged::sk_name), [this](AEvent * pEvent) { this->HandleEntityTagsChangedEvent(pEvent); });
+        this->AddEventHandler(AEvent::GetIDFromName(Event_SetRenderFilter::sk_name), [this](AEvent * pEvent) { this->HandleSetRenderFilterEvent(pEvent); });
         this->AddEventHandler(AEvent::GetIDFromName(Event_SetActiveCamera::sk_name), [this](AEvent * pEvent) { this->HandleSetActiveCameraEvent(pEvent); });
 
         // create a default camera for the scene
@@ -63,7 +76,14 @@ namespace alpha
 
     bool GraphicsSystem::VShutdown()
     {
-        if (m_pSceneManager) { delete m_pSceneManager; }
+        // the thread pool has already stopped, so anything left of the last render runs here
+        this->VFinishTasks();
+
+        if (m_pSceneManager)
+        {
+            m_pSceneManager->ReleaseRemoved(m_pRenderer);
+            delete m_pSceneManager;
+        }
 
         if (m_pRenderer)
         {
@@ -75,15 +95,18 @@ namespace alpha
 
     void GraphicsSystem::Render()
     {
-        // prepare the scene data for rendering
-        m_pSceneManager->PreRender();
+        // nothing may still be stepping the scene while it is prepared and drawn
+        this->VFinishTasks();
 
         // udpate the camera pre-render, so it can adjust to any game logic changes
         m_pCamera->Update(m_fWindowWidth, m_fWindowHeight);
 
-        // XXX TODO - pass camera into scene manager so the renderables can be frustum culled ... maybe ?
+        // prepare the scene data for rendering, culled to what the camera can see
+        m_pSceneManager->PreRender(Frustum(m_pCamera->GetView() * m_pCamera->GetProjection()));
+
         const std::vector<RenderSet *> renderables = m_pSceneManager->GetRenderData();
         const std::vector<Light *> lights = m_pSceneManager->GetLightData();
+        const std::vector<ParticleEmitter *> particles = m_pSceneManager->GetParticleData();
 
         // Prep current set of renderables
         for (auto rs : renderables)
@@ -92,7 +115,49 @@ namespace alpha
         }
 
         // Render the array of renderables from the given camera viewpoint
-        m_pRenderer->Render(m_pCamera, renderables, lights);
+        m_pRenderer->Render(m_pCamera, renderables, lights, particles);
+
+        // the frame is done with, so destroyed entities can safely give up their gpu resources
+        m_pSceneManager->ReleaseRemoved(m_pRenderer);
+
+        // step the scene just drawn while the next frame is updated
+        this->SimulateScene();
+    }
+
+    void GraphicsSystem::VFinishTasks()
+    {
+        if (m_pSceneTasks != nullptr)
+        {
+            m_pSceneTasks->Wait();
+            m_pSceneTasks.reset();
+        }
+    }
+
+    void GraphicsSystem::SimulateScene()
+    {
+        if (m_fSimulateTime <= 0.f)
+        {
+            return;
+        }
+
+        // the lists come from this frames render, so none of them point at nodes that were just released
+        std::vector<ATask *> tasks;
+        for (ParticleEmitter * pEmitter : m_pSceneManager->GetParticleData())
+        {
+            tasks.push_back(new Task_SimulateParticles(pEmitter, m_fSimulateTime));
+        }
+
+        // pose every visible skinned model, a batch of animators per task
+        const std::vector<SkeletonAnimator *> & skinned = m_pSceneManager->GetSkinnedData();
+        for (size_t begin = 0; begin < skinned.size(); begin += Task_EvaluatePoses::sk_batchSize)
+        {
+            const size_t end = std::min(begin + Task_EvaluatePoses::sk_batchSize, skinned.size());
+            std::vector<SkeletonAnimator *> batch(skinned.begin() + begin, skinned.begin() + end);
+            tasks.push_back(new Task_EvaluatePoses(batch, m_fSimulateTime));
+        }
+        m_fSimulateTime = 0.f;
+
+        m_pSceneTasks = TaskGroup::Publish(std::move(tasks), [this](AEvent * pEvent) { this->PublishEvent(pEvent); });
     }
 
     bool GraphicsSystem::VUpdate(double currentTime, double elapsedTime)
@@ -102,6 +167,9 @@ namespace alpha
         // scene.
         m_pSceneManager->Update(currentTime, elapsedTime);
 
+        // emitters and skinned models are stepped on the thread pool after the next render, by all the time passed since the last one
+        m_fSimulateTime += static_cast<float>(elapsedTime);
+
         // Prep current set of renderables, make sure that
         // the objects to be rendered are ready, and contain
         // and renderer specific data variables
@@ -119,6 +187,21 @@ namespace alpha
         m_pAssets = pAssets;
     }
 
+    void GraphicsSystem::QueryBoxes(const std::vector<AABB> & boxes, std::vector<std::vector<EntityHandle> > & results, EntityTagMask exclude)
+    {
+        m_pSceneManager->QueryBoxes(boxes, results, exclude);
+    }
+
+    void GraphicsSystem::QuerySpheres(const std::vector<Sphere> & spheres, std::vector<std::vector<EntityHandle> > & results, EntityTagMask exclude)
+    {
+        m_pSceneManager->QuerySpheres(spheres, results, exclude);
+    }
+
+    void GraphicsSystem::Raycast(const std::vector<Ray> & rays, std::vector<std::vector<RaycastHit> > & results, EntityTagMask exclude)
+    {
+        m_pSceneManager->Raycast(rays, results, exclude);
+    }
+
     void GraphicsSystem::HandleEntityCreatedEvent(AEvent * pEvent)
     {
         LOG("Graphics system received Event_EntityCreated");
@@ -128,12 +211,48 @@ namespace alpha
         }
     }
 
-    void GraphicsSystem::HandleEntityUpdatedEvent(AEvent * pEvent)
+    void GraphicsSystem::HandleEntitiesUpdatedEvent(AEvent * pEvent)
+    {
+        if (auto pUpdateEvent = dynamic_cast<Event_EntitiesUpdated *>(pEvent))
+        {
+            // only apply the fields that changed, rather than refreshing every node of each entity
+            this->m_pSceneManager->ApplyChanges(pUpdateEvent->GetDeltas());
+        }
+    }
+
+    void GraphicsSystem::HandleEntitiesDestroyedEvent(AEvent * pEvent)
+    {
+        if (auto pDestroyedEvent = dynamic_cast<Event_EntitiesDestroyed *>(pEvent))
+        {
+            for (auto & handle : pDestroyedEvent->GetHandles())
+            {
+                this->m_pSceneManager->Remove(handle);
+            }
+        }
+    }
+
+    void GraphicsSystem::HandleEntityHandleChangedEvent(AEvent * pEvent)
+    {
+        if (auto pHandleEvent = dynamic_cast<Event_EntityHandleChanged *>(pEvent))
+        {
+            this->m_pSceneManager->ChangeHandle(pHandleEvent->GetOldHandle(), pHandleEvent->GetNewHandle());
+            this->m_pSceneManager->SetTags(pHandleEvent->GetNewHandle(), pHandleEvent->GetTags());
+        }
+    }
+
+    void GraphicsSystem::HandleEntityTagsChangedEvent(AEvent * pEvent)
+    {
+        if (auto pTagsEvent = dynamic_cast<Event_EntityTagsChanged *>(pEvent))
+        {
+            this->m_pSceneManager->SetTags(pTagsEvent->GetHandle(), pTagsEvent->GetTags());
+        }
+    }
+
+    void GraphicsSystem::HandleSetRenderFilterEvent(AEvent * pEvent)
     {
-        //LOG("Graphics system received Event_EntityUpdated");
-        if (auto pUpdateEvent = dynamic_cast<Event_EntityUpdated *>(pEvent))
+        if (auto pFilterEvent = dynamic_cast<Event_SetRenderFilter *>(pEvent))
         {
-            this->m_pSceneManager->Update(pUpdateEvent->GetEntity());
+            this->m_pSceneManager->SetRenderFilter(pFilterEvent->GetRenderExclude(), pFilterEvent->GetLightExclude());
         }
     }
 
@@ -21,17 +21,34 @@ namespace alpha
 {
     Light::Light(std::shared_ptr<LightComponent> light_component)
     {
-        m_eLightType = light_component->GetLightType();
-        m_vBaseColor = light_component->GetLightColor();
-        m_fIntensity = light_component->GetIntensity();
-        m_fAmbientIntensity = light_component->GetAmbientIntensity();
-        m_vDirection = light_component->GetLightDirection();
-        m_fMaxDistance = light_component->GetLightDistance();
+        this->Refresh(*light_component);
+    }
+
+    Light::~Light() { }
+
+    void Light::Refresh(const LightComponent & light_component)
+    {
+        m_eLightType = light_component.GetLightType();
+        m_vBaseColor = light_component.GetLightColor();
+        m_fIntensity = light_component.GetIntensity();
+        m_fAmbientIntensity = light_component.GetAmbientIntensity();
+        m_vDirection = light_component.GetLightDirection();
+        m_fMaxDistance = light_component.GetLightDistance();
 
         CalculateLighting();
     }
 
-    Light::~Light() { }
+    void Light::Refresh(const ComponentValues & values)
+    {
+        m_eLightType = values.lightType;
+        m_vBaseColor = values.lightColor;
+        m_fIntensity = values.lightIntensity;
+        m_fAmbientIntensity = values.lightAmbientIntensity;
+        m_vDirection = values.lightDirection;
+        m_fMaxDistance = values.lightDistance;
+
+        CalculateLighting();
+    }
 
     Vector4 Light::GetAmbientLight() const
     {
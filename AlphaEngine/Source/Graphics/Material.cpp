@@ -41,31 +41,30 @@ namespace alpha
         {
             m_pMaterialScript = new MaterialScript(pAsset);
 
-            auto table = m_pMaterialScript->GetMaterialTable();
+            auto arena = m_pMaterialScript->GetMaterialTable();
 
-            if (table == nullptr)
+            if (arena == nullptr)
             {
                 LOG_ERR("Material script variable data does not represent a valid data table.");
                 return;
             }
             else
             {
+                const LuaVar table = arena->GetRoot();
+
                 // get object color value
-                auto color_table = std::dynamic_pointer_cast<LuaTable>(table->Get("color"));
-                if (color_table != nullptr)
-                {
-                    m_pMaterialScript->GetTableFloatValue(color_table, "r", &m_vColor.x);
-                    m_pMaterialScript->GetTableFloatValue(color_table, "g", &m_vColor.y);
-                    m_pMaterialScript->GetTableFloatValue(color_table, "b", &m_vColor.z);
-                    m_pMaterialScript->GetTableFloatValue(color_table, "a", &m_vColor.w);
-                }
+                const LuaVar color = table.Get("color");
+                m_vColor.x = static_cast<float>(color.Get("r").GetNumber(m_vColor.x));
+                m_vColor.y = static_cast<float>(color.Get("g").GetNumber(m_vColor.y));
+                m_vColor.z = static_cast<float>(color.Get("b").GetNumber(m_vColor.z));
+                m_vColor.w = static_cast<float>(color.Get("a").GetNumber(m_vColor.w));
 
                 // get object roughness
-                m_pMaterialScript->GetTableFloatValue(table, "roughness", &m_fRoughness);
+                m_fRoughness = static_cast<float>(table.Get("roughness").GetNumber(m_fRoughness));
                 // get object metallic factor
-                m_pMaterialScript->GetTableFloatValue(table, "metallic", &m_fMetallic);
+                m_fMetallic = static_cast<float>(table.Get("metallic").GetNumber(m_fMetallic));
                 // get object spcular
-                m_pMaterialScript->GetTableFloatValue(table, "specular", &m_fSpecular);
+                m_fSpecular = static_cast<float>(table.Get("specular").GetNumber(m_fSpecular));
             }
         }
 
@@ -139,7 +138,7 @@ namespace alpha
     MaterialScript::~MaterialScript() { }
 
     //! Get a list of the components specified by the script.
-    std::shared_ptr<LuaTable> MaterialScript::GetMaterialTable()
+    std::shared_ptr<const LuaArena> MaterialScript::GetMaterialTable()
     {
         if (m_pMaterialTable == nullptr)
         {
@@ -147,6 +146,9 @@ namespace alpha
             this->Run();
 
             m_pMaterialTable = this->GetGlobalTable("material");
+
+            // the material table is all that is needed, release the lua state.
+            this->Close();
         }
         return m_pMaterialTable;
     }
@@ -18,14 +18,15 @@ limitations under the License.
 #include <sstream>
 
 #include "Graphics/Mesh.h"
+#include "Graphics/ModelFile.h"
 #include "Math/Constants.h"
 
 #include "Toolbox/Logger.h"
 
 namespace alpha
 {
-    Mesh::Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices)
-        : Renderable(vertices, indices)
+    Mesh::Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<VertexWeights> weights)
+        : Renderable(vertices, indices, weights)
     { }
 
     std::vector<Vertex> Mesh::GetVertices() const
@@ -38,6 +39,11 @@ namespace alpha
         return indices;
     }
 
+    std::vector<VertexWeights> Mesh::GetWeights() const
+    {
+        return weights;
+    }
+
     void Mesh::Serialize(std::ostream & stream) const
     {
         // output number of vertices
@@ -63,9 +69,20 @@ namespace alpha
             sprintf(indBuf, "%d", index);
             stream.write(indBuf, UINT_LENGTH);
         }
+
+        // output the number of weights, either none or one per vertex
+        char weightSizeBuf[UINT_LENGTH] = { 0 };
+        sprintf(weightSizeBuf, "%d", (unsigned int)weights.size());
+        stream.write(weightSizeBuf, UINT_LENGTH);
+
+        // then the weights in a single block
+        if (!weights.empty())
+        {
+            stream.write(reinterpret_cast<const char *>(&weights[0]), weights.size() * sizeof(VertexWeights));
+        }
     }
 
-    Mesh * Mesh::Deserialize(std::istream & stream)
+    Mesh * Mesh::Deserialize(std::istream & stream, unsigned short version)
     {
         // get the number of vertices to make
         unsigned int numVerts = 0;
@@ -102,7 +119,29 @@ namespace alpha
             indices.push_back(ind);
         }
 
+        // version 2 files follow the indices with the bone weights for skinned meshes
+        std::vector<VertexWeights> weights;
+        if (version >= MODELFILE_V2)
+        {
+            unsigned int numWeights = 0;
+            char weightBuf[UINT_LENGTH + 1] = { 0 };
+            stream.read(weightBuf, UINT_LENGTH);
+            std::stringstream weight_size_stream(weightBuf);
+            weight_size_stream >> numWeights;
+
+            if (numWeights == numVerts && numWeights > 0)
+            {
+                weights.resize(numWeights);
+                stream.read(reinterpret_cast<char *>(&weights[0]), numWeights * sizeof(VertexWeights));
+            }
+            else if (numWeights > 0)
+            {
+                LOG_ERR("Mesh > Expected ", numVerts, " vertex weights, found ", numWeights, ".");
+                stream.ignore(numWeights * sizeof(VertexWeights));
+            }
+        }
+
         // make and return the new mesh
-        return new Mesh(vertices, indices);
+        return new Mesh(vertices, indices, weights);
     }
 }
@@ -20,15 +20,40 @@ limitations under the License.
 
 #include "Graphics/Model.h"
 #include "Graphics/Mesh.h"
+#include "Graphics/ModelFile.h"
 #include "Graphics/Renderable.h"
+#include "Animation/Skeleton.h"
 #include "Math/Constants.h"
 
 namespace alpha
 {
-    Model::Model(std::vector<Renderable *> meshes)
+    Model::Model(std::vector<Renderable *> meshes, Skeleton * pSkeleton)
         : RenderSet("PS")
         , m_meshes(meshes)
-    { }
+        , m_pSkeleton(pSkeleton)
+    {
+        // work out the model space bounds from every vertex of every mesh
+        bool first = true;
+        for (auto renderable : m_meshes)
+        {
+            if (renderable == nullptr)
+            {
+                continue;
+            }
+            for (const Vertex & vertex : renderable->vertices)
+            {
+                if (first)
+                {
+                    bounds = AABB(vertex.position, vertex.position);
+                    first = false;
+                }
+                else
+                {
+                    bounds = AABB::Merge(bounds, AABB(vertex.position, vertex.position));
+                }
+            }
+        }
+    }
     Model::~Model()
     {
         for (auto renderable : m_meshes)
@@ -38,6 +63,10 @@ namespace alpha
                 delete renderable;
             }
         }
+        if (m_pSkeleton != nullptr)
+        {
+            delete m_pSkeleton;
+        }
     }
 
     std::vector<Renderable *> Model::GetRenderables()
@@ -45,6 +74,11 @@ namespace alpha
         return m_meshes;
     }
 
+    const Skeleton * Model::GetSkeleton() const
+    {
+        return m_pSkeleton;
+    }
+
     void Model::Serialize(std::ostream & stream) const
     {
         // serializing a model amounts to serializing all meshes
@@ -60,9 +94,19 @@ namespace alpha
             auto mesh = dynamic_cast<const Mesh *>(r);
             mesh->Serialize(stream);
         }
+
+        // then the skeleton, a model without one writes an empty skeleton
+        if (m_pSkeleton != nullptr)
+        {
+            m_pSkeleton->Serialize(stream);
+        }
+        else
+        {
+            Skeleton(std::vector<Bone>(), Pose()).Serialize(stream);
+        }
     }
 
-    Model * Model::Deserialize(std::istream & stream)
+    Model * Model::Deserialize(std::istream & stream, unsigned short version)
     {
         // first data point should be the number of meshes to make
         unsigned int numMeshes = 0;
@@ -75,9 +119,21 @@ namespace alpha
         std::vector<Renderable *> meshes;
         for (unsigned int i = 0; i < numMeshes; ++i)
         {
-            meshes.push_back(Mesh::Deserialize(stream));
+            meshes.push_back(Mesh::Deserialize(stream, version));
+        }
+
+        // version 2 files end with the skeleton the meshes are skinned to
+        Skeleton * pSkeleton = nullptr;
+        if (version >= MODELFILE_V2)
+        {
+            pSkeleton = Skeleton::Deserialize(stream);
+            if (pSkeleton != nullptr && pSkeleton->GetBoneCount() == 0)
+            {
+                delete pSkeleton;
+                pSkeleton = nullptr;
+            }
         }
 
-        return new Model(meshes);
+        return new Model(meshes, pSkeleton);
     }
 }
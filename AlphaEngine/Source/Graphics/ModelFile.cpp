@@ -43,12 +43,11 @@ namespace alpha
         ModelFileHeader header;
         stream.read(reinterpret_cast<char *>(&header), sizeof(ModelFileHeader));
 
-        // check to make sure this is a valid Alpha-Model
-        // In the future we can deserialize the file differently
-        // based on the version as well.
-        if (strcmp(header.signature, MODELFILE_SIG) == 0 && header.version == MODELFILE_V1)
+        // check to make sure this is a valid Alpha-Model,
+        // the model reads each version differently.
+        if (strcmp(header.signature, MODELFILE_SIG) == 0 && (header.version == MODELFILE_V1 || header.version == MODELFILE_V2))
         {
-            return Model::Deserialize(stream);
+            return Model::Deserialize(stream, header.version);
         }
         return nullptr;
     }
@@ -57,7 +56,7 @@ namespace alpha
     {
         ModelFileHeader header;
         sprintf(header.signature, "%s", MODELFILE_SIG);
-        header.version = MODELFILE_V1;
+        header.version = MODELFILE_V2;
 
         // add header data to stream
         stream.write(reinterpret_cast<char *>(&header), sizeof(ModelFileHeader));
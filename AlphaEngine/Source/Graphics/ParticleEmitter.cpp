@@ -0,0 +1,198 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+#include <cmath>
+
+#include "Graphics/ParticleEmitter.h"
+#include "Math/SIMD.h"
+
+namespace alpha
+{
+    ParticleEmitter::ParticleEmitter(const ParticleSettings & settings)
+        : m_settings(settings)
+        , m_count(0)
+        , m_fEmitDebt(0.f)
+        , m_random(std::random_device()())
+    {
+        // pad out to a whole number of four wide lanes, the padding is integrated but never drawn
+        const size_t capacity = (static_cast<size_t>(m_settings.maxParticles) + 3) & ~static_cast<size_t>(3);
+        m_posX.resize(capacity); m_posY.resize(capacity); m_posZ.resize(capacity);
+        m_velX.resize(capacity); m_velY.resize(capacity); m_velZ.resize(capacity);
+        m_age.resize(capacity);
+        m_life.resize(capacity);
+        m_instances.reserve(capacity * 4);
+
+        // normalize once, so spawning does not have to
+        Vector3 & dir = m_settings.direction;
+        const float length = std::sqrt(dir.x * dir.x + dir.y * dir.y + dir.z * dir.z);
+        dir = (length > 0.f) ? Vector3(dir.x / length, dir.y / length, dir.z / length) : Vector3(0.f, 1.f, 0.f);
+    }
+    ParticleEmitter::~ParticleEmitter() { }
+
+    void ParticleEmitter::SetWorldTransform(const Matrix & world)
+    {
+        m_world = world;
+    }
+
+    void ParticleEmitter::Simulate(float fElapsedTime)
+    {
+        this->Integrate(fElapsedTime);
+        this->Retire();
+        this->Emit(fElapsedTime);
+
+        // interleave the live particles for the gpu, shrinking each one away as it reaches the end of its life
+        m_instances.resize(m_count * 4);
+        for (size_t i = 0; i < m_count; ++i)
+        {
+            float * instance = &m_instances[i * 4];
+            instance[0] = m_posX[i];
+            instance[1] = m_posY[i];
+            instance[2] = m_posZ[i];
+            instance[3] = m_settings.size * (1.f - m_age[i] / m_life[i]);
+        }
+    }
+
+    void ParticleEmitter::Clear()
+    {
+        m_count = 0;
+        m_fEmitDebt = 0.f;
+        m_instances.clear();
+    }
+
+    size_t ParticleEmitter::GetCount() const
+    {
+        return m_count;
+    }
+
+    const std::vector<float> & ParticleEmitter::GetInstanceData() const
+    {
+        return m_instances;
+    }
+
+    void ParticleEmitter::Integrate(float fElapsedTime)
+    {
+        const float dt = fElapsedTime;
+        const size_t lanes = (m_count + 3) & ~static_cast<size_t>(3);
+
+#if defined(ALPHA_SIMD_SSE2)
+        const __m128 vdt = _mm_set1_ps(dt);
+        const __m128 gx = _mm_set1_ps(m_settings.gravity.x * dt);
+        const __m128 gy = _mm_set1_ps(m_settings.gravity.y * dt);
+        const __m128 gz = _mm_set1_ps(m_settings.gravity.z * dt);
+        for (size_t i = 0; i < lanes; i += 4)
+        {
+            __m128 vx = _mm_add_ps(_mm_loadu_ps(&m_velX[i]), gx);
+            __m128 vy = _mm_add_ps(_mm_loadu_ps(&m_velY[i]), gy);
+            __m128 vz = _mm_add_ps(_mm_loadu_ps(&m_velZ[i]), gz);
+            _mm_storeu_ps(&m_velX[i], vx);
+            _mm_storeu_ps(&m_velY[i], vy);
+            _mm_storeu_ps(&m_velZ[i], vz);
+
+            _mm_storeu_ps(&m_posX[i], _mm_add_ps(_mm_loadu_ps(&m_posX[i]), _mm_mul_ps(vx, vdt)));
+            _mm_storeu_ps(&m_posY[i], _mm_add_ps(_mm_loadu_ps(&m_posY[i]), _mm_mul_ps(vy, vdt)));
+            _mm_storeu_ps(&m_posZ[i], _mm_add_ps(_mm_loadu_ps(&m_posZ[i]), _mm_mul_ps(vz, vdt)));
+
+            _mm_storeu_ps(&m_age[i], _mm_add_ps(_mm_loadu_ps(&m_age[i]), vdt));
+        }
+#else
+        const float gx = m_settings.gravity.x * dt;
+        const float gy = m_settings.gravity.y * dt;
+        const float gz = m_settings.gravity.z * dt;
+        for (size_t i = 0; i < lanes; ++i)
+        {
+            m_velX[i] += gx; m_velY[i] += gy; m_velZ[i] += gz;
+            m_posX[i] += m_velX[i] * dt; m_posY[i] += m_velY[i] * dt; m_posZ[i] += m_velZ[i] * dt;
+            m_age[i] += dt;
+        }
+#endif
+    }
+
+    void ParticleEmitter::Retire()
+    {
+        size_t i = 0;
+        while (i < m_count)
+        {
+            if (m_age[i] < m_life[i])
+            {
+                ++i;
+                continue;
+            }
+
+            // move the last live particle into the hole, and test it next
+            const size_t last = --m_count;
+            m_posX[i] = m_posX[last]; m_posY[i] = m_posY[last]; m_posZ[i] = m_posZ[last];
+            m_velX[i] = m_velX[last]; m_velY[i] = m_velY[last]; m_velZ[i] = m_velZ[last];
+            m_age[i] = m_age[last];
+            m_life[i] = m_life[last];
+        }
+    }
+
+    void ParticleEmitter::Emit(float fElapsedTime)
+    {
+        m_fEmitDebt += m_settings.rate * fElapsedTime;
+        const size_t due = static_cast<size_t>(m_fEmitDebt);
+        m_fEmitDebt -= static_cast<float>(due);
+
+        const size_t spawn = std::min(due, static_cast<size_t>(m_settings.maxParticles) - m_count);
+        if (spawn == 0)
+        {
+            return;
+        }
+
+        // launch direction in world space, and a pair of axes perpendicular to it for the cone
+        const Vector3 & d = m_settings.direction;
+        Vector3 axis(d.x * m_world.m_11 + d.y * m_world.m_21 + d.z * m_world.m_31,
+                     d.x * m_world.m_12 + d.y * m_world.m_22 + d.z * m_world.m_32,
+                     d.x * m_world.m_13 + d.y * m_world.m_23 + d.z * m_world.m_33);
+        float length = std::sqrt(axis.x * axis.x + axis.y * axis.y + axis.z * axis.z);
+        axis = (length > 0.f) ? Vector3(axis.x / length, axis.y / length, axis.z / length) : Vector3(0.f, 1.f, 0.f);
+
+        Vector3 helper = std::fabs(axis.y) < 0.99f ? Vector3(0.f, 1.f, 0.f) : Vector3(1.f, 0.f, 0.f);
+        Vector3 tangent(helper.y * axis.z - helper.z * axis.y, helper.z * axis.x - helper.x * axis.z, helper.x * axis.y - helper.y * axis.x);
+        length = std::sqrt(tangent.x * tangent.x + tangent.y * tangent.y + tangent.z * tangent.z);
+        tangent = Vector3(tangent.x / length, tangent.y / length, tangent.z / length);
+        Vector3 bitangent(axis.y * tangent.z - axis.z * tangent.y, axis.z * tangent.x - axis.x * tangent.z, axis.x * tangent.y - axis.y * tangent.x);
+
+        const Vector3 origin = m_world.Position();
+
+        const float two_pi = 6.28318531f;
+        std::uniform_real_distribution<float> unit(0.f, 1.f);
+        const float min_cos = std::cos(m_settings.spread);
+        for (size_t n = 0; n < spawn; ++n)
+        {
+            // pick a direction uniformly over the cap of the cone
+            const float cos_theta = 1.f - unit(m_random) * (1.f - min_cos);
+            const float sin_theta = std::sqrt(std::max(0.f, 1.f - cos_theta * cos_theta));
+            const float phi = unit(m_random) * two_pi;
+            const float t = sin_theta * std::cos(phi);
+            const float b = sin_theta * std::sin(phi);
+
+            const float speed = m_settings.minSpeed + unit(m_random) * (m_settings.maxSpeed - m_settings.minSpeed);
+            const float life = m_settings.minLifetime + unit(m_random) * (m_settings.maxLifetime - m_settings.minLifetime);
+
+            const size_t i = m_count++;
+            m_posX[i] = origin.x;
+            m_posY[i] = origin.y;
+            m_posZ[i] = origin.z;
+            m_velX[i] = (axis.x * cos_theta + tangent.x * t + bitangent.x * b) * speed;
+            m_velY[i] = (axis.y * cos_theta + tangent.y * t + bitangent.y * b) * speed;
+            m_velZ[i] = (axis.z * cos_theta + tangent.z * t + bitangent.z * b) * speed;
+            m_age[i] = 0.f;
+            m_life[i] = std::max(life, 0.001f);
+        }
+    }
+}
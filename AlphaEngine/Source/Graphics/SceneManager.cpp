@@ -14,34 +14,59 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <algorithm>
+#include <limits>
+#include <utility>
+
 #include "Graphics/SceneManager.h"
 #include "Graphics/SceneNode.h"
 #include "Graphics/RenderSet.h"
 #include "Graphics/Light.h"
+#include "Graphics/IRenderer.h"
+#include "Graphics/ParticleEmitter.h"
+#include "Graphics/Model.h"
+#include "Animation/AnimationClip.h"
+#include "Animation/Skeleton.h"
+#include "Animation/SkeletonAnimator.h"
 #include "Assets/AssetSystem.h"
 #include "Entities/Entity.h"
 #include "Entities/EntityComponent.h"
 #include "Entities/MeshComponent.h"
 #include "Entities/LightComponent.h"
+#include "Entities/ParticleEmitterComponent.h"
+#include "Entities/SkinnedMeshComponent.h"
+#include "Math/Frustum.h"
 #include "Toolbox/Logger.h"
 
 namespace alpha
 {
     SceneManager::SceneManager(AssetSystem * const pAssets)
         : m_pAssets(pAssets)
+        , m_compactTransforms(false)
+        , m_transformPass(0)
+        , m_renderExclude(ET_DISABLED | ET_HIDDEN | ET_EDITOR_ONLY | ET_SERVER_ONLY | ET_POOLED)
+        , m_lightExclude(ET_DISABLED | ET_EDITOR_ONLY | ET_SERVER_ONLY | ET_POOLED)
     { }
     SceneManager::~SceneManager()
     {
-        for (auto pair : m_nodes)
+        for (auto & pair : m_nodes)
         {
             // delete all entity scene nodes properly
-            for (auto nodepair : pair.second)
+            for (auto nodepair : pair.second.roots)
             {
                 delete nodepair.second;
             }
-            pair.second.clear();
         }
         m_nodes.clear();
+
+        for (auto nodes : m_removedNodes)
+        {
+            for (auto nodepair : nodes)
+            {
+                delete nodepair.second;
+            }
+        }
+        m_removedNodes.clear();
     }
 
     bool SceneManager::Update(double /*currentTime*/, double /*elapsedTime*/)
@@ -60,14 +85,43 @@ namespace alpha
         return true;
     }
 
-    bool SceneManager::PreRender()
+    bool SceneManager::PreRender(const Frustum & view)
     {
+        // bring every world transform up to date before handing out render data
+        this->RefreshTransforms();
+
+        // stamp every node in view with this pass, anything left unstamped is culled below
+        const unsigned int pass = m_transformPass;
+        m_spatialTree.Query(view, [&view, pass](SceneNode * node)
+        {
+            if (view.Overlaps(node->GetWorldBounds()))
+            {
+                node->SetVisiblePass(pass);
+            }
+        });
+
         m_vRenderData.clear();
         m_vLightData.clear();
+        m_vParticleData.clear();
+        m_vSkinnedData.clear();
 
-        for (auto pair : m_nodes)
+        for (auto & pair : m_nodes)
         {
-            this->BuildRenderData(pair.first, pair.second, m_vRenderData, m_vLightData);
+            const EntityNodes & nodes = pair.second;
+            if (nodes.roots.empty())
+            {
+                continue;
+            }
+
+            // every node carries its entities tags, so one test per entity filters the whole entity
+            EntityTagMask tags = nodes.roots.begin()->second->GetTags();
+            bool render = (tags & m_renderExclude) == 0;
+            bool light = (tags & m_lightExclude) == 0;
+            if (render || light)
+            {
+                this->BuildRenderData(nodes.handle, nodes.roots, render ? &m_vRenderData : nullptr, light ? &m_vLightData : nullptr,
+                                      render ? &m_vParticleData : nullptr, render ? &m_vSkinnedData : nullptr);
+            }
         }
 
         return true;
@@ -84,45 +138,205 @@ namespace alpha
         return m_vLightData;
     }
 
+    const std::vector<ParticleEmitter *> & SceneManager::GetParticleData()
+    {
+        return m_vParticleData;
+    }
+
+    const std::vector<SkeletonAnimator *> & SceneManager::GetSkinnedData()
+    {
+        return m_vSkinnedData;
+    }
+
     bool SceneManager::Add(const std::shared_ptr<Entity> & entity)
     {
-        unsigned int entity_id = entity->GetId();
-        auto search = m_nodes.find(entity_id);
-        if (search == m_nodes.end())
+        EntityHandle handle = entity->GetHandle();
+        if (!handle.IsValid())
         {
-            auto components = entity->GetComponents();
-            m_nodes[entity_id] = this->CreateNodes(components, nullptr);
-            this->UpdateRenderData(m_nodes[entity_id]);
-            return true;
+            // the entity was destroyed before it ever made it into the scene
+            return false;
         }
-        return false;
+
+        auto search = m_nodes.find(handle.index);
+        if (search != m_nodes.end())
+        {
+            if (search->second.handle == handle)
+            {
+                return false;
+            }
+            // whatever held the slot before is gone, its removal has just not been seen yet
+            this->Remove(search->second.handle);
+        }
+
+        EntityNodes & nodes = m_nodes[handle.index];
+        nodes.handle = handle;
+        nodes.roots = this->CreateNodes(handle, entity->GetComponents(), nullptr, nodes.components);
+        this->SetTags(handle, entity->GetTags());
+        this->UpdateRenderData(nodes.roots);
+        return true;
     }
 
     bool SceneManager::Update(const std::shared_ptr<Entity> & entity)
     {
-        auto search = m_nodes.find(entity->GetId());
-        if (search != m_nodes.end())
+        EntityNodes * pNodes = this->FindNodes(entity->GetHandle());
+        if (pNodes != nullptr)
         {
-            this->UpdateRenderData(search->second);
+            this->UpdateRenderData(pNodes->roots);
             return true;
         }
         return false;
     }
 
-    bool SceneManager::Remove(const std::shared_ptr<Entity> & /*entity*/)
+    void SceneManager::ApplyChanges(const std::vector<ComponentDelta> & deltas)
     {
-        /*
-        auto search = m_nodes.find(entity->GetId());
-        if (search != m_nodes.end())
+        for (auto & delta : deltas)
+        {
+            // transforms are read under their lock, every other change brings its values with it
+            if ((delta.changes & (CC_MATERIAL | CC_LIGHT | CC_CLIP | CC_CLIP_SPEED)) == 0 || delta.pValues == nullptr)
+            {
+                continue;
+            }
+            const ComponentValues & values = *delta.pValues;
+
+            EntityNodes * pNodes = this->FindNodes(delta.entity);
+            if (pNodes == nullptr)
+            {
+                continue;
+            }
+            auto search = pNodes->components.find(delta.componentId);
+            if (search == pNodes->components.end())
+            {
+                continue;
+            }
+            SceneNode * node = search->second;
+
+            if (delta.changes & CC_MATERIAL)
+            {
+                this->LoadMaterial(node, values.materialPath);
+                if (RenderSet * rs = node->GetRenderSet())
+                {
+                    rs->material = node->GetMaterial();
+                }
+            }
+
+            if (delta.changes & CC_LIGHT)
+            {
+                // a node only has a light if it was built from a light component
+                Light * pLight = node->GetLight();
+                if (pLight != nullptr)
+                {
+                    pLight->Refresh(values);
+                }
+            }
+
+            // only skinned mesh nodes have an animator, and only if the model has a skeleton
+            SkeletonAnimator * pAnimator = node->GetSkeletonAnimator();
+            if (pAnimator != nullptr && (delta.changes & (CC_CLIP | CC_CLIP_SPEED)))
+            {
+                if (delta.changes & CC_CLIP_SPEED)
+                {
+                    pAnimator->SetSpeed(values.clipSpeed);
+                }
+                // a reset component raises every change, even if it has no clip to start
+                if ((delta.changes & CC_CLIP) && !values.clip.empty())
+                {
+                    pAnimator->Play(values.clip, values.clipBlendTime, values.clipLoop);
+                }
+            }
+        }
+    }
+
+    void SceneManager::ChangeHandle(const EntityHandle & oldHandle, const EntityHandle & newHandle)
+    {
+        EntityNodes * pNodes = this->FindNodes(oldHandle);
+        if (pNodes == nullptr)
+        {
+            return;
+        }
+
+        // a reissued handle keeps its slot, so the entry stays where it is, only a move to another slot re-keys it
+        if (newHandle.index != oldHandle.index)
+        {
+            auto occupied = m_nodes.find(newHandle.index);
+            if (occupied != m_nodes.end())
+            {
+                this->Remove(occupied->second.handle);
+            }
+            EntityNodes & moved = m_nodes[newHandle.index];
+            moved = std::move(*pNodes);
+            m_nodes.erase(oldHandle.index);
+            pNodes = &moved;
+        }
+        pNodes->handle = newHandle;
+
+        // every node, children included, reports the new handle to spatial queries
+        for (auto & pair : pNodes->components)
+        {
+            pair.second->SetEntityHandle(newHandle);
+        }
+    }
+
+    void SceneManager::SetTags(const EntityHandle & handle, EntityTagMask tags)
+    {
+        EntityNodes * pNodes = this->FindNodes(handle);
+        if (pNodes != nullptr)
+        {
+            for (auto & pair : pNodes->components)
+            {
+                pair.second->SetTags(tags);
+
+                // a parked emitter drops its particles, so they do not reappear where it was when it is recycled
+                ParticleEmitter * pEmitter = pair.second->GetParticleEmitter();
+                if (pEmitter != nullptr && (tags & ET_POOLED))
+                {
+                    pEmitter->Clear();
+                }
+            }
+        }
+    }
+
+    void SceneManager::SetRenderFilter(EntityTagMask renderExclude, EntityTagMask lightExclude)
+    {
+        // parked entities are never drawn, whatever the game filters
+        m_renderExclude = renderExclude | ET_POOLED;
+        m_lightExclude = lightExclude | ET_POOLED;
+    }
+
+    bool SceneManager::Remove(const EntityHandle & handle)
+    {
+        EntityNodes * pNodes = this->FindNodes(handle);
+        if (pNodes != nullptr)
         {
+            // stop building render data for the nodes now, but hold on to them until
+            // the renderer is done with them, then release them all at once.
+            this->RemoveTransforms(pNodes->roots);
+            m_removedNodes.push_back(std::move(pNodes->roots));
+            m_nodes.erase(handle.index);
             return true;
         }
         return false;
-        */
-        return false;
     }
 
-    std::map<unsigned int, SceneNode *> SceneManager::CreateNodes(const std::map<unsigned int, std::shared_ptr<EntityComponent> > components, SceneNode * pParent)
+    void SceneManager::ReleaseRemoved(IRenderer * pRenderer)
+    {
+        for (auto nodes : m_removedNodes)
+        {
+            if (pRenderer != nullptr)
+            {
+                this->ReleaseRenderData(nodes, pRenderer);
+            }
+
+            // deleting a node deletes its children, render set, and light.
+            for (auto nodepair : nodes)
+            {
+                delete nodepair.second;
+            }
+        }
+        m_removedNodes.clear();
+    }
+
+    std::map<unsigned int, SceneNode *> SceneManager::CreateNodes(const EntityHandle & handle, const std::map<unsigned int, std::shared_ptr<EntityComponent> > components, SceneNode * pParent,
+                                                                  std::map<unsigned int, SceneNode *> & lookup)
     {
         std::map<unsigned int, SceneNode *> nodes;
 
@@ -131,6 +345,7 @@ namespace alpha
             // creat this node
             std::shared_ptr<SceneComponent> scene_component = std::dynamic_pointer_cast<SceneComponent>(component.second);
             auto node = new SceneNode(pParent, scene_component);
+            node->SetEntityHandle(handle);
 
             // add any necessary assets to the scene node
             // XXX this should also happen during update incase the model asset is changed anytime during 
@@ -144,20 +359,13 @@ namespace alpha
                     node->SetMesh(asset);
                 }
             }
-
-            // get the material path, load as an asset, and set it on the node.
-            auto material_path = scene_component->GetMaterialPath();
-            std::shared_ptr<Material> pMaterial;
-            if (m_pAssets != nullptr)
+            if (std::dynamic_pointer_cast<SkinnedMeshComponent>(scene_component) != nullptr)
             {
-                auto pAsset = m_pAssets->GetAsset(material_path.c_str());
-
-                // XXX TODO - pass asset through a material manager, so that only one
-                // material every exists for a given material script.
-                pMaterial = std::make_shared<Material>(pAsset);
-                node->SetMaterial(pMaterial);
+                this->CreateSkeletonAnimator(node);
             }
 
+            this->LoadMaterial(node, scene_component->GetMaterialPath());
+
             if (auto light_component = std::dynamic_pointer_cast<LightComponent>(scene_component))
             {
                 // create a light based on the light component and set it on the scene node
@@ -165,19 +373,107 @@ namespace alpha
                 node->SetLight(pLight);
             }
 
+            if (auto emitter_component = std::dynamic_pointer_cast<ParticleEmitterComponent>(scene_component))
+            {
+                node->SetParticleEmitter(new ParticleEmitter(emitter_component->GetSettings()));
+            }
+
+            // add the node to the flattened transform list before any of its children,
+            // so that a single pass over the list always sees parents first.
+            // the nodes bounds are only known once its mesh is set, and placed once its world transform is built.
+            TransformEntry entry;
+            entry.node = node;
+            entry.parent = (pParent != nullptr) ? pParent->GetTransformIndex() : -1;
+            entry.version = 0;
+            entry.dirty = true;
+            entry.updatedPass = 0;
+            entry.localBounds = node->GetLocalBounds();
+            entry.proxy = m_spatialTree.CreateProxy(entry.localBounds, node);
+            node->SetTransformIndex(static_cast<int>(m_transforms.size()));
+            m_transforms.push_back(entry);
+
             // do a depth first creation, so the list of child nodes can be passed into the scene node creation.
-            std::map<unsigned int, SceneNode *> child_nodes = this->CreateNodes(component.second->GetComponents(), node);
+            std::map<unsigned int, SceneNode *> child_nodes = this->CreateNodes(handle, component.second->GetComponents(), node, lookup);
             node->SetChildren(child_nodes);
 
             nodes[component.first] = node;
+            lookup[component.first] = node;
         }
 
         return nodes;
     }
 
-    void SceneManager::BuildRenderData(unsigned int entity_id, std::map<unsigned int, SceneNode *> nodes, std::vector<RenderSet *> & renderables, std::vector<Light *> & lights) const
+    void SceneManager::LoadMaterial(SceneNode * pNode, const std::string & path)
     {
-        // XXX not sure if the entity id is needed at this point ... refactor as needed.
+        if (m_pAssets == nullptr)
+        {
+            return;
+        }
+
+        // a recycled node is usually reset to the material it already has
+        if (pNode->GetMaterialPath() == path && !pNode->GetMaterial().expired())
+        {
+            return;
+        }
+
+        // get the material path, load as an asset, and set it on the node.
+        auto pAsset = m_pAssets->GetAsset(path.c_str());
+
+        // XXX TODO - pass asset through a material manager, so that only one
+        // material every exists for a given material script.
+        pNode->SetMaterial(std::make_shared<Material>(pAsset), path);
+    }
+
+    void SceneManager::CreateSkeletonAnimator(SceneNode * pNode)
+    {
+        auto & skinned = static_cast<const SkinnedMeshComponent &>(*pNode->GetSceneComponent());
+
+        // a skinned mesh whose model has no skeleton is drawn in its bind pose
+        Model * pModel = dynamic_cast<Model *>(pNode->GetRenderSet());
+        if (pModel == nullptr || pModel->GetSkeleton() == nullptr)
+        {
+            LOG_WARN("SceneManager > Skinned mesh model '", skinned.GetMeshPath(), "' has no skeleton.");
+            return;
+        }
+
+        SkeletonAnimator * pAnimator = new SkeletonAnimator(pModel->GetSkeleton(), pModel);
+        for (auto & pair : skinned.GetClipPaths())
+        {
+            pAnimator->AddClip(pair.first, this->LoadClip(pair.second));
+        }
+        pAnimator->SetSpeed(skinned.GetClipSpeed());
+        if (!skinned.GetClip().empty())
+        {
+            pAnimator->Play(skinned.GetClip(), 0.f, skinned.GetLoop());
+        }
+        pNode->SetSkeletonAnimator(pAnimator);
+    }
+
+    std::shared_ptr<const AnimationClip> SceneManager::LoadClip(const std::string & path)
+    {
+        auto search = m_clips.find(path);
+        if (search != m_clips.end())
+        {
+            return search->second;
+        }
+
+        std::shared_ptr<const AnimationClip> clip;
+        if (m_pAssets != nullptr)
+        {
+            clip.reset(LoadClipFromAsset(m_pAssets->GetAsset(path.c_str())));
+        }
+        if (clip == nullptr)
+        {
+            LOG_WARN("SceneManager > Failed to load clip '", path, "'.");
+        }
+        m_clips[path] = clip;
+        return clip;
+    }
+
+    void SceneManager::BuildRenderData(const EntityHandle & handle, const std::map<unsigned int, SceneNode *> & nodes, std::vector<RenderSet *> * pRenderables, std::vector<Light *> * pLights,
+                                       std::vector<ParticleEmitter *> * pParticles, std::vector<SkeletonAnimator *> * pSkinned) const
+    {
+        // XXX not sure if the entity handle is needed at this point ... refactor as needed.
 
         // for each node
         for (auto iter : nodes)
@@ -187,20 +483,37 @@ namespace alpha
 
             Light * pLight = node->GetLight();
 
-            // make render data for this node
-            if (RenderSet * rs = node->GetRenderSet())
+            // make render data for this node, if it is in view
+            const bool visible = node->GetVisiblePass() == m_transformPass;
+            RenderSet * rs = node->GetRenderSet();
+            if (rs != nullptr && pRenderables != nullptr && visible)
             {
-                renderables.push_back(rs);
+                pRenderables->push_back(rs);
             }
 
             // see if it is a light
-            if (pLight != nullptr)
+            if (pLight != nullptr && pLights != nullptr)
+            {
+                pLights->push_back(pLight);
+            }
+
+            // emitters follow their node, and draw with its material
+            ParticleEmitter * pEmitter = node->GetParticleEmitter();
+            if (pEmitter != nullptr && pParticles != nullptr)
             {
-                lights.push_back(pLight);
+                pEmitter->SetWorldTransform(node->GetWorldTransform());
+                pEmitter->material = node->GetMaterial();
+                pParticles->push_back(pEmitter);
+            }
+
+            SkeletonAnimator * pAnimator = node->GetSkeletonAnimator();
+            if (pAnimator != nullptr && pSkinned != nullptr && visible)
+            {
+                pSkinned->push_back(pAnimator);
             }
 
             // recurse each child node
-            this->BuildRenderData(entity_id, node->GetChildren(), renderables, lights);
+            this->BuildRenderData(handle, node->GetChildren(), pRenderables, pLights, pParticles, pSkinned);
         }
     }
 
@@ -212,16 +525,12 @@ namespace alpha
             // check this node
             auto node = iter.second;
 
-            // prep the world transform for this node
-            Matrix world_transform = node->GetWorldTransform();
-
-            Light * pLight = node->GetLight();
+            // world transforms are kept up to date by UpdateTransforms,
+            // only the non-transform render data is refreshed here.
 
             // make render data for this node
             if (RenderSet * rs = node->GetRenderSet())
             {
-                rs->worldTransform = world_transform;
-
                 // if this renderable has a light attached
                 // then it emits light and should use a different
                 // shader
@@ -231,14 +540,224 @@ namespace alpha
                 rs->material = node->GetMaterial();
             }
 
-            // see if it is a light
-            if (pLight != nullptr)
+            // recurse each child node
+            this->UpdateRenderData(node->GetChildren());
+        }
+    }
+
+    void SceneManager::ReleaseRenderData(std::map<unsigned int, SceneNode *> nodes, IRenderer * pRenderer) const
+    {
+        for (auto iter : nodes)
+        {
+            auto node = iter.second;
+
+            if (RenderSet * rs = node->GetRenderSet())
             {
-                pLight->worldTransform = world_transform;
+                pRenderer->Release(rs);
             }
 
-            // recurse each child node
-            this->UpdateRenderData(node->GetChildren());
+            this->ReleaseRenderData(node->GetChildren(), pRenderer);
+        }
+    }
+
+    SceneManager::EntityNodes * SceneManager::FindNodes(const EntityHandle & handle)
+    {
+        auto search = m_nodes.find(handle.index);
+        if (search == m_nodes.end() || search->second.handle != handle)
+        {
+            return nullptr;
+        }
+        return &search->second;
+    }
+
+    void SceneManager::RefreshTransforms()
+    {
+        if (m_compactTransforms)
+        {
+            this->CompactTransforms();
+        }
+        ++m_transformPass;
+        this->UpdateTransforms(0, m_transforms.size());
+    }
+
+    void SceneManager::UpdateTransforms(size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            TransformEntry & entry = m_transforms[i];
+            if (entry.node == nullptr)
+            {
+                continue;
+            }
+
+            auto component = entry.node->GetSceneComponent();
+            unsigned int version = (component != nullptr) ? component->GetTransformVersion() : 0;
+
+            // rebuild if this node moved, or its parent was rebuilt earlier in this pass
+            bool parent_updated = entry.parent >= 0 && m_transforms[entry.parent].updatedPass == m_transformPass;
+            if (!entry.dirty && !parent_updated && entry.version == version)
+            {
+                continue;
+            }
+
+            // take the version the matrix was actually built from, the component may have moved again since
+            Matrix local = (component != nullptr) ? component->GetTransform(&version) : Matrix();
+            entry.world = (entry.parent >= 0) ? local * m_transforms[entry.parent].world : local;
+            entry.version = version;
+            entry.dirty = false;
+            entry.updatedPass = m_transformPass;
+
+            // push the new world transform out to everything that renders with it
+            entry.node->SetWorldTransform(entry.world);
+
+            // and refit the nodes spatial bounds, the tree is only touched if it left its fat box
+            AABB world_bounds = entry.localBounds.Transform(entry.world);
+            entry.node->SetWorldBounds(world_bounds);
+            m_spatialTree.MoveProxy(entry.proxy, world_bounds);
+            if (RenderSet * rs = entry.node->GetRenderSet())
+            {
+                rs->worldTransform = entry.world;
+            }
+            if (Light * pLight = entry.node->GetLight())
+            {
+                pLight->worldTransform = entry.world;
+            }
+        }
+    }
+
+    void SceneManager::CompactTransforms()
+    {
+        // map every surviving entry to its new position, removed entries map to -1.
+        // parents always precede children, so a parents new index is known before it is needed.
+        std::vector<int> remap(m_transforms.size(), -1);
+        size_t count = 0;
+        for (size_t i = 0; i < m_transforms.size(); ++i)
+        {
+            TransformEntry entry = m_transforms[i];
+            if (entry.node == nullptr)
+            {
+                continue;
+            }
+
+            entry.parent = (entry.parent >= 0) ? remap[entry.parent] : -1;
+            entry.node->SetTransformIndex(static_cast<int>(count));
+            remap[i] = static_cast<int>(count);
+            m_transforms[count++] = entry;
+        }
+        m_transforms.resize(count);
+        m_compactTransforms = false;
+    }
+
+    void SceneManager::RemoveTransforms(std::map<unsigned int, SceneNode *> nodes)
+    {
+        for (auto iter : nodes)
+        {
+            int index = iter.second->GetTransformIndex();
+            if (index >= 0)
+            {
+                m_spatialTree.DestroyProxy(m_transforms[index].proxy);
+                m_transforms[index].node = nullptr;
+                iter.second->SetTransformIndex(-1);
+                m_compactTransforms = true;
+            }
+            this->RemoveTransforms(iter.second->GetChildren());
+        }
+    }
+
+    void SceneManager::QueryBoxes(const std::vector<AABB> & boxes, std::vector<std::vector<EntityHandle> > & results, EntityTagMask exclude)
+    {
+        // refit anything that moved since the last pass, so results are not a frame behind
+        this->RefreshTransforms();
+
+        // parked entities are kept out of every query
+        exclude |= ET_POOLED;
+
+        results.resize(boxes.size());
+        for (size_t i = 0; i < boxes.size(); ++i)
+        {
+            const AABB & box = boxes[i];
+            std::vector<EntityHandle> & result = results[i];
+            result.clear();
+
+            // the tree reports fat bounds, so check the nodes actual bounds as well
+            m_spatialTree.Query(box, [&box, &result, exclude](SceneNode * node)
+            {
+                if ((node->GetTags() & exclude) == 0 && node->GetWorldBounds().Overlaps(box))
+                {
+                    result.push_back(node->GetEntityHandle());
+                }
+            });
+
+            // an entity with several nodes in the box should only be listed once
+            std::sort(result.begin(), result.end());
+            result.erase(std::unique(result.begin(), result.end()), result.end());
+        }
+    }
+
+    void SceneManager::QuerySpheres(const std::vector<Sphere> & spheres, std::vector<std::vector<EntityHandle> > & results, EntityTagMask exclude)
+    {
+        this->RefreshTransforms();
+
+        // parked entities are kept out of every query
+        exclude |= ET_POOLED;
+
+        results.resize(spheres.size());
+        for (size_t i = 0; i < spheres.size(); ++i)
+        {
+            const Sphere & sphere = spheres[i];
+            std::vector<EntityHandle> & result = results[i];
+            result.clear();
+
+            m_spatialTree.Query(sphere.center, sphere.radius, [&sphere, &result, exclude](SceneNode * node)
+            {
+                if ((node->GetTags() & exclude) == 0 && node->GetWorldBounds().Overlaps(sphere.center, sphere.radius))
+                {
+                    result.push_back(node->GetEntityHandle());
+                }
+            });
+
+            std::sort(result.begin(), result.end());
+            result.erase(std::unique(result.begin(), result.end()), result.end());
+        }
+    }
+
+    void SceneManager::Raycast(const std::vector<Ray> & rays, std::vector<std::vector<RaycastHit> > & results, EntityTagMask exclude)
+    {
+        this->RefreshTransforms();
+
+        // parked entities are kept out of every query
+        exclude |= ET_POOLED;
+
+        const float inf = std::numeric_limits<float>::infinity();
+
+        results.resize(rays.size());
+        for (size_t i = 0; i < rays.size(); ++i)
+        {
+            const Ray & ray = rays[i];
+            std::vector<RaycastHit> & result = results[i];
+            result.clear();
+
+            Vector3 inv(ray.direction.x != 0.f ? 1.f / ray.direction.x : inf,
+                        ray.direction.y != 0.f ? 1.f / ray.direction.y : inf,
+                        ray.direction.z != 0.f ? 1.f / ray.direction.z : inf);
+
+            m_spatialTree.Raycast(ray.origin, ray.direction, ray.maxDistance, [&ray, &inv, &result, exclude](SceneNode * node, float /*fatDistance*/)
+            {
+                float distance = 0.f;
+                if ((node->GetTags() & exclude) == 0 && node->GetWorldBounds().Raycast(ray.origin, inv, ray.maxDistance, &distance))
+                {
+                    RaycastHit hit = { node->GetEntityHandle(), distance };
+                    result.push_back(hit);
+                }
+            });
+
+            // nearest first, and only the nearest hit for each entity
+            std::sort(result.begin(), result.end(), [](const RaycastHit & a, const RaycastHit & b)
+            {
+                return a.entity < b.entity || (a.entity == b.entity && a.distance < b.distance);
+            });
+            result.erase(std::unique(result.begin(), result.end(), [](const RaycastHit & a, const RaycastHit & b) { return a.entity == b.entity; }), result.end());
+            std::sort(result.begin(), result.end(), [](const RaycastHit & a, const RaycastHit & b) { return a.distance < b.distance; });
         }
     }
 }
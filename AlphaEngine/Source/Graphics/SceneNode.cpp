@@ -21,6 +21,8 @@ limitations under the License.
 #include "Graphics/Model.h"
 #include "Graphics/ModelFile.h"
 #include "Graphics/Light.h"
+#include "Graphics/ParticleEmitter.h"
+#include "Animation/SkeletonAnimator.h"
 #include "Assets/Asset.h"
 #include "Entities/EntityComponent.h"
 #include "Math/Matrix.h"
@@ -31,9 +33,14 @@ namespace alpha
 {
     SceneNode::SceneNode(SceneNode * pParent, std::shared_ptr<SceneComponent> component)
         : m_parent(pParent)
+        , m_tags(ET_NONE)
+        , m_transformIndex(-1)
+        , m_visiblePass(0)
         , m_pSceneComponent(component)
         , m_pRenderSet(nullptr)
         , m_pLight(nullptr)
+        , m_pParticleEmitter(nullptr)
+        , m_pSkeletonAnimator(nullptr)
         , m_pMaterial(nullptr)
     { }
     SceneNode::~SceneNode()
@@ -43,6 +50,11 @@ namespace alpha
         {
             delete pair.second;
         }
+        // the animator poses the render set, so it goes first
+        if (m_pSkeletonAnimator != nullptr)
+        {
+            delete m_pSkeletonAnimator;
+        }
         // destroy render data, so all gpu resources are released
         if (m_pRenderSet) { delete m_pRenderSet; }
 
@@ -51,6 +63,10 @@ namespace alpha
         {
             delete m_pLight;
         }
+        if (m_pParticleEmitter != nullptr)
+        {
+            delete m_pParticleEmitter;
+        }
     }
 
     void SceneNode::SetParent(SceneNode * pParent)
@@ -79,13 +95,78 @@ namespace alpha
         return this->m_children;
     }
 
-    Matrix SceneNode::GetWorldTransform() const
+    std::shared_ptr<SceneComponent> SceneNode::GetSceneComponent() const
     {
-        if (m_parent != nullptr)
+        return m_pSceneComponent;
+    }
+
+    const Matrix & SceneNode::GetWorldTransform() const
+    {
+        return m_world;
+    }
+
+    void SceneNode::SetWorldTransform(const Matrix & world)
+    {
+        m_world = world;
+    }
+
+    const AABB & SceneNode::GetWorldBounds() const
+    {
+        return m_worldBounds;
+    }
+
+    void SceneNode::SetWorldBounds(const AABB & bounds)
+    {
+        m_worldBounds = bounds;
+    }
+
+    AABB SceneNode::GetLocalBounds()
+    {
+        if (m_pRenderSet != nullptr)
         {
-            return m_pSceneComponent->GetTransform() * m_parent->GetWorldTransform();
+            return m_pRenderSet->bounds;
         }
-        return m_pSceneComponent->GetTransform();
+        return AABB();
+    }
+
+    EntityHandle SceneNode::GetEntityHandle() const
+    {
+        return m_entity;
+    }
+
+    void SceneNode::SetEntityHandle(const EntityHandle & handle)
+    {
+        m_entity = handle;
+    }
+
+    EntityTagMask SceneNode::GetTags() const
+    {
+        return m_tags;
+    }
+
+    void SceneNode::SetTags(EntityTagMask tags)
+    {
+        m_tags = tags;
+    }
+
+    int SceneNode::GetTransformIndex() const
+    {
+        return m_transformIndex;
+    }
+
+    void SceneNode::SetTransformIndex(int index)
+    {
+        m_transformIndex = index;
+    }
+
+    unsigned int SceneNode::GetVisiblePass() const
+    {
+        return m_visiblePass;
+    }
+
+    void SceneNode::SetVisiblePass(unsigned int pass)
+    {
+        m_visiblePass = pass;
     }
 
     void SceneNode::SetMesh(std::shared_ptr<Asset> pAsset)
@@ -110,9 +191,35 @@ namespace alpha
         return m_pLight;
     }
 
-    void SceneNode::SetMaterial(std::shared_ptr<Material> pMaterial)
+    void SceneNode::SetParticleEmitter(ParticleEmitter * pEmitter)
+    {
+        m_pParticleEmitter = pEmitter;
+    }
+
+    ParticleEmitter * SceneNode::GetParticleEmitter() const
+    {
+        return m_pParticleEmitter;
+    }
+
+    void SceneNode::SetSkeletonAnimator(SkeletonAnimator * pAnimator)
+    {
+        m_pSkeletonAnimator = pAnimator;
+    }
+
+    SkeletonAnimator * SceneNode::GetSkeletonAnimator() const
+    {
+        return m_pSkeletonAnimator;
+    }
+
+    void SceneNode::SetMaterial(std::shared_ptr<Material> pMaterial, const std::string & path)
     {
         m_pMaterial = pMaterial;
+        m_sMaterialPath = path;
+    }
+
+    const std::string & SceneNode::GetMaterialPath() const
+    {
+        return m_sMaterialPath;
     }
 
     std::weak_ptr<Material> SceneNode::GetMaterial() const
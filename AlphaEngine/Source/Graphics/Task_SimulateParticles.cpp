@@ -0,0 +1,32 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "Graphics/Task_SimulateParticles.h"
+#include "Graphics/ParticleEmitter.h"
+
+namespace alpha
+{
+    Task_SimulateParticles::Task_SimulateParticles(ParticleEmitter * pEmitter, float fElapsedTime)
+        : m_pEmitter(pEmitter)
+        , m_fElapsedTime(fElapsedTime)
+    { }
+
+    bool Task_SimulateParticles::VExecute()
+    {
+        m_pEmitter->Simulate(m_fElapsedTime);
+        return true;
+    }
+}
@@ -0,0 +1,140 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+
+#include "Logic/GameSystem.h"
+#include "Entities/Entity.h"
+#include "Entities/EntityQuery.h"
+
+namespace alpha
+{
+    namespace
+    {
+        /** Do two sorted lists share any value */
+        bool Intersects(const std::vector<unsigned int> & a, const std::vector<unsigned int> & b)
+        {
+            auto left = a.begin();
+            auto right = b.begin();
+            while (left != a.end() && right != b.end())
+            {
+                if (*left == *right)
+                {
+                    return true;
+                }
+                if (*left < *right)
+                {
+                    ++left;
+                }
+                else
+                {
+                    ++right;
+                }
+            }
+            return false;
+        }
+
+        std::vector<unsigned int> ToSortedIDs(const std::vector<std::string> & names)
+        {
+            std::vector<unsigned int> ids;
+            ids.reserve(names.size());
+            for (auto & name : names)
+            {
+                ids.push_back(EntityComponent::GetIDFromName(name));
+            }
+            std::sort(ids.begin(), ids.end());
+            ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+            return ids;
+        }
+    }
+
+    SystemView::SystemView(const EntityQuery & query, EntityTagMask exclude)
+        : m_typeIds(query.GetTypeIDs())
+    {
+        const size_t columns = m_typeIds.size();
+        const std::vector<EntityComponent *> & rows = query.GetComponentRows();
+
+        m_entities.reserve(query.Size());
+        m_components.reserve(rows.size());
+        for (size_t i = 0; i < query.Size(); ++i)
+        {
+            const std::shared_ptr<Entity> & entity = query.GetEntities()[i];
+            if (entity->HasAnyTag(exclude))
+            {
+                continue;
+            }
+            m_entities.push_back(entity);
+            m_components.insert(m_components.end(), rows.begin() + i * columns, rows.begin() + (i + 1) * columns);
+        }
+    }
+
+    size_t SystemView::Size() const
+    {
+        return m_entities.size();
+    }
+
+    bool SystemView::Empty() const
+    {
+        return m_entities.empty();
+    }
+
+    Entity * SystemView::GetEntity(size_t index) const
+    {
+        return m_entities[index].get();
+    }
+
+    AGameSystem::AGameSystem(const std::vector<std::string> & reads, const std::vector<std::string> & writes, size_t batchSize)
+        : m_writeIds(ToSortedIDs(writes))
+        , m_batchSize(batchSize)
+    {
+        // a type that is both read and written only counts as written
+        for (unsigned int id : ToSortedIDs(reads))
+        {
+            if (!std::binary_search(m_writeIds.begin(), m_writeIds.end(), id))
+            {
+                m_readIds.push_back(id);
+            }
+        }
+
+        m_typeNames = reads;
+        for (auto & name : writes)
+        {
+            if (std::find(m_typeNames.begin(), m_typeNames.end(), name) == m_typeNames.end())
+            {
+                m_typeNames.push_back(name);
+            }
+        }
+    }
+    AGameSystem::~AGameSystem() { }
+
+    const std::vector<std::string> & AGameSystem::GetTypeNames() const
+    {
+        return m_typeNames;
+    }
+
+    size_t AGameSystem::GetBatchSize() const
+    {
+        return m_batchSize;
+    }
+
+    bool AGameSystem::ConflictsWith(const AGameSystem & other) const
+    {
+        // readers can share data, anything written has to be touched by one system at a time
+        return Intersects(m_writeIds, other.m_writeIds)
+            || Intersects(m_writeIds, other.m_readIds)
+            || Intersects(m_readIds, other.m_writeIds);
+    }
+}
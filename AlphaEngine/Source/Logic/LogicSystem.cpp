@@ -14,11 +14,25 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <algorithm>
+#include <fstream>
+#include <thread>
+
 #include "Logic/LogicSystem.h"
 #include "Logic/LogicSystemEvents.h"
-#include "Logic/Task_UpdateEntity.h"
+#include "Logic/GameSystem.h"
+#include "Logic/Task_CreateEntities.h"
+#include "Logic/Task_LoadWorldCell.h"
+#include "Logic/Task_UpdateEntities.h"
+#include "Logic/WorldFile.h"
 #include "Entities/EntityFactory.h"
 #include "Entities/Entity.h"
+#include "Entities/EntityQuery.h"
+#include "Entities/EntityScript.h"
+#include "Entities/CameraComponent.h"
+#include "Entities/ColliderComponent.h"
+#include "Collision/CollisionEvents.h"
+#include "Collision/Task_Broadphase.h"
 #include "Toolbox/Logger.h"
 #include "Assets/AssetSystem.h"
 #include "FSA/StateMachine.h"
@@ -27,15 +41,36 @@ limitations under the License.
 #include "HID/HIDSystemEvents.h"
 #include "Audio/AudioSystem.h"
 #include "Audio/Sound.h"
+#include "Graphics/GraphicsSystem.h"
+#include "Graphics/SceneManager.h"
+#include "Math/AABB.h"
+#include "Math/Ray.h"
+#include "Threading/TaskGroup.h"
 #include "Threading/ThreadSystemEvents.h"
 
 namespace alpha
 {
+    const double LogicSystem::sk_targetBatchSeconds = 0.0002;
+    const size_t LogicSystem::sk_minBatchSize = 8;
+    const unsigned int LogicSystem::sk_maxCellLoads = 2;
+
     LogicSystem::LogicSystem()
         : AlphaSystem(60)
         , m_pEntityFactory(nullptr)
+        , m_spawnCommitBudget(64)
+        , m_lastUpdateTime(0.0)
+        , m_updateExclude(ET_DISABLED | ET_POOLED)
+        , m_updateBatchSize(0)
+        , m_entityUpdateCost(0.0)
+        , m_reportedUpdateNanoseconds(0)
+        , m_reportedUpdateCount(0)
+        , m_worldPartition(64.f, 1)
+        , m_cellLoads(0)
+        , m_streamCommitBudget(64)
+        , m_streamUnloadBudget(64)
         , m_pAssets(nullptr)
         , m_pAudio(nullptr)
+        , m_pGraphics(nullptr)
         , m_pHIDContextManager(nullptr)
     { }
     LogicSystem::~LogicSystem() { }
@@ -51,6 +86,26 @@ namespace alpha
 
         // register event handlers
         this->AddEventHandler(AEvent::GetIDFromName(Event_HIDKeyAction::sk_name), [this](AEvent * pEvent) { this->HandleHIDKeyActionEvent(pEvent); });
+        this->AddEventHandler(AEvent::GetIDFromName(Event_ContactsBegan::sk_name), [this](AEvent * pEvent)
+        {
+            auto pContacts = dynamic_cast<Event_ContactsBegan *>(pEvent);
+            if (pContacts && m_delContactsBegan)
+            {
+                m_delContactsBegan(pContacts->GetContacts());
+            }
+        });
+        this->AddEventHandler(AEvent::GetIDFromName(Event_ContactsEnded::sk_name), [this](AEvent * pEvent)
+        {
+            auto pContacts = dynamic_cast<Event_ContactsEnded *>(pEvent);
+            if (pContacts && m_delContactsEnded)
+            {
+                m_delContactsEnded(pContacts->GetContacts());
+            }
+        });
+
+        // colliders are tracked like any other query, so gathering bounds is a walk over an array
+        m_colliders = this->Query({ ColliderComponent::sk_name });
+        m_pBroadphase = std::make_shared<BroadphaseState>();
 
         // setup context manager
         m_pHIDContextManager = new HIDContextManager();
@@ -60,7 +115,26 @@ namespace alpha
 
     bool LogicSystem::VShutdown()
     {
-        m_entities.clear();
+        // the thread pool has already stopped, so anything left of the last tick runs here
+        this->VFinishTasks();
+
+        // entities may outlive the logic system, so stop them from waking it
+        for (auto & entity : m_entities)
+        {
+            entity->SetWakeListener(nullptr);
+        }
+        m_entities.Clear();
+        m_queries.clear();
+        m_colliders.reset();
+        m_animator.Clear();
+        m_gameSystems.Clear();
+        m_activeEntities.clear();
+        m_wakeTimers.clear();
+        m_pendingDestroy.clear();
+        m_pools.clear();
+        m_committingSpawns.clear();
+        m_committingCells.clear();
+        m_streamUnloads.clear();
 
         if (m_pEntityFactory)
         {
@@ -74,15 +148,286 @@ namespace alpha
         float current_time = static_cast<float>(fCurrentTime);
         float elapsed_time = static_cast<float>(fElapsedTime);
 
-        for (auto key_value : m_entities)
+        m_lastUpdateTime = fCurrentTime;
+
+        // destroy requested entities before gathering this ticks updates. the last ticks update tasks
+        // were finished before this update started, so nothing is freed out from under them.
+        this->DestroyPendingEntities();
+
+        // add entities built on worker threads since the last tick, they wake and are updated this tick
+        this->CommitSpawnedEntities();
+
+        // stream world cells in and out, newly committed entities wake and are updated this tick
+        this->UpdateStreaming();
+
+        // the last ticks animation, update tasks, and game systems were finished before this update started,
+        // so nothing else is moving colliders while their bounds are gathered
+        this->UpdateCollision();
+
+        // animate transforms in parallel, animated entities wake and are journaled with the next batch
+        m_pAnimationGroup = m_animator.Update(elapsed_time, [this](AEvent * pEvent) { this->PublishEvent(pEvent); });
+
+        // run game systems over a snapshot of their views, alongside this ticks entity updates.
+        // like the entity updates they wait for the animation, which writes the same transforms.
+        m_gameSystems.Update(fCurrentTime, elapsed_time, m_updateExclude, [this](AEvent * pEvent) { this->PublishEvent(pEvent); },
+                             m_pAnimationGroup);
+
+        // fire any wake timers that have come due
+        auto timer_end = m_wakeTimers.upper_bound(fCurrentTime);
+        for (auto it = m_wakeTimers.begin(); it != timer_end; ++it)
         {
-            auto pTask = new Task_UpdateEntity(current_time, elapsed_time, key_value.second, [this](AEvent * pEvent) { this->PublishEvent(pEvent); });
-            this->PublishEvent(new Event_NewThreadTask(pTask));
+            this->WakeEntity(it->second);
         }
+        m_wakeTimers.erase(m_wakeTimers.begin(), timer_end);
+
+        // gather every entity that needs an update this tick, starting with entities that always need ticking.
+        // the slot map owns them until the update tasks are finished, so the tasks only take pointers.
+        auto entities = std::make_shared<std::vector<Entity *> >();
+        entities->reserve(m_activeEntities.size());
+        for (auto & handle : m_activeEntities)
+        {
+            auto entity = m_entities.Get(handle);
+            if (entity != nullptr && !(*entity)->HasAnyTag(m_updateExclude))
+            {
+                entities->push_back(entity->get());
+            }
+        }
+
+        // then any sleeping entity that has been woken since the last tick.
+        // an entity is only queued once per wake, so there are no duplicates to filter.
+        EntityHandle handle;
+        while (m_wokenEntities.TryPop(handle))
+        {
+            auto entity = m_entities.Get(handle);
+            if (entity != nullptr && !(*entity)->RequiresUpdate() && !(*entity)->HasAnyTag(m_updateExclude))
+            {
+                entities->push_back(entity->get());
+            }
+        }
+
+        this->ScheduleUpdates(entities, current_time, elapsed_time);
 
         return true;
     }
 
+    void LogicSystem::ScheduleUpdates(std::shared_ptr<const std::vector<Entity *> > entities, float fCurrentTime, float fElapsedTime)
+    {
+        const size_t count = entities->size();
+        if (count == 0)
+        {
+            return;
+        }
+
+        auto publish = [this](AEvent * pEvent) { this->PublishEvent(pEvent); };
+        auto report = [this](size_t updated, double seconds)
+        {
+            m_reportedUpdateNanoseconds += static_cast<unsigned long long>(seconds * 1000000000.0);
+            m_reportedUpdateCount += updated;
+        };
+
+        // every task updates a contiguous range of the shared entity list
+        const size_t batch_size = this->GetUpdateBatchSize(count);
+        std::vector<ATask *> tasks;
+        tasks.reserve((count + batch_size - 1) / batch_size);
+        for (size_t begin = 0; begin < count; begin += batch_size)
+        {
+            size_t end = std::min(begin + batch_size, count);
+            tasks.push_back(new Task_UpdateEntities(fCurrentTime, fElapsedTime, entities, begin, end, publish, report));
+        }
+        m_pUpdateGroup = TaskGroup::Publish(std::move(tasks), publish, m_pAnimationGroup);
+    }
+
+    void LogicSystem::VFinishTasks()
+    {
+        // tasks reach the thread pool a frame after they are published, so waiting helps run them here
+        if (m_pAnimationGroup != nullptr)
+        {
+            m_pAnimationGroup->Wait();
+            m_pAnimationGroup.reset();
+        }
+        if (m_pUpdateGroup != nullptr)
+        {
+            m_pUpdateGroup->Wait();
+            m_pUpdateGroup.reset();
+        }
+        m_gameSystems.Finish();
+    }
+
+    size_t LogicSystem::GetUpdateBatchSize(size_t entityCount)
+    {
+        if (m_updateBatchSize > 0)
+        {
+            return m_updateBatchSize;
+        }
+
+        // fold the cost reported by last ticks tasks into the running average
+        unsigned long long nanoseconds = m_reportedUpdateNanoseconds.exchange(0);
+        unsigned long long updated = m_reportedUpdateCount.exchange(0);
+        if (updated > 0)
+        {
+            double cost = (static_cast<double>(nanoseconds) / 1000000000.0) / static_cast<double>(updated);
+            m_entityUpdateCost = (m_entityUpdateCost > 0.0) ? (m_entityUpdateCost * 0.9 + cost * 0.1) : cost;
+        }
+
+        // size batches so each task does a worthwhile amount of work ...
+        size_t batch_size = entityCount;
+        if (m_entityUpdateCost > 0.0)
+        {
+            batch_size = std::max(sk_minBatchSize, static_cast<size_t>(sk_targetBatchSeconds / m_entityUpdateCost));
+        }
+
+        // ... but never so large that some hardware threads are left without work.
+        size_t threads = std::max(1u, std::thread::hardware_concurrency());
+        size_t per_thread = (entityCount + threads - 1) / threads;
+        return std::max(static_cast<size_t>(1), std::min(batch_size, per_thread));
+    }
+
+    void LogicSystem::AddWorldCell(int x, int z, const char * resource)
+    {
+        m_worldPartition.AddCell(x, z, resource);
+    }
+
+    void LogicSystem::SetWorldCellSize(float cellSize)
+    {
+        m_worldPartition.SetCellSize(cellSize);
+    }
+
+    void LogicSystem::SetWorldLoadRadius(unsigned int loadRadius)
+    {
+        m_worldPartition.SetLoadRadius(loadRadius);
+    }
+
+    void LogicSystem::SetStreamingBudgets(unsigned int commitBudget, unsigned int unloadBudget)
+    {
+        m_streamCommitBudget = std::max(1u, commitBudget);
+        m_streamUnloadBudget = std::max(1u, unloadBudget);
+    }
+
+    void LogicSystem::SetStreamingFocus(const Vector3 & focus)
+    {
+        m_vStreamingFocus = focus;
+    }
+
+    void LogicSystem::SetStreamingCamera(std::weak_ptr<CameraComponent> pCameraComponent)
+    {
+        m_pStreamingCamera = pCameraComponent;
+    }
+
+    void LogicSystem::UpdateStreaming()
+    {
+        if (m_worldPartition.Empty())
+        {
+            return;
+        }
+
+        if (auto pCamera = m_pStreamingCamera.lock())
+        {
+            m_vStreamingFocus = pCamera->GetPosition();
+        }
+
+        std::vector<WorldCell *> to_load;
+        std::vector<WorldCell *> to_unload;
+        m_worldPartition.UpdateFocus(m_vStreamingFocus, to_load, to_unload);
+
+        // 1. cells that moved out of range hand their entities over to the unload queue,
+        // anything not yet committed is simply dropped.
+        for (auto pCell : to_unload)
+        {
+            if (pCell->state == WCS_COMMITTING)
+            {
+                m_committingCells.erase(std::remove(m_committingCells.begin(), m_committingCells.end(), pCell->coord), m_committingCells.end());
+            }
+            m_streamUnloads.insert(m_streamUnloads.end(), pCell->entities.begin(), pCell->entities.end());
+            pCell->entities.clear();
+            pCell->pending.clear();
+            pCell->committed = 0;
+            pCell->state = WCS_UNLOADED;
+        }
+
+        // 2. start loading the nearest cells, the asset lookup happens here since the asset system
+        // is not thread safe, the read and entity creation happen on a worker thread.
+        auto complete = [this](WorldCellCoord coord, std::vector<std::shared_ptr<Entity> > entities)
+        {
+            LoadedWorldCell loaded = { coord, std::move(entities) };
+            m_loadedCells.Push(loaded);
+        };
+        for (auto pCell : to_load)
+        {
+            if (m_cellLoads >= sk_maxCellLoads || m_pAssets == nullptr)
+            {
+                break;
+            }
+
+            auto asset = m_pAssets->GetAsset(pCell->resource.c_str());
+            if (asset == nullptr)
+            {
+                // treat a missing cell as an empty one, so it is not requested again every update
+                LOG_WARN("LogicSystem > World cell resource not found: ", pCell->resource);
+                pCell->state = WCS_LOADED;
+                continue;
+            }
+
+            pCell->state = WCS_LOADING;
+            ++m_cellLoads;
+            this->PublishEvent(new Event_NewThreadTask(new Task_LoadWorldCell(pCell->coord, asset, m_pEntityFactory, complete)));
+        }
+
+        // 3. pick up finished loads, cells that went out of range while loading are discarded
+        LoadedWorldCell loaded;
+        while (m_loadedCells.TryPop(loaded))
+        {
+            --m_cellLoads;
+            WorldCell * pCell = m_worldPartition.GetCell(loaded.coord);
+            if (pCell == nullptr || pCell->state != WCS_LOADING)
+            {
+                continue;
+            }
+            if (!pCell->wanted)
+            {
+                pCell->state = WCS_UNLOADED;
+                continue;
+            }
+
+            pCell->state = WCS_COMMITTING;
+            pCell->pending = std::move(loaded.entities);
+            pCell->committed = 0;
+            m_committingCells.push_back(pCell->coord);
+        }
+
+        // 4. add loaded entities to the world, oldest cell first, within the commit budget
+        unsigned int budget = m_streamCommitBudget;
+        size_t finished = 0;
+        for (; finished < m_committingCells.size() && budget > 0; ++finished)
+        {
+            WorldCell * pCell = m_worldPartition.GetCell(m_committingCells[finished]);
+            while (pCell->committed < pCell->pending.size() && budget > 0)
+            {
+                auto & entity = pCell->pending[pCell->committed++];
+                this->AddEntity(entity);
+                pCell->entities.push_back(entity->GetHandle());
+                this->PublishEvent(new Event_EntityCreated(entity));
+                --budget;
+            }
+
+            if (pCell->committed < pCell->pending.size())
+            {
+                break;
+            }
+            pCell->pending = std::vector<std::shared_ptr<Entity> >();
+            pCell->committed = 0;
+            pCell->state = WCS_LOADED;
+        }
+        m_committingCells.erase(m_committingCells.begin(), m_committingCells.begin() + finished);
+
+        // 5. destroy unloaded entities, within the unload budget
+        size_t unload_count = std::min(m_streamUnloads.size(), static_cast<size_t>(m_streamUnloadBudget));
+        for (size_t i = 0; i < unload_count; ++i)
+        {
+            this->DestroyEntity(m_streamUnloads[i]);
+        }
+        m_streamUnloads.erase(m_streamUnloads.begin(), m_streamUnloads.begin() + unload_count);
+    }
+
     void LogicSystem::SetAssetSystem(AssetSystem * const pAssets)
     {
         m_pAssets = pAssets;
@@ -93,14 +438,16 @@ namespace alpha
         m_pAudio = pAudio;
     }
 
-    std::shared_ptr<Entity> LogicSystem::GetEntity(const unsigned long entityId)
+    void LogicSystem::SetGraphicsSystem(GraphicsSystem * const pGraphics)
     {
-        auto it = m_entities.find(entityId);
-        if (it != m_entities.end())
-        {
-            return it->second;
-        }
-        return std::shared_ptr<Entity>();
+        m_pGraphics = pGraphics;
+    }
+
+    Entity * LogicSystem::GetEntity(const EntityHandle & handle)
+    {
+        // parked entities are not handed out until they are recycled
+        auto entity = m_entities.Get(handle);
+        return (entity != nullptr && !(*entity)->HasAnyTag(ET_POOLED)) ? entity->get() : nullptr;
     }
 
     std::shared_ptr<Entity> LogicSystem::CreateEntity(const char * resource)
@@ -113,8 +460,15 @@ namespace alpha
             auto asset = m_pAssets->GetAsset(resource);
             if (asset != nullptr)
             {
+                // a recycled entity is already known to every system, it was only hidden
+                new_entity = this->TakeFromPool(asset);
+                if (new_entity != nullptr)
+                {
+                    return new_entity;
+                }
+
                 new_entity = m_pEntityFactory->CreateEntity(asset);
-                m_entities[new_entity->GetId()] = new_entity;
+                this->AddEntity(new_entity);
             }
         }
 
@@ -124,9 +478,499 @@ namespace alpha
         return new_entity;
     }
 
-    void LogicSystem::DestroyEntity(const unsigned long entityId)
+    std::vector<std::shared_ptr<Entity> > LogicSystem::CreateEntities(const char * resource, unsigned int count)
     {
-        m_entities.erase(m_entities.find(entityId));
+        std::vector<std::shared_ptr<Entity> > new_entities;
+        size_t recycled = 0;
+
+        if (m_pAssets != nullptr)
+        {
+            auto asset = m_pAssets->GetAsset(resource);
+            if (asset != nullptr)
+            {
+                // recycle parked entities first ...
+                new_entities.reserve(count);
+                while (new_entities.size() < count)
+                {
+                    auto entity = this->TakeFromPool(asset);
+                    if (entity == nullptr)
+                    {
+                        break;
+                    }
+                    new_entities.push_back(entity);
+                }
+                recycled = new_entities.size();
+
+                // ... then batch create the rest from a single run of the script resource
+                auto created = m_pEntityFactory->CreateEntities(asset, count - static_cast<unsigned int>(recycled));
+                new_entities.insert(new_entities.end(), created.begin(), created.end());
+            }
+        }
+
+        for (size_t i = recycled; i < new_entities.size(); ++i)
+        {
+            this->AddEntity(new_entities[i]);
+            this->PublishEvent(new Event_EntityCreated(new_entities[i]));
+        }
+
+        return new_entities;
+    }
+
+    std::shared_future<std::shared_ptr<Entity> > LogicSystem::CreateEntityAsync(const char * resource)
+    {
+        auto promise = std::make_shared<std::promise<std::shared_ptr<Entity> > >();
+        std::shared_future<std::shared_ptr<Entity> > future = promise->get_future().share();
+
+        this->SpawnAsync(resource, 1, [promise](const std::vector<std::shared_ptr<Entity> > & entities)
+        {
+            promise->set_value(entities.empty() ? nullptr : entities[0]);
+        });
+        return future;
+    }
+
+    std::shared_future<std::vector<std::shared_ptr<Entity> > > LogicSystem::CreateEntitiesAsync(const char * resource, unsigned int count)
+    {
+        auto promise = std::make_shared<std::promise<std::vector<std::shared_ptr<Entity> > > >();
+        std::shared_future<std::vector<std::shared_ptr<Entity> > > future = promise->get_future().share();
+
+        this->SpawnAsync(resource, count, [promise](const std::vector<std::shared_ptr<Entity> > & entities)
+        {
+            promise->set_value(entities);
+        });
+        return future;
+    }
+
+    void LogicSystem::SetSpawnCommitBudget(unsigned int budget)
+    {
+        m_spawnCommitBudget = std::max(1u, budget);
+    }
+
+    void LogicSystem::SpawnAsync(const char * resource, unsigned int count, std::function<void(const std::vector<std::shared_ptr<Entity> > &)> delComplete)
+    {
+        // the asset lookup happens here since the asset system is not thread safe
+        auto asset = m_pAssets != nullptr ? m_pAssets->GetAsset(resource) : nullptr;
+        if (asset == nullptr)
+        {
+            LOG_WARN("LogicSystem > Unable to spawn entities, resource not found: ", resource);
+            delComplete(std::vector<std::shared_ptr<Entity> >());
+            return;
+        }
+
+        // parked entities need no building, so they are handed out straight away
+        std::vector<std::shared_ptr<Entity> > recycled;
+        while (recycled.size() < count)
+        {
+            auto entity = this->TakeFromPool(asset);
+            if (entity == nullptr)
+            {
+                break;
+            }
+            recycled.push_back(entity);
+        }
+        if (recycled.size() == count)
+        {
+            delComplete(recycled);
+            return;
+        }
+
+        // build the rest on a worker thread, the request finishes once they have all been committed
+        auto complete = [this, recycled, delComplete](std::vector<std::shared_ptr<Entity> > entities)
+        {
+            SpawnedEntities spawned;
+            spawned.entities = recycled;
+            spawned.entities.insert(spawned.entities.end(), entities.begin(), entities.end());
+            spawned.committed = recycled.size();
+            spawned.delComplete = delComplete;
+            m_spawned.Push(spawned);
+        };
+        unsigned int remaining = count - static_cast<unsigned int>(recycled.size());
+        this->PublishEvent(new Event_NewThreadTask(new Task_CreateEntities(asset, remaining, m_pEntityFactory, complete)));
+    }
+
+    void LogicSystem::CommitSpawnedEntities()
+    {
+        SpawnedEntities spawned;
+        while (m_spawned.TryPop(spawned))
+        {
+            m_committingSpawns.push_back(std::move(spawned));
+        }
+
+        // add built entities to the world, oldest request first, within the commit budget
+        unsigned int budget = m_spawnCommitBudget;
+        size_t finished = 0;
+        for (; finished < m_committingSpawns.size() && budget > 0; ++finished)
+        {
+            SpawnedEntities & request = m_committingSpawns[finished];
+            while (request.committed < request.entities.size() && budget > 0)
+            {
+                auto & entity = request.entities[request.committed++];
+                this->AddEntity(entity);
+                this->PublishEvent(new Event_EntityCreated(entity));
+                --budget;
+            }
+
+            if (request.committed < request.entities.size())
+            {
+                break;
+            }
+            request.delComplete(request.entities);
+        }
+        m_committingSpawns.erase(m_committingSpawns.begin(), m_committingSpawns.begin() + finished);
+    }
+
+    bool LogicSystem::SaveSnapshot(const char * path)
+    {
+        std::ofstream stream(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!stream.is_open())
+        {
+            LOG_ERR("LogicSystem > Unable to open world snapshot for writing: ", path);
+            return false;
+        }
+
+        std::vector<std::shared_ptr<Entity> > entities;
+        entities.reserve(m_entities.Size());
+        for (auto & entity : m_entities)
+        {
+            if (!entity->HasAnyTag(ET_POOLED))
+            {
+                entities.push_back(entity);
+            }
+        }
+        SerializeWorld(entities, stream);
+        return stream.good();
+    }
+
+    std::vector<std::shared_ptr<Entity> > LogicSystem::LoadSnapshot(const char * resource)
+    {
+        std::vector<std::shared_ptr<Entity> > new_entities;
+
+        if (m_pAssets != nullptr)
+        {
+            auto asset = m_pAssets->GetAsset(resource);
+            if (asset != nullptr)
+            {
+                // read the file fresh, a cached copy would be stale after the snapshot is saved again
+                auto data = asset->ReadData();
+                if (!data.empty())
+                {
+                    new_entities = DeserializeWorld(reinterpret_cast<const char *>(&data[0]), data.size(), m_pEntityFactory);
+                }
+            }
+        }
+
+        for (auto entity : new_entities)
+        {
+            this->AddEntity(entity);
+            this->PublishEvent(new Event_EntityCreated(entity));
+        }
+
+        return new_entities;
+    }
+
+    void LogicSystem::DestroyEntity(const EntityHandle & handle)
+    {
+        if (m_entities.Contains(handle))
+        {
+            m_pendingDestroy.push_back(handle);
+        }
+    }
+
+    void LogicSystem::DestroyPendingEntities()
+    {
+        if (m_pendingDestroy.empty())
+        {
+            return;
+        }
+
+        std::vector<EntityHandle> destroyed;
+        destroyed.reserve(m_pendingDestroy.size());
+
+        for (auto & handle : m_pendingDestroy)
+        {
+            // the same entity may have been requested more than once, only the first request finds it
+            if (auto entity = this->GetEntity(handle))
+            {
+                // a destroyed entity can no longer be woken, updated, or queried
+                entity->SetWakeListener(nullptr);
+                m_activeEntities.erase(handle);
+                for (auto & query : m_queries)
+                {
+                    query->Remove(handle);
+                }
+
+                // a parked entity stays in the entity list, and in the scene, just hidden
+                if (this->ParkEntity(entity))
+                {
+                    continue;
+                }
+
+                this->ReleaseEntity(handle);
+                destroyed.push_back(handle);
+            }
+        }
+        m_pendingDestroy.clear();
+
+        // let every other system tear down its data for the destroyed entities in one go
+        if (!destroyed.empty())
+        {
+            this->PublishEvent(new Event_EntitiesDestroyed(std::move(destroyed)));
+        }
+    }
+
+    std::shared_ptr<const EntityQuery> LogicSystem::Query(const std::vector<std::string> & typeNames)
+    {
+        std::vector<unsigned int> type_ids;
+        type_ids.reserve(typeNames.size());
+        for (auto & name : typeNames)
+        {
+            type_ids.push_back(EntityComponent::GetIDFromName(name));
+        }
+        auto query = std::make_shared<EntityQuery>(std::move(type_ids));
+
+        // share views between callers asking for the same set of types
+        for (auto & existing : m_queries)
+        {
+            if (existing->GetTypeIDs() == query->GetTypeIDs())
+            {
+                return existing;
+            }
+        }
+
+        // a new view starts with every matching entity, and is maintained incrementally from then on
+        for (auto & entity : m_entities)
+        {
+            if (!entity->HasAnyTag(ET_POOLED))
+            {
+                query->TryAdd(entity);
+            }
+        }
+        m_queries.push_back(query);
+        return query;
+    }
+
+    void LogicSystem::SetEntityTags(const EntityHandle & handle, EntityTagMask tags)
+    {
+        // only parking an entity may pool it, a live entity tagged as pooled would be lost to saves and the pool
+        tags &= ~ET_POOLED;
+
+        if (auto entity = this->GetEntity(handle))
+        {
+            entity->SetTags(tags);
+            this->PublishEvent(new Event_EntityTagsChanged(handle, tags));
+
+            // an entity that was filtered out may have missed updates, so give it one.
+            // a filtered entity can be left flagged awake, in which case waking it again would do nothing.
+            if (entity->IsAwake())
+            {
+                m_wokenEntities.Push(handle);
+            }
+            else
+            {
+                entity->Wake();
+            }
+        }
+    }
+
+    void LogicSystem::SetUpdateFilter(EntityTagMask exclude)
+    {
+        // parked entities are never updated, whatever the game filters
+        m_updateExclude = exclude | ET_POOLED;
+    }
+
+    void LogicSystem::WakeEntity(const EntityHandle & handle)
+    {
+        if (auto entity = this->GetEntity(handle))
+        {
+            entity->Wake();
+        }
+    }
+
+    void LogicSystem::ScheduleWake(const EntityHandle & handle, double delay)
+    {
+        m_wakeTimers.insert(std::make_pair(m_lastUpdateTime + delay, handle));
+    }
+
+    void LogicSystem::SetUpdateBatchSize(unsigned int batchSize)
+    {
+        m_updateBatchSize = batchSize;
+    }
+
+    void LogicSystem::AddEntity(std::shared_ptr<Entity> entity)
+    {
+        if (entity == nullptr)
+        {
+            return;
+        }
+
+        entity->SetHandle(m_entities.Insert(entity));
+        this->ActivateEntity(entity);
+    }
+
+    void LogicSystem::ActivateEntity(const std::shared_ptr<Entity> & entity)
+    {
+        if (entity->RequiresUpdate())
+        {
+            m_activeEntities.insert(entity->GetHandle());
+        }
+
+        for (auto & query : m_queries)
+        {
+            query->TryAdd(entity);
+        }
+
+        // any wake, from any thread, queues the entity up for the next tick
+        entity->SetWakeListener([this](Entity * pEntity) { m_wokenEntities.Push(pEntity->GetHandle()); });
+
+        // every new or recycled entity gets one update, so its initial state is passed along.
+        // a recycled entity can be left flagged awake, in which case waking it again would do nothing.
+        if (entity->IsAwake())
+        {
+            m_wokenEntities.Push(entity->GetHandle());
+        }
+        else
+        {
+            entity->Wake();
+        }
+    }
+
+    void LogicSystem::SetPoolCapacity(const char * resource, unsigned int capacity)
+    {
+        auto asset = m_pAssets != nullptr ? m_pAssets->GetAsset(resource) : nullptr;
+        if (asset == nullptr)
+        {
+            LOG_WARN("LogicSystem > Unable to pool entity script, resource not found: ", resource);
+            return;
+        }
+
+        EntityPool & pool = m_pools[asset->GetPath()];
+        pool.capacity = capacity;
+        pool.parked.reserve(capacity);
+
+        // tear down anything parked beyond the new capacity
+        std::vector<EntityHandle> destroyed;
+        while (pool.parked.size() > capacity)
+        {
+            EntityHandle handle = pool.parked.back();
+            pool.parked.pop_back();
+            if (m_entities.Contains(handle))
+            {
+                this->ReleaseEntity(handle);
+                destroyed.push_back(handle);
+            }
+        }
+        if (!destroyed.empty())
+        {
+            this->PublishEvent(new Event_EntitiesDestroyed(std::move(destroyed)));
+        }
+
+        if (capacity == 0)
+        {
+            m_pools.erase(asset->GetPath());
+        }
+    }
+
+    void LogicSystem::PrewarmPool(const char * resource, unsigned int count)
+    {
+        auto asset = m_pAssets != nullptr ? m_pAssets->GetAsset(resource) : nullptr;
+        if (asset == nullptr)
+        {
+            LOG_WARN("LogicSystem > Unable to prewarm entity pool, resource not found: ", resource);
+            return;
+        }
+
+        auto search = m_pools.find(asset->GetPath());
+        if (search == m_pools.end())
+        {
+            LOG_WARN("LogicSystem > Unable to prewarm entity pool, script is not pooled: ", resource);
+            return;
+        }
+        EntityPool & pool = search->second;
+        count = std::min(count, pool.capacity - static_cast<unsigned int>(pool.parked.size()));
+
+        // prewarmed entities go straight into the pool, they are added to the scene already hidden
+        for (auto & entity : m_pEntityFactory->CreateEntities(asset, count))
+        {
+            entity->SetTags(entity->GetTags() | ET_POOLED);
+            entity->SetHandle(m_entities.Insert(entity));
+            pool.parked.push_back(entity->GetHandle());
+            this->PublishEvent(new Event_EntityCreated(entity));
+        }
+    }
+
+    bool LogicSystem::ParkEntity(Entity * pEntity)
+    {
+        auto script = pEntity->GetScript();
+        if (script == nullptr)
+        {
+            return false;
+        }
+
+        auto search = m_pools.find(script->GetPath());
+        if (search == m_pools.end() || search->second.parked.size() >= search->second.capacity)
+        {
+            return false;
+        }
+
+        // the entity could be handed out again before a track on it would have finished
+        m_animator.StopEntity(pEntity);
+
+        // handles to the destroyed entity must not resolve to whatever it is recycled as,
+        // so it is parked under a new handle, and every other system moves its data over.
+        EntityHandle old_handle = pEntity->GetHandle();
+        pEntity->SetHandle(m_entities.Reissue(old_handle));
+        pEntity->SetTags(pEntity->GetTags() | ET_POOLED);
+        this->PublishEvent(new Event_EntityHandleChanged(old_handle, pEntity->GetHandle(), pEntity->GetTags()));
+
+        search->second.parked.push_back(pEntity->GetHandle());
+        return true;
+    }
+
+    std::shared_ptr<Entity> LogicSystem::TakeFromPool(std::shared_ptr<Asset> asset)
+    {
+        auto search = m_pools.find(asset->GetPath());
+        if (search == m_pools.end())
+        {
+            return nullptr;
+        }
+
+        auto & parked = search->second.parked;
+        while (!parked.empty())
+        {
+            EntityHandle handle = parked.back();
+            parked.pop_back();
+
+            auto stored = m_entities.Get(handle);
+            if (stored == nullptr)
+            {
+                continue;
+            }
+            std::shared_ptr<Entity> entity = *stored;
+
+            // the script was reloaded while the entity was parked, so it has to be built from scratch instead
+            if (!m_pEntityFactory->ResetEntity(asset, *entity))
+            {
+                this->ReleaseEntity(handle);
+                this->PublishEvent(new Event_EntitiesDestroyed(std::vector<EntityHandle>(1, handle)));
+                continue;
+            }
+
+            // the reset replaced the pooled tag with the scripts tags, which shows the entity again
+            this->PublishEvent(new Event_EntityTagsChanged(handle, entity->GetTags()));
+            this->ActivateEntity(entity);
+            return entity;
+        }
+        return nullptr;
+    }
+
+    void LogicSystem::ReleaseEntity(const EntityHandle & handle)
+    {
+        if (auto entity = m_entities.Get(handle))
+        {
+            // a released entity can no longer be woken, or looked up
+            (*entity)->SetWakeListener(nullptr);
+            (*entity)->SetHandle(EntityHandle());
+            m_entities.Remove(handle);
+        }
     }
 
     std::weak_ptr<Sound> LogicSystem::CreateSound(const char * resource)
@@ -148,6 +992,113 @@ namespace alpha
         return new_sound;
     }
 
+    void LogicSystem::QueryBoxes(const std::vector<AABB> & boxes, std::vector<std::vector<EntityHandle> > & results, EntityTagMask exclude)
+    {
+        if (m_pGraphics != nullptr)
+        {
+            m_pGraphics->QueryBoxes(boxes, results, exclude);
+            return;
+        }
+        results.assign(boxes.size(), std::vector<EntityHandle>());
+    }
+
+    void LogicSystem::QuerySpheres(const std::vector<Sphere> & spheres, std::vector<std::vector<EntityHandle> > & results, EntityTagMask exclude)
+    {
+        if (m_pGraphics != nullptr)
+        {
+            m_pGraphics->QuerySpheres(spheres, results, exclude);
+            return;
+        }
+        results.assign(spheres.size(), std::vector<EntityHandle>());
+    }
+
+    void LogicSystem::Raycast(const std::vector<Ray> & rays, std::vector<std::vector<RaycastHit> > & results, EntityTagMask exclude)
+    {
+        if (m_pGraphics != nullptr)
+        {
+            m_pGraphics->Raycast(rays, results, exclude);
+            return;
+        }
+        results.assign(rays.size(), std::vector<RaycastHit>());
+    }
+
+    void LogicSystem::BindContactsBegan(std::function<void(const std::vector<ContactPair> &)> delegate)
+    {
+        m_delContactsBegan = delegate;
+    }
+
+    void LogicSystem::BindContactsEnded(std::function<void(const std::vector<ContactPair> &)> delegate)
+    {
+        m_delContactsEnded = delegate;
+    }
+
+    AnimationHandle LogicSystem::PlayAnimation(const ComponentHandle<SceneComponent> & target, std::shared_ptr<const AnimationTrack> track,
+                                               AnimationLoop loop, float speed)
+    {
+        return m_animator.Play(target, track, loop, speed);
+    }
+
+    void LogicSystem::StopAnimation(const AnimationHandle & handle)
+    {
+        m_animator.Stop(handle);
+    }
+
+    void LogicSystem::SetAnimationSpeed(const AnimationHandle & handle, float speed)
+    {
+        m_animator.SetSpeed(handle, speed);
+    }
+
+    bool LogicSystem::IsAnimationPlaying(const AnimationHandle & handle) const
+    {
+        return m_animator.IsPlaying(handle);
+    }
+
+    unsigned int LogicSystem::GetAnimationLoops(const AnimationHandle & handle) const
+    {
+        return m_animator.GetLoops(handle);
+    }
+
+    void LogicSystem::AddGameSystem(std::shared_ptr<AGameSystem> system)
+    {
+        m_gameSystems.Add(system, this->Query(system->GetTypeNames()));
+    }
+
+    bool LogicSystem::RemoveGameSystem(const std::shared_ptr<AGameSystem> & system)
+    {
+        return m_gameSystems.Remove(system);
+    }
+
+    void LogicSystem::UpdateCollision()
+    {
+        // a pass still running from the last tick owns the contact list, skip this tick rather than wait on it
+        if (m_colliders == nullptr || m_pBroadphase->busy)
+        {
+            return;
+        }
+
+        // nothing to test and nothing to end, no need for a task
+        if (m_colliders->Empty() && m_pBroadphase->contacts.empty())
+        {
+            return;
+        }
+
+        BroadphaseBounds bounds;
+        bounds.Reserve(m_colliders->Size());
+        for (size_t i = 0; i < m_colliders->Size(); ++i)
+        {
+            Entity * pEntity = m_colliders->GetEntity(i);
+            if (pEntity->HasAnyTag(m_updateExclude))
+            {
+                continue;
+            }
+            bounds.Add(pEntity->GetHandle(), m_colliders->Get<ColliderComponent>(i)->GetWorldBounds());
+        }
+
+        m_pBroadphase->busy = true;
+        auto publish = [this](AEvent * pEvent) { this->PublishEvent(pEvent); };
+        this->PublishEvent(new Event_NewThreadTask(new Task_Broadphase(m_pBroadphase, std::move(bounds), publish)));
+    }
+
     void LogicSystem::HandleHIDKeyActionEvent(AEvent * pEvent)
     {
         if (auto data = dynamic_cast<Event_HIDKeyAction *>(pEvent))
@@ -15,6 +15,7 @@ limitations under the License.
 */
 
 #include <memory>
+#include <vector>
 
 #include "Logic/LogicSystemEvents.h"
 #include "Entities/Entity.h"
@@ -46,25 +47,155 @@ namespace alpha
 
 
 
-    const std::string Event_EntityUpdated::sk_name = "Event_EntityUpdated";
+    const std::string Event_EntitiesUpdated::sk_name = "Event_EntitiesUpdated";
 
-    Event_EntityUpdated::Event_EntityUpdated(std::shared_ptr<Entity> pEntity)
-        : m_pEntity(pEntity)
+    Event_EntitiesUpdated::Event_EntitiesUpdated(std::vector<EntityHandle> handles, std::vector<ComponentDelta> deltas)
+        : m_handles(std::move(handles))
+        , m_deltas(std::move(deltas))
     { }
 
-    std::string Event_EntityUpdated::VGetTypeName() const
+    std::string Event_EntitiesUpdated::VGetTypeName() const
     {
-        return Event_EntityUpdated::sk_name;
+        return Event_EntitiesUpdated::sk_name;
     }
 
-    AEvent * Event_EntityUpdated::VCopy()
+    AEvent * Event_EntitiesUpdated::VCopy()
     {
-        return new Event_EntityUpdated(m_pEntity);
+        return new Event_EntitiesUpdated(m_handles, m_deltas);
     }
 
-    std::shared_ptr<Entity> Event_EntityUpdated::GetEntity() const
+    const std::vector<EntityHandle> & Event_EntitiesUpdated::GetHandles() const
     {
-        return m_pEntity;
+        return m_handles;
+    }
+
+    const std::vector<ComponentDelta> & Event_EntitiesUpdated::GetDeltas() const
+    {
+        return m_deltas;
+    }
+
+
+
+
+
+    const std::string Event_EntitiesDestroyed::sk_name = "Event_EntitiesDestroyed";
+
+    Event_EntitiesDestroyed::Event_EntitiesDestroyed(std::vector<EntityHandle> handles)
+        : m_handles(std::move(handles))
+    { }
+
+    std::string Event_EntitiesDestroyed::VGetTypeName() const
+    {
+        return Event_EntitiesDestroyed::sk_name;
+    }
+
+    AEvent * Event_EntitiesDestroyed::VCopy()
+    {
+        return new Event_EntitiesDestroyed(m_handles);
+    }
+
+    const std::vector<EntityHandle> & Event_EntitiesDestroyed::GetHandles() const
+    {
+        return m_handles;
+    }
+
+
+
+
+
+    const std::string Event_EntityTagsChanged::sk_name = "Event_EntityTagsChanged";
+
+    Event_EntityTagsChanged::Event_EntityTagsChanged(const EntityHandle & handle, EntityTagMask tags)
+        : m_handle(handle)
+        , m_tags(tags)
+    { }
+
+    std::string Event_EntityTagsChanged::VGetTypeName() const
+    {
+        return Event_EntityTagsChanged::sk_name;
+    }
+
+    AEvent * Event_EntityTagsChanged::VCopy()
+    {
+        return new Event_EntityTagsChanged(m_handle, m_tags);
+    }
+
+    EntityHandle Event_EntityTagsChanged::GetHandle() const
+    {
+        return m_handle;
+    }
+
+    EntityTagMask Event_EntityTagsChanged::GetTags() const
+    {
+        return m_tags;
+    }
+
+
+
+
+
+    const std::string Event_EntityHandleChanged::sk_name = "Event_EntityHandleChanged";
+
+    Event_EntityHandleChanged::Event_EntityHandleChanged(const EntityHandle & oldHandle, const EntityHandle & newHandle, EntityTagMask tags)
+        : m_oldHandle(oldHandle)
+        , m_newHandle(newHandle)
+        , m_tags(tags)
+    { }
+
+    std::string Event_EntityHandleChanged::VGetTypeName() const
+    {
+        return Event_EntityHandleChanged::sk_name;
+    }
+
+    AEvent * Event_EntityHandleChanged::VCopy()
+    {
+        return new Event_EntityHandleChanged(m_oldHandle, m_newHandle, m_tags);
+    }
+
+    EntityHandle Event_EntityHandleChanged::GetOldHandle() const
+    {
+        return m_oldHandle;
+    }
+
+    EntityHandle Event_EntityHandleChanged::GetNewHandle() const
+    {
+        return m_newHandle;
+    }
+
+    EntityTagMask Event_EntityHandleChanged::GetTags() const
+    {
+        return m_tags;
+    }
+
+
+
+
+
+    const std::string Event_SetRenderFilter::sk_name = "Event_SetRenderFilter";
+
+    Event_SetRenderFilter::Event_SetRenderFilter(EntityTagMask renderExclude, EntityTagMask lightExclude)
+        : m_renderExclude(renderExclude)
+        , m_lightExclude(lightExclude)
+    { }
+
+    std::string Event_SetRenderFilter::VGetTypeName() const
+    {
+        return Event_SetRenderFilter::sk_name;
+    }
+
+    AEvent * Event_SetRenderFilter::VCopy()
+    {
+        return new Event_SetRenderFilter(m_renderExclude, m_lightExclude);
+    }
+
+    EntityTagMask Event_SetRenderFilter::GetRenderExclude() const
+    {
+        return m_renderExclude;
+    }
+
+    EntityTagMask Event_SetRenderFilter::GetLightExclude() const
+    {
+        return m_lightExclude;
     }
 
 
@@ -0,0 +1,184 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+
+#include "Logic/SystemScheduler.h"
+#include "Logic/GameSystem.h"
+#include "Logic/Task_RunSystems.h"
+#include "Entities/EntityQuery.h"
+#include "Threading/ThreadSystemEvents.h"
+
+namespace alpha
+{
+    SystemScheduler::SystemScheduler()
+        : m_graphDirty(false)
+    { }
+
+    void SystemScheduler::Add(std::shared_ptr<AGameSystem> system, std::shared_ptr<const EntityQuery> query)
+    {
+        if (system == nullptr || query == nullptr)
+        {
+            return;
+        }
+
+        ScheduledSystem scheduled;
+        scheduled.system = system;
+        scheduled.query = query;
+        scheduled.dependencies = 0;
+        m_systems.push_back(scheduled);
+        m_graphDirty = true;
+    }
+
+    bool SystemScheduler::Remove(const std::shared_ptr<AGameSystem> & system)
+    {
+        auto it = std::find_if(m_systems.begin(), m_systems.end(), [&system](const ScheduledSystem & scheduled) { return scheduled.system == system; });
+        if (it == m_systems.end())
+        {
+            return false;
+        }
+
+        // keep the remaining systems in the order they were added, the order decides who waits for who
+        m_systems.erase(it);
+        m_graphDirty = true;
+        return true;
+    }
+
+    size_t SystemScheduler::Size() const
+    {
+        return m_systems.size();
+    }
+
+    void SystemScheduler::Clear()
+    {
+        m_systems.clear();
+        m_graphDirty = false;
+    }
+
+    void SystemScheduler::Update(float fCurrentTime, float fElapsedTime, EntityTagMask exclude, std::function<void(AEvent *)> delPublishEvent,
+                                 std::shared_ptr<TaskGroup> pAfter)
+    {
+        // two frames must never overlap, a later frame would run alongside systems it should wait for
+        this->Finish();
+
+        if (m_systems.empty())
+        {
+            return;
+        }
+
+        if (m_graphDirty)
+        {
+            this->BuildGraph();
+        }
+
+        auto frame = std::make_shared<SystemFrame>(m_systems.size());
+        frame->currentTime = fCurrentTime;
+        frame->elapsedTime = fElapsedTime;
+        frame->pAfter = pAfter;
+
+        // systems over the same query share one snapshot, the logic system hands out one query per set of types
+        std::vector<std::pair<const EntityQuery *, std::shared_ptr<const SystemView> > > views;
+        size_t total_batches = 0;
+        for (size_t i = 0; i < m_systems.size(); ++i)
+        {
+            const ScheduledSystem & scheduled = m_systems[i];
+            SystemFrame::Node & node = frame->nodes[i];
+
+            auto view = std::find_if(views.begin(), views.end(), [&scheduled](const std::pair<const EntityQuery *, std::shared_ptr<const SystemView> > & pair)
+            {
+                return pair.first == scheduled.query.get();
+            });
+            if (view == views.end())
+            {
+                views.push_back(std::make_pair(scheduled.query.get(), std::make_shared<SystemView>(*scheduled.query, exclude)));
+                view = views.end() - 1;
+            }
+
+            // every system gets at least one batch, even an empty one, so the graph is walked the same way every frame
+            node.system = scheduled.system;
+            node.view = view->second;
+            node.batchSize = scheduled.system->GetBatchSize() > 0 ? scheduled.system->GetBatchSize() : std::max<size_t>(1, node.view->Size());
+            node.batchCount = std::max<size_t>(1, (node.view->Size() + node.batchSize - 1) / node.batchSize);
+            node.remainingBatches = node.batchCount;
+            node.remainingDependencies = scheduled.dependencies;
+            node.dependents = scheduled.dependents;
+            total_batches += node.batchCount;
+        }
+
+        // systems that wait for nothing are ready straight away
+        frame->ready.reserve(total_batches);
+        for (size_t i = 0; i < m_systems.size(); ++i)
+        {
+            if (m_systems[i].dependencies == 0)
+            {
+                for (size_t b = 0; b < frame->nodes[i].batchCount; ++b)
+                {
+                    frame->ready.push_back(std::make_pair(i, b));
+                }
+            }
+        }
+        m_pFrame = frame;
+
+        // one task per hardware thread is enough, each keeps taking batches until the whole frame is done
+        size_t threads = std::max(1u, std::thread::hardware_concurrency());
+        size_t tasks = std::min(threads, total_batches);
+        for (size_t t = 0; t < tasks; ++t)
+        {
+            delPublishEvent(new Event_NewThreadTask(new Task_RunSystems(frame)));
+        }
+    }
+
+    void SystemScheduler::Finish()
+    {
+        if (m_pFrame == nullptr)
+        {
+            return;
+        }
+
+        // the published tasks may not have reached a worker yet, so take part rather than just waiting
+        Task_RunSystems task(m_pFrame);
+        while (!task.IsComplete())
+        {
+            task.Execute();
+        }
+        m_pFrame.reset();
+    }
+
+    void SystemScheduler::BuildGraph()
+    {
+        for (auto & scheduled : m_systems)
+        {
+            scheduled.dependents.clear();
+            scheduled.dependencies = 0;
+        }
+
+        // a system waits for every earlier system it conflicts with, which also keeps the graph acyclic
+        for (size_t later = 0; later < m_systems.size(); ++later)
+        {
+            for (size_t earlier = 0; earlier < later; ++earlier)
+            {
+                if (m_systems[later].system->ConflictsWith(*m_systems[earlier].system))
+                {
+                    m_systems[earlier].dependents.push_back(later);
+                    ++m_systems[later].dependencies;
+                }
+            }
+        }
+        m_graphDirty = false;
+    }
+}
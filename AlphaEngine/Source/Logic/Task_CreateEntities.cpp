@@ -0,0 +1,38 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "Logic/Task_CreateEntities.h"
+#include "Assets/Asset.h"
+#include "Entities/Entity.h"
+#include "Entities/EntityFactory.h"
+
+namespace alpha
+{
+    Task_CreateEntities::Task_CreateEntities(std::shared_ptr<Asset> asset, unsigned int count, EntityFactory * pFactory,
+                                             std::function<void(std::vector<std::shared_ptr<Entity> >)> delComplete)
+        : m_asset(asset)
+        , m_count(count)
+        , m_pFactory(pFactory)
+        , m_delComplete(delComplete)
+    { }
+
+    bool Task_CreateEntities::VExecute()
+    {
+        // the first build of a script runs it, every other build only copies the cached prototype
+        m_delComplete(m_pFactory->CreateEntities(m_asset, m_count));
+        return true;
+    }
+}
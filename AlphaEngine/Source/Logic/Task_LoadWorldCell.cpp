@@ -0,0 +1,47 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "Logic/Task_LoadWorldCell.h"
+#include "Logic/WorldFile.h"
+#include "Assets/Asset.h"
+#include "Entities/Entity.h"
+
+namespace alpha
+{
+    Task_LoadWorldCell::Task_LoadWorldCell(WorldCellCoord coord, std::shared_ptr<Asset> asset, EntityFactory * pFactory,
+                                           std::function<void(WorldCellCoord, std::vector<std::shared_ptr<Entity> >)> delComplete)
+        : m_coord(coord)
+        , m_asset(asset)
+        , m_pFactory(pFactory)
+        , m_delComplete(delComplete)
+    { }
+
+    bool Task_LoadWorldCell::VExecute()
+    {
+        std::vector<std::shared_ptr<Entity> > entities;
+
+        // the snapshot is only read once per load, so it is not kept in the asset while the cell is resident
+        auto data = m_asset->ReadData();
+        if (!data.empty())
+        {
+            entities = DeserializeWorld(reinterpret_cast<const char *>(&data[0]), data.size(), m_pFactory);
+        }
+
+        // always report back, even an empty cell has to leave the loading state
+        m_delComplete(m_coord, std::move(entities));
+        return true;
+    }
+}
@@ -0,0 +1,99 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+#include <thread>
+
+#include "Logic/Task_RunSystems.h"
+#include "Logic/GameSystem.h"
+#include "Threading/TaskGroup.h"
+
+namespace alpha
+{
+    Task_RunSystems::Task_RunSystems(std::shared_ptr<SystemFrame> pFrame)
+        : m_pFrame(pFrame)
+    { }
+
+    bool Task_RunSystems::VExecute()
+    {
+        SystemFrame & frame = *m_pFrame;
+
+        if (frame.pAfter != nullptr)
+        {
+            frame.pAfter->Wait();
+        }
+
+        while (frame.remainingNodes > 0)
+        {
+            std::pair<size_t, size_t> batch;
+            bool found = false;
+            {
+                std::lock_guard<std::mutex> lock(frame.readyMutex);
+                if (!frame.ready.empty())
+                {
+                    batch = frame.ready.back();
+                    frame.ready.pop_back();
+                    found = true;
+                }
+            }
+
+            // nothing is ready, but every unfinished system is waiting on one that is running
+            // on another task, so more work is on its way.
+            if (!found)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            SystemFrame::Node & node = frame.nodes[batch.first];
+            size_t begin = batch.second * node.batchSize;
+            size_t end = std::min(begin + node.batchSize, node.view->Size());
+            if (begin < end)
+            {
+                node.system->VUpdate(*node.view, begin, end, frame.currentTime, frame.elapsedTime);
+            }
+
+            this->FinishBatch(batch.first);
+        }
+
+        return true;
+    }
+
+    void Task_RunSystems::FinishBatch(size_t node)
+    {
+        SystemFrame & frame = *m_pFrame;
+        SystemFrame::Node & finished = frame.nodes[node];
+        if (--finished.remainingBatches > 0)
+        {
+            return;
+        }
+
+        // release dependents before the system counts as done, so no task gives up while work is still coming
+        for (size_t dependent : finished.dependents)
+        {
+            SystemFrame::Node & next = frame.nodes[dependent];
+            if (--next.remainingDependencies == 0)
+            {
+                std::lock_guard<std::mutex> lock(frame.readyMutex);
+                for (size_t b = 0; b < next.batchCount; ++b)
+                {
+                    frame.ready.push_back(std::make_pair(dependent, b));
+                }
+            }
+        }
+        --frame.remainingNodes;
+    }
+}
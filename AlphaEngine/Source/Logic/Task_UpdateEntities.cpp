@@ -0,0 +1,67 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <chrono>
+
+#include "Logic/Task_UpdateEntities.h"
+#include "Entities/Entity.h"
+#include "Logic/LogicSystemEvents.h"
+
+namespace alpha
+{
+    Task_UpdateEntities::Task_UpdateEntities(float fCurrentTime, float fElapsedTime,
+                                             std::shared_ptr<const std::vector<Entity *> > pEntities, size_t begin, size_t end,
+                                             std::function<void(AEvent *)> delPublishEvent,
+                                             std::function<void(size_t, double)> delReportCost)
+        : m_fCurrentTime(fCurrentTime)
+        , m_fElapsedTime(fElapsedTime)
+        , m_pEntities(pEntities)
+        , m_begin(begin)
+        , m_end(end)
+        , m_delPublishEvent(delPublishEvent)
+        , m_delReportCost(delReportCost)
+    { }
+
+    bool Task_UpdateEntities::VExecute()
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        std::vector<EntityHandle> updated;
+        std::vector<ComponentDelta> deltas;
+        for (size_t i = m_begin; i < m_end; ++i)
+        {
+            Entity * pEntity = (*m_pEntities)[i];
+            if (pEntity->Update(m_fCurrentTime, m_fElapsedTime, deltas))
+            {
+                updated.push_back(pEntity->GetHandle());
+            }
+        }
+
+        // one notification, and one change journal, for the whole batch
+        if (!updated.empty())
+        {
+            m_delPublishEvent(new Event_EntitiesUpdated(std::move(updated), std::move(deltas)));
+        }
+
+        if (m_delReportCost)
+        {
+            std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+            m_delReportCost(m_end - m_begin, elapsed.count());
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,252 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <map>
+#include <string>
+#include <stdio.h>
+#include <string.h>
+
+#include "Logic/WorldFile.h"
+#include "Entities/Entity.h"
+#include "Entities/EntityComponent.h"
+#include "Entities/EntityFactory.h"
+#include "Entities/EntityScript.h"
+#include "Entities/EntityTags.h"
+#include "Toolbox/BinaryStream.h"
+#include "Toolbox/Logger.h"
+
+namespace alpha
+{
+    namespace
+    {
+        /** Collects unique strings, and hands out their index in the table */
+        class StringTable
+        {
+        public:
+            uint32_t Add(const std::string & value)
+            {
+                auto it = m_indices.find(value);
+                if (it != m_indices.end())
+                {
+                    return it->second;
+                }
+                uint32_t index = static_cast<uint32_t>(m_strings.size());
+                m_indices[value] = index;
+                m_strings.push_back(value);
+                return index;
+            }
+
+            const std::vector<std::string> & GetStrings() const { return m_strings; }
+
+        private:
+            std::map<std::string, uint32_t> m_indices;
+            std::vector<std::string> m_strings;
+        };
+
+        /** Write component records parents first, so they can be re-attached in a single pass on load */
+        void WriteComponents(const std::map<unsigned int, std::shared_ptr<EntityComponent> > & components, int32_t parent, uint32_t first,
+                             StringTable & strings, std::vector<WorldComponentRecord> & records, BinaryWriter & data)
+        {
+            for (auto & pair : components)
+            {
+                WorldComponentRecord record;
+                record.type = strings.Add(pair.second->VGetName());
+                record.componentId = pair.first;
+                record.parent = parent;
+                record.dataOffset = static_cast<uint32_t>(data.Size());
+                pair.second->VSerialize(data);
+                record.dataSize = static_cast<uint32_t>(data.Size()) - record.dataOffset;
+                records.push_back(record);
+
+                int32_t index = static_cast<int32_t>(records.size() - 1 - first);
+                WriteComponents(pair.second->GetComponents(), index, first, strings, records, data);
+            }
+        }
+    }
+
+    void SerializeWorld(const std::vector<std::shared_ptr<Entity> > & entities, std::ostream & stream)
+    {
+        StringTable strings;
+        std::vector<WorldEntityRecord> entity_records;
+        std::vector<WorldComponentRecord> component_records;
+        BinaryWriter data;
+
+        entity_records.reserve(entities.size());
+        for (auto & entity : entities)
+        {
+            WorldEntityRecord record;
+            memset(&record, 0, sizeof(WorldEntityRecord));
+            record.tags = entity->GetTags();
+            auto script = entity->GetScript();
+            record.script = (script != nullptr) ? strings.Add(script->GetPath()) : WORLDFILE_NO_STRING;
+            record.firstComponent = static_cast<uint32_t>(component_records.size());
+
+            WriteComponents(entity->GetComponents(), -1, record.firstComponent, strings, component_records, data);
+
+            record.componentCount = static_cast<uint32_t>(component_records.size()) - record.firstComponent;
+            entity_records.push_back(record);
+        }
+
+        WorldFileHeader header;
+        memset(&header, 0, sizeof(WorldFileHeader));
+        sprintf(header.signature, "%s", WORLDFILE_SIG);
+        header.version = WORLDFILE_V2;
+        header.entityCount = static_cast<uint32_t>(entity_records.size());
+        header.componentCount = static_cast<uint32_t>(component_records.size());
+        header.stringCount = static_cast<uint32_t>(strings.GetStrings().size());
+        header.dataSize = static_cast<uint32_t>(data.Size());
+
+        BinaryWriter string_table;
+        for (auto & value : strings.GetStrings())
+        {
+            string_table.WriteString(value);
+        }
+
+        stream.write(reinterpret_cast<const char *>(&header), sizeof(WorldFileHeader));
+        stream.write(string_table.GetBuffer().data(), string_table.Size());
+        if (!entity_records.empty())
+        {
+            stream.write(reinterpret_cast<const char *>(&entity_records[0]), entity_records.size() * sizeof(WorldEntityRecord));
+        }
+        if (!component_records.empty())
+        {
+            stream.write(reinterpret_cast<const char *>(&component_records[0]), component_records.size() * sizeof(WorldComponentRecord));
+        }
+        stream.write(data.GetBuffer().data(), data.Size());
+    }
+
+    std::vector<std::shared_ptr<Entity> > DeserializeWorld(const char * data, size_t size, EntityFactory * pFactory)
+    {
+        std::vector<std::shared_ptr<Entity> > entities;
+        BinaryReader reader(data, size);
+
+        WorldFileHeader header;
+        if (!reader.Read(header) || strncmp(header.signature, WORLDFILE_SIG, sizeof(header.signature)) != 0 || header.version != WORLDFILE_V2)
+        {
+            LOG_ERR("WorldFile > Data is not a valid Alpha-World snapshot.");
+            return entities;
+        }
+
+        // the counts are not trusted, every table has to fit in what is left before anything is sized by it
+        if (header.stringCount > reader.GetRemaining() / sizeof(uint32_t))
+        {
+            LOG_ERR("WorldFile > Snapshot is truncated.");
+            return entities;
+        }
+
+        std::vector<std::string> strings(header.stringCount);
+        for (auto & value : strings)
+        {
+            reader.ReadString(value);
+        }
+
+        const size_t remaining = reader.GetRemaining();
+        if (!reader.IsValid() || header.entityCount > remaining / sizeof(WorldEntityRecord) ||
+            header.componentCount > (remaining - header.entityCount * sizeof(WorldEntityRecord)) / sizeof(WorldComponentRecord))
+        {
+            LOG_ERR("WorldFile > Snapshot is truncated.");
+            return entities;
+        }
+
+        // both record tables are fixed size, so each is a single bulk copy
+        std::vector<WorldEntityRecord> entity_records(header.entityCount);
+        std::vector<WorldComponentRecord> component_records(header.componentCount);
+        if (header.entityCount > 0)
+        {
+            reader.Read(&entity_records[0], entity_records.size() * sizeof(WorldEntityRecord));
+        }
+        if (header.componentCount > 0)
+        {
+            reader.Read(&component_records[0], component_records.size() * sizeof(WorldComponentRecord));
+        }
+
+        size_t data_start = reader.GetPosition();
+        if (!reader.IsValid() || header.dataSize > size - data_start)
+        {
+            LOG_ERR("WorldFile > Snapshot is truncated.");
+            return entities;
+        }
+        const char * component_data = data + data_start;
+
+        // type names are shared by many components, resolve each once
+        std::vector<unsigned int> type_ids(strings.size());
+        for (size_t i = 0; i < strings.size(); ++i)
+        {
+            type_ids[i] = EntityComponent::GetIDFromName(strings[i]);
+        }
+
+        entities.reserve(entity_records.size());
+        std::vector<std::shared_ptr<EntityComponent> > components;
+        for (auto & entity_record : entity_records)
+        {
+            if (entity_record.firstComponent > component_records.size() ||
+                entity_record.componentCount > component_records.size() - entity_record.firstComponent)
+            {
+                LOG_ERR("WorldFile > Entity references components outside of the snapshot.");
+                break;
+            }
+
+            // entities keep a reference to their script if it is already cached,
+            // but a snapshot never causes a script to be run.
+            std::shared_ptr<EntityScript> script;
+            if (entity_record.script < strings.size())
+            {
+                script = pFactory->GetCachedScript(strings[entity_record.script]);
+            }
+            auto entity = std::make_shared<Entity>(script);
+            entity->SetTags(entity_record.tags & ~ET_POOLED);
+
+            components.assign(entity_record.componentCount, nullptr);
+            for (uint32_t c = 0; c < entity_record.componentCount; ++c)
+            {
+                const WorldComponentRecord & record = component_records[entity_record.firstComponent + c];
+                if (record.type >= strings.size() || record.dataOffset > header.dataSize || record.dataSize > header.dataSize - record.dataOffset)
+                {
+                    LOG_WARN("WorldFile > Skipping invalid component record.");
+                    continue;
+                }
+
+                auto component = pFactory->CreateComponentOfType(type_ids[record.type]);
+                if (component == nullptr)
+                {
+                    LOG_WARN("WorldFile > Skipping component of unregistered type: ", strings[record.type]);
+                    continue;
+                }
+
+                BinaryReader component_reader(component_data + record.dataOffset, record.dataSize);
+                if (!component->VDeserialize(component_reader))
+                {
+                    LOG_WARN("WorldFile > Failed to read component data for type: ", strings[record.type]);
+                    continue;
+                }
+
+                // parents are always written before their children
+                if (record.parent >= 0 && static_cast<uint32_t>(record.parent) < c && components[record.parent] != nullptr)
+                {
+                    components[record.parent]->Attach(record.componentId, component);
+                    component->SetParent(components[record.parent]);
+                }
+
+                entity->Add(record.componentId, component);
+                components[c] = component;
+            }
+
+            entities.push_back(entity);
+        }
+
+        return entities;
+    }
+}
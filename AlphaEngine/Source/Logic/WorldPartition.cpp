@@ -0,0 +1,109 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "Logic/WorldPartition.h"
+#include "Math/Vector3.h"
+
+namespace alpha
+{
+    WorldPartition::WorldPartition(float cellSize, unsigned int loadRadius)
+        : m_cellSize(cellSize)
+        , m_loadRadius(loadRadius)
+    { }
+
+    void WorldPartition::AddCell(int x, int z, const std::string & resource)
+    {
+        WorldCellCoord coord = { x, z };
+        WorldCell & cell = m_cells[coord];
+        cell.coord = coord;
+        cell.resource = resource;
+        cell.state = WCS_UNLOADED;
+        cell.wanted = false;
+        cell.committed = 0;
+    }
+
+    WorldCell * WorldPartition::GetCell(const WorldCellCoord & coord)
+    {
+        auto it = m_cells.find(coord);
+        return it != m_cells.end() ? &it->second : nullptr;
+    }
+
+    bool WorldPartition::Empty() const
+    {
+        return m_cells.empty();
+    }
+
+    void WorldPartition::SetCellSize(float cellSize)
+    {
+        m_cellSize = cellSize;
+    }
+
+    void WorldPartition::SetLoadRadius(unsigned int loadRadius)
+    {
+        m_loadRadius = loadRadius;
+    }
+
+    WorldCellCoord WorldPartition::GetCellCoord(const Vector3 & position) const
+    {
+        WorldCellCoord coord = { static_cast<int>(std::floor(position.x / m_cellSize)), static_cast<int>(std::floor(position.z / m_cellSize)) };
+        return coord;
+    }
+
+    void WorldPartition::UpdateFocus(const Vector3 & focus, std::vector<WorldCell *> & toLoad, std::vector<WorldCell *> & toUnload)
+    {
+        const WorldCellCoord center = this->GetCellCoord(focus);
+        const int load_radius = static_cast<int>(m_loadRadius);
+
+        // a cell is at the chebyshev distance of its furthest axis from the focus cell
+        auto distance = [&center](const WorldCellCoord & coord)
+        {
+            return std::max(std::abs(coord.x - center.x), std::abs(coord.z - center.z));
+        };
+
+        for (auto & pair : m_cells)
+        {
+            WorldCell & cell = pair.second;
+            int d = distance(cell.coord);
+
+            if (d <= load_radius)
+            {
+                cell.wanted = true;
+                if (cell.state == WCS_UNLOADED)
+                {
+                    toLoad.push_back(&cell);
+                }
+            }
+            else if (d > load_radius + 1)
+            {
+                cell.wanted = false;
+                if (cell.state == WCS_COMMITTING || cell.state == WCS_LOADED)
+                {
+                    toUnload.push_back(&cell);
+                }
+            }
+            // cells in the one cell wide band between the radii keep their current state
+        }
+
+        std::sort(toLoad.begin(), toLoad.end(), [&distance](const WorldCell * a, const WorldCell * b)
+        {
+            return distance(a->coord) < distance(b->coord);
+        });
+    }
+}
@@ -0,0 +1,145 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "Math/AABB.h"
+#include "Math/Matrix.h"
+
+namespace alpha
+{
+    AABB::AABB() { }
+    AABB::AABB(const Vector3 & vMin, const Vector3 & vMax)
+        : min(vMin)
+        , max(vMax)
+    { }
+
+    Vector3 AABB::Center() const
+    {
+        return Vector3((min.x + max.x) * 0.5f, (min.y + max.y) * 0.5f, (min.z + max.z) * 0.5f);
+    }
+
+    Vector3 AABB::Extents() const
+    {
+        return Vector3((max.x - min.x) * 0.5f, (max.y - min.y) * 0.5f, (max.z - min.z) * 0.5f);
+    }
+
+    float AABB::SurfaceArea() const
+    {
+        float dx = max.x - min.x;
+        float dy = max.y - min.y;
+        float dz = max.z - min.z;
+        return 2.f * (dx * dy + dy * dz + dz * dx);
+    }
+
+    bool AABB::Contains(const AABB & other) const
+    {
+        return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z &&
+               max.x >= other.max.x && max.y >= other.max.y && max.z >= other.max.z;
+    }
+
+    bool AABB::Overlaps(const AABB & other) const
+    {
+        return min.x <= other.max.x && max.x >= other.min.x &&
+               min.y <= other.max.y && max.y >= other.min.y &&
+               min.z <= other.max.z && max.z >= other.min.z;
+    }
+
+    bool AABB::Overlaps(const Vector3 & center, float radius) const
+    {
+        // distance from the sphere center to the closest point on the box
+        float dx = std::max(min.x - center.x, std::max(0.f, center.x - max.x));
+        float dy = std::max(min.y - center.y, std::max(0.f, center.y - max.y));
+        float dz = std::max(min.z - center.z, std::max(0.f, center.z - max.z));
+        return (dx * dx + dy * dy + dz * dz) <= radius * radius;
+    }
+
+    namespace
+    {
+        /**
+         * Clip the ray's [tmin, tmax] interval against one slab, returns false if the ray misses it.
+         * A ray parallel to the slab, marked by an infinite inverse direction, either starts between
+         * the planes and is unaffected, or misses.  Handling it here avoids 0 * inf producing NaN when
+         * the origin lies exactly on one of the planes.
+         */
+        bool ClipSlab(float min, float max, float origin, float invDirection, float & tmin, float & tmax)
+        {
+            if (std::isinf(invDirection))
+            {
+                return origin >= min && origin <= max;
+            }
+
+            float t1 = (min - origin) * invDirection;
+            float t2 = (max - origin) * invDirection;
+            tmin = std::max(tmin, std::min(t1, t2));
+            tmax = std::min(tmax, std::max(t1, t2));
+            return true;
+        }
+    }
+
+    bool AABB::Raycast(const Vector3 & origin, const Vector3 & invDirection, float maxDistance, float * distance) const
+    {
+        float tmin = -std::numeric_limits<float>::infinity();
+        float tmax = std::numeric_limits<float>::infinity();
+        if (!ClipSlab(min.x, max.x, origin.x, invDirection.x, tmin, tmax) ||
+            !ClipSlab(min.y, max.y, origin.y, invDirection.y, tmin, tmax) ||
+            !ClipSlab(min.z, max.z, origin.z, invDirection.z, tmin, tmax))
+        {
+            return false;
+        }
+
+        if (tmax < std::max(tmin, 0.f) || tmin > maxDistance)
+        {
+            return false;
+        }
+        if (distance != nullptr)
+        {
+            *distance = std::max(tmin, 0.f);
+        }
+        return true;
+    }
+
+    AABB AABB::Expand(float margin) const
+    {
+        return AABB(Vector3(min.x - margin, min.y - margin, min.z - margin),
+                    Vector3(max.x + margin, max.y + margin, max.z + margin));
+    }
+
+    AABB AABB::Transform(const Matrix & transform) const
+    {
+        // transform the center, and project the extents onto each world axis.
+        // row vector convention, so row n of the matrix is where local axis n ends up.
+        Vector3 c = this->Center();
+        Vector3 e = this->Extents();
+
+        Vector3 center(c.x * transform.m_11 + c.y * transform.m_21 + c.z * transform.m_31 + transform.m_41,
+                       c.x * transform.m_12 + c.y * transform.m_22 + c.z * transform.m_32 + transform.m_42,
+                       c.x * transform.m_13 + c.y * transform.m_23 + c.z * transform.m_33 + transform.m_43);
+        Vector3 extents(e.x * std::fabs(transform.m_11) + e.y * std::fabs(transform.m_21) + e.z * std::fabs(transform.m_31),
+                        e.x * std::fabs(transform.m_12) + e.y * std::fabs(transform.m_22) + e.z * std::fabs(transform.m_32),
+                        e.x * std::fabs(transform.m_13) + e.y * std::fabs(transform.m_23) + e.z * std::fabs(transform.m_33));
+
+        return AABB(center - extents, center + extents);
+    }
+
+    AABB AABB::Merge(const AABB & left, const AABB & right)
+    {
+        return AABB(Vector3(std::min(left.min.x, right.min.x), std::min(left.min.y, right.min.y), std::min(left.min.z, right.min.z)),
+                    Vector3(std::max(left.max.x, right.max.x), std::max(left.max.y, right.max.y), std::max(left.max.z, right.max.z)));
+    }
+}
@@ -0,0 +1,63 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "Math/Frustum.h"
+#include "Math/AABB.h"
+#include "Math/Matrix.h"
+
+namespace alpha
+{
+    Frustum::Frustum()
+    {
+        for (Vector4 & plane : planes)
+        {
+            plane = Vector4(0.f, 0.f, 0.f, 1.f);
+        }
+    }
+
+    Frustum::Frustum(const Matrix & m)
+    {
+        // clip = p * m, so each clip coordinate is p dotted with a column of m.
+        // a point is inside when -w <= x, y, z <= w, giving one plane per inequality.
+        const Vector4 x(m.m_11, m.m_21, m.m_31, m.m_41);
+        const Vector4 y(m.m_12, m.m_22, m.m_32, m.m_42);
+        const Vector4 z(m.m_13, m.m_23, m.m_33, m.m_43);
+        const Vector4 w(m.m_14, m.m_24, m.m_34, m.m_44);
+
+        planes[0] = w + x; // left
+        planes[1] = w - x; // right
+        planes[2] = w + y; // bottom
+        planes[3] = w - y; // top
+        planes[4] = w + z; // near
+        planes[5] = w - z; // far
+    }
+
+    bool Frustum::Overlaps(const AABB & aabb) const
+    {
+        for (const Vector4 & plane : planes)
+        {
+            // the corner furthest along the plane normal, if it is outside then so is the whole box
+            float px = plane.x >= 0.f ? aabb.max.x : aabb.min.x;
+            float py = plane.y >= 0.f ? aabb.max.y : aabb.min.y;
+            float pz = plane.z >= 0.f ? aabb.max.z : aabb.min.z;
+            if (plane.x * px + plane.y * py + plane.z * pz + plane.w < 0.f)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
@@ -98,6 +98,23 @@ namespace alpha
                       0.f, 0.f, 0.f, 1.f);
     }
 
+    Matrix Matrix::Compose(const Vector3 & position, const Quaternion & rotation, const Vector3 & scale)
+    {
+        // R * S scales each column of the rotation by the matching scale axis,
+        // and * T only replaces the bottom row with the translation.
+        Matrix m = Matrix::Rotate(rotation);
+
+        m.m_11 *= scale.x; m.m_12 *= scale.y; m.m_13 *= scale.z;
+        m.m_21 *= scale.x; m.m_22 *= scale.y; m.m_23 *= scale.z;
+        m.m_31 *= scale.x; m.m_32 *= scale.y; m.m_33 *= scale.z;
+
+        m.m_41 = position.x;
+        m.m_42 = position.y;
+        m.m_43 = position.z;
+
+        return m;
+    }
+
     Matrix Matrix::Projection(float fov, float aspect, float near, float far)
     {
         float depth = far - near;
@@ -0,0 +1,271 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cstdlib>
+#include <cstring>
+
+extern "C" {
+#include <lua.h>
+}
+
+#include "Scripting/LuaAllocator.h"
+
+namespace alpha
+{
+    const size_t LuaAllocator::sk_classSize = 16;
+    const size_t LuaAllocator::sk_classCount = 16;
+    const size_t LuaAllocator::sk_chunkSize = 16 * 1024;
+
+    std::atomic<size_t> LuaAllocator::s_reserved(0);
+
+    LuaAllocator::LuaAllocator()
+        : m_freeLists(sk_classCount, nullptr)
+        , m_pNext(nullptr)
+        , m_pEnd(nullptr)
+        , m_adoptedBytes(0)
+        , m_usage(0)
+        , m_peak(0)
+        , m_limit(0)
+    { }
+
+    LuaAllocator::~LuaAllocator()
+    {
+        for (char * pChunk : m_chunks)
+        {
+            free(pChunk);
+        }
+        s_reserved -= m_chunks.size() * sk_chunkSize;
+
+        for (void * pBlock : m_adopted)
+        {
+            free(pBlock);
+        }
+        s_reserved -= m_adoptedBytes;
+    }
+
+    void * LuaAllocator::Allocate(void * pUserData, void * pBlock, size_t oldSize, size_t newSize)
+    {
+        LuaAllocator * pAllocator = static_cast<LuaAllocator *>(pUserData);
+
+        // when there is no block, lua passes the type of object being created as the old size
+        if (pBlock == nullptr)
+        {
+            oldSize = 0;
+        }
+
+        if (newSize == 0)
+        {
+            if (pBlock != nullptr)
+            {
+                pAllocator->Free(pBlock, oldSize);
+                pAllocator->m_usage -= oldSize;
+            }
+            return nullptr;
+        }
+
+        // lua expects shrinking to never fail, so only growth is held to the limit
+        if (newSize > oldSize && pAllocator->m_limit > 0 && pAllocator->m_usage - oldSize + newSize > pAllocator->m_limit)
+        {
+            return nullptr;
+        }
+
+        const size_t oldClass = GetClass(oldSize);
+        const size_t newClass = GetClass(newSize);
+        void * pResult = nullptr;
+        if (pBlock != nullptr && oldClass == newClass && newClass < sk_classCount)
+        {
+            // still fits the same pooled block
+            pResult = pBlock;
+        }
+        else if (pBlock != nullptr && oldClass == sk_classCount && newClass == sk_classCount)
+        {
+            pResult = realloc(pBlock, newSize);
+            if (pResult != nullptr)
+            {
+                s_reserved += newSize;
+                s_reserved -= oldSize;
+            }
+        }
+        else
+        {
+            pResult = pAllocator->Alloc(newSize);
+            if (pResult != nullptr && pBlock != nullptr)
+            {
+                memcpy(pResult, pBlock, oldSize < newSize ? oldSize : newSize);
+                pAllocator->Free(pBlock, oldSize);
+            }
+        }
+
+        if (pResult == nullptr)
+        {
+            if (newSize > oldSize)
+            {
+                return nullptr;
+            }
+
+            // the system is out of memory, the old block is big enough to keep using
+            if (oldClass == sk_classCount && newClass < sk_classCount)
+            {
+                // a large block filed under a pooled size would be recycled by the pool, and never freed
+                pResult = pAllocator->Adopt(pBlock, oldSize, newClass);
+            }
+            else
+            {
+                // filed under the smaller size from now on, wasting its spare bytes until it is freed
+                pResult = pBlock;
+                if (oldClass == sk_classCount)
+                {
+                    s_reserved -= oldSize - newSize;
+                }
+            }
+        }
+
+        pAllocator->m_usage = pAllocator->m_usage - oldSize + newSize;
+        if (pAllocator->m_usage > pAllocator->m_peak)
+        {
+            pAllocator->m_peak = pAllocator->m_usage;
+        }
+        return pResult;
+    }
+
+    LuaAllocator * LuaAllocator::Get(lua_State * pState)
+    {
+        void * pUserData = nullptr;
+        if (lua_getallocf(pState, &pUserData) != &LuaAllocator::Allocate)
+        {
+            return nullptr;
+        }
+        return static_cast<LuaAllocator *>(pUserData);
+    }
+
+    size_t LuaAllocator::GetReservedTotal()
+    {
+        return s_reserved;
+    }
+
+    void LuaAllocator::SetLimit(size_t limit)
+    {
+        m_limit = limit;
+    }
+
+    size_t LuaAllocator::GetLimit() const
+    {
+        return m_limit;
+    }
+
+    size_t LuaAllocator::GetUsage() const
+    {
+        return m_usage;
+    }
+
+    size_t LuaAllocator::GetPeak() const
+    {
+        return m_peak;
+    }
+
+    void LuaAllocator::ResetPeak()
+    {
+        m_peak = m_usage;
+    }
+
+    size_t LuaAllocator::GetClass(size_t size)
+    {
+        if (size == 0 || size > sk_classSize * sk_classCount)
+        {
+            return sk_classCount;
+        }
+        return (size - 1) / sk_classSize;
+    }
+
+    void * LuaAllocator::Alloc(size_t size)
+    {
+        const size_t sizeClass = GetClass(size);
+        if (sizeClass < sk_classCount)
+        {
+            return this->AllocSmall(sizeClass);
+        }
+
+        void * pBlock = malloc(size);
+        if (pBlock != nullptr)
+        {
+            s_reserved += size;
+        }
+        return pBlock;
+    }
+
+    void LuaAllocator::Free(void * pBlock, size_t size)
+    {
+        const size_t sizeClass = GetClass(size);
+        if (sizeClass < sk_classCount)
+        {
+            FreeBlock * pFree = static_cast<FreeBlock *>(pBlock);
+            pFree->pNext = m_freeLists[sizeClass];
+            m_freeLists[sizeClass] = pFree;
+            return;
+        }
+
+        free(pBlock);
+        s_reserved -= size;
+    }
+
+    void * LuaAllocator::Adopt(void * pBlock, size_t oldSize, size_t sizeClass)
+    {
+        // shrinking in place is all but certain to work, if it does not the block is kept whole
+        const size_t blockSize = (sizeClass + 1) * sk_classSize;
+        size_t size = oldSize;
+        void * pShrunk = realloc(pBlock, blockSize);
+        if (pShrunk != nullptr)
+        {
+            pBlock = pShrunk;
+            size = blockSize;
+        }
+
+        s_reserved -= oldSize;
+        s_reserved += size;
+        m_adopted.push_back(pBlock);
+        m_adoptedBytes += size;
+        return pBlock;
+    }
+
+    void * LuaAllocator::AllocSmall(size_t sizeClass)
+    {
+        FreeBlock * pFree = m_freeLists[sizeClass];
+        if (pFree != nullptr)
+        {
+            m_freeLists[sizeClass] = pFree->pNext;
+            return pFree;
+        }
+
+        const size_t blockSize = (sizeClass + 1) * sk_classSize;
+        if (static_cast<size_t>(m_pEnd - m_pNext) < blockSize)
+        {
+            // the rest of the current chunk is too small, it is left unused
+            char * pChunk = static_cast<char *>(malloc(sk_chunkSize));
+            if (pChunk == nullptr)
+            {
+                return nullptr;
+            }
+            m_chunks.push_back(pChunk);
+            s_reserved += sk_chunkSize;
+            m_pNext = pChunk;
+            m_pEnd = pChunk + sk_chunkSize;
+        }
+
+        void * pBlock = m_pNext;
+        m_pNext += blockSize;
+        return pBlock;
+    }
+}
@@ -0,0 +1,228 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <thread>
+
+#include "Scripting/LuaBytecodeCache.h"
+#include "Toolbox/FileSystem.h"
+#include "Toolbox/Logger.h"
+
+namespace alpha
+{
+    namespace
+    {
+        /** Written ahead of the bytecode, so a torn or foreign file is never handed to lua */
+        struct ChunkHeader
+        {
+            char magic[4];
+            uint32_t version;
+            uint64_t key;
+            uint64_t size;
+            uint64_t checksum;
+        };
+
+        const char sk_chunkMagic[4] = { 'A', 'L', 'B', 'C' };
+        const uint32_t sk_chunkVersion = 1;
+
+        std::atomic<unsigned int> s_tempCount(0);
+    }
+
+    std::mutex LuaBytecodeCache::s_mutex;
+    std::string LuaBytecodeCache::s_directory;
+    std::map<uint64_t, std::shared_ptr<const LuaBytecodeCache::Bytecode> > LuaBytecodeCache::s_chunks;
+
+    void LuaBytecodeCache::SetDirectory(const std::string & directory)
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_directory.clear();
+        if (directory.empty())
+        {
+            return;
+        }
+
+        if (OSCreateDirectory(directory.c_str()))
+        {
+            s_directory = directory;
+            LOG("  <LuaBytecodeCache> Caching compiled scripts in: ", directory);
+        }
+        else
+        {
+            LOG_WARN("  <LuaBytecodeCache> Unable to create cache directory ", directory, ", compiled scripts are kept in memory only.");
+        }
+    }
+
+    uint64_t LuaBytecodeCache::Hash(const char * pSource, size_t size)
+    {
+        // 64 bit FNV-1a, cheap next to parsing, and wide enough that distinct scripts do not collide
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= static_cast<unsigned char>(pSource[i]);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    std::shared_ptr<const LuaBytecodeCache::Bytecode> LuaBytecodeCache::Find(uint64_t key)
+    {
+        std::string path;
+        {
+            std::lock_guard<std::mutex> lock(s_mutex);
+            auto it = s_chunks.find(key);
+            if (it != s_chunks.end())
+            {
+                return it->second;
+            }
+            path = GetFilePath(key);
+        }
+
+        if (path.empty())
+        {
+            return nullptr;
+        }
+
+        auto bytecode = std::make_shared<Bytecode>();
+        if (!ReadChunk(path, key, *bytecode))
+        {
+            return nullptr;
+        }
+
+        // another thread may have read the same file meanwhile, keep whichever landed first
+        std::lock_guard<std::mutex> lock(s_mutex);
+        return s_chunks.insert(std::make_pair(key, bytecode)).first->second;
+    }
+
+    void LuaBytecodeCache::Store(uint64_t key, Bytecode bytecode)
+    {
+        auto chunk = std::make_shared<const Bytecode>(std::move(bytecode));
+
+        std::string path;
+        {
+            std::lock_guard<std::mutex> lock(s_mutex);
+            s_chunks[key] = chunk;
+            path = GetFilePath(key);
+        }
+
+        if (!path.empty() && !chunk->empty())
+        {
+            WriteChunk(path, key, *chunk);
+        }
+    }
+
+    void LuaBytecodeCache::Remove(uint64_t key)
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_chunks.erase(key);
+    }
+
+    void LuaBytecodeCache::Clear()
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_chunks.clear();
+    }
+
+    std::string LuaBytecodeCache::GetFilePath(uint64_t key)
+    {
+        if (s_directory.empty())
+        {
+            return std::string();
+        }
+
+        char name[32];
+        snprintf(name, sizeof(name), "%016llx.luac", static_cast<unsigned long long>(key));
+
+        char * path = OSJoinPath(s_directory.c_str(), name);
+        std::string result(path);
+        free(path);
+        return result;
+    }
+
+    bool LuaBytecodeCache::ReadChunk(const std::string & path, uint64_t key, Bytecode & bytecode)
+    {
+        FILE * fp = fopen(path.c_str(), "rb");
+        if (fp == nullptr)
+        {
+            return false;
+        }
+
+        ChunkHeader header;
+        bool valid = fread(&header, sizeof(header), 1, fp) == 1 &&
+                     memcmp(header.magic, sk_chunkMagic, sizeof(sk_chunkMagic)) == 0 &&
+                     header.version == sk_chunkVersion &&
+                     header.key == key &&
+                     header.size > 0;
+
+        if (valid)
+        {
+            // check the size against the file before allocating, a corrupt header must not ask for gigabytes
+            long start = ftell(fp);
+            valid = fseek(fp, 0, SEEK_END) == 0 &&
+                    static_cast<uint64_t>(ftell(fp) - start) == header.size &&
+                    fseek(fp, start, SEEK_SET) == 0;
+        }
+        if (valid)
+        {
+            bytecode.resize(static_cast<size_t>(header.size));
+            valid = fread(&bytecode[0], 1, bytecode.size(), fp) == bytecode.size() &&
+                    Hash(&bytecode[0], bytecode.size()) == header.checksum;
+        }
+        fclose(fp);
+
+        if (!valid)
+        {
+            // leave the file, the script compiles its source and the store that follows replaces it
+            LOG_WARN("  <LuaBytecodeCache> Ignoring damaged compiled script: ", path);
+            bytecode.clear();
+        }
+        return valid;
+    }
+
+    void LuaBytecodeCache::WriteChunk(const std::string & path, uint64_t key, const Bytecode & bytecode)
+    {
+        ChunkHeader header;
+        memcpy(header.magic, sk_chunkMagic, sizeof(sk_chunkMagic));
+        header.version = sk_chunkVersion;
+        header.key = key;
+        header.size = bytecode.size();
+        header.checksum = Hash(&bytecode[0], bytecode.size());
+
+        // each writer gets its own temporary file, and only a complete file is moved over the chunk path,
+        // so a reader never sees a half written chunk and two threads storing the same key do not interleave
+        char suffix[48];
+        snprintf(suffix, sizeof(suffix), ".%zx.%u.tmp", std::hash<std::thread::id>()(std::this_thread::get_id()), s_tempCount++);
+        std::string tempPath = path + suffix;
+
+        FILE * fp = fopen(tempPath.c_str(), "wb");
+        if (fp == nullptr)
+        {
+            LOG_WARN("  <LuaBytecodeCache> Unable to write compiled script: ", path);
+            return;
+        }
+        bool written = fwrite(&header, sizeof(header), 1, fp) == 1 &&
+                       fwrite(&bytecode[0], 1, bytecode.size(), fp) == bytecode.size();
+        written = fclose(fp) == 0 && written;
+
+        if (!written || !OSReplaceFile(tempPath.c_str(), path.c_str()))
+        {
+            LOG_WARN("  <LuaBytecodeCache> Unable to write compiled script: ", path);
+            std::remove(tempPath.c_str());
+        }
+    }
+}
@@ -14,8 +14,10 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <algorithm>
 #include <memory>
 #include <string.h>
+#include <utility>
 #include <vector>
 
 extern "C" {
@@ -25,22 +27,42 @@ extern "C" {
 }
 
 #include "Scripting/LuaScript.h"
+#include "Scripting/LuaAllocator.h"
+#include "Scripting/LuaBytecodeCache.h"
+#include "Scripting/LuaStatePool.h"
 #include "Scripting/LuaVar.h"
 #include "Assets/Asset.h"
 #include "Toolbox/Logger.h"
 
 namespace alpha
 {
-    LuaScript::LuaScript()
-        : m_pLuaState(luaL_newstate())
+    namespace
     {
-        luaL_openlibs(m_pLuaState);
+        /** Registry name of the metatable that lets script globals fall back on the standard libraries */
+        const char * const sk_envMetatable = "alpha.script_env";
+
+        /** lua_dump writer, appends each block of the compiled chunk to a bytecode buffer */
+        int WriteBytecode(lua_State * /*pState*/, const void * pData, size_t size, void * pBytecode)
+        {
+            auto bytecode = static_cast<LuaBytecodeCache::Bytecode *>(pBytecode);
+            const char * pBytes = static_cast<const char *>(pData);
+            bytecode->insert(bytecode->end(), pBytes, pBytes + size);
+            return 0;
+        }
     }
 
+    LuaScript::LuaScript()
+        : m_pLuaState(nullptr)
+        , m_envRef(LUA_NOREF)
+        , m_closed(false)
+        , m_memoryLimit(0)
+        , m_baseUsage(0)
+    { }
+
     LuaScript::~LuaScript()
     {
         m_scriptAssets.empty();
-        lua_close(m_pLuaState);
+        this->Close();
     }
 
     void LuaScript::Add(std::shared_ptr<Asset> asset)
@@ -50,6 +72,12 @@ namespace alpha
 
     void LuaScript::Load()
     {
+        if (!this->Open())
+        {
+            LOG_ERR("LUA: Attempt to load a script after its lua state was closed, or a state could not be created.");
+            return;
+        }
+
         // load each script into the lua state
         for (auto script : m_scriptAssets)
         {
@@ -57,12 +85,11 @@ namespace alpha
             if (data.size() > 0)
             {
                 char * buffer = reinterpret_cast<char *>(&data[0]);
-                LOG("Attempting to load buffer data into LUA environment");
-                int error = luaL_loadbuffer(m_pLuaState, buffer, strlen(buffer), "line");
-                if (error)
+                if (this->LoadChunk(buffer, strlen(buffer)))
                 {
-                    LOG_ERR("LUA: ", lua_tostring(m_pLuaState, -1));
-                    lua_pop(m_pLuaState, 1);
+                    // the chunks first upvalue is its _ENV, point it at this scripts own globals
+                    lua_rawgeti(m_pLuaState, LUA_REGISTRYINDEX, m_envRef);
+                    lua_setupvalue(m_pLuaState, -2, 1);
                 }
             }
             else
@@ -74,50 +101,112 @@ namespace alpha
 
     void LuaScript::Run()
     {
-        if (lua_pcall(m_pLuaState, 0, LUA_MULTRET, 0))
+        if (m_pLuaState == nullptr)
+        {
+            LOG_ERR("LUA: Attempt to run a script that is not loaded, or after its lua state was closed.");
+            return;
+        }
+
+        // only the protected call is capped, a memory error anywhere else would abort
+        LuaAllocator * pAllocator = LuaAllocator::Get(m_pLuaState);
+        if (m_memoryLimit > 0)
+        {
+            pAllocator->SetLimit(m_baseUsage + m_memoryLimit);
+        }
+        int result = lua_pcall(m_pLuaState, 0, LUA_MULTRET, 0);
+        pAllocator->SetLimit(0);
+
+        if (result == LUA_ERRMEM)
+        {
+            LOG_ERR("LUA: Script ran out of memory, limit ", m_memoryLimit, " bytes, using ", this->GetMemoryUsage(), " bytes.");
+            lua_pop(m_pLuaState, 1);
+        }
+        else if (result != LUA_OK)
         {
             LOG_ERR("LUA: ", lua_tostring(m_pLuaState, -1));
             lua_pop(m_pLuaState, 1);
         }
     }
 
-    void LuaScript::GetTableFloatValue(std::shared_ptr<LuaTable> table, const std::string key, float * const out)
+    void LuaScript::Close()
     {
-        auto var = std::dynamic_pointer_cast<LuaStatic<double>>(table->Get(key));
-        if (var != nullptr && out != nullptr)
+        if (m_pLuaState != nullptr)
         {
-            *out = static_cast<float>(var->GetValue());
+            // drop the scripts globals, the pool collects them when the state is released
+            lua_settop(m_pLuaState, 0);
+            luaL_unref(m_pLuaState, LUA_REGISTRYINDEX, m_envRef);
+            m_envRef = LUA_NOREF;
+
+            LuaStatePool::Release(m_pLuaState);
+            m_pLuaState = nullptr;
         }
+        m_closed = true;
     }
 
-    void LuaScript::GetTableStringValue(std::shared_ptr<LuaTable> table, const std::string key, std::string * const out)
+    bool LuaScript::IsOpen() const
     {
-        auto var = std::dynamic_pointer_cast<LuaStatic<std::string>>(table->Get(key));
-        if (var != nullptr && out != nullptr)
+        return !m_closed;
+    }
+
+    void LuaScript::SetMemoryLimit(size_t limit)
+    {
+        m_memoryLimit = limit;
+    }
+
+    size_t LuaScript::GetMemoryLimit() const
+    {
+        return m_memoryLimit;
+    }
+
+    size_t LuaScript::GetMemoryUsage() const
+    {
+        if (m_pLuaState == nullptr)
         {
-            *out = var->GetValue();
+            return 0;
         }
+        // garbage left over from before the script was loaded can be collected while it runs
+        size_t usage = LuaAllocator::Get(m_pLuaState)->GetUsage();
+        return usage > m_baseUsage ? usage - m_baseUsage : 0;
     }
 
-    void LuaScript::GetTableBoolValue(std::shared_ptr<LuaTable> table, const std::string key, bool * const out)
+    size_t LuaScript::GetPeakMemoryUsage() const
     {
-        auto var = std::dynamic_pointer_cast<LuaStatic<bool>>(table->Get(key));
-        if (var != nullptr && out != nullptr)
+        if (m_pLuaState == nullptr)
         {
-            *out = var->GetValue();
+            return 0;
         }
+        size_t peak = LuaAllocator::Get(m_pLuaState)->GetPeak();
+        return peak > m_baseUsage ? peak - m_baseUsage : 0;
     }
 
     /**
      * Recursively traverses a global table and creates LuaVar representations for each key/value pair.
      */
-    std::shared_ptr<LuaTable> LuaScript::GetGlobalTable(const std::string & key)
+    bool LuaScript::HasGlobal(const std::string & key)
+    {
+        if (m_pLuaState == nullptr)
+        {
+            return false;
+        }
+
+        int type = this->PushGlobal(key);
+        lua_pop(m_pLuaState, 1);
+        return type != LUA_TNIL;
+    }
+
+    std::shared_ptr<const LuaArena> LuaScript::GetGlobalTable(const std::string & key)
     {
+        if (m_pLuaState == nullptr)
+        {
+            LOG_ERR("LUA: Attempt to access global variable [", key, "] after the lua state was closed.");
+            return nullptr;
+        }
+
         int stack_top = lua_gettop(m_pLuaState);
 
         // load the global variable onto the stack
         // and verify it is actually a table.
-        int type = lua_getglobal(m_pLuaState, key.c_str());
+        int type = this->PushGlobal(key);
         if (type != LUA_TTABLE)
         {
             LOG_WARN("Attempt to access global variable [", key, "] as table failed, it is not a table, <", lua_typename(m_pLuaState, lua_type(m_pLuaState, -1)), "> detected.");
@@ -125,8 +214,20 @@ namespace alpha
             return nullptr;
         }
 
-        // Recurse the table key/values and build a table class
-        auto table = this->BuildTable(key, lua_gettop(m_pLuaState));
+        // the root table is the first value, its pairs and every nested table follow it
+        auto arena = std::make_shared<LuaArena>();
+        std::map<std::string, uint32_t> interned;
+        LuaArena::Value root;
+        root.type = VT_TABLE;
+        root.key = Intern(*arena, key.c_str(), key.size(), interned);
+        root.pairs.first = 0;
+        root.pairs.count = 0;
+        arena->m_values.push_back(root);
+
+        // Recurse the table key/values and build the arena
+        this->BuildTable(*arena, 0, lua_gettop(m_pLuaState), interned);
+        arena->m_values.shrink_to_fit();
+        arena->m_strings.shrink_to_fit();
 
         // pop the global table from the stack
         // so that we dont leave anything lingering...
@@ -137,71 +238,176 @@ namespace alpha
             LOG_ERR("Stack top should be ", stack_top, ", actual value is: ", lua_gettop(m_pLuaState));
         }
 
-        // cast and return the LuaTable
-        return std::dynamic_pointer_cast<LuaTable>(table);
+        return arena;
     }
 
-    std::shared_ptr<LuaVar> LuaScript::BuildTable(std::string table_name, int index)
+    bool LuaScript::Open()
     {
-        std::shared_ptr<LuaTable> table = std::make_shared<LuaTable>(table_name);
+        if (m_pLuaState != nullptr)
+        {
+            return true;
+        }
+        if (m_closed)
+        {
+            return false;
+        }
+
+        m_pLuaState = LuaStatePool::Acquire();
+        if (m_pLuaState == nullptr)
+        {
+            return false;
+        }
+        m_baseUsage = LuaAllocator::Get(m_pLuaState)->GetUsage();
+
+        // a fresh global table, reads of anything the script has not set fall through to the shared
+        // libraries, writes stay in this table.  the metatable is built once per pooled state.
+        lua_newtable(m_pLuaState);
+        if (luaL_newmetatable(m_pLuaState, sk_envMetatable))
+        {
+            lua_rawgeti(m_pLuaState, LUA_REGISTRYINDEX, LUA_RIDX_GLOBALS);
+            lua_setfield(m_pLuaState, -2, "__index");
+        }
+        lua_setmetatable(m_pLuaState, -2);
+        m_envRef = luaL_ref(m_pLuaState, LUA_REGISTRYINDEX);
+        return true;
+    }
+
+    bool LuaScript::LoadChunk(const char * pSource, size_t size)
+    {
+        const uint64_t key = LuaBytecodeCache::Hash(pSource, size);
+        if (auto bytecode = LuaBytecodeCache::Find(key))
+        {
+            if (luaL_loadbufferx(m_pLuaState, &(*bytecode)[0], bytecode->size(), "line", "b") == LUA_OK)
+            {
+                return true;
+            }
+
+            // built by a different lua, or cut short while being written, compile the source again
+            LOG_WARN("LUA: Discarding cached bytecode, ", lua_tostring(m_pLuaState, -1));
+            lua_pop(m_pLuaState, 1);
+            LuaBytecodeCache::Remove(key);
+        }
+
+        LOG("Attempting to load buffer data into LUA environment");
+        if (luaL_loadbufferx(m_pLuaState, pSource, size, "line", "t") != LUA_OK)
+        {
+            LOG_ERR("LUA: ", lua_tostring(m_pLuaState, -1));
+            lua_pop(m_pLuaState, 1);
+            return false;
+        }
+
+        // keep debug info, so errors raised by cached chunks still report line numbers
+        LuaBytecodeCache::Bytecode bytecode;
+        lua_dump(m_pLuaState, WriteBytecode, &bytecode, 0);
+        LuaBytecodeCache::Store(key, std::move(bytecode));
+        return true;
+    }
+
+    int LuaScript::PushGlobal(const std::string & key)
+    {
+        lua_rawgeti(m_pLuaState, LUA_REGISTRYINDEX, m_envRef);
+        lua_pushlstring(m_pLuaState, key.c_str(), key.size());
+        int type = lua_rawget(m_pLuaState, -2);
+        lua_remove(m_pLuaState, -2);
+        return type;
+    }
+
+    void LuaScript::BuildTable(LuaArena & arena, uint32_t slot, int index, std::map<std::string, uint32_t> & interned)
+    {
+        // key, value, a copy of either, and a nested table
+        lua_checkstack(m_pLuaState, 4);
+
+        const uint32_t first = static_cast<uint32_t>(arena.m_values.size());
 
         lua_pushnil(m_pLuaState);
         while (lua_next(m_pLuaState, index) != 0)
         {
             /* now 'key' at index -2, 'value' at index -1 */
-            std::string key = lua_tostring(m_pLuaState, -2);
+            // convert a copy of the key, converting a number key in place would confuse lua_next
+            size_t key_length = 0;
+            lua_pushvalue(m_pLuaState, -2);
+            const char * key = lua_tolstring(m_pLuaState, -1, &key_length);
+            if (key == nullptr)
+            {
+                LOG_WARN("Unsupported key type in table: ", lua_typename(m_pLuaState, lua_type(m_pLuaState, -3)));
+                lua_pop(m_pLuaState, 2);
+                continue;
+            }
+
+            LuaArena::Value value;
+            value.key = Intern(arena, key, key_length, interned);
+            lua_pop(m_pLuaState, 1);
 
-            // switch on the value type, and create LuaVar's depending on the type
-            // for now we only support basic types, and sub tables.  This could be
-            // expanded to support other values such as nil, or even functions.
+            // switch on the value type, for now we only support basic types, and sub tables.
+            // This could be expanded to support other values such as functions.
+            size_t length = 0;
+            const char * string = nullptr;
             switch (lua_type(m_pLuaState, -1))
             {
             case LUA_TSTRING:
-                table->Push(key, this->BuildString(key, lua_tostring(m_pLuaState, -1)));
+                string = lua_tolstring(m_pLuaState, -1, &length);
+                value.type = VT_STRING;
+                value.string = Intern(arena, string, length, interned);
                 break;
             case LUA_TNUMBER:
-                table->Push(key, this->BuildNumber(key, lua_tonumber(m_pLuaState, -1)));
+                value.type = VT_NUMBER;
+                value.number = lua_tonumber(m_pLuaState, -1);
                 break;
             case LUA_TBOOLEAN:
-                switch (lua_toboolean(m_pLuaState, -1))
-                {
-                case 0:
-                    table->Push(key, this->BuildBoolean(key, false));
-                    break;
-                case 1:
-                    table->Push(key, this->BuildBoolean(key, true));
-                    break;
-                default:
-                    LOG_WARN("Invalid boolean value, could not push to LuaTable");
-                }
+                value.type = VT_BOOLEAN;
+                value.boolean = lua_toboolean(m_pLuaState, -1) != 0;
                 break;
             case LUA_TTABLE:
-                // recurse to make a new table
-                table->Push(key, this->BuildTable(lua_tostring(m_pLuaState, -2), lua_gettop(m_pLuaState)));
+                // nested tables are built once this tables pairs are all in place, so each tables pairs
+                // stay one unbroken run.  until then the table is parked in the registry.
+                value.type = VT_TABLE;
+                lua_pushvalue(m_pLuaState, -1);
+                value.pairs.first = static_cast<uint32_t>(luaL_ref(m_pLuaState, LUA_REGISTRYINDEX));
+                value.pairs.count = 0;
                 break;
             default:
                 LOG_WARN("Unsupported type in table: ", lua_typename(m_pLuaState, lua_type(m_pLuaState, -1)));
+                lua_pop(m_pLuaState, 1);
+                continue;
             }
+            arena.m_values.push_back(value);
 
             /* pop value, not the key */
             lua_pop(m_pLuaState, 1);
         }
 
-        return table;
-    }
+        // sort the pairs by key, so lookups can binary search them
+        const uint32_t end = static_cast<uint32_t>(arena.m_values.size());
+        const std::vector<char> & strings = arena.m_strings;
+        std::sort(arena.m_values.begin() + first, arena.m_values.end(), [&strings](const LuaArena::Value & left, const LuaArena::Value & right)
+        {
+            return strcmp(&strings[left.key], &strings[right.key]) < 0;
+        });
+        arena.m_values[slot].pairs.first = first;
+        arena.m_values[slot].pairs.count = end - first;
 
-    std::shared_ptr<LuaVar> LuaScript::BuildString(std::string name, std::string value)
-    {
-        return std::shared_ptr<LuaVar>(new LuaStatic<std::string>(name, value));
-    }
+        for (uint32_t i = first; i < end; ++i)
+        {
+            if (arena.m_values[i].type == VT_TABLE)
+            {
+                int ref = static_cast<int>(arena.m_values[i].pairs.first);
+                lua_rawgeti(m_pLuaState, LUA_REGISTRYINDEX, ref);
+                luaL_unref(m_pLuaState, LUA_REGISTRYINDEX, ref);
 
-    std::shared_ptr<LuaVar> LuaScript::BuildNumber(std::string name, double value)
-    {
-        return std::shared_ptr<LuaVar>(new LuaStatic<double>(name, value));
+                this->BuildTable(arena, i, lua_gettop(m_pLuaState), interned);
+                lua_pop(m_pLuaState, 1);
+            }
+        }
     }
 
-    std::shared_ptr<LuaVar> LuaScript::BuildBoolean(std::string name, bool value)
+    uint32_t LuaScript::Intern(LuaArena & arena, const char * pString, size_t length, std::map<std::string, uint32_t> & interned)
     {
-        return std::shared_ptr<LuaVar>(new LuaStatic<bool>(name, value));
+        auto it = interned.insert(std::make_pair(std::string(pString, length), static_cast<uint32_t>(arena.m_strings.size())));
+        if (it.second)
+        {
+            arena.m_strings.insert(arena.m_strings.end(), pString, pString + length);
+            arena.m_strings.push_back('\0');
+        }
+        return it.first->second;
     }
 }
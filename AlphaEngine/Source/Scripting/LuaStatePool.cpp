@@ -0,0 +1,113 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+#include <thread>
+
+extern "C" {
+#include <lua.h>
+#include <lualib.h>
+#include <lauxlib.h>
+}
+
+#include "Scripting/LuaStatePool.h"
+#include "Scripting/LuaAllocator.h"
+#include "Toolbox/Logger.h"
+
+namespace alpha
+{
+    namespace
+    {
+        /** Called for errors raised outside a protected call, lua aborts once it returns */
+        int Panic(lua_State * pState)
+        {
+            LOG_ERR("LUA: Unprotected error, ", lua_tostring(pState, -1));
+            return 0;
+        }
+    }
+
+    std::mutex LuaStatePool::s_mutex;
+    std::vector<lua_State *> LuaStatePool::s_idle;
+    const size_t LuaStatePool::sk_maxIdle = std::max(2u, std::thread::hardware_concurrency());
+
+    lua_State * LuaStatePool::Acquire()
+    {
+        {
+            std::lock_guard<std::mutex> lock(s_mutex);
+            if (!s_idle.empty())
+            {
+                lua_State * pState = s_idle.back();
+                s_idle.pop_back();
+                return pState;
+            }
+        }
+
+        // build new states outside the lock, other threads can keep taking idle ones meanwhile
+        LuaAllocator * pAllocator = new LuaAllocator();
+        lua_State * pState = lua_newstate(&LuaAllocator::Allocate, pAllocator);
+        if (pState == nullptr)
+        {
+            LOG_ERR("LuaStatePool > Failed to create a lua state.");
+            delete pAllocator;
+            return nullptr;
+        }
+        lua_atpanic(pState, &Panic);
+        luaL_openlibs(pState);
+        return pState;
+    }
+
+    void LuaStatePool::Release(lua_State * pState)
+    {
+        if (pState == nullptr)
+        {
+            return;
+        }
+
+        // collect the last scripts garbage and lift its cap, so the next script starts from a clean count
+        LuaAllocator * pAllocator = LuaAllocator::Get(pState);
+        pAllocator->SetLimit(0);
+        lua_gc(pState, LUA_GCCOLLECT, 0);
+        pAllocator->ResetPeak();
+
+        {
+            std::lock_guard<std::mutex> lock(s_mutex);
+            if (s_idle.size() < sk_maxIdle)
+            {
+                s_idle.push_back(pState);
+                return;
+            }
+        }
+        Close(pState);
+    }
+
+    void LuaStatePool::Clear()
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        for (lua_State * pState : s_idle)
+        {
+            Close(pState);
+        }
+        s_idle.clear();
+    }
+
+    void LuaStatePool::Close(lua_State * pState)
+    {
+        // the allocator has to outlive the state, lua frees everything through it while closing
+        LuaAllocator * pAllocator = LuaAllocator::Get(pState);
+        lua_close(pState);
+        delete pAllocator;
+    }
+}
@@ -14,38 +14,99 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <algorithm>
+#include <cstring>
+
 #include "Scripting/LuaVar.h"
 
 namespace alpha
 {
-    LuaTable::LuaTable(const std::string & name)
-        : LuaVar(name)
+    LuaVar::LuaVar()
+        : m_pArena(nullptr)
+        , m_index(0)
+    { }
+    LuaVar::LuaVar(const LuaArena * pArena, uint32_t index)
+        : m_pArena(pArena)
+        , m_index(index)
     { }
-    LuaTable::~LuaTable() { }
 
-    LUA_VARTYPE LuaTable::GetVarType() const { return VT_TABLE; }
+    LUA_VARTYPE LuaVar::GetVarType() const
+    {
+        return m_pArena != nullptr ? m_pArena->m_values[m_index].type : VT_NIL;
+    }
 
-    void LuaTable::Push(std::string key, std::shared_ptr<LuaVar> value)
+    bool LuaVar::IsNil() const
     {
-        m_vars[key] = value;
+        return this->GetVarType() == VT_NIL;
     }
 
-    /**
-     * Find the LuaVar with the given key, if it exists (shallow search)
-     */
-    std::shared_ptr<LuaVar> LuaTable::Get(const std::string & key) const
+    bool LuaVar::IsTable() const
     {
-        auto search = m_vars.find(key);
-        if (search != m_vars.end())
+        return this->GetVarType() == VT_TABLE;
+    }
+
+    double LuaVar::GetNumber(double fallback) const
+    {
+        return this->GetVarType() == VT_NUMBER ? m_pArena->m_values[m_index].number : fallback;
+    }
+
+    bool LuaVar::GetBool(bool fallback) const
+    {
+        return this->GetVarType() == VT_BOOLEAN ? m_pArena->m_values[m_index].boolean : fallback;
+    }
+
+    const char * LuaVar::GetString(const char * fallback) const
+    {
+        return this->GetVarType() == VT_STRING ? &m_pArena->m_strings[m_pArena->m_values[m_index].string] : fallback;
+    }
+
+    size_t LuaVar::Size() const
+    {
+        return this->IsTable() ? m_pArena->m_values[m_index].pairs.count : 0;
+    }
+
+    const char * LuaVar::GetKey(size_t index) const
+    {
+        const uint32_t first = m_pArena->m_values[m_index].pairs.first;
+        return &m_pArena->m_strings[m_pArena->m_values[first + index].key];
+    }
+
+    LuaVar LuaVar::GetValue(size_t index) const
+    {
+        return LuaVar(m_pArena, m_pArena->m_values[m_index].pairs.first + static_cast<uint32_t>(index));
+    }
+
+    LuaVar LuaVar::Get(const char * key) const
+    {
+        if (!this->IsTable())
         {
-            return search->second;
+            return LuaVar();
         }
-        return nullptr;
+
+        // pairs are sorted by key, so a binary search over the run finds it
+        const LuaArena::Range & pairs = m_pArena->m_values[m_index].pairs;
+        auto begin = m_pArena->m_values.begin() + pairs.first;
+        auto end = begin + pairs.count;
+        const std::vector<char> & strings = m_pArena->m_strings;
+        auto it = std::lower_bound(begin, end, key, [&strings](const LuaArena::Value & value, const char * search)
+        {
+            return strcmp(&strings[value.key], search) < 0;
+        });
+
+        if (it != end && strcmp(&strings[it->key], key) == 0)
+        {
+            return LuaVar(m_pArena, static_cast<uint32_t>(it - m_pArena->m_values.begin()));
+        }
+        return LuaVar();
+    }
+
+    LuaVar LuaVar::Get(const std::string & key) const
+    {
+        return this->Get(key.c_str());
     }
 
-    //! Get all variables that exist in this LUA table
-    const std::map<std::string, std::shared_ptr<LuaVar> > & LuaTable::GetAll() const
+    LuaVar LuaArena::GetRoot() const
     {
-        return m_vars;
+        return m_values.empty() ? LuaVar() : LuaVar(this, 0);
     }
 }
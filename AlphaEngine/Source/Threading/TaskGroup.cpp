@@ -0,0 +1,101 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <thread>
+
+#include "Threading/TaskGroup.h"
+#include "Threading/ATask.h"
+#include "Threading/Task_RunGroup.h"
+#include "Threading/ThreadSystemEvents.h"
+
+namespace alpha
+{
+    TaskGroup::TaskGroup(std::vector<ATask *> tasks, std::shared_ptr<TaskGroup> pAfter)
+        : m_tasks(std::move(tasks))
+        , m_pAfter(pAfter)
+        , m_next(0)
+        , m_finished(0)
+    { }
+    TaskGroup::~TaskGroup()
+    {
+        for (ATask * pTask : m_tasks)
+        {
+            delete pTask;
+        }
+    }
+
+    std::shared_ptr<TaskGroup> TaskGroup::Publish(std::vector<ATask *> tasks, std::function<void(AEvent *)> delPublishEvent,
+                                                  std::shared_ptr<TaskGroup> pAfter)
+    {
+        if (tasks.empty())
+        {
+            return nullptr;
+        }
+
+        auto group = std::make_shared<TaskGroup>(std::move(tasks), pAfter);
+        for (size_t i = 0; i < group->Size(); ++i)
+        {
+            delPublishEvent(new Event_NewThreadTask(new Task_RunGroup(group)));
+        }
+        return group;
+    }
+
+    void TaskGroup::Run()
+    {
+        // nothing left to claim, so there is no reason to wait on the earlier group
+        if (m_next >= m_tasks.size())
+        {
+            return;
+        }
+
+        if (m_pAfter != nullptr)
+        {
+            m_pAfter->Wait();
+        }
+
+        for (size_t index = m_next++; index < m_tasks.size(); index = m_next++)
+        {
+            ATask * pTask = m_tasks[index];
+            pTask->Execute();
+            // a task that asks to be run again is repeated here, nothing else will pick it up
+            while (!pTask->IsComplete())
+            {
+                std::this_thread::yield();
+                pTask->Execute();
+            }
+            ++m_finished;
+        }
+    }
+
+    void TaskGroup::Wait()
+    {
+        this->Run();
+        while (!this->IsDone())
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    bool TaskGroup::IsDone() const
+    {
+        return m_finished == m_tasks.size();
+    }
+
+    size_t TaskGroup::Size() const
+    {
+        return m_tasks.size();
+    }
+}
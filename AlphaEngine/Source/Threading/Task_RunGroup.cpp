@@ -0,0 +1,31 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "Threading/Task_RunGroup.h"
+#include "Threading/TaskGroup.h"
+
+namespace alpha
+{
+    Task_RunGroup::Task_RunGroup(std::shared_ptr<TaskGroup> pGroup)
+        : m_pGroup(pGroup)
+    { }
+
+    bool Task_RunGroup::VExecute()
+    {
+        m_pGroup->Run();
+        return true;
+    }
+}
@@ -19,6 +19,8 @@ limitations under the License.
 #include "Graphics/GeometryPass.h"
 #include "Graphics/Camera.h"
 #include "Graphics/Light.h"
+#include "Graphics/Material.h"
+#include "Graphics/ParticleEmitter.h"
 #include "Graphics/RenderSet.h"
 #include "Graphics/Renderable.h"
 #include "Assets/AssetSystem.h"
@@ -30,6 +32,10 @@ namespace alpha
     GeometryPass::GeometryPass()
         : m_shaderProgram(0)
         , m_gBuffer(0)
+        , m_particleProgram(0)
+        , m_particleVertexAttribute(0)
+        , m_particleQuadBuffer(0)
+        , m_particleInstanceBuffer(0)
     {
         for (int i = 0; i < GBUFFER_TEXTURE_COUNT; ++i)
         {
@@ -76,11 +82,51 @@ namespace alpha
         }
         glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
 
+        // particles are camera facing quads, drawn instanced from a shared set of corners
+        m_vsParticleShader = pAssetSystem->GetAsset("Shaders/gl_particle_vs.glsl");
+        m_particleProgram = CreateShaderProgram(m_vsParticleShader, m_psShader);
+
+        const GLfloat corners[] = { -0.5f, -0.5f, 0.5f, -0.5f, -0.5f, 0.5f, 0.5f, 0.5f };
+
+        glGenVertexArrays(1, &m_particleVertexAttribute);
+        glGenBuffers(1, &m_particleQuadBuffer);
+        glGenBuffers(1, &m_particleInstanceBuffer);
+
+        glBindVertexArray(m_particleVertexAttribute);
+
+            glBindBuffer(GL_ARRAY_BUFFER, m_particleQuadBuffer);
+            glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), (GLvoid*)0);
+
+            // one position and size per particle, advanced once per instance
+            glBindBuffer(GL_ARRAY_BUFFER, m_particleInstanceBuffer);
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (GLvoid*)0);
+            glVertexAttribDivisor(1, 1);
+
+        glBindVertexArray(0);
+
         return true;
     }
 
     bool GeometryPass::VShutdown()
     {
+        if (m_particleVertexAttribute != 0)
+        {
+            glDeleteVertexArrays(1, &m_particleVertexAttribute);
+            m_particleVertexAttribute = 0;
+        }
+        if (m_particleQuadBuffer != 0)
+        {
+            glDeleteBuffers(1, &m_particleQuadBuffer);
+            m_particleQuadBuffer = 0;
+        }
+        if (m_particleInstanceBuffer != 0)
+        {
+            glDeleteBuffers(1, &m_particleInstanceBuffer);
+            m_particleInstanceBuffer = 0;
+        }
         return true;
     }
 
@@ -110,12 +156,22 @@ namespace alpha
             // attach object matrix values
             glUniformMatrix4fv(glGetUniformLocation(m_shaderProgram, "world"), 1, GL_FALSE, &rs->worldTransform.m_11);
 
+            // skinned sets upload their bone palette once, for every mesh in the set
+            const bool skinned = !rs->bonePalette.empty();
+            if (skinned)
+            {
+                glUniformMatrix4fv(glGetUniformLocation(m_shaderProgram, "bones"), static_cast<GLsizei>(rs->bonePalette.size()), GL_FALSE, &rs->bonePalette[0].m_11);
+            }
+
             // set object color information
             glUniform3f(glGetUniformLocation(m_shaderProgram, "diffuse"), diffuse.x, diffuse.y, diffuse.z);
             glUniform1f(glGetUniformLocation(m_shaderProgram, "specular"), specular);
 
             for (Renderable * renderable : rs->GetRenderables())
             {
+                // only meshes with bone weights can be skinned
+                glUniform1i(glGetUniformLocation(m_shaderProgram, "skinned"), (skinned && renderable->m_weightBuffer != 0) ? 1 : 0);
+
                 // bind vertices to array object
                 glBindVertexArray(renderable->m_vertexAttribute);
 
@@ -131,6 +187,56 @@ namespace alpha
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
     }
     
+    void GeometryPass::RenderParticles(std::shared_ptr<Camera> pCamera, std::vector<ParticleEmitter *> emitters)
+    {
+        if (emitters.empty())
+        {
+            return;
+        }
+
+        // draw on top of the geometry already in the gbuffer
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_gBuffer);
+        glUseProgram(m_particleProgram);
+
+        Matrix view = pCamera->GetView();
+        Matrix proj = pCamera->GetProjection();
+
+        glUniformMatrix4fv(glGetUniformLocation(m_particleProgram, "view"), 1, GL_FALSE, &view.m_11);
+        glUniformMatrix4fv(glGetUniformLocation(m_particleProgram, "projection"), 1, GL_FALSE, &proj.m_11);
+
+        glBindVertexArray(m_particleVertexAttribute);
+        glBindBuffer(GL_ARRAY_BUFFER, m_particleInstanceBuffer);
+
+        for (ParticleEmitter * emitter : emitters)
+        {
+            const size_t count = emitter->GetCount();
+            if (count == 0)
+            {
+                continue;
+            }
+
+            Vector4 diffuse(1.f, 1.f, 1.f, 1.f);
+            float specular = 0.f;
+            if (auto material = emitter->material.lock())
+            {
+                diffuse = material->GetDiffuse();
+                specular = material->GetSpecularCoefficient();
+            }
+            glUniform3f(glGetUniformLocation(m_particleProgram, "diffuse"), diffuse.x, diffuse.y, diffuse.z);
+            glUniform1f(glGetUniformLocation(m_particleProgram, "specular"), specular);
+
+            // orphan last emitters data rather than wait for its draw to finish, then upload this emitters particles
+            const std::vector<float> & instances = emitter->GetInstanceData();
+            glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(float), nullptr, GL_STREAM_DRAW);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(float), instances.data());
+
+            glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(count));
+        }
+
+        glBindVertexArray(0);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
     GLuint GeometryPass::GetGBufferTexture(GBUFFER_TYPE texture_type)
     {
         return m_gBufferTextures[texture_type];
@@ -151,13 +151,59 @@ namespace alpha
                     // Vertex Normals
                     glEnableVertexAttribArray(1);
                     glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (GLvoid*)offsetof(Vertex, normal));
+
+                    // skinned meshes keep their bone weights in a second vertex buffer
+                    if (!renderable->weights.empty())
+                    {
+                        glGenBuffers(1, &renderable->m_weightBuffer);
+                        glBindBuffer(GL_ARRAY_BUFFER, renderable->m_weightBuffer);
+                        glBufferData(GL_ARRAY_BUFFER, renderable->weights.size() * sizeof(VertexWeights), renderable->weights.data(), GL_STATIC_DRAW);
+
+                        // Bone indices, read as integers
+                        glEnableVertexAttribArray(2);
+                        glVertexAttribIPointer(2, 4, GL_UNSIGNED_BYTE, sizeof(VertexWeights), (GLvoid*)offsetof(VertexWeights, bones));
+
+                        // Bone weights
+                        glEnableVertexAttribArray(3);
+                        glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(VertexWeights), (GLvoid*)offsetof(VertexWeights, weights));
+                    }
                 
                 glBindVertexArray(0);
             }
         }
     }
 
-    void GraphicsRenderer::Render(std::shared_ptr<Camera> pCamera, std::vector<RenderSet *> render_sets, std::vector<Light *> lights)
+    void GraphicsRenderer::Release(RenderSet * renderSet)
+    {
+        auto renderables = renderSet->GetRenderables();
+
+        for (Renderable * renderable : renderables)
+        {
+            if (renderable->m_vertexAttribute != 0)
+            {
+                glDeleteVertexArrays(1, &renderable->m_vertexAttribute);
+                renderable->m_vertexAttribute = 0;
+            }
+            if (renderable->m_vertexBuffer != 0)
+            {
+                glDeleteBuffers(1, &renderable->m_vertexBuffer);
+                renderable->m_vertexBuffer = 0;
+            }
+            if (renderable->m_elementBuffer != 0)
+            {
+                glDeleteBuffers(1, &renderable->m_elementBuffer);
+                renderable->m_elementBuffer = 0;
+            }
+            if (renderable->m_weightBuffer != 0)
+            {
+                glDeleteBuffers(1, &renderable->m_weightBuffer);
+                renderable->m_weightBuffer = 0;
+            }
+        }
+    }
+
+    void GraphicsRenderer::Render(std::shared_ptr<Camera> pCamera, std::vector<RenderSet *> render_sets, std::vector<Light *> lights,
+                                  std::vector<ParticleEmitter *> particles)
     {
         auto window = m_pWindow->GetWindow();
 
@@ -166,6 +212,8 @@ namespace alpha
 
         // render to gbuffer textures
         m_pGeometryPass->VRender(pCamera, render_sets, lights);
+        // particles are lit like any other geometry, so they go into the gbuffer too
+        m_pGeometryPass->RenderParticles(pCamera, particles);
         // Render gbuffer textures to screen with lighting
         m_pLightingPass->VRender(pCamera, render_sets, lights);
 
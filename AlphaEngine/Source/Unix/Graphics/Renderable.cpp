@@ -18,10 +18,12 @@ limitations under the License.
 
 namespace alpha
 {
-    Renderable::Renderable(std::vector<Vertex> vertexList, std::vector<unsigned int> indexList)
+    Renderable::Renderable(std::vector<Vertex> vertexList, std::vector<unsigned int> indexList, std::vector<VertexWeights> weightList)
         : vertices(vertexList)
         , indices(indexList)
+        , weights(weightList)
         , m_vertexBuffer(0)
+        , m_weightBuffer(0)
         , m_vertexAttribute(0)
         , m_elementBuffer(0)
     { }
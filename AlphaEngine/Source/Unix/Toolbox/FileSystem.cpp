@@ -14,9 +14,12 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <errno.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string>
 #include <cstring>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include "Toolbox/FileSystem.h"
@@ -63,4 +66,14 @@ namespace alpha
 
         return path;
     }
+
+    bool OSCreateDirectory(const char * path)
+    {
+        return mkdir(path, 0755) == 0 || errno == EEXIST;
+    }
+
+    bool OSReplaceFile(const char * from, const char * to)
+    {
+        return rename(from, to) == 0;
+    }
 }
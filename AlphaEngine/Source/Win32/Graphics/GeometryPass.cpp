@@ -14,24 +14,38 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <algorithm>
+#include <cstring>
+
 #include <DirectXColors.h>
 
 #include "Graphics/GeometryPass.h"
 #include "Graphics/Camera.h"
 #include "Graphics/RenderSet.h"
 #include "Graphics/Renderable.h"
+#include "Graphics/Material.h"
+#include "Graphics/ParticleEmitter.h"
 #include "Assets/AssetSystem.h"
 #include "Assets/Asset.h"
 #include "Math/Matrix_Conversions.h"
 
 namespace alpha
 {
+    const unsigned int GeometryPass::sk_maxParticleInstances = 65536;
+
     GeometryPass::GeometryPass()
         : m_pVertexShader(nullptr)
         , m_pInputLayout(nullptr)
         , m_pPixelShader(nullptr)
+        , m_pSkinnedVertexShader(nullptr)
+        , m_pSkinnedInputLayout(nullptr)
         , m_pMatrixBuffer(nullptr)
         , m_pDeferredBuffer(nullptr)
+        , m_pBoneBuffer(nullptr)
+        , m_pParticleVertexShader(nullptr)
+        , m_pParticleInputLayout(nullptr)
+        , m_pParticleQuadBuffer(nullptr)
+        , m_pParticleInstanceBuffer(nullptr)
     {
         for (int i = 0; i < GBUFFER_TEXTURE_COUNT; ++i)
         {
@@ -65,6 +79,22 @@ namespace alpha
             m_pInputLayout = this->CreateInputLayoutFromVSBlob(pD3DDevice, layout, numElements, &pVSBlob);
             pVSBlob->Release();
         }
+        // skinning vertex shader, bone weights come from a second vertex buffer
+        ID3DBlob* pSkinnedVSBlob = nullptr;
+        m_pSkinnedVertexShader = this->CreateVertexShaderFromAsset(pD3DDevice, pVSShader, "VS_Skinned", &pSkinnedVSBlob);
+        if (pSkinnedVSBlob != nullptr)
+        {
+            D3D11_INPUT_ELEMENT_DESC layout[] =
+            {
+                { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+                { "NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+                { "BLENDINDICES", 0, DXGI_FORMAT_R8G8B8A8_UINT, 1, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+                { "BLENDWEIGHT", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+            };
+            UINT numElements = ARRAYSIZE(layout);
+            m_pSkinnedInputLayout = this->CreateInputLayoutFromVSBlob(pD3DDevice, layout, numElements, &pSkinnedVSBlob);
+            pSkinnedVSBlob->Release();
+        }
         // pixel shader
         m_pPixelShader = this->CreatePixelShaderFromAsset(pD3DDevice, pPSShader, "PS");
 
@@ -159,18 +189,76 @@ namespace alpha
         // create pixel/vertex shader constant buffers
         this->CreateBuffer(pD3DDevice, sizeof(MatrixBuffer), D3D11_BIND_CONSTANT_BUFFER, nullptr, &m_pMatrixBuffer);
         this->CreateBuffer(pD3DDevice, sizeof(DeferredBuffer), D3D11_BIND_CONSTANT_BUFFER, nullptr, &m_pDeferredBuffer);
+        this->CreateBuffer(pD3DDevice, sizeof(BoneBuffer), D3D11_BIND_CONSTANT_BUFFER, nullptr, &m_pBoneBuffer);
+
+        // particles are camera facing quads, drawn instanced from a shared set of corners
+        auto pParticleVSShader = pAssetSystem->GetAsset("Shaders/dx_particle_vs.hlsl");
+        ID3DBlob* pParticleVSBlob = nullptr;
+        m_pParticleVertexShader = this->CreateVertexShaderFromAsset(pD3DDevice, pParticleVSShader, "VS", &pParticleVSBlob);
+        if (pParticleVSBlob != nullptr)
+        {
+            D3D11_INPUT_ELEMENT_DESC layout[] =
+            {
+                { "POSITION", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+                // one position and size per particle, advanced once per instance
+                { "TEXCOORD", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 0, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+            };
+            UINT numElements = ARRAYSIZE(layout);
+            m_pParticleInputLayout = this->CreateInputLayoutFromVSBlob(pD3DDevice, layout, numElements, &pParticleVSBlob);
+            pParticleVSBlob->Release();
+        }
+
+        const float corners[] = { -0.5f, -0.5f, -0.5f, 0.5f, 0.5f, -0.5f, 0.5f, 0.5f };
+        this->CreateBuffer(pD3DDevice, sizeof(corners), D3D11_BIND_VERTEX_BUFFER, corners, &m_pParticleQuadBuffer);
+
+        // the instance buffer is rewritten every draw, so it has to be cpu writable
+        D3D11_BUFFER_DESC instance_desc;
+        ZeroMemory(&instance_desc, sizeof(instance_desc));
+        instance_desc.Usage = D3D11_USAGE_DYNAMIC;
+        instance_desc.ByteWidth = sk_maxParticleInstances * 4 * sizeof(float);
+        instance_desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+        instance_desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+        hr = pD3DDevice->CreateBuffer(&instance_desc, nullptr, &m_pParticleInstanceBuffer);
+        if (FAILED(hr)) { return false; }
 
         return true;
     }
 
     bool GeometryPass::VShutdown()
     {
+        if (m_pParticleInstanceBuffer)
+        {
+            m_pParticleInstanceBuffer->Release();
+            m_pParticleInstanceBuffer = nullptr;
+        }
+        if (m_pParticleQuadBuffer)
+        {
+            m_pParticleQuadBuffer->Release();
+            m_pParticleQuadBuffer = nullptr;
+        }
+        if (m_pParticleInputLayout)
+        {
+            m_pParticleInputLayout->Release();
+            m_pParticleInputLayout = nullptr;
+        }
+        if (m_pParticleVertexShader)
+        {
+            m_pParticleVertexShader->Release();
+            m_pParticleVertexShader = nullptr;
+        }
+
         if (m_pDeferredBuffer)
         {
             m_pDeferredBuffer->Release();
             m_pDeferredBuffer = nullptr;
         }
 
+        if (m_pBoneBuffer)
+        {
+            m_pBoneBuffer->Release();
+            m_pBoneBuffer = nullptr;
+        }
+
         if (m_pMatrixBuffer)
         {
             m_pMatrixBuffer->Release();
@@ -225,6 +313,16 @@ namespace alpha
             m_pPixelShader->Release();
             m_pPixelShader = nullptr;
         }
+        if (m_pSkinnedInputLayout)
+        {
+            m_pSkinnedInputLayout->Release();
+            m_pSkinnedInputLayout = nullptr;
+        }
+        if (m_pSkinnedVertexShader)
+        {
+            m_pSkinnedVertexShader->Release();
+            m_pSkinnedVertexShader = nullptr;
+        }
 
         return true;
     }
@@ -263,8 +361,21 @@ namespace alpha
             cb.specular = material->GetSpecularCoefficient();
             pDeviceContext->UpdateSubresource(m_pDeferredBuffer, 0, nullptr, &cb, 0, 0);
 
+            // skinned sets upload their bone palette once, for every mesh in the set
+            const bool skinned = !render_set->bonePalette.empty() && m_pSkinnedVertexShader != nullptr && m_pSkinnedInputLayout != nullptr;
+            if (skinned)
+            {
+                BoneBuffer bb;
+                const size_t count = std::min<size_t>(render_set->bonePalette.size(), Skeleton::sk_maxBones);
+                for (size_t i = 0; i < count; ++i)
+                {
+                    bb.mBones[i] = DirectX::XMMatrixTranspose(MatrixToXMMATRIX(render_set->bonePalette[i]));
+                }
+                pDeviceContext->UpdateSubresource(m_pBoneBuffer, 0, nullptr, &bb, 0, 0);
+                pDeviceContext->VSSetConstantBuffers(1, 1, &m_pBoneBuffer);
+            }
+
             // apply constant buffers to shaders
-            pDeviceContext->VSSetShader(m_pVertexShader, nullptr, 0);
             pDeviceContext->VSSetConstantBuffers(0, 1, &m_pMatrixBuffer);
             pDeviceContext->PSSetShader(m_pPixelShader, nullptr, 0);
             pDeviceContext->PSSetConstantBuffers(0, 1, &m_pMatrixBuffer);
@@ -272,13 +383,28 @@ namespace alpha
 
             for (auto renderable : renderables)
             {
-                // set input layout
-                pDeviceContext->IASetInputLayout(m_pInputLayout);
-
-                // Set vertex buffer
-                UINT stride = sizeof(Vertex);
-                UINT offset = 0;
-                pDeviceContext->IASetVertexBuffers(0, 1, &renderable->m_pVertexBuffer, &stride, &offset);
+                // only meshes with bone weights can be skinned
+                if (skinned && renderable->m_pWeightBuffer != nullptr)
+                {
+                    pDeviceContext->VSSetShader(m_pSkinnedVertexShader, nullptr, 0);
+                    pDeviceContext->IASetInputLayout(m_pSkinnedInputLayout);
+
+                    ID3D11Buffer * buffers[2] = { renderable->m_pVertexBuffer, renderable->m_pWeightBuffer };
+                    UINT strides[2] = { sizeof(Vertex), sizeof(VertexWeights) };
+                    UINT offsets[2] = { 0, 0 };
+                    pDeviceContext->IASetVertexBuffers(0, 2, buffers, strides, offsets);
+                }
+                else
+                {
+                    pDeviceContext->VSSetShader(m_pVertexShader, nullptr, 0);
+                    // set input layout
+                    pDeviceContext->IASetInputLayout(m_pInputLayout);
+
+                    // Set vertex buffer
+                    UINT stride = sizeof(Vertex);
+                    UINT offset = 0;
+                    pDeviceContext->IASetVertexBuffers(0, 1, &renderable->m_pVertexBuffer, &stride, &offset);
+                }
                 // Set index buffer
                 pDeviceContext->IASetIndexBuffer(renderable->m_pIndexBuffer, DXGI_FORMAT_R32_UINT, 0);
                 // Set primitive topology
@@ -290,6 +416,71 @@ namespace alpha
         }
     }
 
+    void GeometryPass::RenderParticles(ID3D11DeviceContext * pDeviceContext, std::shared_ptr<Camera> pCamera, std::vector<ParticleEmitter *> emitters)
+    {
+        if (emitters.empty() || m_pParticleVertexShader == nullptr || m_pParticleInputLayout == nullptr)
+        {
+            return;
+        }
+
+        // particles are already in world space, so only the view and projection matter
+        MatrixBuffer mb;
+        mb.mWorld = DirectX::XMMatrixIdentity();
+        mb.mView = DirectX::XMMatrixTranspose(MatrixToXMMATRIX(pCamera->GetView()));
+        mb.mProjection = DirectX::XMMatrixTranspose(MatrixToXMMATRIX(pCamera->GetProjection()));
+        pDeviceContext->UpdateSubresource(m_pMatrixBuffer, 0, nullptr, &mb, 0, 0);
+
+        pDeviceContext->VSSetShader(m_pParticleVertexShader, nullptr, 0);
+        pDeviceContext->VSSetConstantBuffers(0, 1, &m_pMatrixBuffer);
+        pDeviceContext->PSSetShader(m_pPixelShader, nullptr, 0);
+        pDeviceContext->PSSetConstantBuffers(0, 1, &m_pMatrixBuffer);
+        pDeviceContext->PSSetConstantBuffers(1, 1, &m_pDeferredBuffer);
+
+        pDeviceContext->IASetInputLayout(m_pParticleInputLayout);
+        pDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+
+        ID3D11Buffer * buffers[2] = { m_pParticleQuadBuffer, m_pParticleInstanceBuffer };
+        UINT strides[2] = { 2 * sizeof(float), 4 * sizeof(float) };
+        UINT offsets[2] = { 0, 0 };
+        pDeviceContext->IASetVertexBuffers(0, 2, buffers, strides, offsets);
+
+        for (ParticleEmitter * emitter : emitters)
+        {
+            const size_t count = emitter->GetCount();
+            if (count == 0)
+            {
+                continue;
+            }
+
+            DeferredBuffer cb;
+            cb.diffuse = Vector4(1.f, 1.f, 1.f, 1.f);
+            cb.specular = 0.f;
+            if (auto material = emitter->material.lock())
+            {
+                cb.diffuse = material->GetDiffuse();
+                cb.specular = material->GetSpecularCoefficient();
+            }
+            pDeviceContext->UpdateSubresource(m_pDeferredBuffer, 0, nullptr, &cb, 0, 0);
+
+            // upload and draw in chunks the size of the instance buffer, discarding the last chunk each time
+            const float * instances = emitter->GetInstanceData().data();
+            for (size_t first = 0; first < count; first += sk_maxParticleInstances)
+            {
+                const UINT chunk = static_cast<UINT>(std::min<size_t>(sk_maxParticleInstances, count - first));
+
+                D3D11_MAPPED_SUBRESOURCE mapped;
+                if (FAILED(pDeviceContext->Map(m_pParticleInstanceBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped)))
+                {
+                    return;
+                }
+                memcpy(mapped.pData, instances + first * 4, chunk * 4 * sizeof(float));
+                pDeviceContext->Unmap(m_pParticleInstanceBuffer, 0);
+
+                pDeviceContext->DrawInstanced(4, chunk, 0, 0);
+            }
+        }
+    }
+
     ID3D11ShaderResourceView ** GeometryPass::GetShaderResourceViews()
     {
         return m_pShaderResourceViews;
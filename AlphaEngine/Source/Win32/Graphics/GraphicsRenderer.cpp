@@ -148,10 +148,40 @@ namespace alpha
                 this->CreateBuffer(sizeof(Vertex) * renderable->vertices.size(), D3D11_BIND_VERTEX_BUFFER, &renderable->vertices[0], &renderable->m_pVertexBuffer);
                 this->CreateBuffer(sizeof(unsigned int) * renderable->indices.size(), D3D11_BIND_INDEX_BUFFER, &renderable->indices[0], &renderable->m_pIndexBuffer);
             }
+            // skinned meshes keep their bone weights in a second vertex buffer
+            if (renderable->m_pWeightBuffer == nullptr && !renderable->weights.empty())
+            {
+                this->CreateBuffer(sizeof(VertexWeights) * renderable->weights.size(), D3D11_BIND_VERTEX_BUFFER, &renderable->weights[0], &renderable->m_pWeightBuffer);
+            }
+        }
+    }
+
+    void GraphicsRenderer::Release(RenderSet * renderSet)
+    {
+        auto renderables = renderSet->GetRenderables();
+
+        for (Renderable * renderable : renderables)
+        {
+            if (renderable->m_pVertexBuffer != nullptr)
+            {
+                renderable->m_pVertexBuffer->Release();
+                renderable->m_pVertexBuffer = nullptr;
+            }
+            if (renderable->m_pIndexBuffer != nullptr)
+            {
+                renderable->m_pIndexBuffer->Release();
+                renderable->m_pIndexBuffer = nullptr;
+            }
+            if (renderable->m_pWeightBuffer != nullptr)
+            {
+                renderable->m_pWeightBuffer->Release();
+                renderable->m_pWeightBuffer = nullptr;
+            }
         }
     }
 
-    void GraphicsRenderer::Render(std::shared_ptr<Camera> pCamera, std::vector<RenderSet *> renderables, std::vector<Light *> lights)
+    void GraphicsRenderer::Render(std::shared_ptr<Camera> pCamera, std::vector<RenderSet *> renderables, std::vector<Light *> lights,
+                                  std::vector<ParticleEmitter *> particles)
     {
         // Clear PS Shader resources, so the textures are un-bound and can be used as a render target again
         m_pImmediateContext->PSSetShaderResources(0, 1, &m_pNULLShaderResourceView);
@@ -162,6 +192,8 @@ namespace alpha
         m_pGeometryPass->VSetRenderTarget(m_pImmediateContext);
         m_pGeometryPass->VClearRenderTarget(m_pImmediateContext);
         m_pGeometryPass->VRender(m_pImmediateContext, pCamera, renderables, lights);
+        // particles are lit like any other geometry, so they go into the gbuffer too
+        m_pGeometryPass->RenderParticles(m_pImmediateContext, pCamera, particles);
 
         // switch back to render to back buffer
         m_pImmediateContext->OMSetRenderTargets(1, &m_pRenderTargetView, m_pDepthStencilView);
@@ -18,15 +18,18 @@ limitations under the License.
 
 namespace alpha
 {
-    Renderable::Renderable(std::vector<Vertex> vertexList, std::vector<unsigned int> indexList)
+    Renderable::Renderable(std::vector<Vertex> vertexList, std::vector<unsigned int> indexList, std::vector<VertexWeights> weightList)
         : vertices(vertexList)
         , indices(indexList)
+        , weights(weightList)
         , m_pVertexBuffer(nullptr)
+        , m_pWeightBuffer(nullptr)
         , m_pIndexBuffer(nullptr)
     { }
     Renderable::~Renderable()
     {
         if (m_pVertexBuffer) m_pVertexBuffer->Release();
+        if (m_pWeightBuffer) m_pWeightBuffer->Release();
         if (m_pIndexBuffer) m_pIndexBuffer->Release();
     }
 }
@@ -53,4 +53,14 @@ namespace alpha
 
         return path;
     }
+
+    bool OSCreateDirectory(const char * path)
+    {
+        return CreateDirectory(path, NULL) != 0 || GetLastError() == ERROR_ALREADY_EXISTS;
+    }
+
+    bool OSReplaceFile(const char * from, const char * to)
+    {
+        return MoveFileEx(from, to, MOVEFILE_REPLACE_EXISTING) != 0;
+    }
 }
@@ -0,0 +1,36 @@
+-- Copyright 2014-2015 Jason R. Wendlandt
+--
+-- Licensed under the Apache License, Version 2.0 (the "License");
+-- you may not use this file except in compliance with the License.
+-- You may obtain a copy of the License at
+--
+-- http://www.apache.org/licenses/LICENSE-2.0
+--
+-- Unless required by applicable law or agreed to in writing, software
+-- distributed under the License is distributed on an "AS IS" BASIS,
+-- WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+-- See the License for the specific language governing permissions and
+-- limitations under the License.
+
+-- component data table
+components = {
+	root = {
+		type = "particle_emitter",
+		transform = {
+			position = { x = 0.0, y = 0.0, z = 0.0 },
+			rotation = { x = 0.0, y = 0.0, z = 0.0 },
+			scale = { x = 1.0, y = 1.0, z = 1.0 }
+		},
+		material = "Materials/lightyellow.lua",
+		-- particles are simulated and drawn by the graphics system, not as entities
+		max_particles = 20000,
+		rate = 5000.0,
+		lifetime = { min = 1.5, max = 3.0 },
+		speed = { min = 6.0, max = 9.0 },
+		-- half angle of the launch cone, in radians
+		spread = 0.3,
+		direction = { x = 0.0, y = 1.0, z = 0.0 },
+		gravity = { x = 0.0, y = -9.8, z = 0.0 },
+		size = 0.1,
+	}
+}
@@ -17,6 +17,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include "Entities/ComponentHandle.h"
 #include "Entities/Entity.h"
 
 #include "FSA/GameState.h"
@@ -37,6 +38,9 @@ private:
     std::shared_ptr<alpha::Entity> m_pCamera;
     std::shared_ptr<alpha::Entity> m_pLight;
     std::shared_ptr<alpha::Entity> m_pLight2;
+
+    /** The orbiting lights root component, resolved once in VInitialize */
+    alpha::ComponentHandle<alpha::SceneComponent> m_light2Root;
 };
 
 #endif // DEMO_GAME_STATE_H
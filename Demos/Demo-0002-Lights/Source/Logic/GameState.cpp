@@ -17,6 +17,7 @@ limitations under the License.
 #include "Logic/GameState.h"
 #include "Entities/EntityComponent.h"
 #include "Entities/CameraComponent.h"
+#include "Entities/LightComponent.h"
 #include "Entities/MeshComponent.h"
 
 GameState::GameState()
@@ -55,7 +56,8 @@ bool GameState::VInitialize()
     }
 
     // move second light forward and left
-    if (auto pLightComp = std::dynamic_pointer_cast<alpha::SceneComponent>(m_pLight2->Get("root")))
+    m_light2Root = m_pLight2->GetComponent<alpha::LightComponent>("root");
+    if (alpha::SceneComponent * pLightComp = m_light2Root.Get())
     {
         pLightComp->SetPosition(alpha::Vector3(0.f, -1.f, -4.f));
     }
@@ -66,7 +68,7 @@ bool GameState::VInitialize()
 bool GameState::VUpdate(double currentTime, double /*elapsedTime*/)
 {
     // rotate the light in a circle around the origin about the y axis
-    if (auto pLightComp = std::dynamic_pointer_cast<alpha::SceneComponent>(m_pLight2->Get("root")))
+    if (alpha::SceneComponent * pLightComp = m_light2Root.Get())
     {
         float degrees = static_cast<float>(currentTime * 10);
         float radians = static_cast<float>(degrees * (3.14 / 180));
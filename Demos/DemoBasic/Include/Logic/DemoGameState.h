@@ -17,6 +17,8 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include "Entities/CameraComponent.h"
+#include "Entities/ComponentHandle.h"
 #include "Entities/Entity.h"
 
 #include "FSA/GameState.h"
@@ -51,9 +53,21 @@ private:
     std::shared_ptr<alpha::Entity> m_cube;
     std::shared_ptr<alpha::Entity> m_pLight;
     std::shared_ptr<alpha::Entity> m_pLight2;
+    std::shared_ptr<alpha::Entity> m_pFountain;
 
     std::shared_ptr<alpha::Entity> m_pCamera;
 
+    /** Components touched every update, resolved once in VInitialize */
+    alpha::ComponentHandle<alpha::SceneComponent> m_testRoot;
+    alpha::ComponentHandle<alpha::SceneComponent> m_test2Root;
+    alpha::ComponentHandle<alpha::CameraComponent> m_cameraRoot;
+
+    /** Animations playing on the test models */
+    alpha::AnimationHandle m_spin;
+    alpha::AnimationHandle m_swing;
+    /** Number of times the swing has reversed, the test sound plays on each reversal */
+    unsigned int m_swingLoops;
+
     std::weak_ptr<alpha::Sound> m_pTestSound;
 
     DemoContext * m_pInputContext;
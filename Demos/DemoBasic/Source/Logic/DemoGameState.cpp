@@ -7,6 +7,8 @@
 #include "Entities/Entity.h"
 #include "Entities/EntityComponent.h"
 #include "Entities/CameraComponent.h"
+#include "Entities/MeshComponent.h"
+#include "Animation/AnimationTrack.h"
 #include "Math/Quaternion.h"
 #include "Math/Vector3.h"
 #include "Audio/Sound.h"
@@ -14,7 +16,8 @@
 #include "Toolbox/Logger.h"
 
 DemoGameState::DemoGameState()
-    : m_pInputContext(nullptr)
+    : m_swingLoops(0)
+    , m_pInputContext(nullptr)
     , m_strafeLeft(false)
     , m_strafeRight(false)
     , m_moveForward(false)
@@ -26,12 +29,26 @@ bool DemoGameState::VInitialize()
 {
     // setup the state, make actors, etc.
 
-    m_test = CreateEntity("Entities/test.lua");
-    m_test2 = CreateEntity("Entities/test.lua");
+    auto tests = CreateEntities("Entities/test.lua", 2);
+    if (tests.size() < 2)
+    {
+        // the log macros expect to be used from inside the alpha namespace
+        using namespace alpha;
+        LOG_ERR("DemoGameState: failed to create the test entities from Entities/test.lua");
+        return false;
+    }
+    m_test = tests[0];
+    m_test2 = tests[1];
     m_cube = CreateEntity("Entities/cube.lua");
     m_pCamera = CreateEntity("Entities/camera.lua");
     m_pLight = CreateEntity("Entities/directional_light.lua");
     m_pLight2 = CreateEntity("Entities/light.lua");
+    m_pFountain = CreateEntity("Entities/fountain.lua");
+
+    // resolve the components we touch every update once, instead of looking them up each frame
+    m_testRoot = m_test->GetComponent<alpha::MeshComponent>("root");
+    m_test2Root = m_test2->GetComponent<alpha::MeshComponent>("root");
+    m_cameraRoot = m_pCamera->GetComponent<alpha::CameraComponent>("root");
 
     // set our camera as the active camera for the scene
     auto pCameraComponent = std::dynamic_pointer_cast<alpha::CameraComponent>(m_pCamera->Get("root"));
@@ -62,6 +79,28 @@ bool DemoGameState::VInitialize()
         root->SetPosition(alpha::Vector3(-5, -5, 0));
     }
 
+    // put the particle fountain below the scene
+    root = std::dynamic_pointer_cast<alpha::SceneComponent>(m_pFountain->Get("root"));
+    if (root != nullptr)
+    {
+        root->SetPosition(alpha::Vector3(0, -8, 0));
+    }
+
+    // spin the first model a full turn every 24 seconds, keys are a third of a turn apart so each
+    // pair blends the short way around
+    auto spin = std::make_shared<alpha::AnimationTrack>(alpha::AC_ROTATION);
+    for (int key = 0; key <= 3; ++key)
+    {
+        float radians = key * 120.f * (3.14159f / 180.f);
+        spin->AddKey(key * 8.f, alpha::Quaternion::RotationFromAxisAngle(alpha::Vector3(0, 0, -1), radians));
+    }
+    m_spin = PlayAnimation(m_testRoot, spin, alpha::AL_LOOP);
+
+    // swing the second model back and forth between 45 and 135 degrees
+    alpha::Quaternion q45 = alpha::Quaternion::RotationFromAxisAngle(alpha::Vector3(0, 0, 1), 45 * (3.14159f / 180.f));
+    alpha::Quaternion q135 = alpha::Quaternion::RotationFromAxisAngle(alpha::Vector3(0, 0, 1), 135 * (3.14159f / 180.f));
+    m_swing = PlayAnimation(m_test2Root, alpha::AnimationTrack::Tween(q45, q135, 2.f, alpha::AE_EASE_IN_OUT), alpha::AL_PING_PONG);
+
     // create a test sound to play
     m_pTestSound = this->CreateSound("Media/hit.wav");
     if (auto pSound = m_pTestSound.lock())
@@ -84,67 +123,22 @@ bool DemoGameState::VUpdate(double /*currentTime*/, double elapsedTime)
 {
     // Update the state, move actors, shoot bullets, blah blah
 
-    // get root node and rotate it
-    // I know root is a scene component, so cast it
-    auto root = std::dynamic_pointer_cast<alpha::SceneComponent>(m_test->Get("root"));
-    auto root2 = std::dynamic_pointer_cast<alpha::SceneComponent>(m_test2->Get("root"));
-
-    // but just in case, check before doing anything
-    if (root != nullptr && root2 != nullptr)
+    // whenever the swinging model reaches a reversal point, play the test sound
+    unsigned int swing_loops = GetAnimationLoops(m_swing);
+    if (swing_loops != m_swingLoops)
     {
-        //float t = static_cast<float>(currentTime); // / 100.0f;
-        static int tick = 0;
-        tick += 1;
-
-        float degrees = static_cast<float>(tick / 4);
-        float radians = static_cast<float>(degrees * (3.14 / 180));
-
-        alpha::Quaternion q1 = alpha::Quaternion::RotationFromAxisAngle(alpha::Vector3(0, 0, -1), radians);
-        root->SetRotation(q1);
-
-        // slerp back and forth between 45 degrees and 135 degrees
-        static alpha::Quaternion q90 = alpha::Quaternion::RotationFromAxisAngle(alpha::Vector3(0, 0, 1), 135 * (3.14f / 180.f));
-        static alpha::Quaternion q00 = alpha::Quaternion::RotationFromAxisAngle(alpha::Vector3(0, 0, 1), 45 * (3.14f / 180.f));
-        static alpha::Quaternion q2end = q90;
-        static float slerpTime = 0.0f;
-
-        alpha::Quaternion q2start = root2->GetRotation();
-        if (q2start == q00)
-        {
-            // got back to 00
-            q2end = q90;
-            slerpTime = 0.001f;
-
-            // whenever we reach a target reversal point, play the test sound
-            if (auto pSound = m_pTestSound.lock())
-            {
-                pSound->Stop();
-                pSound->Play();
-            }
-        }
-        if (q2start == q90)
+        m_swingLoops = swing_loops;
+        if (auto pSound = m_pTestSound.lock())
         {
-            // got to 90 degrees
-            q2end = q00;
-            slerpTime = 0.001f;
-
-            // whenever we reach a target reversal point, play the test sound
-            if (auto pSound = m_pTestSound.lock())
-            {
-                pSound->Stop();
-                pSound->Play();
-            }
+            pSound->Stop();
+            pSound->Play();
         }
-        alpha::Quaternion q2slerp = alpha::Quaternion::Slerp(q2start, q2end, slerpTime);
-        root2->SetRotation(q2slerp);
-        slerpTime += static_cast<float>(elapsedTime) / 45.f;
     }
 
     // update camera position based on user input
     if (m_strafeLeft || m_strafeRight || m_moveForward || m_moveBack)
     {
-        auto camera = std::dynamic_pointer_cast<alpha::CameraComponent>(m_pCamera->Get("root"));
-        if (camera)
+        if (alpha::CameraComponent * camera = m_cameraRoot.Get())
         {
             alpha::Vector3 direction = camera->GetPosition();
             float speed = 1;
@@ -192,8 +186,8 @@ std::shared_ptr<alpha::AState> DemoGameState::VShutdown()
     }
 
     // Remove any actors that are no longer needed
-    DestroyEntity(m_test->GetId());
-    DestroyEntity(m_test2->GetId());
+    DestroyEntity(m_test->GetHandle());
+    DestroyEntity(m_test2->GetHandle());
 
     // return the next game state, or nullptr for end of state machine
     return nullptr;
@@ -0,0 +1,50 @@
+#ifndef ALPHA_TEST_CHECK_H
+#define ALPHA_TEST_CHECK_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <iostream>
+
+/**
+ * Minimal checks for the unit tests.
+ *
+ * Each test is its own executable, CHECK logs every failed expression and counts it, and main
+ * returns TEST_RESULT() so ctest sees a non-zero exit code when anything failed.
+ */
+namespace alpha
+{
+    namespace test
+    {
+        inline int & FailureCount()
+        {
+            static int failures = 0;
+            return failures;
+        }
+    }
+}
+
+#define CHECK(expr) \
+    do { \
+        if (!(expr)) { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #expr ") failed" << std::endl; \
+            ++alpha::test::FailureCount(); \
+        } \
+    } while (false)
+
+#define TEST_RESULT() (alpha::test::FailureCount() == 0 ? 0 : 1)
+
+#endif // ALPHA_TEST_CHECK_H
@@ -0,0 +1,74 @@
+#ifndef ALPHA_TEST_SCRIPT_H
+#define ALPHA_TEST_SCRIPT_H
+
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <sys/stat.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include "Assets/Asset.h"
+#include "Scripting/LuaScript.h"
+#include "Scripting/LuaVar.h"
+
+namespace alpha
+{
+    namespace test
+    {
+        /**
+         * A script built from source text.  The source is written to a file in the working directory, so it is
+         * loaded through an Asset the same way as any game script, and the file is removed again once loaded.
+         */
+        class TestScript : public LuaScript
+        {
+        public:
+            TestScript(const std::string & fileName, const std::string & source)
+                : m_path(fileName)
+            {
+                FILE * fp = fopen(m_path.c_str(), "wb");
+                if (fp != nullptr)
+                {
+                    fwrite(source.data(), 1, source.size(), fp);
+                    fclose(fp);
+                }
+
+                struct stat file_stats;
+                if (stat(m_path.c_str(), &file_stats) == 0)
+                {
+                    // the asset keeps the path pointer, so it points at a member that lives as long as the script
+                    this->Add(std::make_shared<Asset>(m_path.c_str(), file_stats));
+                }
+            }
+
+            /** Load and run the script, then hand back one of its global tables, null if it is not a table */
+            std::shared_ptr<const LuaArena> RunAndGet(const std::string & key)
+            {
+                this->Load();
+                std::remove(m_path.c_str());
+                this->Run();
+                return this->GetGlobalTable(key);
+            }
+
+        private:
+            std::string m_path;
+        };
+    }
+}
+
+#endif // ALPHA_TEST_SCRIPT_H
@@ -0,0 +1,174 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "TestCheck.h"
+#include "TestScript.h"
+#include "Entities/ComponentSchema.h"
+
+using namespace alpha;
+using alpha::test::TestScript;
+
+namespace
+{
+    enum TestShape
+    {
+        TS_BOX,
+        TS_SPHERE,
+        TS_CAPSULE,
+    };
+
+    /** Every kind of field, each with a default that is easy to tell apart from a parsed value */
+    struct TestDescriptor
+    {
+        TestDescriptor()
+            : radius(-1.f)
+            , count(99)
+            , visible(false)
+            , name("default")
+            , shape(TS_BOX)
+            , position(-1.f, -1.f, -1.f)
+            , hasPhysics(false)
+            , mass(-1.f)
+        { }
+
+        float radius;
+        unsigned int count;
+        bool visible;
+        std::string name;
+        int shape;
+        Vector3 position;
+        std::map<std::string, std::string> textures;
+        bool hasPhysics;
+        float mass;
+    };
+
+    const ComponentSchema<TestDescriptor> & GetSchema()
+    {
+        static ComponentSchema<TestDescriptor> schema;
+        static bool built = false;
+        if (!built)
+        {
+            const TestDescriptor & layout = schema.Layout();
+            schema.AddFloat("radius", layout.radius);
+            schema.AddUInt("count", layout.count);
+            schema.AddBool("visible", layout.visible);
+            schema.AddString("name", layout.name);
+
+            std::map<std::string, int> shapes;
+            shapes["box"] = TS_BOX;
+            shapes["sphere"] = TS_SPHERE;
+            shapes["capsule"] = TS_CAPSULE;
+            schema.AddEnum("shape", layout.shape, shapes);
+
+            schema.AddVector3("transform.position", layout.position);
+            schema.AddStringMap("textures", layout.textures);
+            schema.AddTableFlag("physics", layout.hasPhysics);
+            schema.AddFloat("physics.mass", layout.mass);
+            built = true;
+        }
+        return schema;
+    }
+
+    /** Parse the global table called component from a script */
+    bool ParseScript(const std::string & source, TestDescriptor & descriptor)
+    {
+        TestScript script("component_schema_test.lua", source);
+        auto table = script.RunAndGet("component");
+        return table != nullptr && GetSchema().Parse(table->GetRoot(), descriptor);
+    }
+
+    void TestEveryField()
+    {
+        TestDescriptor descriptor;
+        CHECK(ParseScript(
+            "component = {\n"
+            "    radius = 2.5, count = 7, visible = true, name = 'crate', shape = 'capsule',\n"
+            "    transform = { position = { x = 1, y = 2, z = 3 } },\n"
+            "    textures = { diffuse = 'crate.png', normal = 'crate_n.png' },\n"
+            "    physics = { mass = 12 },\n"
+            "}\n", descriptor));
+
+        CHECK(descriptor.radius == 2.5f);
+        CHECK(descriptor.count == 7);
+        CHECK(descriptor.visible);
+        CHECK(descriptor.name == "crate");
+        CHECK(descriptor.shape == TS_CAPSULE);
+        CHECK(descriptor.position.x == 1.f && descriptor.position.y == 2.f && descriptor.position.z == 3.f);
+        CHECK(descriptor.textures.size() == 2);
+        CHECK(descriptor.textures["diffuse"] == "crate.png");
+        CHECK(descriptor.textures["normal"] == "crate_n.png");
+        CHECK(descriptor.hasPhysics);
+        CHECK(descriptor.mass == 12.f);
+    }
+
+    void TestDefaultsKept()
+    {
+        // missing keys, values of the wrong type, and unknown enum values all leave the defaults alone
+        TestDescriptor descriptor;
+        CHECK(ParseScript(
+            "component = {\n"
+            "    radius = 'wide', visible = 1, name = 5, shape = 'cone',\n"
+            "    transform = { position = { y = 4 } },\n"
+            "    textures = { diffuse = 3, specular = 'shiny.png' },\n"
+            "}\n", descriptor));
+
+        TestDescriptor defaults;
+        CHECK(descriptor.radius == defaults.radius);
+        CHECK(descriptor.count == defaults.count);
+        CHECK(descriptor.visible == defaults.visible);
+        CHECK(descriptor.name == defaults.name);
+        CHECK(descriptor.shape == defaults.shape);
+        CHECK(descriptor.position.x == -1.f && descriptor.position.y == 4.f && descriptor.position.z == -1.f);
+        CHECK(descriptor.textures.size() == 1 && descriptor.textures["specular"] == "shiny.png");
+        CHECK(!descriptor.hasPhysics);
+        CHECK(descriptor.mass == defaults.mass);
+    }
+
+    void TestEdgeCases()
+    {
+        // negative counts are clamped, an empty table still raises its flag, unknown keys are skipped
+        // wherever they sort, and a field where a table is expected is ignored
+        TestDescriptor descriptor;
+        CHECK(ParseScript(
+            "component = {\n"
+            "    aaa = 1, count = -3, physics = {}, zzz = { radius = 9 }, transform = 6, radius = 1,\n"
+            "}\n", descriptor));
+
+        CHECK(descriptor.count == 0);
+        CHECK(descriptor.hasPhysics);
+        CHECK(descriptor.mass == -1.f);
+        CHECK(descriptor.radius == 1.f);
+        CHECK(descriptor.position.x == -1.f);
+
+        // only a table can be parsed
+        TestDescriptor untouched;
+        CHECK(!ParseScript("component = 5\n", untouched));
+        CHECK(!GetSchema().Parse(LuaVar(), untouched));
+        CHECK(untouched.name == "default");
+    }
+}
+
+int main()
+{
+    TestEveryField();
+    TestDefaultsKept();
+    TestEdgeCases();
+    return TEST_RESULT();
+}
@@ -0,0 +1,224 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+#include "TestCheck.h"
+#include "Math/AABB.h"
+#include "Math/Frustum.h"
+#include "Math/Matrix.h"
+#include "Toolbox/DynamicAABBTree.h"
+
+using namespace alpha;
+
+namespace
+{
+    AABB Box(float x, float y, float z, float half)
+    {
+        return AABB(Vector3(x - half, y - half, z - half), Vector3(x + half, y + half, z + half));
+    }
+
+    std::vector<int> QueryAll(const DynamicAABBTree<int> & tree, const AABB & box)
+    {
+        std::vector<int> found;
+        tree.Query(box, [&found](int value) { found.push_back(value); });
+        std::sort(found.begin(), found.end());
+        return found;
+    }
+
+    /** Brute force answer for a box query against the fat boxes the tree holds */
+    std::vector<int> BruteForce(const DynamicAABBTree<int> & tree, const std::vector<int> & proxies, const AABB & box)
+    {
+        std::vector<int> found;
+        for (size_t i = 0; i < proxies.size(); ++i)
+        {
+            if (proxies[i] >= 0 && tree.GetFatAABB(proxies[i]).Overlaps(box))
+            {
+                found.push_back(static_cast<int>(i));
+            }
+        }
+        return found;
+    }
+
+    void TestQueries()
+    {
+        DynamicAABBTree<int> tree(0.f);
+        CHECK(tree.GetHeight() == 0);
+        CHECK(QueryAll(tree, Box(0.f, 0.f, 0.f, 100.f)).empty());
+
+        tree.CreateProxy(Box(0.f, 0.f, 0.f, 1.f), 0);
+        tree.CreateProxy(Box(10.f, 0.f, 0.f, 1.f), 1);
+        tree.CreateProxy(Box(0.f, 10.f, 0.f, 1.f), 2);
+
+        std::vector<int> found = QueryAll(tree, Box(0.f, 0.f, 0.f, 2.f));
+        CHECK(found.size() == 1 && found[0] == 0);
+
+        found = QueryAll(tree, Box(5.f, 5.f, 0.f, 6.f));
+        CHECK(found.size() == 3);
+
+        std::vector<int> spheres;
+        tree.Query(Vector3(10.f, 0.f, 0.f), 0.5f, [&spheres](int value) { spheres.push_back(value); });
+        CHECK(spheres.size() == 1 && spheres[0] == 1);
+    }
+
+    void TestMoveAndDestroy()
+    {
+        DynamicAABBTree<int> tree(0.5f);
+        int a = tree.CreateProxy(Box(0.f, 0.f, 0.f, 1.f), 0);
+        int b = tree.CreateProxy(Box(20.f, 0.f, 0.f, 1.f), 1);
+
+        // a small move stays inside the fat box, a large one re-inserts the proxy
+        CHECK(!tree.MoveProxy(a, Box(0.25f, 0.f, 0.f, 1.f)));
+        CHECK(tree.MoveProxy(a, Box(20.f, 20.f, 0.f, 1.f)));
+        std::vector<int> found = QueryAll(tree, Box(0.f, 0.f, 0.f, 2.f));
+        CHECK(found.empty());
+        found = QueryAll(tree, Box(20.f, 20.f, 0.f, 2.f));
+        CHECK(found.size() == 1 && found[0] == 0);
+
+        tree.DestroyProxy(b);
+        CHECK(QueryAll(tree, Box(20.f, 0.f, 0.f, 2.f)).empty());
+        tree.DestroyProxy(a);
+        CHECK(tree.GetHeight() == 0);
+    }
+
+    void TestAgainstBruteForce()
+    {
+        std::srand(7);
+        DynamicAABBTree<int> tree(0.1f);
+        std::vector<int> proxies;
+        for (int i = 0; i < 500; ++i)
+        {
+            float x = static_cast<float>(std::rand() % 200) - 100.f;
+            float y = static_cast<float>(std::rand() % 200) - 100.f;
+            float z = static_cast<float>(std::rand() % 200) - 100.f;
+            proxies.push_back(tree.CreateProxy(Box(x, y, z, 1.f + static_cast<float>(std::rand() % 4)), i));
+        }
+
+        // shuffle some around and drop some, the tree must still agree with a linear scan
+        for (int i = 0; i < 500; i += 3)
+        {
+            float x = static_cast<float>(std::rand() % 200) - 100.f;
+            tree.MoveProxy(proxies[i], Box(x, 0.f, 0.f, 2.f));
+        }
+        for (int i = 0; i < 500; i += 7)
+        {
+            tree.DestroyProxy(proxies[i]);
+            proxies[i] = -1;
+        }
+
+        // balancing keeps the tree far shallower than a list
+        CHECK(tree.GetHeight() < 40);
+
+        for (int q = 0; q < 50; ++q)
+        {
+            float x = static_cast<float>(std::rand() % 200) - 100.f;
+            float y = static_cast<float>(std::rand() % 200) - 100.f;
+            AABB box = Box(x, y, 0.f, 20.f);
+            CHECK(QueryAll(tree, box) == BruteForce(tree, proxies, box));
+        }
+    }
+
+    void TestRaycast()
+    {
+        DynamicAABBTree<int> tree(0.f);
+        tree.CreateProxy(Box(10.f, 0.f, 0.f, 1.f), 0);
+        tree.CreateProxy(Box(20.f, 0.f, 0.f, 1.f), 1);
+        tree.CreateProxy(Box(0.f, 10.f, 0.f, 1.f), 2);
+
+        std::vector<int> hits;
+        std::vector<float> distances;
+        tree.Raycast(Vector3(0.f, 0.f, 0.f), Vector3(1.f, 0.f, 0.f), 100.f, [&](int value, float distance)
+        {
+            hits.push_back(value);
+            distances.push_back(distance);
+        });
+        CHECK(hits.size() == 2);
+        for (size_t i = 0; i < hits.size(); ++i)
+        {
+            CHECK(std::fabs(distances[i] - (hits[i] == 0 ? 9.f : 19.f)) < 1e-4f);
+        }
+
+        // the max distance stops the ray short of the second box
+        hits.clear();
+        tree.Raycast(Vector3(0.f, 0.f, 0.f), Vector3(1.f, 0.f, 0.f), 15.f, [&hits](int value, float) { hits.push_back(value); });
+        CHECK(hits.size() == 1 && hits[0] == 0);
+
+        // queries can be nested, each traversal keeps its own stack
+        size_t inner = 0;
+        tree.Query(Box(0.f, 0.f, 0.f, 100.f), [&tree, &inner](int)
+        {
+            tree.Query(Box(0.f, 0.f, 0.f, 100.f), [&inner](int) { ++inner; });
+        });
+        CHECK(inner == 9);
+    }
+
+    void TestSlabEdges()
+    {
+        const float inf = std::numeric_limits<float>::infinity();
+        AABB box(Vector3(0.f, 0.f, 0.f), Vector3(1.f, 1.f, 1.f));
+        float distance = -1.f;
+
+        // a ray parallel to x, starting exactly on the y = 0 face plane, used to produce 0 * inf = NaN
+        CHECK(box.Raycast(Vector3(-1.f, 0.f, 0.5f), Vector3(1.f, inf, inf), 10.f, &distance));
+        CHECK(std::fabs(distance - 1.f) < 1e-6f);
+
+        // parallel to x but outside the y slab misses
+        CHECK(!box.Raycast(Vector3(-1.f, 2.f, 0.5f), Vector3(1.f, inf, inf), 10.f, &distance));
+
+        // starting inside reports a distance of 0
+        CHECK(box.Raycast(Vector3(0.5f, 0.5f, 0.5f), Vector3(inf, inf, 1.f), 10.f, &distance));
+        CHECK(distance == 0.f);
+
+        // pointing away misses
+        CHECK(!box.Raycast(Vector3(-1.f, 0.5f, 0.5f), Vector3(-1.f, inf, inf), 10.f, &distance));
+    }
+
+    void TestFrustum()
+    {
+        // the default camera, pushed 20 units along z, with a 0.1 to 100 view range
+        Frustum view(Matrix::Translate(Vector3(0.f, 0.f, 20.f)) * Matrix::Projection(45.f, 4.f / 3.f, 0.1f, 100.f));
+        CHECK(view.Overlaps(Box(0.f, 0.f, 0.f, 1.f)));
+        CHECK(!view.Overlaps(Box(0.f, 0.f, -40.f, 1.f)));
+        CHECK(!view.Overlaps(Box(0.f, 0.f, 200.f, 1.f)));
+        CHECK(!view.Overlaps(Box(500.f, 0.f, 0.f, 1.f)));
+
+        // the default frustum keeps everything
+        CHECK(Frustum().Overlaps(Box(1000.f, -1000.f, 1000.f, 1.f)));
+
+        DynamicAABBTree<int> tree(0.f);
+        tree.CreateProxy(Box(0.f, 0.f, 0.f, 1.f), 0);
+        tree.CreateProxy(Box(0.f, 0.f, -40.f, 1.f), 1);
+        tree.CreateProxy(Box(500.f, 0.f, 0.f, 1.f), 2);
+        std::vector<int> visible;
+        tree.Query(view, [&visible](int value) { visible.push_back(value); });
+        CHECK(visible.size() == 1 && visible[0] == 0);
+    }
+}
+
+int main()
+{
+    TestQueries();
+    TestMoveAndDestroy();
+    TestAgainstBruteForce();
+    TestRaycast();
+    TestSlabEdges();
+    TestFrustum();
+    return TEST_RESULT();
+}
@@ -0,0 +1,148 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <memory>
+#include <vector>
+
+#include "TestCheck.h"
+#include "Entities/Entity.h"
+#include "Entities/EntityHandle.h"
+#include "Entities/EntityQuery.h"
+#include "Entities/LightComponent.h"
+#include "Entities/MeshComponent.h"
+
+using namespace alpha;
+
+namespace
+{
+    /** An entity at the given slot with a mesh, and a light if asked for */
+    std::shared_ptr<Entity> MakeEntity(uint32_t index, bool light)
+    {
+        auto entity = std::make_shared<Entity>(nullptr);
+        entity->SetHandle(EntityHandle(index, 1));
+        entity->Add(EntityComponent::GetIDFromName("mesh"), std::make_shared<MeshComponent>());
+        if (light)
+        {
+            entity->Add(EntityComponent::GetIDFromName("light"), std::make_shared<LightComponent>());
+        }
+        return entity;
+    }
+
+    EntityQuery MakeQuery()
+    {
+        std::vector<unsigned int> type_ids;
+        type_ids.push_back(GetComponentTypeID<LightComponent>());
+        type_ids.push_back(GetComponentTypeID<MeshComponent>());
+        type_ids.push_back(GetComponentTypeID<LightComponent>());
+        return EntityQuery(type_ids);
+    }
+
+    /** Is the entity in the view, with its own components in its row */
+    bool Contains(const EntityQuery & query, const std::shared_ptr<Entity> & entity)
+    {
+        for (size_t i = 0; i < query.Size(); ++i)
+        {
+            if (query.GetEntity(i) == entity.get())
+            {
+                return query.Get<MeshComponent>(i) == entity->GetOfType(GetComponentTypeID<MeshComponent>()).get() &&
+                       query.Get<LightComponent>(i) == entity->GetOfType(GetComponentTypeID<LightComponent>()).get();
+            }
+        }
+        return false;
+    }
+
+    void TestAdd()
+    {
+        EntityQuery query = MakeQuery();
+        CHECK(query.GetTypeIDs().size() == 2);
+        CHECK(query.Empty());
+
+        auto lit = MakeEntity(1, true);
+        auto unlit = MakeEntity(2, false);
+        CHECK(query.TryAdd(lit));
+        CHECK(!query.TryAdd(unlit));
+        CHECK(!query.TryAdd(lit));
+        CHECK(!query.TryAdd(nullptr));
+
+        // a failed match leaves no partial row behind
+        CHECK(query.Size() == 1);
+        CHECK(query.GetComponentRows().size() == 2);
+        CHECK(Contains(query, lit));
+        CHECK(!Contains(query, unlit));
+    }
+
+    void TestRemove()
+    {
+        EntityQuery query = MakeQuery();
+        std::vector<std::shared_ptr<Entity> > entities;
+        for (uint32_t i = 0; i < 5; ++i)
+        {
+            entities.push_back(MakeEntity(i, true));
+            CHECK(query.TryAdd(entities.back()));
+        }
+        CHECK(query.Size() == 5);
+
+        // removing the last entry only drops the tail
+        query.Remove(entities[4]->GetHandle());
+        CHECK(query.Size() == 4);
+        CHECK(!Contains(query, entities[4]));
+        for (size_t i = 0; i < 4; ++i)
+        {
+            CHECK(Contains(query, entities[i]));
+        }
+
+        // removing a middle entry moves the last one into its place
+        query.Remove(entities[1]->GetHandle());
+        CHECK(query.Size() == 3);
+        CHECK(query.GetEntity(1) == entities[3].get());
+        CHECK(!Contains(query, entities[1]));
+        CHECK(Contains(query, entities[0]) && Contains(query, entities[2]) && Contains(query, entities[3]));
+
+        // the moved entry was re-indexed, so it can still be removed
+        query.Remove(entities[3]->GetHandle());
+        CHECK(query.Size() == 2);
+        CHECK(!Contains(query, entities[3]));
+        CHECK(Contains(query, entities[0]) && Contains(query, entities[2]));
+
+        // unknown and already removed handles are ignored
+        query.Remove(entities[1]->GetHandle());
+        query.Remove(EntityHandle(42, 1));
+        CHECK(query.Size() == 2);
+
+        // a removed entity can be added again
+        CHECK(query.TryAdd(entities[1]));
+        CHECK(query.Size() == 3);
+        CHECK(Contains(query, entities[1]));
+
+        query.Remove(entities[0]->GetHandle());
+        query.Remove(entities[2]->GetHandle());
+        query.Remove(entities[1]->GetHandle());
+        CHECK(query.Empty());
+        CHECK(query.GetComponentRows().empty());
+
+        CHECK(query.TryAdd(entities[4]));
+        query.Clear();
+        CHECK(query.Empty());
+        CHECK(query.TryAdd(entities[4]));
+    }
+}
+
+int main()
+{
+    TestAdd();
+    TestRemove();
+    return TEST_RESULT();
+}
@@ -0,0 +1,215 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cstring>
+#include <vector>
+
+extern "C" {
+#include <lua.h>
+#include <lauxlib.h>
+#include <lualib.h>
+}
+
+#include "TestCheck.h"
+#include "Scripting/LuaAllocator.h"
+
+using namespace alpha;
+
+namespace
+{
+    void * Allocate(LuaAllocator & allocator, void * pBlock, size_t oldSize, size_t newSize)
+    {
+        return LuaAllocator::Allocate(&allocator, pBlock, oldSize, newSize);
+    }
+
+    /** Fill a block with a pattern that depends on the seed, to check its contents survive a move */
+    void Fill(void * pBlock, size_t size, unsigned char seed)
+    {
+        unsigned char * pBytes = static_cast<unsigned char *>(pBlock);
+        for (size_t i = 0; i < size; ++i)
+        {
+            pBytes[i] = static_cast<unsigned char>(seed + i);
+        }
+    }
+
+    bool Holds(const void * pBlock, size_t size, unsigned char seed)
+    {
+        const unsigned char * pBytes = static_cast<const unsigned char *>(pBlock);
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (pBytes[i] != static_cast<unsigned char>(seed + i))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void TestUsage()
+    {
+        const size_t reserved = LuaAllocator::GetReservedTotal();
+        {
+            LuaAllocator allocator;
+            CHECK(allocator.GetUsage() == 0);
+
+            // with no block, lua passes the type of object as the old size, which must not be counted
+            void * pSmall = Allocate(allocator, nullptr, LUA_TTABLE, 24);
+            CHECK(pSmall != nullptr);
+            CHECK(allocator.GetUsage() == 24);
+
+            void * pLarge = Allocate(allocator, nullptr, 0, 1000);
+            CHECK(pLarge != nullptr);
+            CHECK(allocator.GetUsage() == 1024);
+            CHECK(allocator.GetPeak() == 1024);
+            CHECK(LuaAllocator::GetReservedTotal() > reserved);
+
+            Allocate(allocator, pLarge, 1000, 0);
+            CHECK(allocator.GetUsage() == 24);
+            CHECK(allocator.GetPeak() == 1024);
+            allocator.ResetPeak();
+            CHECK(allocator.GetPeak() == 24);
+
+            Allocate(allocator, pSmall, 24, 0);
+            CHECK(allocator.GetUsage() == 0);
+        }
+        // every chunk and large block went back to the system
+        CHECK(LuaAllocator::GetReservedTotal() == reserved);
+    }
+
+    void TestResize()
+    {
+        const size_t reserved = LuaAllocator::GetReservedTotal();
+        {
+            LuaAllocator allocator;
+
+            // within a size class the block stays where it is
+            void * pBlock = Allocate(allocator, nullptr, 0, 17);
+            Fill(pBlock, 17, 1);
+            void * pSame = Allocate(allocator, pBlock, 17, 32);
+            CHECK(pSame == pBlock);
+            CHECK(Holds(pSame, 17, 1));
+
+            // across classes, pooled to pooled, then pooled to large, then large to large
+            Fill(pSame, 32, 2);
+            void * pBigger = Allocate(allocator, pSame, 32, 200);
+            CHECK(pBigger != nullptr && Holds(pBigger, 32, 2));
+            Fill(pBigger, 200, 3);
+            void * pLarge = Allocate(allocator, pBigger, 200, 4000);
+            CHECK(pLarge != nullptr && Holds(pLarge, 200, 3));
+            Fill(pLarge, 4000, 4);
+            void * pLarger = Allocate(allocator, pLarge, 4000, 9000);
+            CHECK(pLarger != nullptr && Holds(pLarger, 4000, 4));
+            CHECK(allocator.GetUsage() == 9000);
+
+            // and back down, large to pooled keeps the bytes that still fit
+            void * pShrunk = Allocate(allocator, pLarger, 9000, 100);
+            CHECK(pShrunk != nullptr && Holds(pShrunk, 100, 4));
+            CHECK(allocator.GetUsage() == 100);
+
+            Allocate(allocator, pShrunk, 100, 0);
+            CHECK(allocator.GetUsage() == 0);
+        }
+        // the large block is not left counted, or held, once it has shrunk into the pool
+        CHECK(LuaAllocator::GetReservedTotal() == reserved);
+    }
+
+    void TestRecycling()
+    {
+        LuaAllocator allocator;
+        void * pFirst = Allocate(allocator, nullptr, 0, 48);
+        void * pSecond = Allocate(allocator, nullptr, 0, 48);
+        CHECK(pFirst != pSecond);
+
+        // a freed block is handed out again for any size in its class
+        Allocate(allocator, pFirst, 48, 0);
+        void * pReused = Allocate(allocator, nullptr, 0, 40);
+        CHECK(pReused == pFirst);
+
+        Allocate(allocator, pReused, 40, 0);
+        Allocate(allocator, pSecond, 48, 0);
+        CHECK(allocator.GetUsage() == 0);
+    }
+
+    void TestLimit()
+    {
+        LuaAllocator allocator;
+        allocator.SetLimit(256);
+        CHECK(allocator.GetLimit() == 256);
+
+        void * pBlock = Allocate(allocator, nullptr, 0, 200);
+        CHECK(pBlock != nullptr);
+        CHECK(Allocate(allocator, nullptr, 0, 100) == nullptr);
+        CHECK(Allocate(allocator, pBlock, 200, 300) == nullptr);
+        CHECK(allocator.GetUsage() == 200);
+
+        // shrinking never fails, even once the limit is lowered below what is in use
+        allocator.SetLimit(64);
+        void * pShrunk = Allocate(allocator, pBlock, 200, 100);
+        CHECK(pShrunk != nullptr);
+        CHECK(allocator.GetUsage() == 100);
+
+        allocator.SetLimit(0);
+        void * pGrown = Allocate(allocator, pShrunk, 100, 5000);
+        CHECK(pGrown != nullptr);
+        Allocate(allocator, pGrown, 5000, 0);
+        CHECK(allocator.GetUsage() == 0);
+    }
+
+    void TestState()
+    {
+        const size_t reserved = LuaAllocator::GetReservedTotal();
+        {
+            LuaAllocator allocator;
+            lua_State * pState = lua_newstate(&LuaAllocator::Allocate, &allocator);
+            CHECK(pState != nullptr);
+            CHECK(LuaAllocator::Get(pState) == &allocator);
+
+            luaL_openlibs(pState);
+            const char * source = "local t = {} for i = 1, 1000 do t[i] = tostring(i) end result = #t";
+            CHECK(luaL_dostring(pState, source) == 0);
+            lua_getglobal(pState, "result");
+            CHECK(lua_tointeger(pState, -1) == 1000);
+            CHECK(allocator.GetUsage() > 0);
+            CHECK(allocator.GetPeak() >= allocator.GetUsage());
+
+            // a capped state raises a memory error in the script, and keeps working afterwards
+            allocator.SetLimit(allocator.GetUsage() + 4096);
+            CHECK(luaL_loadstring(pState, "local t = {} for i = 1, 100000 do t[i] = i end") == LUA_OK);
+            CHECK(lua_pcall(pState, 0, 0, 0) == LUA_ERRMEM);
+            lua_pop(pState, 1);
+            allocator.SetLimit(0);
+            CHECK(luaL_dostring(pState, "result = result + 1") == 0);
+
+            lua_close(pState);
+            CHECK(allocator.GetUsage() == 0);
+
+            lua_State * pOther = luaL_newstate();
+            CHECK(LuaAllocator::Get(pOther) == nullptr);
+            lua_close(pOther);
+        }
+        CHECK(LuaAllocator::GetReservedTotal() == reserved);
+    }
+}
+
+int main()
+{
+    TestUsage();
+    TestResize();
+    TestRecycling();
+    TestLimit();
+    TestState();
+    return TEST_RESULT();
+}
@@ -0,0 +1,241 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "TestCheck.h"
+#include "TestScript.h"
+#include "Scripting/LuaBytecodeCache.h"
+#include "Toolbox/FileSystem.h"
+
+using namespace alpha;
+using alpha::test::TestScript;
+
+namespace
+{
+    const char * const sk_directory = "bytecode_cache_test";
+
+    LuaBytecodeCache::Bytecode MakeBytecode(const char * pText)
+    {
+        return LuaBytecodeCache::Bytecode(pText, pText + strlen(pText));
+    }
+
+    bool Matches(const std::shared_ptr<const LuaBytecodeCache::Bytecode> & bytecode, const char * pText)
+    {
+        return bytecode != nullptr && *bytecode == MakeBytecode(pText);
+    }
+
+    /** Path the cache writes a keys chunk to, mirrors LuaBytecodeCache::GetFilePath */
+    std::string ChunkPath(uint64_t key)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "%016llx.luac", static_cast<unsigned long long>(key));
+        char * path = OSJoinPath(sk_directory, name);
+        std::string result(path);
+        free(path);
+        return result;
+    }
+
+    std::string ReadFile(const std::string & path)
+    {
+        std::string contents;
+        FILE * fp = fopen(path.c_str(), "rb");
+        if (fp != nullptr)
+        {
+            char buffer[256];
+            size_t read = 0;
+            while ((read = fread(buffer, 1, sizeof(buffer), fp)) > 0)
+            {
+                contents.append(buffer, read);
+            }
+            fclose(fp);
+        }
+        return contents;
+    }
+
+    void WriteFile(const std::string & path, const std::string & contents)
+    {
+        FILE * fp = fopen(path.c_str(), "wb");
+        if (fp != nullptr)
+        {
+            fwrite(contents.data(), 1, contents.size(), fp);
+            fclose(fp);
+        }
+    }
+
+    void TestHash()
+    {
+        const char * source = "value = 1";
+        const uint64_t key = LuaBytecodeCache::Hash(source, strlen(source));
+        CHECK(key == LuaBytecodeCache::Hash(source, strlen(source)));
+        CHECK(key != LuaBytecodeCache::Hash("value = 2", 9));
+        CHECK(key != LuaBytecodeCache::Hash(source, strlen(source) - 1));
+        CHECK(LuaBytecodeCache::Hash("", 0) != LuaBytecodeCache::Hash(" ", 1));
+    }
+
+    void TestMemoryOnly()
+    {
+        LuaBytecodeCache::SetDirectory("");
+        LuaBytecodeCache::Clear();
+
+        const uint64_t key = 42;
+        CHECK(LuaBytecodeCache::Find(key) == nullptr);
+
+        LuaBytecodeCache::Store(key, MakeBytecode("chunk"));
+        CHECK(Matches(LuaBytecodeCache::Find(key), "chunk"));
+
+        // a newer chunk replaces the old one, and chunks already handed out stay valid
+        auto held = LuaBytecodeCache::Find(key);
+        LuaBytecodeCache::Store(key, MakeBytecode("newer"));
+        CHECK(Matches(LuaBytecodeCache::Find(key), "newer"));
+        CHECK(Matches(held, "chunk"));
+
+        LuaBytecodeCache::Remove(key);
+        CHECK(LuaBytecodeCache::Find(key) == nullptr);
+
+        LuaBytecodeCache::Store(key, MakeBytecode("chunk"));
+        LuaBytecodeCache::Clear();
+        CHECK(LuaBytecodeCache::Find(key) == nullptr);
+    }
+
+    void TestDirectory()
+    {
+        LuaBytecodeCache::SetDirectory(sk_directory);
+        LuaBytecodeCache::Clear();
+
+        // chunks on disk outlive the chunks in memory, as they would a restart
+        const uint64_t key = 7;
+        LuaBytecodeCache::Store(key, MakeBytecode("saved"));
+        LuaBytecodeCache::Clear();
+        CHECK(Matches(LuaBytecodeCache::Find(key), "saved"));
+
+        // an empty chunk is never written, so it is never read back
+        const uint64_t empty_key = 8;
+        LuaBytecodeCache::Store(empty_key, LuaBytecodeCache::Bytecode());
+        LuaBytecodeCache::Clear();
+        CHECK(LuaBytecodeCache::Find(empty_key) == nullptr);
+
+        std::remove(ChunkPath(key).c_str());
+        LuaBytecodeCache::Clear();
+        CHECK(LuaBytecodeCache::Find(key) == nullptr);
+        LuaBytecodeCache::SetDirectory("");
+    }
+
+    void TestDamagedFiles()
+    {
+        LuaBytecodeCache::SetDirectory(sk_directory);
+        LuaBytecodeCache::Clear();
+
+        const uint64_t key = 9;
+        LuaBytecodeCache::Store(key, MakeBytecode("intact chunk"));
+        const std::string path = ChunkPath(key);
+        const std::string intact = ReadFile(path);
+        CHECK(intact.size() > strlen("intact chunk"));
+
+        // a file cut short, as a crash mid write would leave it
+        WriteFile(path, intact.substr(0, intact.size() - 3));
+        LuaBytecodeCache::Clear();
+        CHECK(LuaBytecodeCache::Find(key) == nullptr);
+
+        // a file with extra bytes on the end
+        WriteFile(path, intact + "tail");
+        LuaBytecodeCache::Clear();
+        CHECK(LuaBytecodeCache::Find(key) == nullptr);
+
+        // a flipped byte in the bytecode fails the checksum
+        std::string flipped = intact;
+        flipped[flipped.size() - 1] ^= 0x20;
+        WriteFile(path, flipped);
+        LuaBytecodeCache::Clear();
+        CHECK(LuaBytecodeCache::Find(key) == nullptr);
+
+        // only a header, and bare bytecode with no header at all
+        WriteFile(path, intact.substr(0, intact.size() - strlen("intact chunk")));
+        LuaBytecodeCache::Clear();
+        CHECK(LuaBytecodeCache::Find(key) == nullptr);
+        WriteFile(path, "intact chunk");
+        LuaBytecodeCache::Clear();
+        CHECK(LuaBytecodeCache::Find(key) == nullptr);
+
+        // a valid file saved under another key
+        const uint64_t other_key = 10;
+        WriteFile(ChunkPath(other_key), intact);
+        LuaBytecodeCache::Clear();
+        CHECK(LuaBytecodeCache::Find(other_key) == nullptr);
+
+        // storing again replaces the damaged file, and the header is not part of the chunk read back
+        LuaBytecodeCache::Store(key, MakeBytecode("intact chunk"));
+        CHECK(ReadFile(path) == intact);
+        LuaBytecodeCache::Clear();
+        CHECK(Matches(LuaBytecodeCache::Find(key), "intact chunk"));
+
+        std::remove(path.c_str());
+        std::remove(ChunkPath(other_key).c_str());
+        LuaBytecodeCache::Clear();
+        LuaBytecodeCache::SetDirectory("");
+    }
+
+    void TestScripts()
+    {
+        LuaBytecodeCache::SetDirectory("");
+        LuaBytecodeCache::Clear();
+
+        const std::string source = "values = { answer = 42, name = 'cached' }";
+        const uint64_t key = LuaBytecodeCache::Hash(source.data(), source.size());
+
+        // the first run compiles and caches the script, the second runs the cached chunk
+        {
+            TestScript script("bytecode_cache_first.lua", source);
+            auto values = script.RunAndGet("values");
+            CHECK(values != nullptr && values->GetRoot().Get("answer").GetNumber() == 42.0);
+        }
+        auto cached = LuaBytecodeCache::Find(key);
+        CHECK(cached != nullptr && !cached->empty() && (*cached)[0] == '\x1b');
+        {
+            TestScript script("bytecode_cache_second.lua", source);
+            auto values = script.RunAndGet("values");
+            CHECK(values != nullptr && strcmp(values->GetRoot().Get("name").GetString(), "cached") == 0);
+        }
+
+        // bytecode that fails to load is replaced by compiling the source again
+        LuaBytecodeCache::Store(key, MakeBytecode("\x1bLua not really"));
+        {
+            TestScript script("bytecode_cache_broken.lua", source);
+            auto values = script.RunAndGet("values");
+            CHECK(values != nullptr && values->GetRoot().Get("answer").GetNumber() == 42.0);
+        }
+        auto replaced = LuaBytecodeCache::Find(key);
+        CHECK(replaced != nullptr && *replaced == *cached);
+
+        // lua refuses source text passed off as a chunk, so only compiled chunks are ever cached
+        CHECK(!Matches(replaced, "\x1bLua not really"));
+        LuaBytecodeCache::Clear();
+    }
+}
+
+int main()
+{
+    TestHash();
+    TestMemoryOnly();
+    TestDirectory();
+    TestDamagedFiles();
+    TestScripts();
+    return TEST_RESULT();
+}
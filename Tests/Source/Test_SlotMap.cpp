@@ -0,0 +1,174 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cstdint>
+#include <string>
+
+#include "TestCheck.h"
+#include "Toolbox/SlotMap.h"
+
+using namespace alpha;
+
+namespace
+{
+    struct TestHandle
+    {
+        TestHandle() : index(0), generation(0) { }
+
+        uint32_t index;
+        uint32_t generation;
+    };
+
+    typedef SlotMap<std::string, TestHandle> StringMap;
+
+    void TestInsertGet()
+    {
+        StringMap map;
+        CHECK(map.Empty());
+
+        TestHandle a = map.Insert("a");
+        TestHandle b = map.Insert("b");
+        CHECK(map.Size() == 2);
+        CHECK(map.Contains(a));
+        CHECK(map.Contains(b));
+        CHECK(map.Get(a) != nullptr && *map.Get(a) == "a");
+        CHECK(map.Get(b) != nullptr && *map.Get(b) == "b");
+
+        // a default handle never resolves
+        TestHandle none;
+        CHECK(!map.Contains(none));
+        CHECK(map.Get(none) == nullptr);
+    }
+
+    void TestRemoveKeepsOthersValid()
+    {
+        StringMap map;
+        TestHandle a = map.Insert("a");
+        TestHandle b = map.Insert("b");
+        TestHandle c = map.Insert("c");
+
+        // removing from the front moves the last value into the hole
+        CHECK(map.Remove(a));
+        CHECK(!map.Remove(a));
+        CHECK(map.Size() == 2);
+        CHECK(!map.Contains(a));
+        CHECK(map.Get(a) == nullptr);
+        CHECK(*map.Get(b) == "b");
+        CHECK(*map.Get(c) == "c");
+
+        // the dense array stays packed and every position maps back to a live handle
+        for (size_t i = 0; i < map.Size(); ++i)
+        {
+            TestHandle handle = map.GetHandleAt(i);
+            CHECK(map.Contains(handle));
+            CHECK(map.Get(handle) == &*(map.begin() + i));
+        }
+    }
+
+    void TestStaleHandleAfterReuse()
+    {
+        StringMap map;
+        TestHandle a = map.Insert("a");
+        CHECK(map.Remove(a));
+
+        // the slot is reused, but the old handle must not see the new value
+        TestHandle d = map.Insert("d");
+        CHECK(d.index == a.index);
+        CHECK(d.generation != a.generation);
+        CHECK(!map.Contains(a));
+        CHECK(map.Get(a) == nullptr);
+        CHECK(*map.Get(d) == "d");
+    }
+
+    void TestReissue()
+    {
+        StringMap map;
+        TestHandle a = map.Insert("a");
+        TestHandle b = map.Insert("b");
+
+        // the value stays where it is, only the handle that reaches it changes
+        TestHandle reissued = map.Reissue(a);
+        CHECK(reissued.index == a.index);
+        CHECK(reissued.generation != a.generation);
+        CHECK(!map.Contains(a));
+        CHECK(map.Get(a) == nullptr);
+        CHECK(map.Get(reissued) != nullptr && *map.Get(reissued) == "a");
+        CHECK(map.Size() == 2);
+        CHECK(map.GetHandleAt(0).generation == reissued.generation);
+
+        // a stale handle can not be reissued, and the value it used to reach keeps its handle
+        CHECK(map.Reissue(a).generation == 0);
+        CHECK(map.Contains(reissued));
+        CHECK(*map.Get(b) == "b");
+
+        // removing through the reissued handle still frees the slot
+        CHECK(map.Remove(reissued));
+        TestHandle c = map.Insert("c");
+        CHECK(!map.Contains(a));
+        CHECK(!map.Contains(reissued));
+        CHECK(*map.Get(c) == "c");
+    }
+
+    void TestClear()
+    {
+        StringMap map;
+        TestHandle handles[8];
+        for (int i = 0; i < 8; ++i)
+        {
+            handles[i] = map.Insert(std::to_string(i));
+        }
+        map.Clear();
+        CHECK(map.Empty());
+        for (int i = 0; i < 8; ++i)
+        {
+            CHECK(!map.Contains(handles[i]));
+        }
+
+        // slots are recycled after a clear
+        TestHandle e = map.Insert("e");
+        CHECK(e.index < 8);
+        CHECK(*map.Get(e) == "e");
+    }
+
+    void TestIteration()
+    {
+        StringMap map;
+        map.Insert("x");
+        TestHandle y = map.Insert("y");
+        map.Insert("z");
+        map.Remove(y);
+
+        std::string joined;
+        for (const std::string & value : map)
+        {
+            joined += value;
+        }
+        CHECK(joined.size() == 2);
+        CHECK(joined.find('x') != std::string::npos);
+        CHECK(joined.find('z') != std::string::npos);
+    }
+}
+
+int main()
+{
+    TestInsertGet();
+    TestRemoveKeepsOthersValid();
+    TestStaleHandleAfterReuse();
+    TestReissue();
+    TestClear();
+    TestIteration();
+    return TEST_RESULT();
+}
@@ -0,0 +1,155 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include "TestCheck.h"
+#include "Collision/Broadphase.h"
+#include "Math/AABB.h"
+
+using namespace alpha;
+
+namespace
+{
+    AABB Box(float x, float y, float z, float half)
+    {
+        return AABB(Vector3(x - half, y - half, z - half), Vector3(x + half, y + half, z + half));
+    }
+
+    float Random(float range)
+    {
+        return (static_cast<float>(std::rand()) / static_cast<float>(RAND_MAX)) * range;
+    }
+
+    /** Brute force answer, every pair tested against every other */
+    std::vector<ContactPair> BruteForce(const std::vector<EntityHandle> & entities, const std::vector<AABB> & boxes)
+    {
+        std::vector<ContactPair> pairs;
+        for (size_t i = 0; i < boxes.size(); ++i)
+        {
+            for (size_t j = i + 1; j < boxes.size(); ++j)
+            {
+                if (entities[i] != entities[j] && boxes[i].Overlaps(boxes[j]))
+                {
+                    pairs.push_back(ContactPair(entities[i], entities[j]));
+                }
+            }
+        }
+        std::sort(pairs.begin(), pairs.end());
+        pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+        return pairs;
+    }
+
+    void TestFewVolumes()
+    {
+        BroadphaseBounds bounds;
+        std::vector<ContactPair> pairs;
+
+        SweepAndPrune(bounds, pairs);
+        CHECK(pairs.empty());
+
+        bounds.Add(EntityHandle(1, 1), Box(0.f, 0.f, 0.f, 1.f));
+        SweepAndPrune(bounds, pairs);
+        CHECK(pairs.empty());
+
+        // overlapping on x alone is not a contact
+        bounds.Add(EntityHandle(2, 1), Box(0.5f, 5.f, 0.f, 1.f));
+        SweepAndPrune(bounds, pairs);
+        CHECK(pairs.empty());
+
+        // touching faces count as overlapping, and the pair is ordered whatever order the volumes were added in
+        bounds.Add(EntityHandle(0, 1), Box(2.f, 0.f, 0.f, 1.f));
+        SweepAndPrune(bounds, pairs);
+        CHECK(pairs.size() == 1);
+        CHECK(pairs.size() == 1 && pairs[0].a == EntityHandle(0, 1) && pairs[0].b == EntityHandle(1, 1));
+    }
+
+    void TestSameEntity()
+    {
+        // an entity with several colliders never collides with itself, and two of its colliders touching
+        // the same other entity only make one pair
+        BroadphaseBounds bounds;
+        bounds.Add(EntityHandle(1, 1), Box(0.f, 0.f, 0.f, 1.f));
+        bounds.Add(EntityHandle(1, 1), Box(0.5f, 0.f, 0.f, 1.f));
+        bounds.Add(EntityHandle(2, 1), Box(1.f, 0.f, 0.f, 1.f));
+
+        std::vector<ContactPair> pairs;
+        SweepAndPrune(bounds, pairs);
+        CHECK(pairs.size() == 1);
+        CHECK(pairs.size() == 1 && pairs[0] == ContactPair(EntityHandle(2, 1), EntityHandle(1, 1)));
+    }
+
+    void TestMatchesBruteForce()
+    {
+        // enough volumes to exercise the four wide tests, and their ragged ends
+        std::srand(7);
+        for (size_t count : { 2u, 3u, 5u, 9u, 64u, 301u })
+        {
+            BroadphaseBounds bounds;
+            std::vector<EntityHandle> entities;
+            std::vector<AABB> boxes;
+            for (size_t i = 0; i < count; ++i)
+            {
+                // a few entities own more than one volume
+                EntityHandle entity(static_cast<uint32_t>(i % (count - count / 8)), 1);
+                AABB box = Box(Random(40.f), Random(40.f), Random(40.f), 0.5f + Random(3.f));
+                entities.push_back(entity);
+                boxes.push_back(box);
+                bounds.Add(entity, box);
+            }
+            CHECK(bounds.Size() == count);
+
+            std::vector<ContactPair> pairs;
+            SweepAndPrune(bounds, pairs);
+            CHECK(pairs == BruteForce(entities, boxes));
+        }
+    }
+
+    void TestIdenticalVolumes()
+    {
+        // volumes sharing a start on x must still all be tested against one another
+        BroadphaseBounds bounds;
+        std::vector<EntityHandle> entities;
+        std::vector<AABB> boxes;
+        for (uint32_t i = 0; i < 6; ++i)
+        {
+            entities.push_back(EntityHandle(i, 1));
+            boxes.push_back(Box(0.f, 0.f, 0.f, 1.f));
+            bounds.Add(entities.back(), boxes.back());
+        }
+
+        std::vector<ContactPair> pairs;
+        SweepAndPrune(bounds, pairs);
+        CHECK(pairs.size() == 15);
+        CHECK(pairs == BruteForce(entities, boxes));
+
+        bounds.Clear();
+        CHECK(bounds.Size() == 0);
+        SweepAndPrune(bounds, pairs);
+        CHECK(pairs.empty());
+    }
+}
+
+int main()
+{
+    TestFewVolumes();
+    TestSameEntity();
+    TestMatchesBruteForce();
+    TestIdenticalVolumes();
+    return TEST_RESULT();
+}
@@ -0,0 +1,315 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TestCheck.h"
+#include "Entities/Entity.h"
+#include "Entities/EntityQuery.h"
+#include "Entities/LightComponent.h"
+#include "Entities/MeshComponent.h"
+#include "Events/AEvent.h"
+#include "Logic/GameSystem.h"
+#include "Logic/SystemScheduler.h"
+#include "Threading/ATask.h"
+#include "Threading/TaskGroup.h"
+#include "Threading/ThreadSystemEvents.h"
+
+using namespace alpha;
+
+namespace
+{
+    /** Shared clock, every batch takes a tick when it starts and when it finishes */
+    std::atomic<unsigned int> s_clock(0);
+
+    /** Records when its batches ran, and how many entities they saw */
+    class RecordingSystem : public AGameSystem
+    {
+    public:
+        RecordingSystem(const std::vector<std::string> & reads, const std::vector<std::string> & writes, size_t batchSize = 0)
+            : AGameSystem(reads, writes, batchSize)
+            , firstStart(~0u)
+            , lastFinish(0)
+            , batches(0)
+            , entities(0)
+        { }
+
+        void VUpdate(const SystemView & /*view*/, size_t begin, size_t end, float /*fCurrentTime*/, float /*fElapsedTime*/)
+        {
+            unsigned int start = s_clock++;
+            // give other batches a chance to overlap, if the graph would let them
+            std::this_thread::yield();
+            unsigned int finish = s_clock++;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            firstStart = std::min(firstStart, start);
+            lastFinish = std::max(lastFinish, finish);
+            ++batches;
+            entities += end - begin;
+        }
+
+        /** Forget when the batches of earlier frames ran */
+        void Reset()
+        {
+            firstStart = ~0u;
+            lastFinish = 0;
+        }
+
+        std::mutex mutex;
+        unsigned int firstStart;
+        unsigned int lastFinish;
+        size_t batches;
+        size_t entities;
+    };
+
+    /** Raises a flag when run, used to check work that must happen before any system */
+    class Task_Flag : public ATask
+    {
+    public:
+        explicit Task_Flag(std::atomic<unsigned int> * pTime) : m_pTime(pTime) { }
+        bool VExecute()
+        {
+            *m_pTime = s_clock++;
+            return true;
+        }
+
+    private:
+        std::atomic<unsigned int> * m_pTime;
+    };
+
+    /** Collects the tasks published by the scheduler, instead of handing them to a thread pool */
+    struct Published
+    {
+        std::function<void(AEvent *)> Publish()
+        {
+            return [this](AEvent * pEvent)
+            {
+                if (auto pTaskEvent = dynamic_cast<Event_NewThreadTask *>(pEvent))
+                {
+                    tasks.push_back(pTaskEvent->GetTask());
+                }
+                delete pEvent;
+            };
+        }
+
+        /** Run every published task, spread over a few threads */
+        void Run()
+        {
+            std::vector<std::thread> threads;
+            for (size_t t = 0; t < tasks.size(); ++t)
+            {
+                ATask * pTask = tasks[t];
+                threads.push_back(std::thread([pTask]()
+                {
+                    while (!pTask->IsComplete())
+                    {
+                        pTask->Execute();
+                    }
+                }));
+            }
+            for (auto & thread : threads)
+            {
+                thread.join();
+            }
+            this->Clear();
+        }
+
+        void Clear()
+        {
+            for (ATask * pTask : tasks)
+            {
+                delete pTask;
+            }
+            tasks.clear();
+        }
+
+        std::vector<ATask *> tasks;
+    };
+
+    std::shared_ptr<EntityQuery> MakeQuery(const std::vector<std::shared_ptr<Entity> > & entities, const std::vector<std::string> & typeNames)
+    {
+        std::vector<unsigned int> type_ids;
+        for (auto & name : typeNames)
+        {
+            type_ids.push_back(EntityComponent::GetIDFromName(name));
+        }
+        auto query = std::make_shared<EntityQuery>(type_ids);
+        for (auto & entity : entities)
+        {
+            query->TryAdd(entity);
+        }
+        return query;
+    }
+
+    /** Entities with a mesh and a light each, every entity needs its own handle to be told apart by queries */
+    std::vector<std::shared_ptr<Entity> > MakeEntities(size_t count)
+    {
+        std::vector<std::shared_ptr<Entity> > entities;
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto entity = std::make_shared<Entity>(nullptr);
+            entity->SetHandle(EntityHandle(static_cast<uint32_t>(i), 1));
+            entity->Add(EntityComponent::GetIDFromName("mesh"), std::make_shared<MeshComponent>());
+            entity->Add(EntityComponent::GetIDFromName("light"), std::make_shared<LightComponent>());
+            entities.push_back(entity);
+        }
+        return entities;
+    }
+
+    void TestConflicts()
+    {
+        const std::string mesh = MeshComponent::sk_name;
+        const std::string light = LightComponent::sk_name;
+
+        RecordingSystem read_mesh({ mesh }, {});
+        RecordingSystem read_mesh_too({ mesh }, {});
+        RecordingSystem write_mesh({}, { mesh });
+        RecordingSystem write_light({}, { light });
+        RecordingSystem read_both_write_light({ mesh }, { light });
+
+        // sharing read access is fine, any write to a touched type is not, whichever side writes
+        CHECK(!read_mesh.ConflictsWith(read_mesh_too));
+        CHECK(read_mesh.ConflictsWith(write_mesh));
+        CHECK(write_mesh.ConflictsWith(read_mesh));
+        CHECK(write_mesh.ConflictsWith(write_mesh));
+        CHECK(!write_mesh.ConflictsWith(write_light));
+        CHECK(!read_mesh.ConflictsWith(write_light));
+        CHECK(read_both_write_light.ConflictsWith(write_light));
+        CHECK(read_both_write_light.ConflictsWith(write_mesh));
+        CHECK(!read_both_write_light.ConflictsWith(read_mesh));
+    }
+
+    void TestOrder()
+    {
+        const std::string mesh = MeshComponent::sk_name;
+        const std::string light = LightComponent::sk_name;
+
+        auto entities = MakeEntities(7);
+        auto mesh_query = MakeQuery(entities, { mesh });
+        auto light_query = MakeQuery(entities, { light });
+        CHECK(mesh_query->Size() == 7);
+
+        // write mesh, then two readers of it, then another writer that has to wait for both readers.
+        // the light writer conflicts with none of them.
+        auto writer = std::make_shared<RecordingSystem>(std::vector<std::string>(), std::vector<std::string>(1, mesh), 2);
+        auto reader_a = std::make_shared<RecordingSystem>(std::vector<std::string>(1, mesh), std::vector<std::string>(), 3);
+        auto reader_b = std::make_shared<RecordingSystem>(std::vector<std::string>(1, mesh), std::vector<std::string>());
+        auto rewriter = std::make_shared<RecordingSystem>(std::vector<std::string>(), std::vector<std::string>(1, mesh), 4);
+        auto lights = std::make_shared<RecordingSystem>(std::vector<std::string>(), std::vector<std::string>(1, light), 1);
+
+        SystemScheduler scheduler;
+        scheduler.Add(writer, mesh_query);
+        scheduler.Add(reader_a, mesh_query);
+        scheduler.Add(reader_b, mesh_query);
+        scheduler.Add(rewriter, mesh_query);
+        scheduler.Add(lights, light_query);
+        CHECK(scheduler.Size() == 5);
+
+        Published published;
+        scheduler.Update(0.f, 0.1f, ET_NONE, published.Publish());
+        CHECK(!published.tasks.empty());
+        published.Run();
+        scheduler.Finish();
+
+        // every entity is visited once per system, in batches of the systems size
+        CHECK(writer->batches == 4 && writer->entities == 7);
+        CHECK(reader_a->batches == 3 && reader_a->entities == 7);
+        CHECK(reader_b->batches == 1 && reader_b->entities == 7);
+        CHECK(rewriter->batches == 2 && rewriter->entities == 7);
+        CHECK(lights->batches == 7 && lights->entities == 7);
+
+        // conflicting systems never overlap, and run in the order they were added
+        CHECK(writer->lastFinish < reader_a->firstStart);
+        CHECK(writer->lastFinish < reader_b->firstStart);
+        CHECK(reader_a->lastFinish < rewriter->firstStart);
+        CHECK(reader_b->lastFinish < rewriter->firstStart);
+
+        // removing the readers lets the second writer follow the first directly
+        CHECK(scheduler.Remove(reader_a));
+        CHECK(scheduler.Remove(reader_b));
+        CHECK(!scheduler.Remove(reader_b));
+        CHECK(scheduler.Size() == 3);
+
+        writer->Reset();
+        rewriter->Reset();
+        scheduler.Update(0.1f, 0.1f, ET_NONE, published.Publish());
+        published.Run();
+        scheduler.Finish();
+        CHECK(writer->batches == 8);
+        CHECK(reader_a->batches == 3);
+        CHECK(rewriter->batches == 4);
+        CHECK(writer->lastFinish < rewriter->firstStart);
+    }
+
+    void TestFinish()
+    {
+        const std::string mesh = MeshComponent::sk_name;
+        auto entities = MakeEntities(5);
+        auto query = MakeQuery(entities, { mesh });
+
+        auto writer = std::make_shared<RecordingSystem>(std::vector<std::string>(), std::vector<std::string>(1, mesh), 2);
+        auto reader = std::make_shared<RecordingSystem>(std::vector<std::string>(1, mesh), std::vector<std::string>());
+        SystemScheduler scheduler;
+        scheduler.Add(writer, query);
+        scheduler.Add(reader, query);
+
+        // tasks that never reach a thread do not hold the frame up, finishing runs it on the caller
+        Published published;
+        scheduler.Update(0.f, 0.1f, ET_NONE, published.Publish());
+        scheduler.Finish();
+        CHECK(writer->batches == 3);
+        CHECK(reader->batches == 1);
+        CHECK(writer->lastFinish < reader->firstStart);
+        published.Run();
+        CHECK(writer->batches == 3);
+
+        // a new frame finishes the last one before it starts
+        scheduler.Update(0.1f, 0.1f, ET_NONE, published.Publish());
+        scheduler.Update(0.2f, 0.1f, ET_NONE, published.Publish());
+        CHECK(writer->batches == 6);
+        CHECK(reader->batches == 2);
+        published.Clear();
+        scheduler.Finish();
+        CHECK(writer->batches == 9);
+        CHECK(reader->batches == 3);
+
+        // no system runs before the work it was told to follow
+        writer->Reset();
+        std::atomic<unsigned int> flagged(0);
+        std::vector<ATask *> before(1, new Task_Flag(&flagged));
+        auto group = TaskGroup::Publish(std::move(before), published.Publish());
+        scheduler.Update(0.3f, 0.1f, ET_NONE, published.Publish(), group);
+        published.Run();
+        scheduler.Finish();
+        CHECK(group->IsDone());
+        CHECK(writer->batches == 12);
+        CHECK(flagged < writer->firstStart);
+    }
+}
+
+int main()
+{
+    TestConflicts();
+    TestOrder();
+    TestFinish();
+    return TEST_RESULT();
+}
@@ -0,0 +1,219 @@
+/**
+Copyright 2014-2015 Jason R. Wendlandt
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "TestCheck.h"
+#include "Entities/Entity.h"
+#include "Entities/EntityComponent.h"
+#include "Entities/EntityFactory.h"
+#include "Entities/EntityTags.h"
+#include "Entities/LightComponent.h"
+#include "Entities/MeshComponent.h"
+#include "Logic/WorldFile.h"
+
+using namespace alpha;
+
+namespace
+{
+    const unsigned int sk_rootId = EntityComponent::GetIDFromName("root");
+    const unsigned int sk_lampId = EntityComponent::GetIDFromName("lamp");
+
+    /** An entity with a mesh root, and a light attached beneath it */
+    std::shared_ptr<Entity> MakeEntity(float x, EntityTagMask tags)
+    {
+        auto entity = std::make_shared<Entity>(nullptr);
+        entity->SetTags(tags);
+
+        auto root = std::make_shared<MeshComponent>();
+        root->SetPosition(Vector3(x, 2.f, 3.f));
+        root->SetScale(Vector3(1.f, 2.f, 1.f));
+        root->SetMaterialPath("Materials/test.lua");
+
+        auto lamp = std::make_shared<LightComponent>();
+        lamp->SetPosition(Vector3(0.f, 1.f, 0.f));
+        lamp->SetIntensity(0.75f);
+        lamp->SetLightColor(Vector4(1.f, 0.5f, 0.25f, 1.f));
+
+        root->Attach(sk_lampId, lamp);
+        lamp->SetParent(root);
+        entity->Add(sk_rootId, root);
+        entity->Add(sk_lampId, lamp);
+        return entity;
+    }
+
+    std::string Serialize(const std::vector<std::shared_ptr<Entity> > & entities)
+    {
+        std::ostringstream stream;
+        SerializeWorld(entities, stream);
+        return stream.str();
+    }
+
+    void TestRoundTrip()
+    {
+        EntityFactory factory;
+        std::vector<std::shared_ptr<Entity> > entities;
+        entities.push_back(MakeEntity(1.f, ET_NONE));
+        entities.push_back(MakeEntity(-4.f, ET_DISABLED));
+
+        std::string data = Serialize(entities);
+        std::vector<std::shared_ptr<Entity> > loaded = DeserializeWorld(data.data(), data.size(), &factory);
+        CHECK(loaded.size() == entities.size());
+
+        for (size_t i = 0; i < loaded.size() && i < entities.size(); ++i)
+        {
+            CHECK(loaded[i]->GetTags() == entities[i]->GetTags());
+            CHECK(loaded[i]->GetScript() == nullptr);
+
+            auto root = std::dynamic_pointer_cast<MeshComponent>(loaded[i]->GetByID(sk_rootId));
+            auto lamp = std::dynamic_pointer_cast<LightComponent>(loaded[i]->GetByID(sk_lampId));
+            CHECK(root != nullptr);
+            CHECK(lamp != nullptr);
+            if (root == nullptr || lamp == nullptr)
+            {
+                continue;
+            }
+
+            auto source = std::static_pointer_cast<MeshComponent>(entities[i]->GetByID(sk_rootId));
+            CHECK(root->GetPosition() == source->GetPosition());
+            CHECK(root->GetScale() == source->GetScale());
+            CHECK(root->GetRotation() == source->GetRotation());
+            CHECK(root->GetMaterialPath() == "Materials/test.lua");
+
+            CHECK(lamp->GetPosition() == Vector3(0.f, 1.f, 0.f));
+            CHECK(lamp->GetIntensity() == 0.75f);
+            Vector4 color = lamp->GetLightColor();
+            CHECK(color.x == 1.f && color.y == 0.5f && color.z == 0.25f);
+
+            // the hierarchy is rebuilt, with the light beneath the mesh
+            auto children = root->GetComponents();
+            CHECK(children.size() == 1 && children.count(sk_lampId) == 1 && children[sk_lampId] == lamp);
+        }
+
+        // loading the same snapshot again gives the same bytes back
+        CHECK(Serialize(loaded) == data);
+    }
+
+    void TestEmptyWorld()
+    {
+        EntityFactory factory;
+        std::string data = Serialize(std::vector<std::shared_ptr<Entity> >());
+        CHECK(data.size() == sizeof(WorldFileHeader));
+        CHECK(DeserializeWorld(data.data(), data.size(), &factory).empty());
+    }
+
+    void TestDropsPooledTag()
+    {
+        // only the logic system may pool an entity, so the tag never comes back from a snapshot
+        EntityFactory factory;
+        std::vector<std::shared_ptr<Entity> > entities;
+        entities.push_back(MakeEntity(0.f, ET_HIDDEN | ET_POOLED));
+
+        std::string data = Serialize(entities);
+        std::vector<std::shared_ptr<Entity> > loaded = DeserializeWorld(data.data(), data.size(), &factory);
+        CHECK(loaded.size() == 1);
+        CHECK(!loaded.empty() && loaded[0]->GetTags() == ET_HIDDEN);
+    }
+
+    void TestRejectsBadData()
+    {
+        EntityFactory factory;
+        std::vector<std::shared_ptr<Entity> > entities;
+        entities.push_back(MakeEntity(0.f, ET_NONE));
+        std::string data = Serialize(entities);
+
+        // wrong signature
+        std::string bad = data;
+        bad[0] = 'X';
+        CHECK(DeserializeWorld(bad.data(), bad.size(), &factory).empty());
+
+        // unknown version
+        bad = data;
+        WorldFileHeader header;
+        memcpy(&header, bad.data(), sizeof(WorldFileHeader));
+        header.version = WORLDFILE_V2 + 1;
+        memcpy(&bad[0], &header, sizeof(WorldFileHeader));
+        CHECK(DeserializeWorld(bad.data(), bad.size(), &factory).empty());
+
+        // truncated component data
+        CHECK(DeserializeWorld(data.data(), data.size() - 1, &factory).empty());
+        CHECK(DeserializeWorld(data.data(), sizeof(WorldFileHeader) / 2, &factory).empty());
+
+        // counts larger than the snapshot could hold are rejected before anything is sized by them
+        memcpy(&header, data.data(), sizeof(WorldFileHeader));
+        WorldFileHeader huge = header;
+        huge.entityCount = 0x40000000;
+        bad = data;
+        memcpy(&bad[0], &huge, sizeof(WorldFileHeader));
+        CHECK(DeserializeWorld(bad.data(), bad.size(), &factory).empty());
+
+        huge = header;
+        huge.componentCount = 0xFFFFFFFF;
+        memcpy(&bad[0], &huge, sizeof(WorldFileHeader));
+        CHECK(DeserializeWorld(bad.data(), bad.size(), &factory).empty());
+
+        huge = header;
+        huge.stringCount = 0xFFFFFFFF;
+        memcpy(&bad[0], &huge, sizeof(WorldFileHeader));
+        CHECK(DeserializeWorld(bad.data(), bad.size(), &factory).empty());
+    }
+
+    void TestRejectsBadRecords()
+    {
+        EntityFactory factory;
+        std::vector<std::shared_ptr<Entity> > entities;
+        entities.push_back(MakeEntity(0.f, ET_NONE));
+        std::string data = Serialize(entities);
+
+        // find the entity record, straight after the header and string table
+        WorldFileHeader header;
+        memcpy(&header, data.data(), sizeof(WorldFileHeader));
+        size_t offset = data.size() - header.dataSize - header.componentCount * sizeof(WorldComponentRecord)
+                        - header.entityCount * sizeof(WorldEntityRecord);
+        WorldEntityRecord record;
+        memcpy(&record, &data[offset], sizeof(WorldEntityRecord));
+
+        // a component range that wraps around is not read
+        std::string bad = data;
+        WorldEntityRecord wrapped = record;
+        wrapped.firstComponent = 1;
+        wrapped.componentCount = 0xFFFFFFFF;
+        memcpy(&bad[offset], &wrapped, sizeof(WorldEntityRecord));
+        CHECK(DeserializeWorld(bad.data(), bad.size(), &factory).empty());
+
+        wrapped.firstComponent = 0xFFFFFFFF;
+        wrapped.componentCount = 2;
+        memcpy(&bad[offset], &wrapped, sizeof(WorldEntityRecord));
+        CHECK(DeserializeWorld(bad.data(), bad.size(), &factory).empty());
+
+        // the untouched record still loads
+        CHECK(DeserializeWorld(data.data(), data.size(), &factory).size() == 1);
+    }
+}
+
+int main()
+{
+    TestRoundTrip();
+    TestEmptyWorld();
+    TestDropsPooledTag();
+    TestRejectsBadData();
+    TestRejectsBadRecords();
+    return TEST_RESULT();
+}
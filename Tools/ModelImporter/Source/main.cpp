@@ -14,6 +14,10 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <map>
 #include <vector>
 #include <string>
 #include <iostream>
@@ -26,11 +30,181 @@ limitations under the License.
 #include "Graphics/Model.h"
 #include "Graphics/Mesh.h"
 #include "Graphics/ModelFile.h"
+#include "Animation/AnimationClip.h"
+#include "Animation/Skeleton.h"
+
+/** Clips are resampled to a fixed rate, so every frame is a full pose */
+const float sk_clipFrameRate = 30.f;
+
+/**
+ * The skeleton being built for the model, bones are ordered parents first.
+ */
+struct SkeletonData
+{
+    std::vector<alpha::Bone> bones;
+    /** Bone index for each bone name */
+    std::map<std::string, unsigned int> indices;
+    /** Local transform of each bone at bind time */
+    std::vector<aiMatrix4x4> bindLocals;
+    /** Transform of any non-bone nodes between each bone and its parent bone */
+    std::vector<aiMatrix4x4> between;
+};
+
+/**
+ * Assimp matrices transform column vectors, the engine uses row vectors, so the matrix is transposed.
+ */
+alpha::Matrix ToMatrix(const aiMatrix4x4 & m)
+{
+    return alpha::Matrix(m.a1, m.b1, m.c1, m.d1,
+                         m.a2, m.b2, m.c2, m.d2,
+                         m.a3, m.b3, m.c3, m.d3,
+                         m.a4, m.b4, m.c4, m.d4);
+}
+
+/**
+ * Split a local transform into the position, rotation, and scale a pose stores.
+ */
+void SetPoseBone(alpha::Pose & pose, unsigned int bone, const aiMatrix4x4 & local)
+{
+    aiVector3D scale, position;
+    aiQuaternion rotation;
+    local.Decompose(scale, rotation, position);
+    pose.SetBone(bone, alpha::Vector3(position.x, position.y, position.z),
+                 alpha::Quaternion(rotation.x, rotation.y, rotation.z, rotation.w),
+                 alpha::Vector3(scale.x, scale.y, scale.z));
+}
+
+/**
+ * Gather the name and offset matrix of every bone used by any mesh.
+ */
+void collectBoneNames(const aiScene * scene, std::map<std::string, aiMatrix4x4> & offsets)
+{
+    for (unsigned int i = 0; i < scene->mNumMeshes; ++i)
+    {
+        const aiMesh * mesh = scene->mMeshes[i];
+        for (unsigned int b = 0; b < mesh->mNumBones; ++b)
+        {
+            offsets[mesh->mBones[b]->mName.C_Str()] = mesh->mBones[b]->mOffsetMatrix;
+        }
+    }
+}
+
+/**
+ * Walk the node tree depth first, so parent bones are always added before their children.
+ */
+void collectBones(const aiNode * node, int parent, const aiMatrix4x4 & between, const std::map<std::string, aiMatrix4x4> & offsets, SkeletonData & skeleton)
+{
+    auto search = offsets.find(node->mName.C_Str());
+    if (search != offsets.end())
+    {
+        alpha::Bone bone;
+        bone.name = search->first;
+        bone.parent = parent;
+        bone.inverseBind = ToMatrix(search->second);
+
+        unsigned int index = static_cast<unsigned int>(skeleton.bones.size());
+        skeleton.bones.push_back(bone);
+        skeleton.indices[bone.name] = index;
+        skeleton.bindLocals.push_back(between * node->mTransformation);
+        skeleton.between.push_back(between);
+
+        for (unsigned int i = 0; i < node->mNumChildren; ++i)
+        {
+            collectBones(node->mChildren[i], static_cast<int>(index), aiMatrix4x4(), offsets, skeleton);
+        }
+    }
+    else
+    {
+        // carry this nodes transform down to the next bone
+        aiMatrix4x4 carried = between * node->mTransformation;
+        for (unsigned int i = 0; i < node->mNumChildren; ++i)
+        {
+            collectBones(node->mChildren[i], parent, carried, offsets, skeleton);
+        }
+    }
+}
+
+/**
+ * Interpolate a list of vector keys at a time in ticks.
+ */
+aiVector3D sampleVectorKeys(const aiVectorKey * keys, unsigned int count, double time)
+{
+    if (count == 1 || time <= keys[0].mTime)
+    {
+        return keys[0].mValue;
+    }
+    for (unsigned int i = 0; i + 1 < count; ++i)
+    {
+        if (time < keys[i + 1].mTime)
+        {
+            float t = static_cast<float>((time - keys[i].mTime) / (keys[i + 1].mTime - keys[i].mTime));
+            return keys[i].mValue + (keys[i + 1].mValue - keys[i].mValue) * t;
+        }
+    }
+    return keys[count - 1].mValue;
+}
+
+/**
+ * Interpolate a list of rotation keys at a time in ticks.
+ */
+aiQuaternion sampleRotationKeys(const aiQuatKey * keys, unsigned int count, double time)
+{
+    if (count == 1 || time <= keys[0].mTime)
+    {
+        return keys[0].mValue;
+    }
+    for (unsigned int i = 0; i + 1 < count; ++i)
+    {
+        if (time < keys[i + 1].mTime)
+        {
+            float t = static_cast<float>((time - keys[i].mTime) / (keys[i + 1].mTime - keys[i].mTime));
+            aiQuaternion out;
+            aiQuaternion::Interpolate(out, keys[i].mValue, keys[i + 1].mValue, t);
+            return out.Normalize();
+        }
+    }
+    return keys[count - 1].mValue;
+}
+
+/**
+ * Resample an assimp animation into a clip, bones without a channel hold their bind pose.
+ */
+alpha::AnimationClip * processAnimation(const aiAnimation * animation, const SkeletonData & skeleton, const alpha::Pose & bindPose)
+{
+    double ticksPerSecond = animation->mTicksPerSecond > 0.0 ? animation->mTicksPerSecond : 25.0;
+    double duration = animation->mDuration / ticksPerSecond;
+    unsigned int frameCount = static_cast<unsigned int>(std::floor(duration * sk_clipFrameRate)) + 1;
+
+    std::vector<alpha::Pose> frames(frameCount, bindPose);
+    for (unsigned int c = 0; c < animation->mNumChannels; ++c)
+    {
+        const aiNodeAnim * channel = animation->mChannels[c];
+        auto search = skeleton.indices.find(channel->mNodeName.C_Str());
+        if (search == skeleton.indices.end() || channel->mNumPositionKeys == 0 || channel->mNumRotationKeys == 0 || channel->mNumScalingKeys == 0)
+        {
+            continue;
+        }
+        unsigned int bone = search->second;
+
+        for (unsigned int f = 0; f < frameCount; ++f)
+        {
+            double time = std::min(static_cast<double>(f) / sk_clipFrameRate, duration) * ticksPerSecond;
+            aiVector3D position = sampleVectorKeys(channel->mPositionKeys, channel->mNumPositionKeys, time);
+            aiQuaternion rotation = sampleRotationKeys(channel->mRotationKeys, channel->mNumRotationKeys, time);
+            aiVector3D scale = sampleVectorKeys(channel->mScalingKeys, channel->mNumScalingKeys, time);
+
+            aiMatrix4x4 local(scale, rotation, position);
+            SetPoseBone(frames[f], bone, skeleton.between[bone] * local);
+        }
+    }
+
+    return new alpha::AnimationClip(sk_clipFrameRate, frames);
+}
 
 /**
  * Create a Mesh for each aiMesh
  */
-alpha::Mesh * processMesh(aiMesh * mesh, const aiScene * /*scene*/)
+alpha::Mesh * processMesh(aiMesh * mesh, const aiScene * /*scene*/, const SkeletonData & skeleton)
 {
     //printf("parsing a mesh.\r\n");
 
@@ -78,29 +252,80 @@ alpha::Mesh * processMesh(aiMesh * mesh, const aiScene * /*scene*/)
         //printf("\r\n");
     }
     
+    // process bone weights, keeping the four strongest influences on each vertex
+    std::vector<alpha::VertexWeights> weights;
+    if (mesh->mNumBones > 0)
+    {
+        alpha::VertexWeights empty = { { 0, 0, 0, 0 }, { 0.f, 0.f, 0.f, 0.f } };
+        weights.resize(mesh->mNumVertices, empty);
+
+        for (unsigned int b = 0; b < mesh->mNumBones; ++b)
+        {
+            const aiBone * bone = mesh->mBones[b];
+            unsigned char index = static_cast<unsigned char>(skeleton.indices.at(bone->mName.C_Str()));
+            for (unsigned int w = 0; w < bone->mNumWeights; ++w)
+            {
+                alpha::VertexWeights & vw = weights[bone->mWeights[w].mVertexId];
+                float weight = bone->mWeights[w].mWeight;
+
+                // replace the weakest slot if this influence is stronger
+                int weakest = 0;
+                for (int k = 1; k < 4; ++k)
+                {
+                    if (vw.weights[k] < vw.weights[weakest])
+                    {
+                        weakest = k;
+                    }
+                }
+                if (weight > vw.weights[weakest])
+                {
+                    vw.bones[weakest] = index;
+                    vw.weights[weakest] = weight;
+                }
+            }
+        }
+
+        for (auto & vw : weights)
+        {
+            float total = vw.weights[0] + vw.weights[1] + vw.weights[2] + vw.weights[3];
+            if (total > 0.f)
+            {
+                for (int k = 0; k < 4; ++k)
+                {
+                    vw.weights[k] /= total;
+                }
+            }
+            else
+            {
+                // an unweighted vertex follows the root bone
+                vw.weights[0] = 1.f;
+            }
+        }
+    }
+
     // process material
     
     //printf("done parsing mesh\r\n");
 
-    return new alpha::Mesh(vertices, indices);
+    return new alpha::Mesh(vertices, indices, weights);
 }
 
 /**
  * Process all meshes at this node, an recurse through child nodes.
  */
-void processNode(aiNode * node, const aiScene * scene, std::vector<alpha::Renderable *> & meshes)
+void processNode(aiNode * node, const aiScene * scene, const SkeletonData & skeleton, std::vector<alpha::Renderable *> & meshes)
 {
     //printf("parsing a node\r\n");
 
     for (unsigned int i = 0; i < node->mNumMeshes; ++i)
     {
         aiMesh * mesh = scene->mMeshes[node->mMeshes[i]];
-        meshes.push_back(processMesh(mesh, scene));
+        meshes.push_back(processMesh(mesh, scene, skeleton));
     }
 
     for (unsigned int i = 0; i < node->mNumChildren; ++i)
     {
-        processNode(node->mChildren[i], scene, meshes);
+        processNode(node->mChildren[i], scene, skeleton, meshes);
     }
 
     //printf("done parsing node.\r\n");
@@ -120,9 +345,31 @@ void ConvertModel(const std::string & source, const std::string & target)
     else
     {
         //printf("Loading model ...\r\n");
+        // build the skeleton first, so mesh weights can refer to bones by index
+        std::map<std::string, aiMatrix4x4> offsets;
+        collectBoneNames(scene, offsets);
+        SkeletonData skeleton;
+        collectBones(scene->mRootNode, -1, aiMatrix4x4(), offsets, skeleton);
+
+        alpha::Skeleton * pSkeleton = nullptr;
+        alpha::Pose bindPose(skeleton.bones.size());
+        if (skeleton.bones.size() > alpha::Skeleton::sk_maxBones)
+        {
+            printf("Error !! %u bones, at most %u are supported.\r\n", (unsigned int)skeleton.bones.size(), alpha::Skeleton::sk_maxBones);
+            return;
+        }
+        if (!skeleton.bones.empty())
+        {
+            for (unsigned int i = 0; i < skeleton.bones.size(); ++i)
+            {
+                SetPoseBone(bindPose, i, skeleton.bindLocals[i]);
+            }
+            pSkeleton = new alpha::Skeleton(skeleton.bones, bindPose);
+        }
+
         std::vector<alpha::Renderable *> meshes;
-        processNode(scene->mRootNode, scene, meshes);
-        alpha::Model mod(meshes);
+        processNode(scene->mRootNode, scene, skeleton, meshes);
+        alpha::Model mod(meshes, pSkeleton);
 
         std::ofstream out;
         out.open(target, std::ios::out | std::ios::binary);
@@ -132,6 +379,31 @@ void ConvertModel(const std::string & source, const std::string & target)
             out.close();
         }
 
+        // each animation is written next to the model, as {target}_{animation}.ac
+        if (pSkeleton != nullptr)
+        {
+            std::string base = target.substr(0, target.find_last_of('.'));
+            for (unsigned int i = 0; i < scene->mNumAnimations; ++i)
+            {
+                std::string name = scene->mAnimations[i]->mName.C_Str();
+                if (name.empty())
+                {
+                    name = "clip" + std::to_string(i);
+                }
+                std::replace_if(name.begin(), name.end(), [](char c) { return !isalnum(static_cast<unsigned char>(c)); }, '_');
+
+                alpha::AnimationClip * pClip = processAnimation(scene->mAnimations[i], skeleton, bindPose);
+                std::ofstream clipOut;
+                clipOut.open(base + "_" + name + ".ac", std::ios::out | std::ios::binary);
+                if (clipOut.is_open())
+                {
+                    alpha::SerializeClip(pClip, clipOut);
+                    clipOut.close();
+                }
+                delete pClip;
+            }
+        }
+
         //// TEST
         
         std::ifstream infile;